@@ -0,0 +1,262 @@
+// 解码基准：逐个文件测量不同解码方式的 CPU 开销与单次解码的最长阻塞时间
+// 用法: decodeBench [--speed=N] [--ahead=SECONDS] <file>...
+//   inline   单线程解码器，在读包的同一线程即时解码 (原有方式)
+//   threaded 解码器多线程 (thread_count = 0，仅对支持的解码器有效)
+//   ahead    DecodeAhead 工作线程提前解码，消费者以 N 倍实时速度取帧，统计取帧的等待时间
+// 输出每个文件一行，最后按编解码器汇总；"load" 为实时播放时占用单个核心的百分比
+
+#include "DecodeAhead.hpp"
+#include <ctime>
+#include <map>
+
+namespace
+{
+struct OpenedFile
+{
+    AVFormatContext *formatCtx = nullptr;
+    AVCodecContext *codecCtx = nullptr;
+    int streamIndex = -1;
+
+    ~OpenedFile()
+    {
+        avcodec_free_context(&codecCtx);
+        avformat_close_input(&formatCtx);
+    }
+};
+
+struct RunResult
+{
+    bool valid = false;
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+    double cpuSeconds = 0.0;
+    LatencySnapshot stallUs; // inline / threaded: 每个数据包的解码耗时；ahead: 每次取帧的等待时间
+};
+
+bool openFile(const std::string &path, bool threaded, OpenedFile &file)
+{
+    if (avformat_open_input(&file.formatCtx, path.c_str(), nullptr, nullptr) != 0)
+        return false;
+    if (avformat_find_stream_info(file.formatCtx, nullptr) < 0)
+        return false;
+
+    file.streamIndex = av_find_best_stream(file.formatCtx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (file.streamIndex < 0)
+        return false;
+
+    const AVCodec *codec = avcodec_find_decoder(file.formatCtx->streams[file.streamIndex]->codecpar->codec_id);
+    if (!codec)
+        return false;
+
+    file.codecCtx = avcodec_alloc_context3(codec);
+    if (!file.codecCtx || avcodec_parameters_to_context(file.codecCtx, file.formatCtx->streams[file.streamIndex]->codecpar) < 0)
+        return false;
+
+    if (threaded)
+    {
+        if (!(codec->capabilities & (AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS | AV_CODEC_CAP_OTHER_THREADS)))
+            return false;
+        file.codecCtx->thread_count = 0;
+        file.codecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+    else
+    {
+        file.codecCtx->thread_count = 1;
+    }
+    return avcodec_open2(file.codecCtx, codec, nullptr) >= 0;
+}
+
+double frameSeconds(const AVFrame *frame)
+{
+    return frame->sample_rate > 0 ? static_cast<double>(frame->nb_samples) / frame->sample_rate : 0.0;
+}
+
+double cpuSecondsNow()
+{
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+// 在同一线程内读包并解码 (inline / threaded)
+RunResult runInline(const std::string &path, bool threaded)
+{
+    RunResult result;
+    OpenedFile file;
+    if (!openFile(path, threaded, file))
+        return result;
+
+    AVPacket *packet = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    LatencyHistogram histogram;
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    const double cpuStart = cpuSecondsNow();
+    bool draining = false;
+    while (!draining)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        int ret = av_read_frame(file.formatCtx, packet);
+        if (ret < 0)
+        {
+            draining = true;
+            avcodec_send_packet(file.codecCtx, nullptr);
+        }
+        else if (packet->stream_index != file.streamIndex)
+        {
+            av_packet_unref(packet);
+            continue;
+        }
+        else
+        {
+            avcodec_send_packet(file.codecCtx, packet);
+            av_packet_unref(packet);
+        }
+
+        while (avcodec_receive_frame(file.codecCtx, frame) >= 0)
+        {
+            result.audioSeconds += frameSeconds(frame);
+            av_frame_unref(frame);
+        }
+        histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+    }
+    result.cpuSeconds = cpuSecondsNow() - cpuStart;
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    result.stallUs = histogram.snapshot();
+    result.valid = true;
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    return result;
+}
+
+// 工作线程提前解码，消费者按 speed 倍实时速度取帧
+RunResult runAhead(const std::string &path, double aheadSeconds, double speed)
+{
+    RunResult result;
+    OpenedFile file;
+    if (!openFile(path, false, file))
+        return result;
+
+    AVFrame *frame = av_frame_alloc();
+    LatencyHistogram waits;
+    LatencyHistogram decodeLatency;
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    const double cpuStart = cpuSecondsNow();
+    {
+        DecodeAhead ahead(file.formatCtx, file.codecCtx, file.streamIndex, aheadSeconds, &decodeLatency);
+        auto due = std::chrono::steady_clock::now();
+        bool started = false;
+        for (;;)
+        {
+            std::this_thread::sleep_until(due);
+            const auto start = std::chrono::steady_clock::now();
+            int error = 0;
+            if (ahead.pop(frame, error) != DecodeAhead::Status::Frame)
+                break;
+            // 第一帧的等待是启动时间 (播放器中由环形缓冲区的预填充覆盖)，不计入
+            if (started)
+            {
+                waits.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+            }
+            started = true;
+
+            const double seconds = frameSeconds(frame);
+            result.audioSeconds += seconds;
+            due += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds / speed));
+            av_frame_unref(frame);
+        }
+    }
+    result.cpuSeconds = cpuSecondsNow() - cpuStart;
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    result.stallUs = waits.snapshot();
+    result.valid = true;
+
+    av_frame_free(&frame);
+    return result;
+}
+
+void printResult(const std::string &label, const RunResult &r)
+{
+    if (!r.valid)
+    {
+        std::cout << std::format("  {:<9} n/a\n", label);
+        return;
+    }
+    const double realtime = r.cpuSeconds > 0 ? r.audioSeconds / r.cpuSeconds : 0.0;
+    const double load = r.audioSeconds > 0 ? r.cpuSeconds / r.audioSeconds * 100.0 : 0.0;
+    std::cout << std::format("  {:<9} cpu {:8.3f} s  wall {:8.3f} s  {:8.1f}x realtime  load {:6.2f} %  stall p99 {:6} us  max {:7} us\n",
+                             label, r.cpuSeconds, r.wallSeconds, realtime, load, r.stallUs.percentileUs(0.99), r.stallUs.maxUs);
+}
+
+struct CodecSummary
+{
+    double audioSeconds = 0.0;
+    double inlineCpu = 0.0;
+    double threadedCpu = 0.0;
+    uint64_t inlineMaxStallUs = 0;
+    uint64_t aheadMaxStallUs = 0;
+    int files = 0;
+};
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    av_log_set_level(AV_LOG_QUIET);
+
+    double speed = 20.0;
+    double aheadSeconds = 3.0;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--speed="))
+            speed = std::max(1.0, std::stod(std::string(arg.substr(8))));
+        else if (arg.starts_with("--ahead="))
+            aheadSeconds = std::max(0.5, std::stod(std::string(arg.substr(8))));
+        else
+            files.emplace_back(arg);
+    }
+    if (files.empty())
+    {
+        std::cerr << "usage: decodeBench [--speed=N] [--ahead=SECONDS] <file>...\n";
+        return 1;
+    }
+
+    std::map<std::string, CodecSummary> summaries;
+    for (const std::string &path : files)
+    {
+        OpenedFile probe;
+        if (!openFile(path, false, probe))
+        {
+            std::cerr << "skip (cannot open): " << path << "\n";
+            continue;
+        }
+        const std::string codecName = avcodec_get_name(probe.codecCtx->codec_id);
+        std::cout << std::format("{} [{} {} Hz {} ch]\n", path, codecName, probe.codecCtx->sample_rate, probe.codecCtx->ch_layout.nb_channels);
+
+        RunResult inlineRun = runInline(path, false);
+        RunResult threadedRun = runInline(path, true);
+        RunResult aheadRun = runAhead(path, aheadSeconds, speed);
+        printResult("inline", inlineRun);
+        printResult("threaded", threadedRun);
+        printResult("ahead", aheadRun);
+
+        CodecSummary &summary = summaries[codecName];
+        summary.files++;
+        summary.audioSeconds += inlineRun.audioSeconds;
+        summary.inlineCpu += inlineRun.cpuSeconds;
+        summary.threadedCpu += threadedRun.valid ? threadedRun.cpuSeconds : inlineRun.cpuSeconds;
+        summary.inlineMaxStallUs = std::max(summary.inlineMaxStallUs, inlineRun.stallUs.maxUs);
+        summary.aheadMaxStallUs = std::max(summary.aheadMaxStallUs, aheadRun.stallUs.maxUs);
+    }
+
+    std::cout << "\nper codec (load = % of one core at 1x playback, stall = worst wait seen by the ring-buffer feeder)\n";
+    for (const auto &[codec, s] : summaries)
+    {
+        const double inlineLoad = s.audioSeconds > 0 ? s.inlineCpu / s.audioSeconds * 100.0 : 0.0;
+        const double threadedLoad = s.audioSeconds > 0 ? s.threadedCpu / s.audioSeconds * 100.0 : 0.0;
+        std::cout << std::format("  {:<12} files {:3}  load inline {:6.2f} %  threaded {:6.2f} %  max stall inline {:7} us  ahead {:7} us\n",
+                                 codec, s.files, inlineLoad, threadedLoad, s.inlineMaxStallUs, s.aheadMaxStallUs);
+    }
+    return 0;
+}
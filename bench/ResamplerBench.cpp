@@ -0,0 +1,205 @@
+// 重采样器基准：各质量档位在常见采样率转换下的 CPU 开销与信号指标
+// 用法: resamplerBench [--seconds=N]
+//   cpu      每秒音频消耗的 CPU 时间 (毫秒，单线程，立体声 FLTP -> FLT)
+//   thd+n    1 kHz 正弦 (-1 dBFS) 的总谐波失真加噪声，相对信号幅度
+//   passband 0.9 × min(输入, 输出) Nyquist 处正弦的增益 (通带滚降)
+//   reject   降采样：输出 Nyquist 之上、输入 Nyquist 之下的正弦在输出中的残留电平 (混叠抑制)
+//            升采样：0.45 × 输入采样率正弦的残差电平 (包含镜像)
+
+#include "Resampler.hpp"
+#include <ctime>
+
+namespace
+{
+constexpr int BLOCK_FRAMES = 1024;
+constexpr int CHANNELS = 2;
+constexpr double TONE_AMPLITUDE = 0.891; // -1 dBFS
+constexpr double PI = 3.14159265358979323846;
+
+struct RatePair
+{
+    int in;
+    int out;
+};
+
+constexpr RatePair RATE_PAIRS[] = {
+    {44100, 96000},
+    {48000, 96000},
+    {44100, 48000},
+    {96000, 44100},
+    {192000, 48000},
+    {96000, 96000},
+};
+
+constexpr ResamplerQuality QUALITIES[] = {ResamplerQuality::Fast, ResamplerQuality::Default, ResamplerQuality::High};
+
+struct Resampled
+{
+    std::vector<float> samples; // 第 0 通道
+    double cpuSeconds = 0.0;
+};
+
+// 把 seconds 秒的正弦 (两个通道相同) 分块送入重采样器，返回输出的第 0 通道
+Resampled resampleTone(const RatePair &rates, ResamplerQuality quality, double frequency, double seconds)
+{
+    Resampled result;
+    AVChannelLayout layout = AV_CHANNEL_LAYOUT_STEREO;
+    SwrContext *swr = Resampler::create(layout, rates.in, AV_SAMPLE_FMT_FLTP, layout, rates.out, AV_SAMPLE_FMT_FLT, quality);
+    if (!swr)
+        return result;
+
+    const int64_t totalFrames = static_cast<int64_t>(seconds * rates.in);
+    std::vector<float> plane(BLOCK_FRAMES);
+    std::vector<float> output;
+    const uint8_t *input[CHANNELS] = {reinterpret_cast<const uint8_t *>(plane.data()), reinterpret_cast<const uint8_t *>(plane.data())};
+    result.samples.reserve(static_cast<size_t>(seconds * rates.out) + BLOCK_FRAMES);
+
+    auto collect = [&](int frames)
+    {
+        for (int i = 0; i < frames; ++i)
+        {
+            result.samples.push_back(output[static_cast<size_t>(i) * CHANNELS]);
+        }
+    };
+
+    for (int64_t pos = 0; pos < totalFrames; pos += BLOCK_FRAMES)
+    {
+        const int frames = static_cast<int>(std::min<int64_t>(BLOCK_FRAMES, totalFrames - pos));
+        for (int i = 0; i < frames; ++i)
+        {
+            plane[i] = static_cast<float>(TONE_AMPLITUDE * std::sin(2.0 * PI * frequency * static_cast<double>(pos + i) / rates.in));
+        }
+
+        const int capacity = swr_get_out_samples(swr, frames);
+        output.resize(static_cast<size_t>(capacity) * CHANNELS);
+        uint8_t *out = reinterpret_cast<uint8_t *>(output.data());
+
+        // 只统计重采样本身的 CPU 时间
+        const std::clock_t start = std::clock();
+        const int converted = swr_convert(swr, &out, capacity, input, frames);
+        result.cpuSeconds += static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+        if (converted > 0)
+            collect(converted);
+    }
+
+    // 取出滤波器中剩余的样本
+    output.resize(static_cast<size_t>(BLOCK_FRAMES) * CHANNELS);
+    uint8_t *out = reinterpret_cast<uint8_t *>(output.data());
+    int converted = 0;
+    while ((converted = swr_convert(swr, &out, BLOCK_FRAMES, nullptr, 0)) > 0)
+    {
+        collect(converted);
+    }
+
+    swr_free(&swr);
+    return result;
+}
+
+struct ToneFit
+{
+    double amplitude = 0.0;   // 拟合出的正弦幅度
+    double residualRms = 0.0; // 去掉该正弦后的残差 RMS
+};
+
+// 已知频率的正弦拟合 (跳过首尾各 0.1 秒的滤波器瞬态)
+ToneFit fitTone(const std::vector<float> &samples, int rate, double frequency)
+{
+    ToneFit fit;
+    const size_t skip = static_cast<size_t>(rate / 10);
+    if (samples.size() <= skip * 2)
+        return fit;
+
+    const size_t begin = skip;
+    const size_t end = samples.size() - skip;
+    const double n = static_cast<double>(end - begin);
+    double sinSum = 0.0;
+    double cosSum = 0.0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        const double phase = 2.0 * PI * frequency * static_cast<double>(i) / rate;
+        sinSum += samples[i] * std::sin(phase);
+        cosSum += samples[i] * std::cos(phase);
+    }
+    const double a = 2.0 * sinSum / n;
+    const double b = 2.0 * cosSum / n;
+    fit.amplitude = std::sqrt(a * a + b * b);
+
+    double residual = 0.0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        const double phase = 2.0 * PI * frequency * static_cast<double>(i) / rate;
+        const double e = samples[i] - (a * std::sin(phase) + b * std::cos(phase));
+        residual += e * e;
+    }
+    fit.residualRms = std::sqrt(residual / n);
+    return fit;
+}
+
+double toDb(double ratio)
+{
+    return 20.0 * std::log10(std::max(ratio, 1e-12));
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    av_log_set_level(AV_LOG_QUIET);
+
+    double seconds = 10.0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--seconds="))
+            seconds = std::max(1.0, std::stod(std::string(arg.substr(10))));
+    }
+
+    const double toneRms = TONE_AMPLITUDE / std::sqrt(2.0);
+    std::cout << std::format("{:>15}  {:<26} {:>10} {:>10} {:>10} {:>10}\n", "rates", "engine", "cpu ms/s", "thd+n dB", "passband", "reject dB");
+    for (const RatePair &rates : RATE_PAIRS)
+    {
+        const bool passthrough = (rates.in == rates.out);
+        const double nyquist = std::min(rates.in, rates.out) / 2.0;
+        for (ResamplerQuality quality : QUALITIES)
+        {
+            // 1 kHz：CPU 开销与 THD+N
+            Resampled reference = resampleTone(rates, quality, 1000.0, seconds);
+            if (reference.samples.empty())
+            {
+                std::cout << std::format("{:>7}->{:<7}  {:<26} init failed\n", rates.in, rates.out, static_cast<int>(quality));
+                continue;
+            }
+            const ToneFit thd = fitTone(reference.samples, rates.out, 1000.0);
+            const double cpuMsPerSecond = reference.cpuSeconds * 1000.0 / seconds;
+
+            // 通带边缘增益
+            const double edge = 0.9 * nyquist;
+            const ToneFit passband = fitTone(resampleTone(rates, quality, edge, seconds).samples, rates.out, edge);
+
+            // 混叠 / 镜像
+            double rejectDb = 0.0;
+            if (rates.in > rates.out)
+            {
+                // 位于输出 Nyquist 与输入 Nyquist 之间，理想情况下应被完全滤除
+                const double alias = rates.out / 2.0 + (rates.in - rates.out) / 4.0;
+                std::vector<float> out = resampleTone(rates, quality, alias, seconds).samples;
+                double energy = 0.0;
+                for (float v : out)
+                    energy += static_cast<double>(v) * v;
+                rejectDb = toDb(std::sqrt(energy / std::max<size_t>(out.size(), 1)) / toneRms);
+            }
+            else
+            {
+                const double high = 0.45 * rates.in;
+                const ToneFit image = fitTone(resampleTone(rates, quality, high, seconds).samples, rates.out, high);
+                rejectDb = toDb(image.residualRms / toneRms);
+            }
+
+            std::cout << std::format("{:>7}->{:<7}  {:<26} {:>10.3f} {:>10.1f} {:>10.3f} {:>10.1f}\n",
+                                     rates.in, rates.out, Resampler::describe(quality, passthrough), cpuMsPerSecond,
+                                     toDb(thd.residualRms / toneRms), toDb(passband.amplitude / TONE_AMPLITUDE), rejectDb);
+            if (passthrough)
+                break; // 直通时各档位相同
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,569 @@
+// 吞吐基准：用 FFmpeg 自带的编码器生成多编解码器语料，测量解码路径各环节，结果输出为 JSON (便于跟踪回归)
+// 用法: throughputBench [--corpus=DIR] [--seconds=N] [--regenerate] [--output=FILE]
+//   corpus    各编码器 / 采样率 / 位深的测试文件，编码器未编译进 FFmpeg 时记为 unavailable
+//   decode    单线程解码每个文件的 CPU / 墙钟时间、倍速，以及单个数据包解码耗时的 p99 / 最大值
+//   resample  Mixing 模式离线渲染 (解码 + 重采样 + 输出格式转换)，对每个目标 AudioParams 统计 swr 耗时
+//   first     离线渲染中 setupDecodingSession 到第一个采样可输出的时间 (首次打开 / 会话缓存命中)
+//   seek      会话缓存命中时定位到若干位置后第一个采样可输出的时间
+// first / seek 使用 Direct 模式，不包含重采样
+
+#include "AudioPlayer.hpp"
+#include "SeekIndex.hpp"
+#include "SimpleThreadPool.hpp"
+#include <ctime>
+
+namespace
+{
+constexpr int CHANNELS = 2;
+constexpr int VARIABLE_FRAME_SIZE = 4096;
+constexpr double PI = 3.14159265358979323846;
+// 渲染到第一个采样后只需再输出很短一段即可停止
+constexpr double FIRST_SAMPLE_RENDER_SECONDS = 0.05;
+constexpr double SEEK_FRACTIONS[] = {0.1, 0.35, 0.6, 0.85};
+constexpr auto SEEK_INDEX_WAIT = std::chrono::seconds(10);
+
+struct CorpusSpec
+{
+    const char *name;
+    std::array<const char *, 2> encoders; // 按优先级尝试
+    const char *extension;                // 决定封装格式
+    int sampleRate;
+    int bits;        // 无损格式的位深，有损格式为 0
+    int64_t bitRate; // 有损格式的码率
+};
+
+constexpr CorpusSpec CORPUS[] = {
+    {"flac_44k_16", {"flac", nullptr}, "flac", 44100, 16, 0},
+    {"flac_48k_24", {"flac", nullptr}, "flac", 48000, 24, 0},
+    {"flac_96k_24", {"flac", nullptr}, "flac", 96000, 24, 0},
+    {"flac_192k_24", {"flac", nullptr}, "flac", 192000, 24, 0},
+    {"alac_44k_16", {"alac", nullptr}, "m4a", 44100, 16, 0},
+    {"alac_96k_24", {"alac", nullptr}, "m4a", 96000, 24, 0},
+    {"wavpack_44k_16", {"wavpack", nullptr}, "wv", 44100, 16, 0},
+    {"wavpack_96k_24", {"wavpack", nullptr}, "wv", 96000, 24, 0},
+    {"ape_44k_16", {"ape", nullptr}, "ape", 44100, 16, 0}, // FFmpeg 目前没有 APE 编码器
+    {"mp3_44k_320", {"libmp3lame", nullptr}, "mp3", 44100, 0, 320000},
+    {"aac_44k_256", {"aac", nullptr}, "m4a", 44100, 0, 256000},
+    {"aac_48k_128", {"aac", nullptr}, "m4a", 48000, 0, 128000},
+    {"opus_48k_160", {"libopus", "opus"}, "opus", 48000, 0, 160000},
+    {"vorbis_44k_192", {"libvorbis", "vorbis"}, "ogg", 44100, 0, 192000},
+};
+
+// 重采样目标 (Mixing 模式可选的采样率与输出格式)
+constexpr int TARGET_RATES[] = {44100, 48000, 96000, 192000};
+
+struct TargetFormat
+{
+    const char *name;
+    AVSampleFormat format;
+    bool packed24;
+};
+constexpr TargetFormat TARGET_FORMATS[] = {
+    {"s16", AV_SAMPLE_FMT_S16, false},
+    {"s24", AV_SAMPLE_FMT_S32, true},
+    {"s32", AV_SAMPLE_FMT_S32, false},
+    {"f32", AV_SAMPLE_FMT_FLT, false},
+};
+
+struct CorpusFile
+{
+    const CorpusSpec *spec = nullptr;
+    std::string path;
+    std::string status; // ok / unavailable / failed: ...
+    std::string encoder;
+    uint64_t bytes = 0;
+};
+
+std::string jsonString(std::string_view text)
+{
+    std::string out = "\"";
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                out += std::format("\\u{:04x}", static_cast<int>(c));
+            else
+                out += c;
+        }
+    }
+    return out + "\"";
+}
+
+// JSON 数组：逐个追加对象，输出时以逗号连接
+struct JsonArray
+{
+    std::vector<std::string> items;
+
+    std::string str() const
+    {
+        std::string out = "[";
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            out += (i ? ",\n    " : "\n    ") + items[i];
+        }
+        return out + (items.empty() ? "]" : "\n  ]");
+    }
+};
+
+double cpuSecondsNow()
+{
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+// 测试信号：缓慢扫频的正弦 + 两个固定音 + 低电平噪声 (避免无损编码器得到不真实的压缩率)
+double signalAt(int64_t n, int rate, int channel, uint32_t &noise)
+{
+    const double t = static_cast<double>(n) / rate;
+    const double sweep = 100.0 + 4000.0 * (0.5 + 0.5 * std::sin(2.0 * PI * 0.05 * t));
+    noise = noise * 1664525u + 1013904223u;
+    const double white = (static_cast<double>(noise >> 8) / 16777216.0 - 0.5) * 0.02;
+    return 0.35 * std::sin(2.0 * PI * sweep * t + channel) + 0.15 * std::sin(2.0 * PI * 440.0 * t) +
+           0.1 * std::sin(2.0 * PI * 9000.0 * t + 0.5 * channel) + white;
+}
+
+void fillFrame(AVFrame *frame, int64_t start, int rate, int bits, uint32_t &noise)
+{
+    const AVSampleFormat fmt = static_cast<AVSampleFormat>(frame->format);
+    const bool planar = av_sample_fmt_is_planar(fmt);
+    const AVSampleFormat packed = av_get_packed_sample_fmt(fmt);
+    for (int i = 0; i < frame->nb_samples; ++i)
+    {
+        for (int c = 0; c < CHANNELS; ++c)
+        {
+            const double v = std::clamp(signalAt(start + i, rate, c, noise), -1.0, 1.0);
+            const size_t index = planar ? static_cast<size_t>(i) : static_cast<size_t>(i) * CHANNELS + c;
+            uint8_t *plane = frame->extended_data[planar ? c : 0];
+            switch (packed)
+            {
+            case AV_SAMPLE_FMT_S16: reinterpret_cast<int16_t *>(plane)[index] = static_cast<int16_t>(std::lrint(v * 32767.0)); break;
+            case AV_SAMPLE_FMT_S32:
+                // 24 位内容放在 32 位容器的高位
+                reinterpret_cast<int32_t *>(plane)[index] = (bits == 24) ? static_cast<int32_t>(std::lrint(v * 8388607.0)) * 256
+                                                                         : static_cast<int32_t>(std::lrint(v * 2147483647.0));
+                break;
+            case AV_SAMPLE_FMT_FLT: reinterpret_cast<float *>(plane)[index] = static_cast<float>(v); break;
+            case AV_SAMPLE_FMT_DBL: reinterpret_cast<double *>(plane)[index] = v; break;
+            default: break;
+            }
+        }
+    }
+}
+
+// 打开编码器：依次尝试可接受的采样格式 (比查询编码器支持列表更不依赖 FFmpeg 版本)
+AVCodecContext *openEncoder(const AVCodec *codec, const CorpusSpec &spec, bool globalHeader)
+{
+    const std::vector<AVSampleFormat> formats =
+        (spec.bits == 24)   ? std::vector<AVSampleFormat>{AV_SAMPLE_FMT_S32, AV_SAMPLE_FMT_S32P}
+        : (spec.bits == 16) ? std::vector<AVSampleFormat>{AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S32, AV_SAMPLE_FMT_S32P}
+                            : std::vector<AVSampleFormat>{AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S32P};
+    for (AVSampleFormat fmt : formats)
+    {
+        AVCodecContext *ctx = avcodec_alloc_context3(codec);
+        if (!ctx)
+            return nullptr;
+        ctx->sample_fmt = fmt;
+        ctx->sample_rate = spec.sampleRate;
+        av_channel_layout_default(&ctx->ch_layout, CHANNELS);
+        ctx->time_base = AVRational{1, spec.sampleRate};
+        ctx->strict_std_compliance = FF_COMPLIANCE_EXPERIMENTAL;
+        if (spec.bits > 0)
+            ctx->bits_per_raw_sample = spec.bits;
+        if (spec.bitRate > 0)
+            ctx->bit_rate = spec.bitRate;
+        if (globalHeader)
+            ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        if (avcodec_open2(ctx, codec, nullptr) >= 0)
+            return ctx;
+        avcodec_free_context(&ctx);
+    }
+    return nullptr;
+}
+
+std::string encodeFile(const CorpusSpec &spec, const AVCodec *codec, const std::string &path, double seconds)
+{
+    AVFormatContext *fmt = nullptr;
+    if (avformat_alloc_output_context2(&fmt, nullptr, nullptr, path.c_str()) < 0 || !fmt)
+        return "failed: no muxer";
+
+    std::string status = "ok";
+    AVCodecContext *ctx = openEncoder(codec, spec, fmt->oformat->flags & AVFMT_GLOBALHEADER);
+    AVStream *stream = ctx ? avformat_new_stream(fmt, nullptr) : nullptr;
+    AVFrame *frame = av_frame_alloc();
+    AVPacket *packet = av_packet_alloc();
+    if (!ctx || !stream || !frame || !packet)
+    {
+        status = "failed: encoder rejected parameters";
+    }
+    else if (avcodec_parameters_from_context(stream->codecpar, ctx) < 0 || avio_open(&fmt->pb, path.c_str(), AVIO_FLAG_WRITE) < 0)
+    {
+        status = "failed: cannot open output";
+    }
+    else
+    {
+        stream->time_base = ctx->time_base;
+        if (avformat_write_header(fmt, nullptr) < 0)
+        {
+            status = "failed: cannot write header";
+        }
+        else
+        {
+            const bool variable = (codec->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE) || ctx->frame_size <= 0;
+            const int frameSize = variable ? VARIABLE_FRAME_SIZE : ctx->frame_size;
+            const int64_t total = static_cast<int64_t>(seconds * spec.sampleRate);
+            uint32_t noise = 1;
+
+            auto writePackets = [&]()
+            {
+                while (avcodec_receive_packet(ctx, packet) >= 0)
+                {
+                    av_packet_rescale_ts(packet, ctx->time_base, stream->time_base);
+                    packet->stream_index = stream->index;
+                    av_interleaved_write_frame(fmt, packet);
+                }
+            };
+
+            for (int64_t pos = 0; pos < total; pos += frameSize)
+            {
+                av_frame_unref(frame);
+                frame->nb_samples = static_cast<int>(std::min<int64_t>(frameSize, total - pos));
+                frame->format = ctx->sample_fmt;
+                frame->sample_rate = ctx->sample_rate;
+                av_channel_layout_copy(&frame->ch_layout, &ctx->ch_layout);
+                if (av_frame_get_buffer(frame, 0) < 0)
+                {
+                    status = "failed: out of memory";
+                    break;
+                }
+                fillFrame(frame, pos, spec.sampleRate, spec.bits, noise);
+                frame->pts = pos;
+                if (avcodec_send_frame(ctx, frame) < 0)
+                {
+                    status = "failed: encoding error";
+                    break;
+                }
+                writePackets();
+            }
+            avcodec_send_frame(ctx, nullptr);
+            writePackets();
+            av_write_trailer(fmt);
+        }
+        avio_closep(&fmt->pb);
+    }
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+    avformat_free_context(fmt);
+    return status;
+}
+
+std::vector<CorpusFile> prepareCorpus(const fs::path &dir, double seconds, bool regenerate)
+{
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    std::vector<CorpusFile> files;
+    for (const CorpusSpec &spec : CORPUS)
+    {
+        CorpusFile file;
+        file.spec = &spec;
+        file.path = (dir / std::format("{}_{}s.{}", spec.name, static_cast<int>(seconds), spec.extension)).string();
+
+        const AVCodec *codec = nullptr;
+        for (const char *name : spec.encoders)
+        {
+            if (name && (codec = avcodec_find_encoder_by_name(name)))
+            {
+                file.encoder = name;
+                break;
+            }
+        }
+
+        if (!regenerate && fs::exists(file.path, ec) && fs::file_size(file.path, ec) > 0)
+        {
+            file.status = "ok";
+        }
+        else if (!codec)
+        {
+            file.status = "unavailable";
+        }
+        else
+        {
+            std::cerr << "encoding " << file.path << "\n";
+            file.status = encodeFile(spec, codec, file.path, seconds);
+        }
+
+        if (file.status == "ok")
+            file.bytes = fs::file_size(file.path, ec);
+        files.push_back(std::move(file));
+    }
+    return files;
+}
+
+struct DecodeRun
+{
+    bool valid = false;
+    std::string codec;
+    double audioSeconds = 0.0;
+    double cpuSeconds = 0.0;
+    double wallSeconds = 0.0;
+    LatencySnapshot packetUs;
+};
+
+// 单线程解码整个文件 (与播放器 inline 解码相同的读包 / 解码方式)
+DecodeRun decodeFile(const std::string &path)
+{
+    DecodeRun run;
+    AVFormatContext *fmt = nullptr;
+    if (avformat_open_input(&fmt, path.c_str(), nullptr, nullptr) != 0)
+        return run;
+
+    AVCodecContext *ctx = nullptr;
+    const int streamIndex = (avformat_find_stream_info(fmt, nullptr) >= 0) ? av_find_best_stream(fmt, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0) : -1;
+    const AVCodec *codec = (streamIndex >= 0) ? avcodec_find_decoder(fmt->streams[streamIndex]->codecpar->codec_id) : nullptr;
+    if (codec && (ctx = avcodec_alloc_context3(codec)) && avcodec_parameters_to_context(ctx, fmt->streams[streamIndex]->codecpar) >= 0)
+    {
+        ctx->thread_count = 1;
+        if (avcodec_open2(ctx, codec, nullptr) >= 0)
+        {
+            AVPacket *packet = av_packet_alloc();
+            AVFrame *frame = av_frame_alloc();
+            LatencyHistogram histogram;
+            const auto wallStart = std::chrono::steady_clock::now();
+            const double cpuStart = cpuSecondsNow();
+            bool draining = false;
+            while (!draining)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                if (av_read_frame(fmt, packet) < 0)
+                {
+                    draining = true;
+                    avcodec_send_packet(ctx, nullptr);
+                }
+                else if (packet->stream_index != streamIndex)
+                {
+                    av_packet_unref(packet);
+                    continue;
+                }
+                else
+                {
+                    avcodec_send_packet(ctx, packet);
+                    av_packet_unref(packet);
+                }
+                while (avcodec_receive_frame(ctx, frame) >= 0)
+                {
+                    if (frame->sample_rate > 0)
+                        run.audioSeconds += static_cast<double>(frame->nb_samples) / frame->sample_rate;
+                    av_frame_unref(frame);
+                }
+                histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+            }
+            run.cpuSeconds = cpuSecondsNow() - cpuStart;
+            run.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+            run.packetUs = histogram.snapshot();
+            run.codec = avcodec_get_name(ctx->codec_id);
+            run.valid = true;
+            av_packet_free(&packet);
+            av_frame_free(&frame);
+        }
+    }
+    avcodec_free_context(&ctx);
+    avformat_close_input(&fmt);
+    return run;
+}
+
+RenderResult renderFirstSample(AudioPlayer &player, const std::string &path, int64_t startUs)
+{
+    RenderOptions options;
+    options.sink = RenderSink::Discard;
+    options.startPositionUs = startUs;
+    options.maxSeconds = FIRST_SAMPLE_RENDER_SECONDS;
+    return player.renderOffline({path}, options);
+}
+
+// 等待后台 seek 索引建立完成 (定位延迟应当测量正常播放时的路径)
+bool waitForSeekIndex(const std::string &path)
+{
+    const auto deadline = std::chrono::steady_clock::now() + SEEK_INDEX_WAIT;
+    SeekPoint point;
+    while (!SeekIndexCache::instance().lookup(path, 0, point))
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return true;
+}
+
+std::string timestampUtc()
+{
+    const std::time_t now = std::time(nullptr);
+    char buffer[32] = {0};
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    av_log_set_level(AV_LOG_QUIET);
+    // seek 索引 / 响度数据库的缓存目录与主程序分开
+    QCoreApplication::setOrganizationName("MusicPlayer3");
+    QCoreApplication::setApplicationName("MusicPlayerBench");
+
+    fs::path corpusDir = fs::temp_directory_path() / "musicplayer-bench-corpus";
+    double seconds = 20.0;
+    bool regenerate = false;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--corpus="))
+            corpusDir = fs::path(std::string(arg.substr(9)));
+        else if (arg.starts_with("--seconds="))
+            seconds = std::clamp(std::stod(std::string(arg.substr(10))), 2.0, 600.0);
+        else if (arg == "--regenerate")
+            regenerate = true;
+        else if (arg.starts_with("--output="))
+            outputPath = arg.substr(9);
+        else
+        {
+            std::cerr << "usage: throughputBench [--corpus=DIR] [--seconds=N] [--regenerate] [--output=FILE]\n";
+            return 1;
+        }
+    }
+
+    const std::vector<CorpusFile> corpus = prepareCorpus(corpusDir, seconds, regenerate);
+
+    JsonArray corpusJson;
+    JsonArray decodeJson;
+    std::unordered_map<std::string, std::string> codecOf;
+    for (const CorpusFile &file : corpus)
+    {
+        corpusJson.items.push_back(std::format(R"({{"name": {}, "encoder": {}, "path": {}, "sample_rate": {}, "bits": {}, "bit_rate": {}, "bytes": {}, "status": {}}})",
+                                               jsonString(file.spec->name), jsonString(file.encoder), jsonString(file.path), file.spec->sampleRate,
+                                               file.spec->bits, file.spec->bitRate, file.bytes, jsonString(file.status)));
+        if (file.status != "ok")
+            continue;
+
+        std::cerr << "decode " << file.spec->name << "\n";
+        const DecodeRun run = decodeFile(file.path);
+        if (!run.valid)
+            continue;
+        codecOf[file.path] = run.codec;
+        decodeJson.items.push_back(std::format(R"({{"name": {}, "codec": {}, "audio_seconds": {:.3f}, "cpu_seconds": {:.4f}, "wall_seconds": {:.4f}, "realtime_factor": {:.1f}, "packet_us_mean": {:.1f}, "packet_us_p99": {}, "packet_us_max": {}}})",
+                                               jsonString(file.spec->name), jsonString(run.codec), run.audioSeconds, run.cpuSeconds, run.wallSeconds,
+                                               run.cpuSeconds > 0 ? run.audioSeconds / run.cpuSeconds : 0.0,
+                                               run.packetUs.meanUs(), run.packetUs.percentileUs(0.99), run.packetUs.maxUs));
+    }
+
+    JsonArray resampleJson;
+    JsonArray firstJson;
+    JsonArray seekJson;
+    {
+        AudioPlayer player;
+
+        // 每种源采样率取一个无损文件，渲染到每个目标 AudioParams
+        std::set<int> sourceRates;
+        for (const CorpusFile &file : corpus)
+        {
+            if (file.status != "ok" || file.spec->bits == 0 || !sourceRates.insert(file.spec->sampleRate).second)
+                continue;
+
+            for (int rate : TARGET_RATES)
+            {
+                for (const TargetFormat &target : TARGET_FORMATS)
+                {
+                    AudioParams params;
+                    params.sampleRate = rate;
+                    params.sampleFormat = target.format;
+                    params.packed24 = target.packed24;
+                    params.ch_layout = AV_CHANNEL_LAYOUT_STEREO;
+                    params.channels = CHANNELS;
+                    player.setMixingParameters(params);
+
+                    std::cerr << std::format("resample {} -> {} Hz {}\n", file.spec->name, rate, target.name);
+                    const uint64_t swrBefore = player.getStats().swrUs.totalUs;
+                    RenderOptions options;
+                    options.sink = RenderSink::Discard;
+                    const RenderResult result = player.renderOffline({file.path}, options);
+                    const double swrSeconds = static_cast<double>(player.getStats().swrUs.totalUs - swrBefore) / 1000000.0;
+                    if (!result.ok)
+                        continue;
+                    resampleJson.items.push_back(std::format(R"({{"source": {}, "source_rate": {}, "target_rate": {}, "target_format": {}, "quality": {}, "audio_seconds": {:.3f}, "wall_seconds": {:.4f}, "realtime_factor": {:.1f}, "swr_seconds": {:.4f}, "swr_ms_per_audio_second": {:.3f}}})",
+                                                             jsonString(file.spec->name), file.spec->sampleRate, rate, jsonString(target.name),
+                                                             jsonString(Resampler::describe(player.getResamplerQuality(OUTPUT_MIXING), rate == file.spec->sampleRate)),
+                                                             result.audioSeconds, result.wallSeconds, result.realtimeFactor(), swrSeconds,
+                                                             result.audioSeconds > 0 ? swrSeconds * 1000.0 / result.audioSeconds : 0.0));
+                }
+            }
+        }
+
+        // 首个采样与定位：Direct 模式 (不含重采样)
+        player.setOutputMode(OUTPUT_DIRECT);
+        for (const CorpusFile &file : corpus)
+        {
+            if (file.status != "ok")
+                continue;
+
+            std::cerr << "first sample / seek " << file.spec->name << "\n";
+            // 第一次渲染打开新会话 (探测 + 打开解码器)，之后的渲染命中会话缓存
+            const RenderResult cold = renderFirstSample(player, file.path, 0);
+            const RenderResult cached = renderFirstSample(player, file.path, 0);
+            if (!cold.ok || !cached.ok)
+                continue;
+            firstJson.items.push_back(std::format(R"({{"name": {}, "codec": {}, "cold_ms": {:.3f}, "cached_ms": {:.3f}}})",
+                                                  jsonString(file.spec->name), jsonString(codecOf[file.path]),
+                                                  cold.firstSampleSeconds * 1000.0, cached.firstSampleSeconds * 1000.0));
+
+            const bool indexed = waitForSeekIndex(file.path);
+            std::string targets;
+            double totalMs = 0.0;
+            double maxMs = 0.0;
+            int count = 0;
+            for (double fraction : SEEK_FRACTIONS)
+            {
+                const int64_t targetUs = static_cast<int64_t>(fraction * seconds * 1000000.0);
+                const RenderResult seek = renderFirstSample(player, file.path, targetUs);
+                if (!seek.ok)
+                    continue;
+                const double ms = seek.firstSampleSeconds * 1000.0;
+                targets += std::format("{}{{\"target_s\": {:.2f}, \"latency_ms\": {:.3f}}}", count ? ", " : "", targetUs / 1000000.0, ms);
+                totalMs += ms;
+                maxMs = std::max(maxMs, ms);
+                count++;
+            }
+            seekJson.items.push_back(std::format(R"({{"name": {}, "codec": {}, "seek_index": {}, "mean_ms": {:.3f}, "max_ms": {:.3f}, "targets": [{}]}})",
+                                                 jsonString(file.spec->name), jsonString(codecOf[file.path]), indexed,
+                                                 count ? totalMs / count : 0.0, maxMs, targets));
+        }
+    }
+    SeekIndexCache::instance().cancelPending();
+    SimpleThreadPool::instance().shutdown();
+
+    const std::string json = std::format("{{\n  \"version\": 1,\n  \"timestamp\": {},\n  \"ffmpeg\": {},\n  \"hardware_threads\": {},\n  \"corpus_seconds\": {:.1f},\n"
+                                         "  \"corpus\": {},\n  \"decode\": {},\n  \"resample\": {},\n  \"first_sample\": {},\n  \"seek\": {}\n}}\n",
+                                         jsonString(timestampUtc()), jsonString(av_version_info()), std::thread::hardware_concurrency(), seconds,
+                                         corpusJson.str(), decodeJson.str(), resampleJson.str(), firstJson.str(), seekJson.str());
+    if (outputPath.empty())
+    {
+        std::cout << json;
+    }
+    else
+    {
+        std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+        out << json;
+        if (!out)
+        {
+            std::cerr << "cannot write " << outputPath << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
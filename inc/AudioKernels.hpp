@@ -0,0 +1,106 @@
+#ifndef AUDIOKERNELS_HPP
+#define AUDIOKERNELS_HPP
+
+#include "PCH.h"
+
+// 音频 SIMD 计算内核 (AVX2 + 标量尾部处理)
+// 所有函数都在调用方提供的内存上原地工作，不做任何分配
+namespace AudioKernels
+{
+// 交错 PCM 格式 (设备侧)，比 AVSampleFormat 多出 24 位打包格式
+enum class PcmFormat : std::uint8_t
+{
+    Unknown,
+    U8,
+    S16,
+    S24, // 3 字节打包，小端
+    S32,
+    F32,
+    F64,
+};
+
+PcmFormat toPcmFormat(AVSampleFormat format, bool packed24 = false);
+size_t bytesPerSample(PcmFormat format);
+
+// 抖动方式 (只对 U8 / S16 / S24 输出生效，S32 与浮点输出不需要抖动)
+enum class DitherMode : std::uint8_t
+{
+    None,       // 直接四舍五入
+    Tpdf,       // 三角概率分布抖动 (±1 LSB)
+    TpdfShaped, // TPDF + 一阶误差反馈噪声整形 (把量化噪声推向高频)
+};
+
+constexpr int MAX_DITHER_CHANNELS = 8;
+
+// 抖动状态：跨调用保持 (随机数序列与噪声整形误差)，由解码线程独占
+struct DitherState
+{
+    DitherMode mode = DitherMode::Tpdf;
+    alignas(32) uint32_t rng[8] = {0x9E3779B9u, 0x7F4A7C15u, 0x85EBCA6Bu, 0xC2B2AE35u,
+                                   0x27D4EB2Fu, 0x165667B1u, 0xD3A2646Cu, 0xFD7046C5u};
+    float shapingError[MAX_DITHER_CHANNELS] = {};
+};
+
+/**
+ * @brief 最终输出级：交错 float32 -> 设备格式
+ * 浮点输入以 ±1.0 为满幅，超出部分饱和截断
+ * 无噪声整形时走 AVX2 路径；噪声整形的误差反馈按通道串行，走标量路径
+ */
+void convertFromFloat(uint8_t *dst, const float *src, size_t frames, int channels, PcmFormat format, DitherState &dither);
+
+/**
+ * @brief 等功率交叉淡化 (原地混音)
+ * dst = dst * cos(t·π/2) + src * sin(t·π/2)，t 从 t0 开始每帧递增 dt 并截断到 [0, 1]
+ * 同一帧内的各通道使用相同增益
+ * @param dst      交错 PCM (淡出的一方)，结果写回此处
+ * @param src      交错 PCM (淡入的一方)，为 nullptr 时只对 dst 做等功率淡出
+ * @param frames   帧数
+ * @param channels 通道数
+ * @param format   dst / src 的格式 (Unknown 不做处理)
+ */
+void equalPowerCrossfade(uint8_t *dst, const uint8_t *src, size_t frames, int channels, PcmFormat format, float t0, float dt);
+
+/**
+ * @brief 平面 -> 交错 (逐位复制，不改变任何样本值)
+ * 立体声 16 / 32 位走 AVX2 路径，其余组合逐样本复制
+ * @param dst         交错输出 (frames * channels * sampleBytes 字节)
+ * @param planes      每个通道一个平面
+ * @param offset      从各平面的第 offset 帧开始读取
+ * @param sampleBytes 单个样本的字节数 (1 / 2 / 4 / 8)
+ */
+void interleave(uint8_t *dst, const uint8_t *const *planes, size_t offset, size_t frames, int channels, size_t sampleBytes);
+
+// 原地乘以固定增益 (float32，交错 / 平面均可)
+void applyGain(float *data, size_t samples, float gain);
+
+// 平方和与参与计算的样本数
+struct SquareSum
+{
+    float sumSquares = 0.0f;
+    int actualCount = 0;
+};
+
+/**
+ * @brief 平方和 (波形、响度分析与电平表共用)
+ * 连续数据 (step == 1) 走 AVX2 路径，其余逐样本计算
+ * @param count      范围内的样本数 (按 data 的下标计)
+ * @param step       相邻两个参与计算的样本的间距 (交错数据只取第一个通道时为通道数)
+ * @param decimation 抽取倍数 (高采样率的波形只取部分样本)，为 1 时计算全部样本
+ */
+SquareSum sumOfSquares(const float *data, int count, int step = 1, int decimation = 1);
+
+// 峰值绝对值 (样本峰值，不做过采样)
+float peakAbsolute(const float *data, size_t samples);
+
+/**
+ * @brief 多相 FIR 过采样后的峰值绝对值 (真峰值)
+ * @param data          单通道样本，data[-(tapsPerPhase - 1)] 起的历史样本必须可读
+ * @param samples       本次计算的样本数
+ * @param taps          相位优先排列的系数：taps[phase * tapsPerPhase + k] 与 data[n - k] 相乘
+ * @param phases        过采样倍数
+ * @param tapsPerPhase  每个相位的系数个数
+ */
+float interpolatedPeak(const float *data, size_t samples, const float *taps, int phases, int tapsPerPhase);
+} // namespace AudioKernels
+
+#endif // AUDIOKERNELS_HPP
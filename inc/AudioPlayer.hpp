@@ -1,7 +1,22 @@
 #ifndef AUDIOPLAYER_HPP
 #define AUDIOPLAYER_HPP
 
+#include "AudioKernels.hpp"
+#include "LoudnessAnalyzer.hpp"
+#include "AudioRingBuffer.hpp"
+#include "DecodeAhead.hpp"
+#include "DspChain.hpp"
+#include "Convolver.hpp"
+#include "Equalizer.hpp"
+#include "LockFreeQueue.hpp"
 #include "PCH.h"
+#include "PlaybackClock.hpp"
+#include "PlaybackEvent.hpp"
+#include "PlaybackStats.hpp"
+#include "RenderWriter.hpp"
+#include "Resampler.hpp"
+#include "SpectrumAnalyzer.hpp"
+#include "TempoFilter.hpp"
 
 enum outputMod : std::uint8_t
 {
@@ -17,20 +32,60 @@ enum class PlayerState : std::uint8_t
     SEEKING,
 };
 
+// 缓冲策略：在延迟与 CPU 唤醒次数之间取舍
+enum class LatencyProfile : std::uint8_t
+{
+    Balanced,   // 400 ms 缓冲，系统默认设备周期
+    LowLatency, // 小缓冲 + 小设备周期：定位、音量等操作响应更快
+    LowPower,   // 一次连续解码数秒后休眠到低水位，大设备周期，减少每秒唤醒次数
+};
+
+// 提前解码 (工作线程解码、按 PCM 时长缓存) 的适用范围
+enum class DecodeAheadMode : std::uint8_t
+{
+    Off,
+    HeavyCodecs, // 仅 APE / TAK / DSD / 高于 96 kHz 的无损格式等解码开销大的格式
+                 // 适用的会话成为当前会话时同时开启解码器多线程 (缓存 / 预加载中的会话始终单线程)
+    Always,
+};
+
 // 重采样器参数
 struct AudioParams
 {
     int sampleRate = 96000;
     AVSampleFormat sampleFormat = AV_SAMPLE_FMT_S32;
+    bool packed24 = false; // sampleFormat 为 S32 时改用 24 位打包输出 (仅设备侧)
     AVChannelLayout ch_layout = AV_CHANNEL_LAYOUT_STEREO;
     int channels = 2;
+    ResamplerQuality resampler = ResamplerQuality::Default; // 仅重采样器使用
 };
 
-// 音频帧结构体 - 简化内存管理
-struct AudioFrame
+// 离线渲染的参数
+struct RenderOptions
 {
-    std::vector<uint8_t> data; // 使用 vector 自动管理内存
-    int64_t pts = 0;           // 微秒单位
+    RenderSink sink = RenderSink::Discard;
+    std::string outputPath;      // Wav / Raw 时使用
+    int64_t startPositionUs = 0; // 第一首的起始位置
+    double maxSeconds = 0.0;     // 输出达到该时长后停止，0 表示渲染整个播放列表
+};
+
+// 离线渲染的结果
+struct RenderResult
+{
+    bool ok = false;
+    std::string error;
+    AudioParams format;                     // 输出格式 (即渲染时的设备格式)
+    uint64_t frames = 0;                    // 输出的采样帧数
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+    double firstSampleSeconds = 0.0;        // 从开始渲染到第一个采样可供输出 (与播放时相同，包含打开会话与解码首帧)
+    size_t tracks = 0;                      // 已开始输出的曲目数
+    std::vector<uint64_t> trackStartFrames; // 每首曲目第一个采样帧在输出中的位置 (用于检查无缝衔接)
+
+    double realtimeFactor() const
+    {
+        return wallSeconds > 0 ? audioSeconds / wallSeconds : 0.0;
+    }
 };
 
 class AudioPlayer
@@ -57,12 +112,69 @@ public:
                                                int64_t endTimeUS);
 
     // 控制接口
-    bool setPath(const std::string &path);
-    void setPreloadPath(const std::string &path);
+    // startMicroseconds: 文件内的起始位置 (CUE 分轨偏移)，解码线程打开后直接定位
+    bool setPath(const std::string &path, int64_t startMicroseconds = 0);
+    // 预加载下一首 (提前打开解码会话以便无缝衔接)，path 为空时取消已登记的预加载
+    void setPreloadPath(const std::string &path, int64_t startMicroseconds = 0);
+    // 登记某个文件内的分轨边界 (微秒)，播放越过边界的那个采样点时产生 TrackBoundary 事件
+    void setTrackBoundaries(const std::string &path, std::vector<int64_t> boundariesUs);
     void play();
     void pause();
     void seek(int64_t timeMicroseconds);
     void setVolume(double vol);
+    // 交叉淡化时长 (毫秒，仅 Mixing 模式生效)，0 表示关闭 (曲目间无缝衔接)
+    void setCrossfadeDuration(int milliseconds);
+    int getCrossfadeDuration() const;
+    // Mixing 模式最终输出级的抖动方式 (输出为 S16 / S24 时生效)
+    void setDitherMode(AudioKernels::DitherMode mode);
+    AudioKernels::DitherMode getDitherMode() const;
+    // 响度归一化 (Mixing 模式的增益级，使用后台分析得到的 EBU R128 结果)
+    void setNormalizationMode(NormalizationMode mode);
+    NormalizationMode getNormalizationMode() const;
+    // 10 段均衡器 (DSP 处理链中的内置处理级，关闭时旁路)，设置在下一块生效
+    void setEqualizerEnabled(bool enabled);
+    bool getEqualizerEnabled() const;
+    void setEqualizerSettings(const EqSettings &settings);
+    EqSettings getEqualizerSettings() const;
+    // FIR 卷积 (房间 / 耳机校正)：加载脉冲响应文件并替换当前的卷积级 (按输出采样率重采样)，path 为空时移除
+    // 在调用线程解码与重采样，失败时保留原来的卷积级
+    bool setConvolverImpulse(const std::string &path);
+    std::string getConvolverImpulse() const;
+    // 播放速度 (0.5 ~ 2.0，变速不变调)，解码线程在下一帧生效；进度、分轨边界与定位始终按媒体时间计算
+    void setPlaybackSpeed(double speed);
+    double getPlaybackSpeed() const;
+    // 输出端的频谱 / 电平表 (采集送往设备的数据，Direct 与 Mixing 模式都有效)，关闭时不做任何计算
+    // readSpectrum 由显示线程每次刷新调用一次，同时请求计算下一帧
+    void setSpectrumEnabled(bool enabled);
+    bool getSpectrumEnabled() const;
+    void readSpectrum(SpectrumFrame &frame);
+    // 实时模式：提升解码线程的调度优先级 (可选绑定到 cpuCore)，并把 PCM 缓冲区锁定在物理内存中
+    // 由解码线程异步应用，系统是否批准见 getRealtimeStatus；设备回调线程的优先级在下次打开设备时生效
+    void setRealtimeMode(bool enabled, int cpuCore = -1);
+    RealtimeStatus getRealtimeStatus() const;
+    // 缓冲策略与设备周期 (毫秒，0 表示使用策略的默认值)
+    // 设备已打开时会重建设备，并从当前播放位置继续
+    void setLatencyProfile(LatencyProfile profile);
+    LatencyProfile getLatencyProfile() const;
+    void setDevicePeriod(int milliseconds);
+    int getDevicePeriod() const;
+    // 重采样器质量 (按输出模式分别设置)，修改当前模式时立即重建当前曲目的重采样器
+    void setResamplerQuality(outputMod mode, ResamplerQuality quality);
+    ResamplerQuality getResamplerQuality(outputMod mode) const;
+    // 提前解码 (缓存上限为 seconds 秒 PCM) 与解码器多线程，从下一次打开会话或定位起生效
+    void setDecodeAhead(DecodeAheadMode mode, double seconds);
+    DecodeAheadMode getDecodeAheadMode() const;
+    // 在后台预先打开这些文件的解码会话 (最近播放 / 即将播放)，切歌时无需再次探测
+    void prefetchSessions(const std::vector<std::string> &paths);
+    // Direct 模式逐位校验：对照解码得到的 PCM 与实际写入输出缓冲区的字节 (CRC32)，结果见 getStats
+    void setBitPerfectVerification(bool enabled);
+    bool getBitPerfectVerification() const;
+    // 离线渲染：不打开声卡，在调用线程上全速按顺序解码整个播放列表，无缝切换 / 交叉淡化与播放时一致
+    // 使用当前的输出模式与参数，输出不含音量 (音量由设备施加)；Direct 模式下各曲目的原生格式必须相同
+    // 播放器必须空闲 (没有正在播放的曲目)，渲染期间解码线程不响应播放请求
+    RenderResult renderOffline(const std::vector<std::string> &playlist, const RenderOptions &options);
+    // 播放引擎统计快照 (断流、回调耗时、缓冲水位、解码 / 重采样耗时)，任意线程可调用
+    PlaybackStats getStats() const;
 
     // 参数设置
     void setMixingParameters(const AudioParams &params);
@@ -74,14 +186,25 @@ public:
         return outputMode;
     }
 
+    // 播放事件 (单消费者)：超时或被 interruptEventWait 唤醒时返回 false
+    bool waitForEvent(PlaybackEvent &event, std::chrono::milliseconds timeout);
+    void interruptEventWait();
+    // 重建音频设备 (设备丢失后恢复)，保持当前播放状态
+    bool reopenDevice();
+
     // 状态查询
     bool isPlaying() const;
     const std::string getCurrentPath() const;
     int64_t getNowPlayingTime() const;              // 微秒
-    int64_t getCurrentPositionMicroseconds() const; // 微秒
+    int64_t getCurrentPositionMicroseconds() const; // 微秒，扬声器正在输出的位置 (延迟补偿 + 插值)
     int64_t getAudioDuration() const;               // 秒
     int64_t getDurationMillisecond() const;         // 毫秒
     int64_t getDurationMicroseconds() const;        // 微秒
+    // 播放时钟的最新锚点 (任意线程无锁读取)，调用方可用 positionAt 在每帧刷新时自行插值
+    ClockAnchor getPlaybackClock() const;
+    // Mixing 模式的 DSP 处理链 (处理级的添加 / 移除 / 旁路可在任意控制线程进行)
+    DspChain &getDspChain();
+    int64_t getOutputLatencyMicroseconds() const; // 估计的设备输出延迟
 
 private:
     // --- 内部类 ---
@@ -92,6 +215,17 @@ private:
         SwrContext *swrCtx = nullptr;
         int audioStreamIndex = -1;
         std::string path;
+        bool consumed = false; // 是否已被取出解码过 (再次使用前需要回到开头)
+        int64_t trimUntilUs = -1;   // 解码后丢弃此时间之前的样本 (-1 表示不裁剪)
+        int64_t startPositionUs = 0; // 最近一次定位的起点 (微秒)
+        std::vector<const uint8_t *> trimmedPlanes; // 裁剪帧头部时的平面指针 (复用，避免分配)
+        int64_t landingUs = 0;             // 最近一次定位后解码实际开始的时间 (已知时，否则等于目标时间)
+        bool timestampsUnreliable = false; // 按字节定位后解复用器给出的时间戳不可信，改用游标推算
+        LoudnessInfo loudness;             // 会话开始时查询的响度分析结果
+        std::unique_ptr<DecodeAhead> decodeAhead; // 运行期间独占 pFormatCtx / pCodecCtx
+        TempoFilter tempo;                        // 变速滤镜图 (第一次需要时建立，定位 / 回到开头 / 释放时关闭)
+        bool codecThreaded = false;               // 解码器是否以多线程打开
+        bool decoderFed = false;                  // 打开 / 定位 / 回到开头之后是否已送入过数据包
 
         AudioStreamSource() = default;
         ~AudioStreamSource()
@@ -101,7 +235,13 @@ private:
 
         void free();
         bool initDecoder(const std::string &inputPath, char *errorBuffer);
+        bool rewind();
+        bool seekTo(int64_t targetUs);
+        // 按新的线程设置重新打开解码器；已送入数据包时不改变 (重新打开会丢失解码器内部状态)
+        void setCodecThreading(bool threaded);
         bool openSwrContext(const AudioParams &deviceParams, double volume, char *errorBuffer);
+        void startDecodeAhead(double seconds, LatencyHistogram *decodeLatency);
+        void stopDecodeAhead();
     };
 
     // --- 成员变量 ---
@@ -111,6 +251,11 @@ private:
     std::condition_variable pathCondVar;
     std::string currentPath = "";
     std::string preloadPath = "";
+    int64_t currentStartPosition = 0;
+    int64_t preloadStartPosition = 0;
+    // 文件路径 -> 分轨边界 (受 pathMutex 保护)
+    std::unordered_map<std::string, std::vector<int64_t>> m_trackBoundaries;
+    std::atomic<bool> m_boundariesChanged{false};
 
     std::thread decodeThread;
     std::atomic<bool> quitFlag{false};
@@ -131,25 +276,135 @@ private:
     std::unique_ptr<AudioStreamSource> m_currentSource;
     std::unique_ptr<AudioStreamSource> m_preloadSource;
 
+    // 解码会话缓存 (LRU，队首为最近使用)，按路径缓存已打开的 AudioStreamSource
+    std::mutex m_sessionCacheMutex;
+    std::deque<std::unique_ptr<AudioStreamSource>> m_sessionCache;
+
+    // 后台预打开任务
+    std::mutex m_prefetchMutex;
+    std::vector<std::string> m_prefetchPaths;
+    bool m_prefetchRunning = false;
+    std::future<void> m_prefetchTask;
+
     // 资源保护锁 (新增：防止参数重置时解码线程运行)
     std::mutex decodeMutex;
 
-    // 音频队列 (生产者-消费者)
-    std::mutex audioFrameQueueMutex; // 保护 queue 和 currentFrame
-    std::atomic<size_t> audioFrameQueueMaxSize{128};
-    std::queue<std::shared_ptr<AudioFrame>> audioFrameQueue;
-
-    // 当前正在回调中播放的帧
-    std::shared_ptr<AudioFrame> m_currentFrame;
-    size_t m_currentFramePos = 0;
+    // PCM 环形缓冲区 (解码线程写入，回调线程读取)
+    AudioRingBuffer m_ringBuffer;
+    // 缓冲目标水位 / 低水位 (字节)，按时长换算，设备打开时按缓冲策略重新计算
+    // 低于低水位时开始补充，一直解码到目标水位后再休眠
+    std::atomic<size_t> m_bufferTargetBytes{0};
+    std::atomic<size_t> m_lowWaterBytes{0};
+    bool m_refilling = false; // 仅解码线程访问
+    std::atomic<LatencyProfile> m_latencyProfile{LatencyProfile::Balanced};
+    std::atomic<int> m_devicePeriodMs{0};
+
+    // 提前解码设置 (从提前解码取帧时复用 m_aheadFrame，仅解码线程访问)
+    std::atomic<DecodeAheadMode> m_decodeAheadMode{DecodeAheadMode::Off};
+    std::atomic<double> m_decodeAheadSeconds{3.0};
+    AVFrame *m_aheadFrame = nullptr;
+    // 输出端每秒字节数 (采样率 * 通道数 * 采样字节数)
+    std::atomic<int64_t> m_outputBytesPerSecond{0};
+
+    // 时间戳标记：记录环形缓冲区某个位置对应的播放时间
+    struct TimeMarker
+    {
+        uint64_t position = 0; // 环形缓冲区单调字节位置
+        int64_t ptsUs = 0;     // 该位置对应的时间 (微秒)
+        double speed = 1.0;    // 之后每个输出采样对应的媒体时长倍数 (变速播放)
+    };
+    SpscQueue<TimeMarker, 1024> m_timeMarkers;
+    TimeMarker m_activeMarker; // 仅回调线程访问
+    uint64_t m_lastFramePos = 0; // 最后一帧在环形缓冲区中的起始位置 (仅解码线程访问)
 
-    // 统计
-    std::atomic<int64_t> totalDecodedBytes{0};
-    std::atomic<int64_t> totalDecodedFrames{0};
-    std::atomic<bool> hasCalculatedQueueSize{false};
+    // 流标记：解码线程换算出事件对应的精确字节位置，回调线程播放到该位置时发出事件
+    struct StreamMarker
+    {
+        uint64_t position = 0;
+        PlaybackEvent event;
+    };
+    SpscQueue<StreamMarker, 128> m_streamMarkers;
+    uint64_t m_sessionStartPos = 0; // 当前曲目第一个采样在环形缓冲区中的位置 (仅解码线程访问)
+    std::vector<int64_t> m_activeBoundaries; // 当前文件的边界 (仅解码线程访问)
+    size_t m_nextBoundaryIndex = 0;
+
+    // Mixing 模式内部处理格式为 float32 交错，最终输出级再转换为设备格式
+    AudioKernels::PcmFormat m_outputFormat = AudioKernels::PcmFormat::Unknown; // 设备格式 (环形缓冲区中的数据格式)
+    std::atomic<AudioKernels::DitherMode> m_ditherMode{AudioKernels::DitherMode::Tpdf};
+    AudioKernels::DitherState m_dither; // 仅解码线程访问
+    std::vector<float> m_mixBuffer;     // 重采样输出 / 各处理级的工作区 (复用，只增不减)
+    DspChain m_dspChain;                // 交叉淡化之后、输出格式转换之前
+    std::shared_ptr<EqualizerStage> m_equalizer = std::make_shared<EqualizerStage>();
+    int m_equalizerStageId = -1;
+    std::atomic<bool> m_equalizerEnabled{false};
+    mutable std::mutex m_convolverMutex; // 保护以下两项 (控制线程)
+    int m_convolverStageId = -1;
+    std::string m_convolverPath;
+    std::atomic<double> m_playbackSpeed{1.0};
+    std::atomic<bool> m_tempoActive{false}; // 最近一帧是否经过变速滤镜图 (统计用)
+    std::atomic<NormalizationMode> m_normalizationMode{NormalizationMode::Off};
+    // 按输出模式 (下标为 outputMod) 的重采样器质量
+    std::array<std::atomic<ResamplerQuality>, 2> m_resamplerQuality{ResamplerQuality::Default, ResamplerQuality::Default};
+
+    // 交叉淡化 (Mixing 模式)：当前曲目最后 m_crossfadeMs 毫秒与预加载曲目开头原地叠加
+    std::atomic<int> m_crossfadeMs{0};
+    // 以下仅解码线程访问 (受 decodeMutex 保护)
+    bool m_crossfadeActive = false;             // 预加载源已开始被提前解码
+    int64_t m_preloadCursorUs = 0;              // 预加载源的解码时间游标
+    std::vector<float> m_crossfadeScratch;      // 预加载源重采样输出 (复用，只增不减)
+    AVPacket *m_crossfadePacket = nullptr;
+    AVFrame *m_crossfadeFrame = nullptr;
+
+    // 实时模式 (请求由任意线程写入，解码线程在循环中应用到自身)
+    std::atomic<bool> m_realtimeRequested{false};
+    std::atomic<int> m_realtimeCore{-1};
+    std::atomic<bool> m_realtimeDirty{false};
+    mutable std::mutex m_realtimeMutex;
+    RealtimeStatus m_realtimeStatus; // 受 m_realtimeMutex 保护
+
+    // 播放事件队列 (回调 / 解码 / 设备通知线程产生，控制器线程消费)
+    MpmcQueue<PlaybackEvent, 256> m_events;
+    std::counting_semaphore<> m_eventSignal{0};
+
+    // 回调线程私有状态 (设备静止时由 openAudioDevice 重置)
+    uint64_t m_lastReadEnd = 0;
+    bool m_underrunArmed = false;
+    bool m_inUnderrun = false;
+    bool m_streamEnded = true;
+
+    // 播放统计：计数器与直方图均无锁，回调线程与解码线程各自写入属于自己的部分
+    LatencyHistogram m_callbackLatency; // 回调线程
+    std::atomic<uint64_t> m_underrunCount{0};
+    std::atomic<uint64_t> m_underrunSilenceUs{0};
+    std::atomic<uint64_t> m_deadlineMisses{0};
+    std::atomic<int64_t> m_callbackDeadlineUs{0};
+    LatencyHistogram m_decodeLatency; // 解码线程
+    LatencyHistogram m_swrLatency;    // 解码线程
+
+    // Direct 模式零转换路径 (解码线程写入，任意线程读取)
+    std::atomic<bool> m_deviceNative{false};     // 后端原样接受了请求的格式 (miniaudio 内部不再转换)
+    std::atomic<bool> m_directCopyActive{false}; // 最近一帧绕过 swr 直接复制
+    std::atomic<uint64_t> m_directCopyFrames{0}; // 本次会话直接复制的帧数
+    // 逐位校验 (可选)，统计按会话 (打开 / 无缝切换 / 定位) 重新开始
+    std::atomic<bool> m_verifyBitPerfect{false};
+    std::atomic<uint64_t> m_verifiedFrames{0};
+    std::atomic<uint64_t> m_checksumMismatches{0};
+    std::atomic<uint32_t> m_outputCrc{0};
+    uint32_t m_crcState = UINT32_MAX;     // 解码线程：已输出 PCM 的 CRC32 中间值
+    std::vector<uint8_t> m_verifyScratch; // 解码线程：参照交错结果 (复用，只增不减)
+
+    // 离线渲染进行中：输出不经过设备，由渲染线程直接读取环形缓冲区
+    std::atomic<bool> m_rendering{false};
+    bool m_renderOutputReady = false; // 本次渲染已确定输出格式 (受 decodeMutex 保护)
+
+    // 由我们主动停止设备时置位，用于区分设备丢失
+    std::atomic<bool> m_deviceStopExpected{true};
 
     // 播放信息
-    std::atomic<int64_t> nowPlayingTime{0}; // 微秒
+    std::atomic<int64_t> nowPlayingTime{0}; // 微秒，回调最近读取的位置 (尚未经过设备缓冲)
+    PlaybackClock m_clock;                  // 扬声器输出的位置：回调更新锚点，任意线程插值读取
+    SpectrumAnalyzer m_spectrum;            // 回调线程写入输出数据，显示线程驱动计算
+    std::atomic<int64_t> m_outputLatencyUs{0};
     std::atomic<int64_t> audioDuration{0};  // 微秒
     std::atomic<double> volume{1.0};
     char errorBuffer[AV_ERROR_MAX_STRING_SIZE * 2] = {0};
@@ -171,26 +426,60 @@ private:
 
     // --- 私有方法 ---
     void freeResources();
+    bool ensureSession(const std::string &path);
+    std::unique_ptr<AudioStreamSource> acquireSession(const std::string &path);
+    void releaseSession(std::unique_ptr<AudioStreamSource> source);
     bool openAudioDevice();
+    void configureOutput(ma_format format, ma_uint32 channels, ma_uint32 sampleRate, double bufferSeconds, double lowWaterSeconds);
+    size_t readOutput(uint8_t *out, size_t bytes, uint64_t &startPos, std::vector<StreamMarker> *collected);
     void closeAudioDevice();
+    bool startDevice();
+    void stopDevice();
     void flushQueue();
+    void drainRingBuffer();
+    bool matchesDeviceFormat(const AudioStreamSource &source) const;
 
     // 核心线程逻辑
     void mainDecodeThread();
-    bool setupDecodingSession(const std::string &path);
+    bool setupDecodingSession(const std::string &path, int64_t startPosition);
+    void loadTrackBoundaries(int64_t fromUs);
+    void pushEvent(const PlaybackEvent &event);
     void handleSeekRequest();
     bool waitForDecodeState();
+    std::chrono::milliseconds refillWaitTime(size_t bufferedBytes) const;
+    void applyLatencyConfiguration();
+    void applyRealtimeSettings();
 
     // 解码逻辑
     void decodeAndProcessPacket(AVPacket *packet, bool &isSongLoopActive, bool &playbackFinishedNaturally);
+    void processDecodeAheadFrame(bool &isSongLoopActive, bool &playbackFinishedNaturally);
+    void handleEndOfInput(int ret, bool &isSongLoopActive, bool &playbackFinishedNaturally);
+    void startDecodeAhead(AudioStreamSource &source);
     bool processFrame(AVFrame *frame);
+    bool prepareFrame(AudioStreamSource &source, AVFrame *frame, int64_t &cursorUs, const uint8_t **&input, int &inputSamples, int64_t &ptsMicro);
+    bool writeToRingBuffer(const uint8_t **input, int inputSamples, int64_t ptsMicro, double speed);
+    bool writeTempoOutput();
+    void drainTempoFilter();
+    bool copyDirect(const uint8_t **input, int inputSamples, int64_t &copied);
+    void verifyDirectCopy(const uint8_t **input, int inputSamples, const AudioRingBuffer::Region *regions);
+    void resetDirectCopyStats();
+    int64_t convertDirect(SwrContext *swr, const uint8_t **input, int inputSamples);
+    int64_t convertMixing(SwrContext *swr, const uint8_t **input, int inputSamples, int64_t ptsMicro);
+    AudioParams resampleTarget() const;
+    float normalizationGain(const AudioStreamSource &source) const;
     void triggerPreload(double currentPts);
-    void calculateQueueSize(int out_bytes_per_sample);
     bool performSeamlessSwitch();
+    void markTrackFinished();
     void applyFadeOutToLastFrame();
+    void mixCrossfade(float *buffer, int64_t chunkFrames, int64_t chunkPtsUs);
+    int pullPreloadSamples(float *dst, int frames);
+    bool decodePreloadFrame();
+    void feedPreloadFrame();
+    void cancelCrossfade();
 
     // Miniaudio 回调
     static void ma_data_callback(ma_device *pDevice, void *pOutput, const void *pInput, ma_uint32 frameCount);
+    static void ma_notification_callback(const ma_device_notification *pNotification);
 };
 
 #endif // AUDIOPLAYER_HPP
\ No newline at end of file
@@ -0,0 +1,220 @@
+#ifndef AUDIORINGBUFFER_HPP
+#define AUDIORINGBUFFER_HPP
+
+#include "PCH.h"
+#include "ThreadPriority.hpp"
+
+// 单生产者/单消费者 PCM 字节环形缓冲区
+// 生产者: 解码线程 (swr_convert 直接写入可写区域)
+// 消费者: miniaudio 回调 (只做 memcpy，无锁、无分配、无通知)
+// 读写位置均为单调递增的 64 位字节计数，取模后得到物理偏移
+class AudioRingBuffer
+{
+public:
+    // 一段连续的可写/暂存内存 (跨越缓冲区末尾时会被拆成两段)
+    struct Region
+    {
+        uint8_t *data = nullptr;
+        size_t bytes = 0;
+    };
+
+    AudioRingBuffer() = default;
+    AudioRingBuffer(const AudioRingBuffer &) = delete;
+    AudioRingBuffer &operator=(const AudioRingBuffer &) = delete;
+    ~AudioRingBuffer()
+    {
+        setLocked(false);
+    }
+
+    // 重新分配容量并清空所有位置
+    // 注意：只能在生产者和消费者都静止时调用 (例如设备刚初始化、尚未 start)
+    void reset(size_t capacityBytes, size_t frameBytes)
+    {
+        frameBytes = std::max<size_t>(frameBytes, 1);
+        capacityBytes = std::max(capacityBytes / frameBytes, size_t{1}) * frameBytes;
+        if (capacityBytes != m_capacity)
+        {
+            // 重新分配时锁定状态跟随到新的存储
+            const bool wantLocked = m_lockRequested;
+            setLocked(false);
+            m_storage = std::make_unique<uint8_t[]>(capacityBytes);
+            m_capacity = capacityBytes;
+            setLocked(wantLocked);
+        }
+        m_frameBytes = frameBytes;
+        m_stagedPos = 0;
+        m_writePos.store(0, std::memory_order_relaxed);
+        m_discardPos.store(0, std::memory_order_relaxed);
+        m_readPos.store(0, std::memory_order_release);
+    }
+
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+    size_t frameBytes() const
+    {
+        return m_frameBytes;
+    }
+
+    // 预先触发缺页并锁定存储 (实时模式)，避免播放中因换页产生的延迟
+    // 只能由生产者调用；返回当前是否已锁定 (受 RLIMIT_MEMLOCK 等限制可能失败)
+    bool setLocked(bool locked)
+    {
+        m_lockRequested = locked;
+        if (locked && !m_locked.load(std::memory_order_relaxed) && m_capacity > 0)
+        {
+            m_locked.store(ThreadPriority::lockMemory(m_storage.get(), m_capacity), std::memory_order_relaxed);
+        }
+        else if (!locked && m_locked.load(std::memory_order_relaxed))
+        {
+            ThreadPriority::unlockMemory(m_storage.get(), m_capacity);
+            m_locked.store(false, std::memory_order_relaxed);
+        }
+        return m_locked.load(std::memory_order_relaxed);
+    }
+
+    // 任意线程可读
+    bool isLocked() const
+    {
+        return m_locked.load(std::memory_order_relaxed);
+    }
+
+    // 任意线程可调用：已发布、尚未播放的字节数 (不含暂存区，仅用于统计)
+    size_t publishedBytes() const
+    {
+        uint64_t writePos = m_writePos.load(std::memory_order_acquire);
+        uint64_t start = std::max(m_readPos.load(std::memory_order_acquire), m_discardPos.load(std::memory_order_acquire));
+        return static_cast<size_t>(writePos - std::min(start, writePos));
+    }
+
+    // ---------------- 生产者接口 ----------------
+
+    // 生产者视角下尚未播放的有效字节数 (包含暂存区)
+    size_t bufferedBytes() const
+    {
+        uint64_t start = std::max(m_readPos.load(std::memory_order_acquire), m_discardPos.load(std::memory_order_relaxed));
+        return static_cast<size_t>(m_stagedPos - std::min(start, m_stagedPos));
+    }
+
+    // 当前可写字节数 (被丢弃但消费者尚未跳过的数据仍占用空间)
+    size_t writableBytes() const
+    {
+        uint64_t readPos = m_readPos.load(std::memory_order_acquire);
+        return m_capacity - static_cast<size_t>(m_stagedPos - readPos);
+    }
+
+    // 获取从暂存位置开始的可写区域，返回总可写字节数
+    size_t prepareWrite(Region (&regions)[2]) const
+    {
+        size_t writable = m_capacity ? writableBytes() : 0;
+        size_t offset = m_capacity ? static_cast<size_t>(m_stagedPos % m_capacity) : 0;
+        size_t first = std::min(writable, m_capacity - offset);
+        regions[0] = {m_storage.get() + offset, first};
+        regions[1] = {m_storage.get(), writable - first};
+        return writable;
+    }
+
+    // 将刚写入的字节追加到暂存区 (此时消费者仍不可见)
+    void stage(size_t bytes)
+    {
+        m_stagedPos += bytes;
+    }
+
+    // 发布暂存区，使消费者可见
+    void publish()
+    {
+        m_writePos.store(m_stagedPos, std::memory_order_release);
+    }
+
+    // 暂存区的起止位置；暂存区只属于生产者，可以原地修改 (例如曲目末尾淡出)
+    uint64_t publishedPosition() const
+    {
+        return m_writePos.load(std::memory_order_relaxed);
+    }
+    uint64_t stagedPosition() const
+    {
+        return m_stagedPos;
+    }
+
+    // 获取 [fromPos, stagedPos) 范围对应的内存区域
+    // fromPos 必须位于暂存区内 (>= publishedPosition)
+    void stagedRegions(uint64_t fromPos, Region (&regions)[2])
+    {
+        regions[0] = {};
+        regions[1] = {};
+        if (m_capacity == 0 || fromPos >= m_stagedPos)
+            return;
+
+        size_t total = static_cast<size_t>(m_stagedPos - fromPos);
+        size_t offset = static_cast<size_t>(fromPos % m_capacity);
+        size_t first = std::min(total, m_capacity - offset);
+        regions[0] = {m_storage.get() + offset, first};
+        regions[1] = {m_storage.get(), total - first};
+    }
+
+    // 丢弃所有尚未播放的数据 (Seek / 切歌)
+    // 消费者下一次读取时会直接跳到丢弃水位，不会再播放旧数据
+    void discard()
+    {
+        m_stagedPos = m_writePos.load(std::memory_order_relaxed);
+        m_discardPos.store(m_stagedPos, std::memory_order_release);
+    }
+
+    // ---------------- 消费者接口 ----------------
+
+    // 读取最多 bytes 字节 (按整帧截断)，返回实际读取的字节数
+    // startPosition 返回本次读取起点对应的单调位置，用于时间戳插值
+    size_t read(uint8_t *dst, size_t bytes, uint64_t *startPosition = nullptr)
+    {
+        uint64_t readPos = m_readPos.load(std::memory_order_relaxed);
+        uint64_t discardPos = m_discardPos.load(std::memory_order_acquire);
+        if (discardPos > readPos)
+            readPos = discardPos;
+
+        // discardPos 总是取自某个已发布的 writePos，因此 writePos >= readPos
+        uint64_t writePos = m_writePos.load(std::memory_order_acquire);
+        size_t available = static_cast<size_t>(writePos - readPos);
+        size_t count = std::min(available, bytes);
+        count -= count % m_frameBytes;
+
+        if (count > 0)
+        {
+            size_t offset = static_cast<size_t>(readPos % m_capacity);
+            size_t first = std::min(count, m_capacity - offset);
+            memcpy(dst, m_storage.get() + offset, first);
+            if (count > first)
+            {
+                memcpy(dst + first, m_storage.get(), count - first);
+            }
+        }
+
+        if (startPosition)
+            *startPosition = readPos;
+        m_readPos.store(readPos + count, std::memory_order_release);
+        return count;
+    }
+
+    // 消费者已读取到的位置 (任意线程可读)
+    uint64_t readPosition() const
+    {
+        return m_readPos.load(std::memory_order_acquire);
+    }
+
+private:
+    std::unique_ptr<uint8_t[]> m_storage;
+    size_t m_capacity = 0;
+    size_t m_frameBytes = 1;
+    bool m_lockRequested = false;
+    std::atomic<bool> m_locked{false};
+
+    // 仅生产者访问：已写入但尚未发布的末尾位置
+    uint64_t m_stagedPos = 0;
+
+    // 生产者发布的位置 / 丢弃水位 与 消费者读取位置分处不同缓存行，避免伪共享
+    alignas(64) std::atomic<uint64_t> m_writePos{0};
+    std::atomic<uint64_t> m_discardPos{0};
+    alignas(64) std::atomic<uint64_t> m_readPos{0};
+};
+
+#endif // AUDIORINGBUFFER_HPP
@@ -0,0 +1,68 @@
+#ifndef CHUNKDECODER_HPP
+#define CHUNKDECODER_HPP
+
+#include "PCH.h"
+#include "SimpleThreadPool.hpp"
+
+// 分块并行解码 (波形生成与响度分析共用)
+// 策略 A - 并行 Seek (FLAC/MP3/WAV ...)：按采样范围切块，每块各自打开文件 seek 后解码
+// 策略 B - 流水线内存解码 (M4A/MP4/MKA ...)：这类容器 seek 代价高，顺序读包后按批交给线程池解码
+// 每块都从范围之前的预卷开始解码 (策略 B 为前一批末尾的数据包)，预卷部分只用于让解码器与
+// 接收者内部的滤波器进入稳态，不属于任何一块的结果
+class ChunkDecoder
+{
+public:
+    // 解码帧接收者：每块一个实例，只在处理该块的工作线程中使用
+    class FrameSink
+    {
+    public:
+        virtual ~FrameSink() = default;
+        // 解码器打开后调用一次 (以 ctx 的采样格式 / 声道布局为准)，返回 false 放弃本块
+        virtual bool open(const AVCodecContext *ctx) = 0;
+        // 解码帧 (解码器输出格式)：firstSample 为帧第一个采样的位置，帧内 [begin, end) 的采样属于本块，其余为预卷
+        virtual void push(const AVFrame *frame, int64_t firstSample, int begin, int end) = 0;
+    };
+    using SinkFactory = std::function<std::unique_ptr<FrameSink>()>;
+
+    ChunkDecoder() = default;
+    ~ChunkDecoder();
+    ChunkDecoder(const ChunkDecoder &) = delete;
+    ChunkDecoder &operator=(const ChunkDecoder &) = delete;
+
+    // 打开文件并选出音频流
+    bool open(const std::string &path);
+    int sampleRate() const
+    {
+        return m_sampleRate;
+    }
+    // 容器给出的时长 (微秒，可能是估算值)
+    int64_t durationUs() const
+    {
+        return m_durationUs;
+    }
+
+    /**
+     * @brief 解码 [startSample, endSample)，阻塞到所有块完成 (之后文件已关闭，不能再次调用)
+     * @param chunks    策略 A 的块数 (策略 B 每 PACKET_BATCH_SIZE 个数据包一批，不使用此参数)
+     * @param preroll   每块之前额外解码的采样数
+     * @param cancelled 非空时在读包 / 解码之间检查，置位后尽快返回
+     * @return 各块的接收者 (按时间顺序)；打开失败或被取消的块不在其中
+     */
+    std::vector<std::unique_ptr<FrameSink>> decode(SimpleThreadPool &pool, int64_t startSample, int64_t endSample, int chunks,
+                                                   int64_t preroll, const SinkFactory &makeSink, const std::atomic<bool> *cancelled = nullptr);
+
+private:
+    std::vector<std::unique_ptr<FrameSink>> decodeSeekable(SimpleThreadPool &pool, int64_t startSample, int64_t endSample, int chunks,
+                                                           int64_t preroll, const SinkFactory &makeSink, const std::atomic<bool> *cancelled);
+    std::vector<std::unique_ptr<FrameSink>> decodePipelined(SimpleThreadPool &pool, int64_t startSample, int64_t endSample,
+                                                            int64_t preroll, const SinkFactory &makeSink, const std::atomic<bool> *cancelled);
+
+    std::string m_path;
+    AVFormatContext *m_fmt = nullptr;
+    int m_streamIdx = -1;
+    int m_sampleRate = 0;
+    int64_t m_durationUs = 0;
+    bool m_pipelined = false;
+};
+
+#endif // CHUNKDECODER_HPP
@@ -0,0 +1,148 @@
+#ifndef CONVOLVER_HPP
+#define CONVOLVER_HPP
+
+#include "DspChain.hpp"
+
+extern "C"
+{
+#include <libavutil/tx.h>
+}
+
+// 脉冲响应 (文件的原始采样率，按通道分开)
+struct ImpulseResponse
+{
+    int sampleRate = 0;
+    std::vector<std::vector<float>> channels;
+
+    size_t taps() const
+    {
+        return channels.empty() ? 0 : channels[0].size();
+    }
+};
+
+// 均匀分区的重叠保留 (overlap-save) FFT 卷积：房间 / 耳机校正等长 FIR
+// 脉冲响应按 PARTITION_FRAMES 切成 P 个分区并预先变换到频域，每个输入块变换一次后放入频域延迟线，
+// 输出块的频谱 = Σ X[n-k]·H[k]。前 HEAD_PARTITIONS 个分区由解码线程直接累加，
+// 其余 (长尾) 分区只依赖更早的输入块，由工作线程提前 HEAD_PARTITIONS 个块开始计算。
+// 解码线程从不等待工作线程：只发布块号 (工作线程每隔一段时间轮询)，需要尾部结果时若尚未完成，
+// 就领取该任务 (CAS) 并用同样的乘加就地计算。
+// 延迟线的物理槽位带块号标签：工作线程读取一个分区前先登记 (pin) 该槽位并核对标签，槽位已被回收时放弃任务；
+// 解码线程要回收的槽位正被登记时改用备用槽位，因此两个线程从不同时读写同一块数据。
+// 附加延迟为 PARTITION_FRAMES 帧；音频通道 c 使用脉冲响应的第 c % 通道数 个通道
+class ConvolverStage : public DspStage
+{
+public:
+    static constexpr size_t PARTITION_FRAMES = 512;
+    static constexpr size_t HEAD_PARTITIONS = 4;
+    static constexpr size_t MAX_TAPS = 1 << 19; // 96 kHz 下约 5.5 秒
+    static constexpr int MAX_CHANNELS = 8;
+
+    // 解码脉冲响应文件 (WAV 或其他 FFmpeg 支持的格式)，超过 MAX_TAPS 的部分被截断
+    static bool loadImpulseResponse(const std::string &path, ImpulseResponse &out);
+
+    explicit ConvolverStage(ImpulseResponse impulse);
+    ~ConvolverStage() override;
+    ConvolverStage(const ConvolverStage &) = delete;
+    ConvolverStage &operator=(const ConvolverStage &) = delete;
+
+    // 按当前采样率重采样后的长度与分区数 (prepare 之后有效)
+    size_t taps() const
+    {
+        return m_taps;
+    }
+    size_t partitions() const
+    {
+        return m_partitions;
+    }
+
+    const char *name() const override;
+    // 把脉冲响应重采样到输出采样率并变换各分区，(重新) 启动工作线程
+    void prepare(int sampleRate, int channels) override;
+    // 清空延迟线与重叠部分并开始新的纪元，不等待工作线程 (上一纪元的尾部结果作废)
+    void reset() override;
+    void process(float *samples, size_t frames, int channels) override;
+    uint64_t workerBusyNs() const override;
+
+private:
+    static constexpr size_t FFT_SIZE = PARTITION_FRAMES * 2;
+    // 实数 FFT 的 N/2 + 1 个频点补齐到 8 的倍数 (AVX2)，实部 / 虚部分开存放
+    static constexpr size_t BINS = (PARTITION_FRAMES + 1 + 7) & ~size_t(7);
+    static constexpr size_t SPECTRUM = BINS * 2;
+    // 尾部结果的槽位数：工作线程最多领先解码线程 HEAD_PARTITIONS 个块
+    static constexpr size_t TAIL_SLOTS = HEAD_PARTITIONS + 1;
+    // 工作线程每个分区时长内轮询新块的次数
+    static constexpr int POLLS_PER_BLOCK = 4;
+
+    // 频域延迟线与滤波器分区的下标 (均为 [re × BINS][im × BINS])
+    const float *fdlSlot(size_t slot, size_t channel) const
+    {
+        return &m_fdl[(slot * m_channels + channel) * SPECTRUM];
+    }
+    // 解码线程：块号 block 当前所在的物理槽位 (只有解码线程修改映射)
+    size_t fdlSlotOf(int64_t block) const
+    {
+        return m_fdlMap[static_cast<size_t>(block % static_cast<int64_t>(m_fdlRing))].load(std::memory_order_relaxed);
+    }
+    const float *filter(size_t channel, size_t partition) const
+    {
+        return &m_filter[((channel % m_filterChannels) * m_partitions + partition) * SPECTRUM];
+    }
+    float *tail(size_t channel, int64_t block)
+    {
+        return &m_tail[(static_cast<size_t>(block % static_cast<int64_t>(TAIL_SLOTS)) * m_channels + channel) * SPECTRUM];
+    }
+
+    std::vector<std::vector<float>> resampleImpulse(int sampleRate) const;
+    void processBlock();
+    // 输入块变换结果写入延迟线 (解码线程，避开工作线程正在读取的槽位)
+    void storeBlock(int64_t block);
+    // 解码线程领取迟到的任务：输出块 block 的尾部分区累加到累加器
+    void accumulateTail(int64_t block);
+    // 工作线程：输出块 job 的尾部分区写入尾部槽位，所需的输入块已被回收时返回 false
+    bool computeTail(int64_t job, int64_t firstBlock);
+    void workerLoop();
+    void startWorker();
+    void stopWorker();
+
+    ImpulseResponse m_impulse;
+
+    AVTXContext *m_forward = nullptr;
+    AVTXContext *m_inverse = nullptr;
+    av_tx_fn m_forwardFn = nullptr;
+    av_tx_fn m_inverseFn = nullptr;
+
+    size_t m_channels = 0;
+    size_t m_filterChannels = 0;
+    size_t m_taps = 0;
+    size_t m_partitions = 0;
+    size_t m_headPartitions = 0;
+    std::vector<float> m_filter; // [脉冲响应通道][分区][频谱]
+
+    // 解码线程
+    std::vector<float> m_fdl;         // [物理槽位][通道][频谱]
+    size_t m_fdlRing = 0;             // 块号环的长度 (分区数 + 余量)，物理槽位比它多一个备用
+    size_t m_fdlSpare = 0;            // 当前的备用物理槽位
+    std::unique_ptr<std::atomic<size_t>[]> m_fdlMap;   // 块号 % m_fdlRing -> 物理槽位
+    std::unique_ptr<std::atomic<int64_t>[]> m_fdlBlock; // 物理槽位中的块号，-1 表示无效 / 正在写入
+    std::vector<float> m_window;      // [通道][FFT_SIZE]：前一块 + 当前块的输入
+    std::vector<float> m_output;      // 上一块的输出 (交错)，延迟一块送出
+    std::vector<float> m_accumulator; // [通道][频谱]
+    std::vector<float> m_time;        // FFT 输入 / 输出
+    std::vector<AVComplexFloat> m_bins;
+    size_t m_position = 0; // 当前块已填入的帧数
+    int64_t m_block = 0;   // 下一个完整块的块号 (单调递增，reset 不归零)
+
+    // 工作线程
+    std::vector<float> m_tail; // [槽位][通道][频谱]
+    std::array<std::atomic<int64_t>, TAIL_SLOTS> m_tailJob; // 槽位中已完成的输出块号
+    std::thread m_worker;
+    std::chrono::nanoseconds m_pollInterval{0};
+    std::atomic<bool> m_stop{false};
+    std::atomic<int64_t> m_posted{-1};    // 已放入延迟线的最新块号
+    std::atomic<int64_t> m_claimed{-1};   // 已被领取的最新尾部任务 (输出块号)
+    std::atomic<int64_t> m_firstBlock{0}; // 纪元：reset 之后的第一个块，更早的输入块视为零 (不参与计算)
+    std::atomic<int64_t> m_pinned{-1};    // 工作线程正在读取的物理槽位
+    std::atomic<uint64_t> m_workerNs{0};
+};
+
+#endif // CONVOLVER_HPP
@@ -0,0 +1,54 @@
+#ifndef DECODEAHEAD_HPP
+#define DECODEAHEAD_HPP
+
+#include "PCH.h"
+#include "PlaybackStats.hpp"
+
+// 提前解码：工作线程在运行期间独占格式与解码器上下文，持续读包、解码，
+// 把解码出的帧缓存起来 (按 PCM 时长限量)，消费者按顺序取出。
+// 用于 APE / TAK / DSD / 高采样率无损等单帧解码开销大的格式，让解码耗时的抖动不再直接传导到环形缓冲区
+class DecodeAhead
+{
+public:
+    enum class Status : std::uint8_t
+    {
+        Frame,       // 取到一帧
+        EndOfStream, // 文件已读完，解码器中的剩余帧也已全部取出
+        Error,       // 读取或解码出错
+    };
+
+    // decodeLatency 可为空；工作线程运行期间由它独占写入
+    DecodeAhead(AVFormatContext *formatCtx, AVCodecContext *codecCtx, int streamIndex, double maxSeconds, LatencyHistogram *decodeLatency);
+    // 停止工作线程并释放缓存的帧，之后调用方重新获得上下文的使用权
+    ~DecodeAhead();
+
+    DecodeAhead(const DecodeAhead &) = delete;
+    DecodeAhead &operator=(const DecodeAhead &) = delete;
+
+    // 取出下一帧 (引用转移到 frame)，缓存为空时等待工作线程；error 为出错时的 FFmpeg 错误码
+    Status pop(AVFrame *frame, int &error);
+    // 已缓存的 PCM 时长 (秒)
+    double bufferedSeconds() const;
+
+private:
+    void workerLoop();
+    bool pushFrame(AVFrame *frame);
+    void finish(int error);
+
+    AVFormatContext *m_formatCtx;
+    AVCodecContext *m_codecCtx;
+    int m_streamIndex;
+    int64_t m_maxUs;
+    LatencyHistogram *m_decodeLatency;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<AVFrame *> m_frames;
+    int64_t m_bufferedUs = 0;
+    bool m_finished = false;
+    int m_error = 0;
+    std::atomic<bool> m_stop{false};
+    std::thread m_worker;
+};
+
+#endif // DECODEAHEAD_HPP
@@ -0,0 +1,140 @@
+#ifndef DSPCHAIN_HPP
+#define DSPCHAIN_HPP
+
+#include "PCH.h"
+#include "PlaybackStats.hpp"
+#include "TripleBuffer.hpp"
+
+// DSP 处理级：原地处理交错 float32 块 (Mixing 模式，重采样 / 响度归一化 / 交叉淡化之后、输出格式转换之前)
+// 线程约定：
+//   prepare          非实时，可以分配内存 (加入处理链时、输出格式变化时；此时不会与 process 并发)
+//   reset / process  解码线程，不得分配内存、加锁或做任何可能阻塞的调用
+// 参数从 UI 线程修改时通过 DspParameters (三缓冲) 传递，process 在每块开头取最新值
+class DspStage
+{
+public:
+    virtual ~DspStage() = default;
+
+    virtual const char *name() const = 0;
+    virtual void prepare(int sampleRate, int channels) = 0;
+    // 清除滤波器历史等内部状态 (定位 / 开始新的播放会话)
+    virtual void reset()
+    {
+    }
+    // frames 不超过 DspChain::BLOCK_FRAMES
+    virtual void process(float *samples, size_t frames, int channels) = 0;
+    // 处理级自带的工作线程累计耗时 (纳秒，prepare 时清零)，计入统计中的 workerLoad
+    virtual uint64_t workerBusyNs() const
+    {
+        return 0;
+    }
+};
+
+// 处理级参数的无锁传递：单个控制线程 set()，解码线程在 process 中 fetch()
+template <typename T>
+class DspParameters
+{
+public:
+    // 第一次 fetch() 返回 true，处理级据此计算初始系数
+    explicit DspParameters(const T &initial = T{})
+    {
+        m_buffer.write(initial);
+    }
+
+    // 控制线程
+    void set(const T &value)
+    {
+        m_buffer.write(value);
+    }
+    // 解码线程：有新参数时返回 true (处理级据此重新计算系数)
+    bool fetch()
+    {
+        return m_buffer.update();
+    }
+    const T &current() const
+    {
+        return m_buffer.front();
+    }
+
+private:
+    TripleBuffer<T> m_buffer;
+};
+
+// DSP 处理链
+// 编辑 (添加 / 移除 / 旁路) 在控制线程进行：构造新的处理级列表后原子地替换，解码线程在下一次 process 时看到
+// 被替换的旧列表与移除的处理级在解码线程确认不再使用 (已处理完或不在处理链中) 后才由控制线程释放，
+// 解码线程从不分配、释放或加锁
+class DspChain
+{
+public:
+    // 每次交给处理级的最大帧数 (一次 process 的数据按此切块，最后一块可能更短)
+    static constexpr size_t BLOCK_FRAMES = 1024;
+    static constexpr size_t MAX_STAGES = 16;
+
+    DspChain();
+    ~DspChain();
+    DspChain(const DspChain &) = delete;
+    DspChain &operator=(const DspChain &) = delete;
+
+    // 控制线程：插入到 position (超出范围时追加到末尾)，返回处理级 id，处理链已满时返回 -1
+    // 调用方可保留 stage 的引用，用于之后修改参数
+    int addStage(std::shared_ptr<DspStage> stage, int position = -1);
+    bool removeStage(int id);
+    // 原子地替换处理级 (保留 id、位置与旁路状态)，解码线程不会看到两者同时存在或都不存在的中间状态
+    bool replaceStage(int id, std::shared_ptr<DspStage> stage);
+    bool setBypassed(int id, bool bypassed);
+    void clear();
+    std::vector<DspStageStats> stats() const;
+
+    // 输出格式变化时调用 (调用方保证此时不会与 process 并发)
+    void prepare(int sampleRate, int channels);
+
+    // 解码线程
+    void reset();
+    void process(float *samples, size_t frames, int channels);
+
+private:
+    struct Entry
+    {
+        int id = 0;
+        std::shared_ptr<DspStage> stage;
+        std::atomic<bool> bypassed{false};
+        LatencyHistogram blockUs;
+        std::atomic<uint64_t> busyNs{0};
+        std::atomic<uint64_t> frames{0};
+    };
+
+    // 不可变的处理级列表，整体替换
+    struct StageList
+    {
+        uint64_t version = 0;
+        size_t count = 0;
+        std::array<Entry *, MAX_STAGES> entries{};
+    };
+
+    // 等待解码线程确认后释放的旧列表 / 处理级 (version 为替换它的新列表版本)
+    struct Retired
+    {
+        uint64_t version = 0;
+        std::unique_ptr<StageList> list;
+        std::vector<std::unique_ptr<Entry>> entries;
+    };
+
+    // 以下均在持有 m_editMutex 时调用
+    void publish(std::unique_ptr<StageList> list, std::vector<std::unique_ptr<Entry>> removed);
+    void collectRetired();
+
+    mutable std::mutex m_editMutex;
+    std::atomic<StageList *> m_active{nullptr};
+    std::unique_ptr<StageList> m_activeOwner;      // 控制线程持有当前列表的所有权
+    std::vector<std::unique_ptr<Entry>> m_entries; // 当前列表中的处理级
+    std::vector<Retired> m_retired;                // 待释放
+    std::atomic<uint64_t> m_idleVersion{0};        // 解码线程最近一次处理完成时使用的列表版本
+    std::atomic<bool> m_processing{false};         // 解码线程正在 process / reset 中
+    uint64_t m_nextVersion = 1;
+    int m_nextId = 1;
+    int m_sampleRate = 0;
+    int m_channels = 0;
+};
+
+#endif // DSPCHAIN_HPP
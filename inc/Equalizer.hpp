@@ -0,0 +1,85 @@
+#ifndef EQUALIZER_HPP
+#define EQUALIZER_HPP
+
+#include "DspChain.hpp"
+
+// 均衡器滤波器类型 (RBJ Audio EQ Cookbook 双二阶节)
+enum class EqFilterType : std::uint8_t
+{
+    Peaking,
+    LowShelf,
+    HighShelf,
+};
+
+struct EqBand
+{
+    EqFilterType type = EqFilterType::Peaking;
+    float frequency = 1000.0f; // Hz，超过 0.45 × 采样率时按 0.45 × 采样率计算
+    float gainDb = 0.0f;
+    float q = 1.41f; // 约一个倍频程带宽
+};
+
+constexpr size_t EQ_BANDS = 10;
+
+struct EqSettings
+{
+    std::array<EqBand, EQ_BANDS> bands{};
+    float preampDb = 0.0f; // 前级增益 (为提升的频段留出余量，避免输出削波)
+};
+
+// 图示均衡预设：各频段增益 (dB)
+struct EqPreset
+{
+    const char *name;
+    std::array<float, EQ_BANDS> gainsDb;
+};
+
+// 10 段参数 / 图示均衡器 (双二阶节级联)
+// 系数在控制线程计算，经 DspParameters 原子切换；解码线程按 8 个通道一组放进 AVX2 的各个通道并行处理，
+// 增益为 0 的峰值频段被跳过 (全部为 0 且无前级增益时不做任何处理)
+class EqualizerStage : public DspStage
+{
+public:
+    static constexpr float MAX_GAIN_DB = 12.0f;
+    // 图示均衡的中心频率 (倍频程)
+    static constexpr std::array<float, EQ_BANDS> GRAPHIC_FREQUENCIES = {31.25f, 62.5f, 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f, 16000.0f};
+
+    static const std::vector<EqPreset> &presets();
+    // 图示均衡：倍频程峰值频段 + 按最大提升量自动设置前级增益
+    static EqSettings graphic(const std::array<float, EQ_BANDS> &gainsDb);
+
+    EqualizerStage();
+
+    // 控制线程：重新计算系数后切换，解码线程在下一块生效
+    void setSettings(const EqSettings &settings);
+    EqSettings settings() const;
+
+    const char *name() const override;
+    void prepare(int sampleRate, int channels) override;
+    void reset() override;
+    void process(float *samples, size_t frames, int channels) override;
+
+private:
+    // 归一化 (a0 = 1) 的直接 II 型转置系数，只包含需要处理的频段
+    struct Coefficients
+    {
+        std::array<std::array<float, 5>, EQ_BANDS> bands{}; // b0 b1 b2 a1 a2
+        std::array<uint8_t, EQ_BANDS> index{};              // 对应的原始频段 (状态按原始频段保存)
+        size_t count = 0;
+        float preamp = 1.0f;
+    };
+
+    static Coefficients compute(const EqSettings &settings, int sampleRate);
+
+    // 控制线程
+    mutable std::mutex m_mutex;
+    EqSettings m_settings;
+    int m_sampleRate = 0;
+    DspParameters<Coefficients> m_coefficients;
+
+    // 解码线程：滤波器状态，按 8 个通道一组 [group][band][2][8]，与 AVX2 寄存器布局一致
+    std::vector<float> m_state;
+    int m_channels = 0;
+};
+
+#endif // EQUALIZER_HPP
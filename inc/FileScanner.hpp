@@ -79,6 +79,21 @@ public:
      */
     static std::string extractCoverToTempFile(MetaData &metadata);
 
+    /**
+     * @brief 提取内嵌歌词 (切换到该曲目时按需调用，扫描时不读取)
+     * ID3v2 SYLT 同步歌词 (毫秒时间戳) 转换为 LRC 文本，其次为 USLT / LYRICS 等文本标签
+     * @param musicPath 文件绝对路径
+     * @return UTF-8 歌词文本，没有时返回空字符串
+     */
+    static std::string extractLyrics(const std::string &musicPath);
+
+    /**
+     * @brief 读取外部歌词文件 (.lrc)，自动探测编码并转换为 UTF-8
+     * @param lrcPath 歌词文件路径
+     * @return UTF-8 文本，读取失败时返回空字符串
+     */
+    static std::string readLyricsFile(const std::string &lrcPath);
+
     /**
      * @brief 启动异步扫描任务
      * 如果已有任务在运行，会先中断并等待其结束，再启动新任务。
@@ -0,0 +1,81 @@
+#ifndef LOUDNESSANALYZER_HPP
+#define LOUDNESSANALYZER_HPP
+
+#include "MetaData.hpp"
+#include "SimpleThreadPool.hpp"
+
+// 响度归一化方式 (Mixing 模式的增益级)
+enum class NormalizationMode : std::uint8_t
+{
+    Off,
+    Track, // 按曲目响度
+    Album, // 按所在文件夹 (专辑) 的整体响度，保留曲目间的相对响度
+};
+
+// EBU R128 / ReplayGain 2.0 响度分析 (单例)
+// 以文件夹为单位在后台遍历整个曲库：每个文件按块并行解码，K 加权后按 100 ms 分段累计能量，
+// 再按 BS.1770 门限计算综合响度、响度范围与 4 倍过采样真峰值。
+// 每完成一个文件夹就把结果追加到磁盘，中断后重新启动时跳过已完成 (且未修改) 的文件夹
+class LoudnessAnalyzer
+{
+public:
+    // ReplayGain 2.0 参考响度
+    static constexpr float REFERENCE_LUFS = -18.0f;
+
+    static LoudnessAnalyzer &instance()
+    {
+        static LoudnessAnalyzer analyzer;
+        return analyzer;
+    }
+
+    LoudnessAnalyzer(const LoudnessAnalyzer &) = delete;
+    LoudnessAnalyzer &operator=(const LoudnessAnalyzer &) = delete;
+    ~LoudnessAnalyzer();
+
+    // 在后台分析整个曲库 (每个元素是一个文件夹内的文件)，替换之前未完成的任务
+    void analyzeLibrary(std::vector<std::vector<std::string>> albums);
+    // 中止后台分析并等待退出
+    void stop();
+
+    // 查询已有的分析结果 (文件修改后视为无效)
+    bool lookup(const std::string &path, LoudnessInfo &info);
+
+    // 按归一化方式换算线性增益 (同时限制增益不让真峰值超过 0 dBTP)；无结果或 Off 时返回 1.0
+    static float gainFor(const LoudnessInfo &info, NormalizationMode mode);
+
+private:
+    LoudnessAnalyzer();
+
+    // 单个文件的测量数据 (专辑结果需要把各曲目的分块能量合并后重新做门限)
+    struct Measurement
+    {
+        std::vector<double> momentary; // 400 ms 块的均方 (K 加权，已按通道权重求和)
+        std::vector<double> shortTerm; // 3 s 窗口的均方
+        float truePeak = 0.0f;
+    };
+
+    struct Entry
+    {
+        int64_t mtime = 0;
+        LoudnessInfo info;
+    };
+
+    void workerLoop(std::vector<std::vector<std::string>> albums);
+    bool analyzeFile(const std::string &path, Measurement &out);
+    bool isUpToDate(const std::vector<std::string> &album);
+
+    static int64_t fileMtime(const std::string &path);
+    void loadStore();
+    void appendStore(const std::vector<std::pair<std::string, Entry>> &entries);
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_results;
+    fs::path m_storePath;
+
+    std::thread m_worker;
+    std::atomic<bool> m_cancelled{false};
+    // 分块解码专用线程池 (空闲优先级，不与播放 / 界面任务抢占 CPU)
+    SimpleThreadPool m_pool;
+};
+
+#endif // LOUDNESSANALYZER_HPP
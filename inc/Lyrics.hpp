@@ -0,0 +1,59 @@
+#ifndef LYRICS_HPP
+#define LYRICS_HPP
+
+#include "MetaData.hpp"
+#include "PCH.h"
+
+struct LyricLine
+{
+    int64_t timeUs = 0; // 相对曲目起点 (微秒)
+    std::string text;
+};
+
+// 一首曲目的歌词：按时间排序的行数组，当前行由播放位置二分查找得到
+// 只在切换到该曲目时加载 (扫描时不读取)，加载与解析都不依赖 Qt，可在后台线程进行
+class Lyrics
+{
+public:
+    /**
+     * @brief 解析 LRC 文本
+     * 支持一行多个时间标签、[offset:±毫秒] 标签，逐字时间标签 <mm:ss.xx> 被去掉；
+     * 没有任何时间标签时作为纯文本歌词 (不同步)
+     */
+    static Lyrics parse(std::string_view text);
+
+    /**
+     * @brief 加载曲目的歌词
+     * 来源依次为：内嵌 (SYLT > USLT / LYRICS)、同名 .lrc、"<标题>.lrc"、"<艺术家> - <标题>.lrc"，
+     * 同步歌词优先于纯文本。CUE 分轨 (offset / duration 为该轨在整个文件中的范围) 时，
+     * 内嵌与同名 .lrc 视为覆盖整个文件，截取本轨范围并平移到轨道起点；按标题命名的 .lrc 视为本轨自己的歌词
+     */
+    static Lyrics load(const MetaData &track);
+
+    bool empty() const
+    {
+        return m_lines.empty();
+    }
+    bool synced() const
+    {
+        return m_synced;
+    }
+    const std::vector<LyricLine> &lines() const
+    {
+        return m_lines;
+    }
+
+    // 当前行：开始时间不晚于 positionUs 的最后一行；第一行之前或不同步时返回 -1
+    int lineAt(int64_t positionUs) const;
+    // line 之后一行的开始时间，没有时返回 -1
+    int64_t nextLineTime(int line) const;
+
+private:
+    // 只保留 [startUs, endUs) 内的行并平移到 startUs (endUs <= startUs 表示到文件末尾)
+    void clip(int64_t startUs, int64_t endUs);
+
+    std::vector<LyricLine> m_lines;
+    bool m_synced = false;
+};
+
+#endif // LYRICS_HPP
@@ -46,6 +46,8 @@ private:
     std::deque<PlaylistNode *> playHistory;
     // 限制历史记录最大长度，防止无限增长
     const size_t MAX_HISTORY_SIZE = 50;
+    // 保持解码会话打开的最近播放曲目数量 (与 AudioPlayer 的会话缓存配合)
+    const size_t PREFETCH_HISTORY_SIZE = 2;
 
     // --- 播放参数 ---
     std::atomic<double> volume{1.0};
@@ -54,15 +56,33 @@ private:
 
     std::atomic<RepeatMode> repeatMode{RepeatMode::None};
 
-    // --- 监控与自动化 ---
-    std::thread monitorThread;
-    std::atomic<bool> monitorRunning{true};
-
+    // --- 事件驱动的自动化 ---
     // 记录上一次检测到的播放路径，用于判断是否发生了自动切歌
     std::string lastDetectedPath = "";
 
+    // 播放事件线程 (阻塞等待 AudioPlayer 事件，无轮询)
+    std::thread eventThread;
+    std::atomic<bool> eventRunning{true};
+    // 播放中刷新 MPRIS 位置的间隔
+    static constexpr std::chrono::milliseconds MPRIS_POSITION_REFRESH_INTERVAL{1000};
+
     // --- 内部辅助函数 ---
-    void monitorLoop();
+    void eventLoop();
+
+    // 底层切换了物理文件 (TrackStarted / SeamlessSwitch)，同步当前节点
+    void syncWithPlayerPath();
+
+    // 最后一首播放完毕 (TrackFinished)
+    void handleTrackFinished();
+
+    // 音频设备丢失 (DeviceLost)
+    void handleDeviceLost();
+
+    // 越过 CUE 分轨边界 (由 AudioPlayer 在精确采样点通知)
+    void handleTrackBoundary(int64_t boundaryUs);
+
+    // 收集与 node 同一物理文件的所有分轨起点
+    std::vector<int64_t> collectTrackBoundaries(PlaylistNode *node);
 
     // 计算并预加载下一首歌曲 (核心无缝播放逻辑)
     void preloadNextSong();
@@ -82,6 +102,9 @@ private:
     // 检查路径归属
     bool isPathUnderRoot(const fs::path &nodePath) const;
 
+    // 扫描完成后按文件夹在后台分析整个曲库的响度
+    void startLoudnessAnalysis();
+
 public:
     // 删除拷贝和赋值，保留单例访问
     MediaController(const MediaController &) = delete;
@@ -125,9 +148,43 @@ public:
     }
     void setRepeatMode(RepeatMode mode);
     RepeatMode getRepeatMode();
-    void setMixingParameters(int sampleRate, AVSampleFormat smapleFormat);
+    void setMixingParameters(int sampleRate, AVSampleFormat smapleFormat, bool packed24 = false);
     void setOUTPUTMode(outputMod mode);
     outputMod getOUTPUTMode();
+    void setCrossfadeDuration(int milliseconds);
+    int getCrossfadeDuration();
+    void setDitherMode(AudioKernels::DitherMode mode);
+    AudioKernels::DitherMode getDitherMode();
+    void setNormalizationMode(NormalizationMode mode);
+    NormalizationMode getNormalizationMode();
+    void setEqualizerEnabled(bool enabled);
+    bool getEqualizerEnabled();
+    void setEqualizerSettings(const EqSettings &settings);
+    EqSettings getEqualizerSettings();
+    bool setConvolverImpulse(const std::string &path);
+    std::string getConvolverImpulse();
+    void setPlaybackSpeed(double speed);
+    double getPlaybackSpeed();
+    void setSpectrumEnabled(bool enabled);
+    bool getSpectrumEnabled();
+    void readSpectrum(SpectrumFrame &frame);
+    void setRealtimeMode(bool enabled, int cpuCore = -1);
+    RealtimeStatus getRealtimeStatus();
+    void setLatencyProfile(LatencyProfile profile);
+    LatencyProfile getLatencyProfile();
+    void setDevicePeriod(int milliseconds);
+    void setDecodeAhead(DecodeAheadMode mode, double seconds = 3.0);
+    void setResamplerQuality(outputMod mode, ResamplerQuality quality);
+    ResamplerQuality getResamplerQuality(outputMod mode);
+    DecodeAheadMode getDecodeAheadMode();
+    int getDevicePeriod();
+    void setBitPerfectVerification(bool enabled);
+    bool getBitPerfectVerification();
+    PlaybackStats getStats();
+    // DSP 处理链 (Mixing 模式)：返回处理级 id，失败时返回 -1
+    int addDspStage(std::shared_ptr<DspStage> stage, int position = -1);
+    bool removeDspStage(int id);
+    bool setDspStageBypassed(int id, bool bypassed);
     AudioParams getMixingParameters();
     AudioParams getDeviceParameters();
 
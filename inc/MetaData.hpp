@@ -3,6 +3,18 @@
 
 #include "PCH.h"
 
+// EBU R128 响度测量结果 (由 LoudnessAnalyzer 在后台计算)
+struct LoudnessInfo
+{
+    bool valid = false;
+    float integratedLufs = 0.0f;      // 曲目综合响度 (LUFS)
+    float loudnessRange = 0.0f;       // 曲目响度范围 (LU)
+    float truePeak = 0.0f;            // 曲目真峰值 (线性，1.0 = 0 dBTP)
+    float albumIntegratedLufs = 0.0f; // 所在文件夹 (专辑) 的综合响度
+    float albumLoudnessRange = 0.0f;
+    float albumTruePeak = 0.0f;
+};
+
 class MetaData
 {
     using file_time_type = std::filesystem::file_time_type;
@@ -21,6 +33,7 @@ private:
     std::uint32_t sampleRate;     // 采样率
     std::uint16_t bitDepth;       // 采样深度
     std::string formatType;       // 文件格式类型
+    LoudnessInfo loudness;        // 响度信息 (尚未分析时 valid = false)
 
 public:
     MetaData() : duration(0), offset(0), sampleRate(0), bitDepth(0)
@@ -159,6 +172,10 @@ public:
     {
         return formatType;
     }
+    const LoudnessInfo &getLoudness() const
+    {
+        return loudness;
+    }
 
     // setter
     void setTitle(const std::string &title)
@@ -213,6 +230,10 @@ public:
     {
         this->formatType = formatType;
     }
+    void setLoudness(const LoudnessInfo &loudness)
+    {
+        this->loudness = loudness;
+    }
 };
 
 #endif
@@ -29,6 +29,7 @@
 #include <future>
 #include <cmath>
 #include <random>
+#include <semaphore>
 
 // ================= TagLib Headers =================
 #include <taglib/tag.h>
@@ -54,6 +55,7 @@
 #include <taglib/apefile.h>
 #include <taglib/apetag.h>
 #include <taglib/unsynchronizedlyricsframe.h>
+#include <taglib/synchronizedlyricsframe.h>
 #ifdef TAGLIB_DSF_FILE_H
 #include <taglib/dsffile.h>
 #endif
@@ -0,0 +1,228 @@
+#ifndef PLAYBACKCLOCK_HPP
+#define PLAYBACKCLOCK_HPP
+
+#include "PCH.h"
+
+// 播放时钟的一个锚点：hostNs 时刻正在被听到的媒体位置，以及之后的推算方式
+struct ClockAnchor
+{
+    int64_t mediaUs = 0;   // hostNs 时刻扬声器输出的媒体位置 (已扣除设备输出延迟)
+    int64_t hostNs = 0;    // steady_clock 时间戳
+    int64_t limitUs = 0;   // 推算上限：已交给设备的数据末尾，回调停止 (断流 / 停止) 时时钟停在这里
+    int64_t latencyUs = 0; // 估计的设备输出延迟
+    double rate = 1.0;     // 每秒墙钟推进的媒体秒数 (播放速度 × 误差校正)
+    bool running = false;  // false：暂停 / 定位 / 停止，位置固定在 mediaUs
+
+    // 在 nowNs 时刻的插值位置
+    int64_t positionAt(int64_t nowNs) const
+    {
+        if (!running || nowNs <= hostNs)
+            return mediaUs;
+        const int64_t advanced = mediaUs + static_cast<int64_t>(static_cast<double>(nowNs - hostNs) * rate / 1000.0);
+        return std::min(advanced, limitUs);
+    }
+};
+
+// 延迟补偿、可插值的播放时钟
+// 写入方：设备回调在每次交出数据后 update()，控制线程在暂停 / 定位 / 换曲时 freeze() / reset()
+//         写入方之间用一个标志互斥，回调只尝试获取 (取不到就跳过本次，下一次回调再更新)，从不等待
+// 读取方：任意线程 read() / positionUs()，不加锁，可在每一帧刷新时调用；
+//         读取期间槽位全部被覆盖 (读取线程被长时间抢占) 时重新读取发布序号重试，最多 MAX_READ_ATTEMPTS 次 (wait-free)，
+//         仍失败则返回本线程上次读到的锚点；本线程从未读到过时返回停在最近发布位置的锚点，发布过锚点之后不会返回全零的锚点
+// 运行期间时钟连续且单调：新回调算出的位置与上一个锚点的推算值之差不直接跳变，而是通过微调 rate 逐渐消除
+class PlaybackClock
+{
+public:
+    static int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 设备回调：hostNs 时刻交给设备的数据从媒体位置 startUs 开始、播放时长 durationUs
+    // speed 为变速播放的速度 (每微秒输出对应的媒体时长)，durationUs / latencyUs 都是输出端的时长
+    // 返回 false 表示控制线程正在写入，本次跳过
+    bool update(int64_t startUs, int64_t durationUs, int64_t latencyUs, int64_t hostNs, double speed = 1.0)
+    {
+        if (m_writing.test_and_set(std::memory_order_acquire))
+            return false;
+
+        // 刚写入的数据要在设备缓冲区中的数据播完之后才会被听到
+        const int64_t heardUs = startUs - static_cast<int64_t>(static_cast<double>(latencyUs) * speed);
+        const int64_t predictedUs = m_last.positionAt(hostNs);
+        const int64_t errorUs = heardUs - predictedUs;
+
+        ClockAnchor anchor;
+        anchor.hostNs = hostNs;
+        anchor.latencyUs = latencyUs;
+        anchor.running = true;
+        if (!m_hasAnchor || std::abs(errorUs) > SNAP_US)
+        {
+            // 首次 / 不连续 (无缝切换到下一首等)：直接跳到新位置
+            anchor.mediaUs = heardUs;
+            anchor.rate = speed;
+        }
+        else
+        {
+            // 从推算位置继续，误差在约 SLEW_US 内通过速率消除
+            anchor.mediaUs = predictedUs;
+            anchor.rate = speed * (1.0 + std::clamp(static_cast<double>(errorUs) / SLEW_US, -MAX_SLEW, MAX_SLEW));
+        }
+        anchor.limitUs = std::max(startUs + static_cast<int64_t>(static_cast<double>(durationUs) * speed), anchor.mediaUs);
+        store(anchor);
+
+        m_writing.clear(std::memory_order_release);
+        return true;
+    }
+
+    // 控制线程：时钟停在当前位置 (暂停 / 设备停止)
+    void freeze()
+    {
+        lockWriter();
+        ClockAnchor anchor = m_last;
+        anchor.mediaUs = m_last.positionAt(nowNs());
+        anchor.hostNs = nowNs();
+        anchor.limitUs = anchor.mediaUs;
+        anchor.rate = 1.0;
+        anchor.running = false;
+        store(anchor);
+        m_writing.clear(std::memory_order_release);
+    }
+
+    // 控制线程：时钟停在 positionUs (定位 / 开始新曲目)，之后的第一个回调从这里继续
+    void reset(int64_t positionUs)
+    {
+        lockWriter();
+        ClockAnchor anchor;
+        anchor.mediaUs = positionUs;
+        anchor.hostNs = nowNs();
+        anchor.limitUs = positionUs;
+        anchor.latencyUs = m_last.latencyUs;
+        store(anchor);
+        m_writing.clear(std::memory_order_release);
+    }
+
+    // 任意线程：最近发布的锚点
+    ClockAnchor read() const
+    {
+        // 本线程上次读到的锚点 (按时钟实例区分)，所有候选槽位都读取失败时使用
+        thread_local const PlaybackClock *lastClock = nullptr;
+        thread_local ClockAnchor lastAnchor;
+
+        // 读取期间写入方覆盖了全部候选槽位时重新读取发布序号：写入方从不在槽位上循环
+        // (回调取不到写入标志就跳过)，重试几乎总能成功
+        for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt)
+        {
+            const uint64_t published = m_published.load(std::memory_order_acquire);
+            if (published == 0)
+                return ClockAnchor{};
+
+            ClockAnchor anchor;
+            if (readSlots(published, anchor))
+            {
+                lastClock = this;
+                lastAnchor = anchor;
+                return anchor;
+            }
+        }
+
+        if (lastClock == this)
+            return lastAnchor;
+        // 本线程第一次读取就失败：位置停在最近发布的锚点 (单个原子量，不会读到一半)，下一次读取再恢复插值
+        ClockAnchor anchor;
+        anchor.mediaUs = m_publishedMediaUs.load(std::memory_order_acquire);
+        anchor.limitUs = anchor.mediaUs;
+        anchor.hostNs = nowNs();
+        return anchor;
+    }
+
+    // 任意线程：当前时刻的插值位置 (微秒)
+    int64_t positionUs() const
+    {
+        return read().positionAt(nowNs());
+    }
+
+private:
+    static constexpr size_t SLOTS = 4;
+    static constexpr int MAX_READ_ATTEMPTS = 4;
+    // 超过该误差视为不连续，直接跳变
+    static constexpr int64_t SNAP_US = 250000;
+    // 误差消除的时间常数与最大速率偏差
+    static constexpr double SLEW_US = 500000.0;
+    static constexpr double MAX_SLEW = 0.1;
+
+    // 每个槽位带版本号：写入中为奇数，完成后为 2 × 发布序号
+    struct Slot
+    {
+        std::atomic<uint64_t> version{0};
+        std::atomic<int64_t> mediaUs{0};
+        std::atomic<int64_t> hostNs{0};
+        std::atomic<int64_t> limitUs{0};
+        std::atomic<int64_t> latencyUs{0};
+        std::atomic<double> rate{1.0};
+        std::atomic<bool> running{false};
+    };
+
+    // 从发布序号 published 往前尝试 SLOTS 个槽位，取到一个完整的槽位时返回 true
+    bool readSlots(uint64_t published, ClockAnchor &anchor) const
+    {
+        for (uint64_t k = 0; k < SLOTS && k < published; ++k)
+        {
+            const uint64_t index = published - k;
+            const Slot &slot = m_slots[index % SLOTS];
+            const uint64_t version = slot.version.load(std::memory_order_acquire);
+            if (version != index * 2)
+                continue;
+
+            anchor.mediaUs = slot.mediaUs.load(std::memory_order_relaxed);
+            anchor.hostNs = slot.hostNs.load(std::memory_order_relaxed);
+            anchor.limitUs = slot.limitUs.load(std::memory_order_relaxed);
+            anchor.latencyUs = slot.latencyUs.load(std::memory_order_relaxed);
+            anchor.rate = slot.rate.load(std::memory_order_relaxed);
+            anchor.running = slot.running.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.version.load(std::memory_order_relaxed) == version)
+                return true;
+        }
+        return false;
+    }
+
+    // 控制线程之间以及与回调之间的写入互斥 (回调持有的时间只有几十纳秒)
+    void lockWriter()
+    {
+        while (m_writing.test_and_set(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // 持有写入标志时调用
+    void store(const ClockAnchor &anchor)
+    {
+        const uint64_t index = m_published.load(std::memory_order_relaxed) + 1;
+        Slot &slot = m_slots[index % SLOTS];
+        slot.version.store(index * 2 - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.mediaUs.store(anchor.mediaUs, std::memory_order_relaxed);
+        slot.hostNs.store(anchor.hostNs, std::memory_order_relaxed);
+        slot.limitUs.store(anchor.limitUs, std::memory_order_relaxed);
+        slot.latencyUs.store(anchor.latencyUs, std::memory_order_relaxed);
+        slot.rate.store(anchor.rate, std::memory_order_relaxed);
+        slot.running.store(anchor.running, std::memory_order_relaxed);
+        slot.version.store(index * 2, std::memory_order_release);
+        m_publishedMediaUs.store(anchor.mediaUs, std::memory_order_release);
+        m_published.store(index, std::memory_order_release);
+
+        m_last = anchor;
+        m_hasAnchor = true;
+    }
+
+    Slot m_slots[SLOTS];
+    std::atomic<uint64_t> m_published{0};
+    std::atomic<int64_t> m_publishedMediaUs{0}; // 最近发布的锚点位置，槽位全部读取失败时的后备
+    std::atomic_flag m_writing = ATOMIC_FLAG_INIT;
+    // 仅持有写入标志时访问
+    ClockAnchor m_last;
+    bool m_hasAnchor = false;
+};
+
+#endif // PLAYBACKCLOCK_HPP
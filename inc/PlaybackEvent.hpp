@@ -0,0 +1,26 @@
+#ifndef PLAYBACKEVENT_HPP
+#define PLAYBACKEVENT_HPP
+
+#include "PCH.h"
+
+// 播放事件类型 (由 AudioPlayer 在音频实际播放到对应位置时产生)
+enum class PlaybackEventType : std::uint8_t
+{
+    TrackStarted,   // 新会话 (setPath / 格式变化切歌) 的第一个采样点开始播放，positionUs 为起点
+    TrackFinished,  // 最后一首的最后一个采样点已播放，且没有可接续的下一首
+    SeamlessSwitch, // 预加载曲目的第一个采样点开始播放 (无缝切换)，positionUs 为起点
+    TrackBoundary,  // 越过同一文件内的分轨边界 (CUE)，positionUs 为边界时间
+    SeekCompleted,  // 解码器已定位到 positionUs，新位置的数据开始写入缓冲区
+    Underrun,       // 回调取不到足够数据 (播放中断)，value 为缺少的帧数
+    DeviceLost,     // 音频设备意外停止 (断开 / 被系统回收)
+};
+
+// 播放事件：保持可平凡复制，便于通过无锁队列在实时线程中传递
+struct PlaybackEvent
+{
+    PlaybackEventType type = PlaybackEventType::TrackStarted;
+    int64_t positionUs = 0; // 事件对应的文件内时间 (微秒)
+    int64_t value = 0;      // 附加数值 (依事件类型而定)
+};
+
+#endif // PLAYBACKEVENT_HPP
@@ -0,0 +1,136 @@
+#ifndef PLAYBACKSTATS_HPP
+#define PLAYBACKSTATS_HPP
+
+#include "PCH.h"
+#include <bit>
+
+// 耗时直方图的快照 (微秒)
+struct LatencySnapshot
+{
+    // 第 i 个桶统计 [2^(i-1), 2^i) 微秒的样本 (第 0 个桶为 0 微秒，最后一个桶包含所有更大的值)
+    static constexpr size_t BUCKETS = 24;
+
+    std::array<uint64_t, BUCKETS> buckets{};
+    uint64_t count = 0;
+    uint64_t totalUs = 0;
+    uint64_t maxUs = 0;
+
+    double meanUs() const
+    {
+        return count ? static_cast<double>(totalUs) / static_cast<double>(count) : 0.0;
+    }
+    // 百分位数 (按桶上界估计，p 取 0~1)
+    uint64_t percentileUs(double p) const;
+};
+
+// 按 2 的幂分桶的耗时直方图：单线程写入 (实时线程可用，无锁无分配)，任意线程读取快照
+class LatencyHistogram
+{
+public:
+    void record(uint64_t us) noexcept
+    {
+        size_t bucket = std::min<size_t>(std::bit_width(us), LatencySnapshot::BUCKETS - 1);
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_totalUs.fetch_add(us, std::memory_order_relaxed);
+        if (us > m_maxUs.load(std::memory_order_relaxed))
+        {
+            m_maxUs.store(us, std::memory_order_relaxed);
+        }
+    }
+
+    LatencySnapshot snapshot() const
+    {
+        LatencySnapshot snap;
+        for (size_t i = 0; i < LatencySnapshot::BUCKETS; ++i)
+        {
+            snap.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        }
+        snap.count = m_count.load(std::memory_order_relaxed);
+        snap.totalUs = m_totalUs.load(std::memory_order_relaxed);
+        snap.maxUs = m_maxUs.load(std::memory_order_relaxed);
+        return snap;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, LatencySnapshot::BUCKETS> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_totalUs{0};
+    std::atomic<uint64_t> m_maxUs{0};
+};
+
+// 作用域计时：析构时把经过的时间记入直方图
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyHistogram &histogram) noexcept
+        : m_histogram(histogram), m_start(std::chrono::steady_clock::now())
+    {
+    }
+    ~ScopedLatency()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    ScopedLatency(const ScopedLatency &) = delete;
+    ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+private:
+    LatencyHistogram &m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// DSP 处理链中单个处理级的统计
+struct DspStageStats
+{
+    int id = 0;
+    std::string name;
+    bool bypassed = false;
+    LatencySnapshot blockUs; // 每块的处理耗时
+    double load = 0.0;       // 处理耗时 / 音频时长 (单核占用比例)
+    double workerLoad = 0.0; // 处理级自带工作线程的耗时 / 音频时长
+};
+
+// 播放引擎统计的快照 (getStats 返回)，自播放器创建起累计
+struct PlaybackStats
+{
+    // 断流：次数 (正常 -> 缺数据的跳变) 与回调中实际补静音的总时长
+    uint64_t underrunCount = 0;
+    double underrunMs = 0.0;
+
+    // 设备回调：执行耗时与截止时间 (一个周期的时长)，超过截止时间的次数
+    uint64_t callbackCount = 0;
+    uint64_t deadlineMisses = 0;
+    double callbackDeadlineUs = 0.0; // 最近一次回调的周期
+    LatencySnapshot callbackUs;
+
+    // 缓冲区中已解码、等待播放的音频
+    double bufferedMs = 0.0;
+    double bufferTargetMs = 0.0;
+    // 估计的设备输出延迟 (播放时钟据此补偿)
+    double outputLatencyMs = 0.0;
+
+    // 解码线程：每个数据包的解码耗时，每帧的重采样 (swr) 耗时
+    LatencySnapshot decodeUs;
+    LatencySnapshot swrUs;
+
+    // Direct 模式：设备是否原样接受格式，最近一帧是否绕过 swr 直接复制，
+    // bitPerfect 另外要求音量为 100% (否则 miniaudio 仍会缩放样本)
+    bool deviceNative = false;
+    bool directCopy = false;
+    bool bitPerfect = false;
+    uint64_t directCopyFrames = 0;
+    // 逐位校验 (开启时)：本次会话已校验的帧数、不一致的次数、已输出 PCM 的 CRC32
+    uint64_t verifiedFrames = 0;
+    uint64_t checksumMismatches = 0;
+    uint32_t outputCrc = 0;
+
+    // Mixing 模式 DSP 处理链 (按处理顺序)
+    std::vector<DspStageStats> dspStages;
+
+    // 单行摘要 (终端与日志使用)
+    std::string summary() const;
+};
+
+#endif // PLAYBACKSTATS_HPP
@@ -0,0 +1,57 @@
+#ifndef RENDERWRITER_HPP
+#define RENDERWRITER_HPP
+
+#include "AudioKernels.hpp"
+#include "PCH.h"
+
+// 离线渲染的输出目标
+enum class RenderSink : std::uint8_t
+{
+    Wav,     // RIFF/WAVE (超过 2 声道或 16 位时写 WAVE_FORMAT_EXTENSIBLE)
+    Raw,     // 交错的裸 PCM (小端)，格式与设备格式相同
+    Discard, // 只计数不写出 (测量解码 + 重采样吞吐)
+};
+
+// 把交错 PCM 写入文件；WAV 的长度字段在 close 时回填
+class RenderWriter
+{
+public:
+    RenderWriter() = default;
+    ~RenderWriter();
+
+    RenderWriter(const RenderWriter &) = delete;
+    RenderWriter &operator=(const RenderWriter &) = delete;
+
+    /**
+     * @brief 打开输出
+     * @param channelMask WAV 声道掩码 (与 FFmpeg 原生声道顺序的位定义相同)，0 表示按声道数取默认值
+     * @return 文件无法创建或格式不支持时返回 false
+     */
+    bool open(RenderSink sink, const std::string &path, AudioKernels::PcmFormat format, int channels, int sampleRate, uint64_t channelMask = 0);
+    bool write(const uint8_t *data, size_t bytes);
+    // 回填 WAV 头并关闭文件 (Discard 时只重置状态)
+    bool close();
+
+    bool isOpen() const
+    {
+        return m_open;
+    }
+    uint64_t dataBytes() const
+    {
+        return m_dataBytes;
+    }
+
+private:
+    std::vector<uint8_t> buildWavHeader(uint64_t dataBytes) const;
+
+    RenderSink m_sink = RenderSink::Discard;
+    std::ofstream m_file;
+    bool m_open = false;
+    AudioKernels::PcmFormat m_format = AudioKernels::PcmFormat::Unknown;
+    int m_channels = 0;
+    int m_sampleRate = 0;
+    uint64_t m_channelMask = 0;
+    uint64_t m_dataBytes = 0;
+};
+
+#endif // RENDERWRITER_HPP
@@ -0,0 +1,30 @@
+#ifndef RESAMPLER_HPP
+#define RESAMPLER_HPP
+
+#include "PCH.h"
+
+// 重采样器质量 (CPU 开销依次增加)
+// 输入输出采样率相同时总是直通 (不建立重采样滤波器，只做格式与声道转换)，与此设置无关
+enum class ResamplerQuality : std::uint8_t
+{
+    Fast,    // 短滤波器 + 相位间线性插值
+    Default, // swr 默认参数
+    High,    // soxr (FFmpeg 编译时启用时)，否则为长滤波器的 swr 多相滤波
+};
+
+namespace Resampler
+{
+/**
+ * @brief 创建并初始化 swr 上下文
+ * High 优先使用 soxr 引擎，不可用时自动退回 swr 高质量参数
+ * @return 失败时返回 nullptr
+ */
+SwrContext *create(const AVChannelLayout &inLayout, int inRate, AVSampleFormat inFormat,
+                   const AVChannelLayout &outLayout, int outRate, AVSampleFormat outFormat,
+                   ResamplerQuality quality);
+
+// 实际使用的引擎描述 (日志 / 基准输出)
+const char *describe(ResamplerQuality quality, bool passthrough);
+} // namespace Resampler
+
+#endif // RESAMPLER_HPP
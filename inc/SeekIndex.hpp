@@ -0,0 +1,62 @@
+#ifndef SEEKINDEX_HPP
+#define SEEKINDEX_HPP
+
+#include "PCH.h"
+
+// 文件级 seek 索引：时间 -> 数据包字节偏移
+struct SeekPoint
+{
+    int64_t ptsUs = 0;   // 该数据包第一个采样的时间 (微秒)
+    int64_t bytePos = 0; // 数据包在文件中的字节偏移
+};
+
+// seek 索引缓存 (单例)
+// 第一次播放某个文件时在后台只解复用不解码地扫描一遍，按固定间隔记录索引点，
+// 结果保存在内存中并持久化到缓存目录 (以路径 + 修改时间为键)，之后直接读取
+class SeekIndexCache
+{
+public:
+    static SeekIndexCache &instance()
+    {
+        static SeekIndexCache cache;
+        return cache;
+    }
+
+    SeekIndexCache(const SeekIndexCache &) = delete;
+    SeekIndexCache &operator=(const SeekIndexCache &) = delete;
+
+    // 后台建立索引 (已在内存 / 磁盘中或正在建立时直接返回)
+    void requestBuild(const std::string &path);
+
+    // 查找不晚于 targetUs 的最近索引点；索引尚未就绪时返回 false
+    bool lookup(const std::string &path, int64_t targetUs, SeekPoint &point);
+
+    // 中止所有后台扫描 (程序退出时调用，避免线程池等待整文件扫描)
+    void cancelPending();
+
+private:
+    SeekIndexCache() = default;
+
+    using PointList = std::vector<SeekPoint>;
+
+    struct Entry
+    {
+        int64_t mtime = 0;
+        std::shared_ptr<const PointList> points;
+    };
+
+    static int64_t fileMtime(const std::string &path);
+    static fs::path cacheFileFor(const std::string &path);
+    std::shared_ptr<const PointList> scanFile(const std::string &path) const;
+    static std::shared_ptr<const PointList> loadFromDisk(const std::string &path, int64_t mtime);
+    static void saveToDisk(const std::string &path, int64_t mtime, const PointList &points);
+    void insert(const std::string &path, Entry entry);
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_indexes;
+    std::deque<std::string> m_order; // 插入顺序，超出容量时淘汰最早的
+    std::unordered_set<std::string> m_pending;
+    std::atomic<bool> m_cancelled{false};
+};
+
+#endif // SEEKINDEX_HPP
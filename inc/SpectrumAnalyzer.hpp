@@ -0,0 +1,107 @@
+#ifndef SPECTRUMANALYZER_HPP
+#define SPECTRUMANALYZER_HPP
+
+#include "AudioKernels.hpp"
+#include "TripleBuffer.hpp"
+
+extern "C"
+{
+#include <libavutil/tx.h>
+}
+
+// 一帧显示数据：电平与频谱都已映射到 [0, 1] (0 为 FLOOR_DB 及以下，1 为 0 dBFS)，全零即静音
+struct SpectrumFrame
+{
+    static constexpr size_t BANDS = 64;
+    static constexpr int MAX_CHANNELS = 8;
+    static constexpr float FLOOR_DB = -72.0f;
+
+    std::array<float, BANDS> bands{};      // 20 Hz – 20 kHz 对数间隔
+    std::array<float, MAX_CHANNELS> peak{}; // 每通道峰值
+    std::array<float, MAX_CHANNELS> rms{};  // 每通道均方根
+    int channels = 0;
+};
+
+// 输出端的频谱 / 电平表
+// 回调线程在输出格式转换之后把设备格式的数据写入自己独占的历史窗口 (write)，
+// 只有工作线程提出请求时才把最近 WINDOW_FRAMES 帧整理成快照经三缓冲交出，回调线程从不等待。
+// 工作线程由显示端驱动：界面每读取一帧 (read) 就唤醒它计算下一帧，计算量与刷新率成正比；
+// 关闭 (窗口隐藏) 时工作线程退出，回调线程只剩一次原子读取
+class SpectrumAnalyzer
+{
+public:
+    static constexpr size_t WINDOW_FRAMES = 4096; // FFT 长度
+
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer();
+    SpectrumAnalyzer(const SpectrumAnalyzer &) = delete;
+    SpectrumAnalyzer &operator=(const SpectrumAnalyzer &) = delete;
+
+    // 设备格式改变时调用 (回调线程未运行)；通道数超过 MAX_CHANNELS 或格式未知时不采集
+    void configure(AudioKernels::PcmFormat format, int channels, int sampleRate);
+    // 回调线程：追加刚送往设备的数据 (整数帧)
+    void write(const uint8_t *data, size_t bytes);
+
+    // 控制线程：开启时启动工作线程，关闭时停止并清空显示数据
+    void setEnabled(bool enabled);
+    bool isEnabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+    // 显示线程：取最新一帧，并请求计算下一帧 (结果比调用晚一次刷新)
+    void read(SpectrumFrame &out);
+
+private:
+    struct Snapshot
+    {
+        static constexpr size_t MAX_BYTES = WINDOW_FRAMES * SpectrumFrame::MAX_CHANNELS * sizeof(double);
+
+        std::array<uint8_t, MAX_BYTES> data;
+        size_t frames = 0;
+        AudioKernels::PcmFormat format = AudioKernels::PcmFormat::Unknown;
+        int channels = 0;
+        int sampleRate = 0;
+    };
+
+    void workerLoop();
+    // 快照 -> 电平与频谱 (dB)，结果写入 m_peakDb / m_rmsDb / m_bandsDb
+    void analyze(const Snapshot &snapshot);
+    void prepareBands(int sampleRate);
+
+    // 回调线程独占 (configure 时回调线程未运行)
+    std::vector<uint8_t> m_history; // WINDOW_FRAMES 帧的循环窗口
+    size_t m_historyPos = 0;        // 下一次写入的字节位置
+    size_t m_historyFill = 0;       // 有效字节数
+    size_t m_frameBytes = 0;
+    AudioKernels::PcmFormat m_format = AudioKernels::PcmFormat::Unknown;
+    int m_channels = 0;
+    int m_sampleRate = 0;
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<bool> m_snapshotRequested{false};
+    std::unique_ptr<TripleBuffer<Snapshot>> m_snapshots; // 回调线程 -> 工作线程
+    TripleBuffer<SpectrumFrame> m_frames;                 // 工作线程 -> 显示线程
+
+    // 工作线程
+    std::mutex m_controlMutex; // 串行化 setEnabled
+    std::thread m_worker;
+    std::atomic<bool> m_stop{false};
+    std::atomic<uint64_t> m_demand{0}; // 显示端每读取一次加一
+    AVTXContext *m_tx = nullptr;
+    av_tx_fn m_txFn = nullptr;
+    std::vector<float> m_window; // Hann 窗
+    std::vector<float> m_planar; // [通道][WINDOW_FRAMES]
+    std::vector<float> m_time;   // 加窗后的单声道混合
+    std::vector<AVComplexFloat> m_bins;
+    std::vector<float> m_bandEdges; // BANDS + 1 个边界 (以频点为单位)
+    int m_bandRate = 0;
+    std::array<float, SpectrumFrame::BANDS> m_bandsDb{};
+    std::array<float, SpectrumFrame::MAX_CHANNELS> m_peakDb{};
+    std::array<float, SpectrumFrame::MAX_CHANNELS> m_rmsDb{};
+    int m_analyzedChannels = 0;
+    SpectrumFrame m_display; // 带回落的显示值
+    std::chrono::steady_clock::time_point m_lastFrame;
+    std::chrono::steady_clock::time_point m_lastSnapshot;
+};
+
+#endif // SPECTRUMANALYZER_HPP
@@ -0,0 +1,78 @@
+#ifndef TEMPOFILTER_HPP
+#define TEMPOFILTER_HPP
+
+#include "PCH.h"
+#include <deque>
+#include <limits>
+
+struct AVFilterGraph;
+struct AVFilterContext;
+
+// 变速不变调：abuffer -> atempo -> aformat -> abuffersink 的进程内滤镜图 (每个音源一个)
+// 输出的采样格式 / 采样率 / 声道布局与输入相同，之后的 swr、Direct 复制路径都不受影响。
+// 改变速度只向 atempo 发送 tempo 命令，不重建滤镜图；命令在滤镜图取空之后才发送，
+// 保证每个输出帧都按实际生成它的速度换算。输出帧的媒体时间由本类按送入的输入段 (PTS + 采样数) 反推
+// (atempo 给出的 PTS 是压缩 / 拉伸之后的时间，不能直接用于进度、分轨边界与定位)
+class TempoFilter
+{
+public:
+    static constexpr double MIN_SPEED = 0.5;
+    static constexpr double MAX_SPEED = 2.0;
+
+    TempoFilter() = default;
+    ~TempoFilter();
+    TempoFilter(const TempoFilter &) = delete;
+    TempoFilter &operator=(const TempoFilter &) = delete;
+
+    // 按 frame 的格式建立滤镜图
+    bool open(const AVFrame *frame, double speed);
+    // 释放滤镜图 (定位 / 结束后丢弃内部缓存的样本)
+    void close();
+    bool isOpen() const
+    {
+        return m_graph != nullptr;
+    }
+
+    // 运行中改变速度：已送入的样本按原速度输出完 (receive 取空) 后生效
+    bool setSpeed(double speed);
+    // 当前输出帧所用的速度
+    double speed() const
+    {
+        return m_speed;
+    }
+
+    // 送入 frame 中从 input 开始的 samples 个采样 (裁剪后的平面指针，引用 frame 的数据，不复制)
+    // ptsUs 为第一个采样的媒体时间；frame 为 nullptr 表示输入结束，之后只能 receive 取完剩余输出再 close
+    bool send(const AVFrame *frame, const uint8_t **input, int samples, int64_t ptsUs);
+    // 取出下一帧输出 (在下一次 receive / close 之前有效)，没有时返回 nullptr；ptsUs 为该帧第一个采样的媒体时间
+    AVFrame *receive(int64_t &ptsUs);
+
+private:
+    // 一段送入的输入：第一个采样的媒体时间与采样数
+    struct InputSpan
+    {
+        int64_t ptsUs = 0;
+        int64_t samples = 0;
+    };
+
+    // 取空之后把等待中的速度发给 atempo
+    void applyPendingSpeed();
+    // 输入位置 (相对 m_inputs 第一段的起点，单位为输入采样) 对应的媒体时间
+    int64_t mediaTimeAt(double position) const;
+
+    AVFilterGraph *m_graph = nullptr;
+    AVFilterContext *m_source = nullptr;
+    AVFilterContext *m_sink = nullptr;
+    AVFrame *m_input = nullptr;
+    AVFrame *m_output = nullptr;
+    double m_speed = 1.0;        // atempo 当前使用的速度
+    double m_pendingSpeed = 1.0; // 请求的速度，滤镜图取空后生效
+    int m_sampleRate = 0;
+    // 尚未完全输出的输入段；m_position 为下一个输出采样在其中的输入位置 (浮点累计避免取整误差)
+    std::deque<InputSpan> m_inputs;
+    double m_position = 0.0;
+    // 已完全输出的最后一段的结束时间 (atempo 冲刷时输出可能略超过送入的样本)；还没有时为 NaN
+    double m_tailUs = std::numeric_limits<double>::quiet_NaN();
+};
+
+#endif // TEMPOFILTER_HPP
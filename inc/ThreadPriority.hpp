@@ -0,0 +1,41 @@
+#ifndef THREADPRIORITY_HPP
+#define THREADPRIORITY_HPP
+
+#include "PCH.h"
+
+// 实时模式的实际生效情况 (请求不一定被系统批准)
+struct RealtimeStatus
+{
+    bool requested = false;        // 是否请求了实时模式
+    bool realtimeGranted = false;  // 解码线程是否获得了实时调度
+    std::string method = "none";   // 实际采用的方式 (SCHED_FIFO / rtkit / nice / TIME_CRITICAL / none)
+    bool pinned = false;           // 解码线程是否已绑定到指定核心
+    bool memoryLocked = false;     // PCM 缓冲区是否已预先缺页并锁定在物理内存中
+};
+
+// 调用线程的调度优先级、CPU 亲和性与内存锁定 (平台相关实现集中在此)
+namespace ThreadPriority
+{
+/**
+ * @brief 把调用线程提升为实时调度
+ * Linux 依次尝试 SCHED_FIFO、rtkit (D-Bus)，都失败时退回 nice -10；Windows 使用 TIME_CRITICAL
+ * @param method 输出实际采用的方式
+ * @return 是否获得了实时调度 (退回 nice 时返回 false)
+ */
+bool promoteToRealtime(std::string &method);
+
+// 恢复为普通调度
+void resetToNormal();
+
+// 降为空闲优先级 (后台分析任务)
+void lowerToIdle();
+
+// 绑定到指定核心；core < 0 时恢复为可在所有核心上运行
+bool pinToCore(int core);
+
+// 预先触发缺页并把内存锁定在物理内存中 (不改变内容)
+bool lockMemory(void *data, size_t bytes);
+void unlockMemory(void *data, size_t bytes);
+} // namespace ThreadPriority
+
+#endif // THREADPRIORITY_HPP
@@ -0,0 +1,61 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include "PCH.h"
+
+// 单写入方/单读取方的三缓冲：写入方与读取方都不会等待对方 (wait-free)，也不分配内存
+// 写入方总是写在自己独占的 back 槽位，publish() 与中间槽位交换；读取方 update() 时若中间槽位有新数据则与 front 交换
+// 读取方只看到最新发布的值 (中间未被读取的旧值被直接覆盖)，适合参数 / 显示数据这类 "只关心最新" 的传递
+template <typename T>
+class TripleBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "TripleBuffer slots are copied without allocation");
+
+public:
+    // 写入方：直接在 back 槽位中填写 (大块数据避免多一次拷贝)，填完后 publish()
+    T &back()
+    {
+        return m_slots[m_back].value;
+    }
+    void publish()
+    {
+        const uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | DIRTY), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+    void write(const T &value)
+    {
+        back() = value;
+        publish();
+    }
+
+    // 读取方：有新发布的数据时切换到它并返回 true
+    bool update()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & DIRTY))
+            return false;
+        const uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+    // 读取方：最近一次 update() 得到的值
+    const T &front() const
+    {
+        return m_slots[m_front].value;
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t DIRTY = 0x4;
+
+    struct alignas(64) Slot
+    {
+        T value{};
+    };
+
+    std::array<Slot, 3> m_slots{};
+    std::atomic<uint8_t> m_middle{1}; // 中间槽位下标 | DIRTY (有未读取的新数据)
+    uint8_t m_back = 0;               // 仅写入方访问
+    uint8_t m_front = 2;              // 仅读取方访问
+};
+
+#endif // TRIPLEBUFFER_HPP
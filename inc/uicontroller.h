@@ -2,6 +2,7 @@
 #define UICONTROLLER_H
 
 
+#include "Lyrics.hpp"
 #include "MediaController.hpp"
 
 class UIController : public QObject
@@ -30,6 +31,26 @@ class UIController : public QObject
     Q_PROPERTY(QVariantList waveformHeights READ waveformHeights NOTIFY waveformHeightsChanged FINAL);
     Q_PROPERTY(int waveformBarWidth READ waveformBarWidth NOTIFY waveformHeightsChanged FINAL);
     Q_PROPERTY(int outputMode READ outputMode WRITE setOutputMode NOTIFY outputModeChanged FINAL);
+    Q_PROPERTY(int crossfadeMs READ crossfadeMs WRITE setCrossfadeMs NOTIFY crossfadeMsChanged FINAL);
+    Q_PROPERTY(int ditherMode READ ditherMode WRITE setDitherMode NOTIFY ditherModeChanged FINAL);
+    Q_PROPERTY(int normalizationMode READ normalizationMode WRITE setNormalizationMode NOTIFY normalizationModeChanged FINAL);
+    Q_PROPERTY(int latencyProfile READ latencyProfile WRITE setLatencyProfile NOTIFY latencyProfileChanged FINAL);
+    Q_PROPERTY(int devicePeriodMs READ devicePeriodMs WRITE setDevicePeriodMs NOTIFY devicePeriodMsChanged FINAL);
+    Q_PROPERTY(int resamplerQuality READ resamplerQuality WRITE setResamplerQuality NOTIFY resamplerQualityChanged FINAL);
+    Q_PROPERTY(int decodeAheadMode READ decodeAheadMode WRITE setDecodeAheadMode NOTIFY decodeAheadModeChanged FINAL);
+    Q_PROPERTY(bool realtimeMode READ realtimeMode WRITE setRealtimeMode NOTIFY realtimeModeChanged FINAL);
+    Q_PROPERTY(QString realtimeStatus READ realtimeStatus NOTIFY realtimeStatusChanged FINAL);
+    Q_PROPERTY(bool eqEnabled READ eqEnabled WRITE setEqEnabled NOTIFY eqEnabledChanged FINAL);
+    Q_PROPERTY(int eqPreset READ eqPreset WRITE setEqPreset NOTIFY eqPresetChanged FINAL);
+    Q_PROPERTY(QStringList eqPresetNames READ eqPresetNames CONSTANT FINAL);
+    Q_PROPERTY(QVariantList eqFrequencies READ eqFrequencies CONSTANT FINAL);
+    Q_PROPERTY(QVariantList eqGains READ eqGains NOTIFY eqGainsChanged FINAL);
+    Q_PROPERTY(QString convolverImpulse READ convolverImpulse NOTIFY convolverImpulseChanged FINAL);
+    Q_PROPERTY(double playbackSpeed READ playbackSpeed WRITE setPlaybackSpeed NOTIFY playbackSpeedChanged FINAL);
+    Q_PROPERTY(bool spectrumEnabled READ spectrumEnabled WRITE setSpectrumEnabled NOTIFY spectrumEnabledChanged FINAL);
+    Q_PROPERTY(QStringList lyrics READ lyrics NOTIFY lyricsChanged FINAL);
+    Q_PROPERTY(bool lyricsSynced READ lyricsSynced NOTIFY lyricsChanged FINAL);
+    Q_PROPERTY(int lyricsLine READ lyricsLine NOTIFY lyricsLineChanged FINAL);
 
 public:
     explicit UIController(QObject *parent = nullptr);
@@ -72,6 +93,35 @@ public:
         return m_waveformBarWidth;
     }
     int outputMode() const;
+    int crossfadeMs() const;
+    int ditherMode() const;
+    int normalizationMode() const;
+    int latencyProfile() const;
+    int devicePeriodMs() const;
+    int resamplerQuality() const;
+    int decodeAheadMode() const;
+    bool realtimeMode() const;
+    QString realtimeStatus() const;
+    bool eqEnabled() const;
+    int eqPreset() const;
+    QStringList eqPresetNames() const;
+    QVariantList eqFrequencies() const;
+    QVariantList eqGains() const;
+    QString convolverImpulse() const;
+    double playbackSpeed() const;
+    bool spectrumEnabled() const;
+    QStringList lyrics() const
+    {
+        return m_lyricsLines;
+    }
+    bool lyricsSynced() const
+    {
+        return m_lyrics.synced();
+    }
+    int lyricsLine() const
+    {
+        return m_lyricsLine;
+    }
 
 
     // [修改] 应用混音参数 (QML 调用)
@@ -81,6 +131,17 @@ public:
     // 返回 Map: { "sampleRate": int, "formatIndex": int }
     Q_INVOKABLE QVariantMap getCurrentDeviceParams();
 
+    // 调整单个均衡频段 (dB)，预设随之变为自定义 (-1)
+    Q_INVOKABLE void setEqGain(int band, double gainDb);
+    // FIR 卷积：加载脉冲响应文件 (WAV 等)，失败时返回 false 并保留原来的设置；空路径表示移除
+    Q_INVOKABLE bool setConvolverImpulse(const QString &path);
+
+    // 播放时钟的插值位置 (延迟补偿，无锁读取)，供进度条等在每帧刷新时调用
+    Q_INVOKABLE qint64 clockPosMicrosec();
+    // 频谱 / 电平表的最新一帧 (每次刷新调用一次，同时请求计算下一帧)，取值均为 [0, 1]：
+    // [左峰值, 右峰值, 左均方根, 右均方根, 64 个频带 (20 Hz – 20 kHz)]，单声道时左右相同
+    Q_INVOKABLE QList<float> spectrumFrame();
+
     void prepareForQuit();
 
 signals:
@@ -103,6 +164,23 @@ signals:
     void repeatModeChanged();
     void waveformHeightsChanged();
     void outputModeChanged();
+    void crossfadeMsChanged();
+    void ditherModeChanged();
+    void normalizationModeChanged();
+    void latencyProfileChanged();
+    void devicePeriodMsChanged();
+    void resamplerQualityChanged();
+    void decodeAheadModeChanged();
+    void realtimeModeChanged();
+    void realtimeStatusChanged();
+    void eqEnabledChanged();
+    void eqPresetChanged();
+    void eqGainsChanged();
+    void convolverImpulseChanged();
+    void playbackSpeedChanged();
+    void spectrumEnabledChanged();
+    void lyricsChanged();
+    void lyricsLineChanged();
     void mixingParamsApplied(int actualSampleRate, int actualFormatIndex);
 
 public slots:
@@ -116,7 +194,20 @@ public slots:
     void setShuffle(bool newShuffle);
     Q_INVOKABLE void toggleRepeatMode();
     void setOutputMode(int mode);
+    void setCrossfadeMs(int milliseconds);
+    void setDitherMode(int mode);
+    void setNormalizationMode(int mode);
+    void setLatencyProfile(int profile);
+    void setDevicePeriodMs(int milliseconds);
+    void setResamplerQuality(int quality);
+    void setDecodeAheadMode(int mode);
+    void setRealtimeMode(bool enabled);
+    void setEqEnabled(bool enabled);
+    void setEqPreset(int preset);
+    void setPlaybackSpeed(double speed);
+    void setSpectrumEnabled(bool enabled);
     void onWaveformCalculationFinished();
+    void onLyricsLoaded();
 
 private:
     MediaController &m_mediaController;
@@ -133,10 +224,13 @@ private:
     void checkAndUpdateShuffleState();
     void checkAndUpdateRepeatModeState();
     void checkAndUpdateOutputMode();
+    void checkAndUpdateRealtimeStatus();
     void generateWaveformForNode(PlaylistNode *node);
+    void loadLyricsForNode(PlaylistNode *node);
+    void checkAndUpdateLyricsLine();
 
     AVSampleFormat indexToAvFormat(int index);
-    int avFormatToIndex(AVSampleFormat fmt);
+    int avFormatToIndex(AVSampleFormat fmt, bool packed24 = false);
 
     QString m_coverArtSource;
     PlaylistNode *m_lastPlayingNode = nullptr;
@@ -158,6 +252,8 @@ private:
     qint64 m_lastSeekRequestTime = 0;
     int m_repeatMode = 0;
     int m_outputMode = 0;
+    QString m_realtimeStatus;
+    int m_eqPreset = 0; // EqualizerStage::presets() 的下标，-1 为自定义
     QVariantList m_waveformHeights;
     int m_waveformBarWidth = 4;
 
@@ -170,6 +266,19 @@ private:
     };
     QFutureWatcher<AsyncWaveformResult> m_waveformWatcher;
     quint64 m_currentWaveformGeneration = 0;
+
+    // 歌词：切换曲目时在后台加载，当前行由播放时钟二分查找
+    struct AsyncLyricsResult
+    {
+        quint64 generationId;
+        Lyrics lyrics;
+    };
+    QFutureWatcher<AsyncLyricsResult> m_lyricsWatcher;
+    quint64 m_currentLyricsGeneration = 0;
+    Lyrics m_lyrics;
+    QStringList m_lyricsLines;
+    int m_lyricsLine = -1;
+    QTimer m_lyricsTimer; // 单次触发：下一行开始时刷新当前行
 };
 
 #endif // UICONTROLLER_H
\ No newline at end of file
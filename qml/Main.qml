@@ -134,6 +134,10 @@ ApplicationWindow {
         id: outputSettingsWin
     }
 
+    SpectrumWindow {
+        id: spectrumWin
+    }
+
     // =========================================================================
     // 圆角实现核心：Mask + Layer
     // =========================================================================
@@ -301,6 +305,44 @@ ApplicationWindow {
                         anchors.centerIn: parent
                     }
                 }
+                Rectangle {
+                    width: 162
+                    height: 40
+                    color: spectrumMouse.containsMouse ? "#50FFFFFF" : "transparent"
+                    radius: 4
+                    RowLayout {
+                        anchors.fill: parent
+                        anchors.leftMargin: 10
+                        anchors.rightMargin: 10
+                        spacing: 12
+                        Text {
+                            text: "equalizer"
+                            font.family: materialFont.name
+                            color: "white"
+                            font.pixelSize: 18
+                            verticalAlignment: Text.AlignVCenter
+                            Layout.fillHeight: true
+                        }
+                        Text {
+                            text: "频谱"
+                            color: "white"
+                            font.pixelSize: 14
+                            Layout.fillWidth: true
+                            verticalAlignment: Text.AlignVCenter
+                            Layout.fillHeight: true
+                        }
+                    }
+                    MouseArea {
+                        id: spectrumMouse
+                        anchors.fill: parent
+                        hoverEnabled: true
+                        onClicked: {
+                            mainMenu.close();
+                            spectrumWin.show();
+                            spectrumWin.raise();
+                        }
+                    }
+                }
                 Rectangle {
                     width: 162
                     height: 40
@@ -601,6 +643,15 @@ ApplicationWindow {
                     Layout.preferredWidth: 1
                 }
 
+                // 播放中每帧从播放时钟取插值位置，暂停 / 拖动时使用定时刷新的位置
+                FrameAnimation {
+                    id: clockAnimation
+                    property real posMicrosec: 0
+                    running: playerController.isPlaying && !playerController.isSeeking && window.visible
+                    onRunningChanged: if (running) posMicrosec = playerController.clockPosMicrosec()
+                    onTriggered: posMicrosec = playerController.clockPosMicrosec()
+                }
+
                 // 2. 波形
                 WaveformProgressBar {
                     id: waveProgress
@@ -609,7 +660,7 @@ ApplicationWindow {
                     Layout.preferredHeight: 60
                     waveformHeights: playerController.waveformHeights
                     barWidth: playerController.waveformBarWidth
-                    progress: playerController.totalDurationMicrosec > 0 ? (playerController.currentPosMicrosec / playerController.totalDurationMicrosec) : 0
+                    progress: playerController.totalDurationMicrosec > 0 ? ((clockAnimation.running ? clockAnimation.posMicrosec : playerController.currentPosMicrosec) / playerController.totalDurationMicrosec) : 0
                     onSeekRequested: function (pos) {
                         playerController.isSeeking = true;
                         var targetTime = pos * playerController.totalDurationMicrosec;
@@ -693,6 +744,33 @@ ApplicationWindow {
                     }
                 }
 
+                // 同步歌词：当前行 + 下一行
+                Column {
+                    Layout.alignment: Qt.AlignHCenter
+                    Layout.fillWidth: true
+                    Layout.maximumWidth: 1000
+                    Layout.topMargin: 10
+                    spacing: 4
+                    visible: playerController.lyricsSynced
+                    property int line: playerController.lyricsLine
+                    Text {
+                        width: parent.width
+                        text: parent.line >= 0 ? playerController.lyrics[parent.line] : ""
+                        color: "white"
+                        font.pixelSize: 16
+                        elide: Text.ElideRight
+                        horizontalAlignment: Text.AlignHCenter
+                    }
+                    Text {
+                        width: parent.width
+                        text: parent.line + 1 < playerController.lyrics.length ? playerController.lyrics[parent.line + 1] : ""
+                        color: "#99FFFFFF"
+                        font.pixelSize: 13
+                        elide: Text.ElideRight
+                        horizontalAlignment: Text.AlignHCenter
+                    }
+                }
+
                 Item {
                     Layout.preferredHeight: 15
                     Layout.preferredWidth: 1
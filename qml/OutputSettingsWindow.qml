@@ -1,12 +1,13 @@
 import QtQuick
 import QtQuick.Controls
+import QtQuick.Dialogs
 import QtQuick.Layouts
 import QtQuick.Window
 
 Window {
     id: settingsWin
     width: 300
-    height: 320
+    height: 1180
     visible: false
     title: "Output Parameters"
     flags: Qt.Dialog | Qt.WindowCloseButtonHint | Qt.CustomizeWindowHint
@@ -16,7 +17,12 @@ Window {
     property bool isApplying: false
 
     readonly property var sampleRates: [44100, 48000, 88200, 96000, 176400, 192000, 352800, 384000]
-    readonly property var formats: ["S16", "S32", "Float", "Double"]
+    readonly property var formats: ["S16", "S32", "Float", "Double", "S24"]
+    readonly property var ditherModes: ["Off", "TPDF", "TPDF + Noise Shaping"]
+    readonly property var normalizationModes: ["Off", "Track (EBU R128)", "Album (EBU R128)"]
+    readonly property var latencyProfiles: ["Balanced", "Low Latency", "Low Power"]
+    readonly property var resamplerQualities: ["Fast", "Default", "High Quality (soxr)"]
+    readonly property var decodeAheadModes: ["Off", "Heavy Codecs (APE / TAK / DSD / Hi-Res)", "Always"]
 
     // 监听 C++ 反馈的信号 (500ms 后触发)
     Connections {
@@ -121,6 +127,285 @@ Window {
             enabled: !isApplying
         }
 
+        Text {
+            text: "Dither (S16 / S24 output)"
+            color: "white"
+            font.pixelSize: 12
+        }
+
+        // 抖动方式，选择即生效
+        ComboBox {
+            id: ditherCombo
+            Layout.fillWidth: true
+            model: ditherModes
+            currentIndex: playerController.ditherMode
+            enabled: !isApplying
+            onActivated: playerController.ditherMode = currentIndex
+        }
+
+        Text {
+            text: "Loudness Normalization (-18 LUFS)"
+            color: "white"
+            font.pixelSize: 12
+        }
+
+        // 响度归一化 (仅 Mixing 模式生效)，选择即生效
+        ComboBox {
+            id: normalizationCombo
+            Layout.fillWidth: true
+            model: normalizationModes
+            currentIndex: playerController.normalizationMode
+            enabled: !isApplying && playerController.outputMode === 1
+            onActivated: playerController.normalizationMode = currentIndex
+        }
+
+        Text {
+            text: "Playback Speed: " + speedSlider.value.toFixed(2) + "x"
+            color: "white"
+            font.pixelSize: 12
+        }
+
+        // 播放速度 (变速不变调)，拖动即生效，双击恢复 1x
+        Slider {
+            id: speedSlider
+            Layout.fillWidth: true
+            from: 0.5
+            to: 2.0
+            stepSize: 0.05
+            snapMode: Slider.SnapAlways
+            value: playerController.playbackSpeed
+            onMoved: playerController.playbackSpeed = value
+
+            TapHandler {
+                onDoubleTapped: playerController.playbackSpeed = 1.0
+            }
+        }
+
+        Text {
+            text: "Crossfade: " + (crossfadeSlider.value > 0 ? (crossfadeSlider.value / 1000).toFixed(1) + " s" : "Off")
+            color: "white"
+            font.pixelSize: 12
+        }
+
+        // 交叉淡化时长 (仅 Mixing 模式生效)，拖动即生效，不需要 Apply
+        Slider {
+            id: crossfadeSlider
+            Layout.fillWidth: true
+            from: 0
+            to: 12000
+            stepSize: 500
+            snapMode: Slider.SnapAlways
+            value: playerController.crossfadeMs
+            enabled: !isApplying && playerController.outputMode === 1
+            onMoved: playerController.crossfadeMs = value
+        }
+
+        // 10 段图示均衡 (仅 Mixing 模式生效)，拖动即生效
+        CheckBox {
+            id: eqCheck
+            Layout.fillWidth: true
+            text: "Equalizer"
+            checked: playerController.eqEnabled
+            enabled: !isApplying && playerController.outputMode === 1
+            onToggled: playerController.eqEnabled = checked
+
+            contentItem: Text {
+                text: eqCheck.text
+                color: "white"
+                font.pixelSize: 12
+                leftPadding: eqCheck.indicator.width + eqCheck.spacing
+                verticalAlignment: Text.AlignVCenter
+            }
+        }
+
+        ComboBox {
+            id: eqPresetCombo
+            Layout.fillWidth: true
+            model: playerController.eqPresetNames
+            currentIndex: playerController.eqPreset
+            displayText: currentIndex < 0 ? "Custom" : currentText
+            enabled: eqCheck.enabled && eqCheck.checked
+            onActivated: playerController.eqPreset = currentIndex
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            Layout.preferredHeight: 180
+            spacing: 0
+            enabled: eqCheck.enabled && eqCheck.checked
+
+            Repeater {
+                model: playerController.eqFrequencies
+
+                ColumnLayout {
+                    required property int index
+                    required property var modelData
+                    Layout.fillWidth: true
+                    Layout.fillHeight: true
+                    spacing: 2
+
+                    Slider {
+                        Layout.fillHeight: true
+                        Layout.alignment: Qt.AlignHCenter
+                        orientation: Qt.Vertical
+                        from: -12
+                        to: 12
+                        stepSize: 0.5
+                        snapMode: Slider.SnapAlways
+                        value: playerController.eqGains[index]
+                        onMoved: playerController.setEqGain(index, value)
+                    }
+
+                    Text {
+                        Layout.alignment: Qt.AlignHCenter
+                        text: modelData >= 1000 ? (modelData / 1000) + "k" : Math.round(modelData)
+                        color: "#AAAAAA"
+                        font.pixelSize: 10
+                    }
+                }
+            }
+        }
+
+        Text {
+            text: "Convolution (FIR): " + (playerController.convolverImpulse.length > 0
+                  ? playerController.convolverImpulse.split("/").pop() : "Off")
+            color: "white"
+            font.pixelSize: 12
+            elide: Text.ElideMiddle
+            Layout.fillWidth: true
+        }
+
+        // 房间 / 耳机校正脉冲响应 (仅 Mixing 模式生效)，加载即生效
+        RowLayout {
+            Layout.fillWidth: true
+            spacing: 10
+            enabled: !isApplying && playerController.outputMode === 1
+
+            Button {
+                text: "Load IR..."
+                Layout.fillWidth: true
+                onClicked: impulseDialog.open()
+            }
+
+            Button {
+                text: "Remove"
+                Layout.fillWidth: true
+                enabled: playerController.convolverImpulse.length > 0
+                onClicked: playerController.setConvolverImpulse("")
+            }
+        }
+
+        FileDialog {
+            id: impulseDialog
+            title: "Select Impulse Response"
+            nameFilters: ["Audio files (*.wav *.flac *.aiff *.aif)", "All files (*)"]
+            onAccepted: {
+                var urlObject = new URL(impulseDialog.selectedFile);
+                var filePath = decodeURIComponent(urlObject.pathname);
+                if (Qt.platform.os === "windows" && filePath.startsWith("/"))
+                    filePath = filePath.substring(1);
+                if (filePath && !playerController.setConvolverImpulse(filePath)) {
+                    statusText.text = "Failed to load impulse response";
+                    statusText.color = "#FF6B6B";
+                }
+            }
+        }
+
+        Text {
+            text: "Buffering"
+            color: "white"
+            font.pixelSize: 12
+        }
+
+        // 缓冲策略：选择即生效 (会重建设备并从当前位置继续)
+        ComboBox {
+            id: latencyCombo
+            Layout.fillWidth: true
+            model: latencyProfiles
+            currentIndex: playerController.latencyProfile
+            enabled: !isApplying
+            onActivated: playerController.latencyProfile = currentIndex
+        }
+
+        Text {
+            text: "Device Period: " + (periodSlider.value > 0 ? periodSlider.value + " ms" : "Auto")
+            color: "white"
+            font.pixelSize: 12
+        }
+
+        // 设备周期 (0 表示使用缓冲策略的默认值)，松开滑块后生效
+        Slider {
+            id: periodSlider
+            Layout.fillWidth: true
+            from: 0
+            to: 100
+            stepSize: 5
+            snapMode: Slider.SnapAlways
+            value: playerController.devicePeriodMs
+            enabled: !isApplying
+            onPressedChanged: {
+                if (!pressed)
+                    playerController.devicePeriodMs = value;
+            }
+        }
+
+        Text {
+            text: "Resampler (current output mode, bypassed when rates match)"
+            color: "white"
+            font.pixelSize: 12
+        }
+
+        // 重采样器质量：选择即生效
+        ComboBox {
+            id: resamplerCombo
+            Layout.fillWidth: true
+            model: resamplerQualities
+            currentIndex: playerController.resamplerQuality
+            enabled: !isApplying
+            onActivated: playerController.resamplerQuality = currentIndex
+        }
+
+        Text {
+            text: "Decode Ahead"
+            color: "white"
+            font.pixelSize: 12
+        }
+
+        // 提前解码 (同时开启解码器多线程)：从下一首或下一次定位起生效
+        ComboBox {
+            id: decodeAheadCombo
+            Layout.fillWidth: true
+            model: decodeAheadModes
+            currentIndex: playerController.decodeAheadMode
+            enabled: !isApplying
+            onActivated: playerController.decodeAheadMode = currentIndex
+        }
+
+        // 实时模式：提升解码线程优先级并锁定缓冲区，选择即生效
+        CheckBox {
+            id: realtimeCheck
+            Layout.fillWidth: true
+            text: "Realtime Priority"
+            checked: playerController.realtimeMode
+            enabled: !isApplying
+            onToggled: playerController.realtimeMode = checked
+
+            contentItem: Text {
+                text: realtimeCheck.text
+                color: "white"
+                font.pixelSize: 12
+                leftPadding: realtimeCheck.indicator.width + realtimeCheck.spacing
+                verticalAlignment: Text.AlignVCenter
+            }
+        }
+
+        Text {
+            text: playerController.realtimeStatus
+            visible: text.length > 0
+            color: "#AAAAAA"
+            font.pixelSize: 11
+        }
+
         Text {
             id: statusText
             text: "Please select parameters"
@@ -0,0 +1,84 @@
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Window
+
+Window {
+    id: spectrumWin
+    width: 420
+    height: 220
+    visible: false
+    title: "Spectrum"
+    flags: Qt.Dialog | Qt.WindowCloseButtonHint | Qt.CustomizeWindowHint
+    color: "#1e1e1e"
+
+    // [左峰值, 右峰值, 左均方根, 右均方根, 频带...]，均为 0 ~ 1
+    property var frame: []
+    readonly property int bandCount: 64
+
+    // 只在窗口可见时采集与计算，隐藏后 C++ 侧停止工作线程
+    onVisibleChanged: {
+        playerController.spectrumEnabled = visible;
+        if (!visible)
+            frame = [];
+    }
+
+    // 每个显示帧取一次结果，计算频率跟随屏幕刷新率
+    FrameAnimation {
+        running: spectrumWin.visible
+        onTriggered: spectrumWin.frame = playerController.spectrumFrame()
+    }
+
+    function value(index) {
+        return index < frame.length ? frame[index] : 0;
+    }
+
+    RowLayout {
+        anchors.fill: parent
+        anchors.margins: 12
+        spacing: 12
+
+        // 电平表：峰值为细线，均方根为实心柱
+        Repeater {
+            model: 2
+            Item {
+                Layout.preferredWidth: 10
+                Layout.fillHeight: true
+                Rectangle {
+                    anchors.fill: parent
+                    color: "#303030"
+                    radius: 2
+                }
+                Rectangle {
+                    anchors.bottom: parent.bottom
+                    width: parent.width
+                    height: parent.height * spectrumWin.value(2 + index)
+                    color: "#4CAF50"
+                    radius: 2
+                }
+                Rectangle {
+                    y: Math.min(parent.height - height, parent.height * (1 - spectrumWin.value(index)))
+                    width: parent.width
+                    height: 2
+                    color: spectrumWin.value(index) >= 0.999 ? "#FF5252" : "#C8E6C9"
+                }
+            }
+        }
+
+        // 频谱
+        Row {
+            id: bands
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            spacing: 1
+            Repeater {
+                model: spectrumWin.bandCount
+                Rectangle {
+                    anchors.bottom: parent.bottom
+                    width: (bands.width - (spectrumWin.bandCount - 1) * bands.spacing) / spectrumWin.bandCount
+                    height: bands.height * spectrumWin.value(4 + index)
+                    color: "#64B5F6"
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,680 @@
+#include "AudioKernels.hpp"
+
+#include <immintrin.h>
+
+using AudioKernels::DitherMode;
+using AudioKernels::DitherState;
+using AudioKernels::MAX_DITHER_CHANNELS;
+using AudioKernels::PcmFormat;
+
+namespace
+{
+constexpr float HALF_PI = 1.57079632679489661923f;
+
+// sin(x)，x ∈ [0, π/2]：9 阶泰勒多项式，最大误差约 4e-6，足够用于增益曲线
+inline float sinPoly(float x)
+{
+    float x2 = x * x;
+    return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f)))));
+}
+
+inline __m256 sinPoly(__m256 x)
+{
+    __m256 x2 = _mm256_mul_ps(x, x);
+    __m256 p = _mm256_set1_ps(1.0f / 362880.0f);
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(-1.0f / 5040.0f));
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(1.0f / 120.0f));
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(-1.0f / 6.0f));
+    p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(1.0f));
+    return _mm256_mul_ps(p, x);
+}
+
+// 等功率增益对：fadeOut = cos(t·π/2)，fadeIn = sin(t·π/2)
+inline void gainPair(float t, float &fadeOut, float &fadeIn)
+{
+    t = std::clamp(t, 0.0f, 1.0f);
+    fadeIn = sinPoly(t * HALF_PI);
+    fadeOut = sinPoly((1.0f - t) * HALF_PI);
+}
+
+inline void gainPair(__m256 t, __m256 &fadeOut, __m256 &fadeIn)
+{
+    t = _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+    const __m256 halfPi = _mm256_set1_ps(HALF_PI);
+    fadeIn = sinPoly(_mm256_mul_ps(t, halfPi));
+    fadeOut = sinPoly(_mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), t), halfPi));
+}
+
+// 每个 SIMD 通道 (交错采样) 所属帧的进度：t = t0 + floor((base + lane) / channels) * dt
+struct RampLanes
+{
+    __m256 laneFrame; // 前 8 个采样各自所属的帧号
+
+    RampLanes(int channels, int lanes)
+    {
+        alignas(32) float frames[8] = {};
+        for (int i = 0; i < lanes; ++i)
+        {
+            frames[i] = static_cast<float>(i / channels);
+        }
+        laneFrame = _mm256_load_ps(frames);
+    }
+};
+
+// 标量版本：同时处理尾部不足一个 SIMD 宽度的采样
+template <typename Load, typename Store>
+void crossfadeScalar(size_t begin, size_t end, int channels, float t0, float dt, bool hasSrc, Load load, Store store)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        float fadeOut = 0.0f;
+        float fadeIn = 0.0f;
+        gainPair(t0 + static_cast<float>(i / channels) * dt, fadeOut, fadeIn);
+        float mixed = load(true, i) * fadeOut;
+        if (hasSrc)
+            mixed += load(false, i) * fadeIn;
+        store(i, mixed);
+    }
+}
+
+void crossfadeFlt(float *dst, const float *src, size_t samples, int channels, float t0, float dt)
+{
+    size_t i = 0;
+    // 8 个采样必须对应整数帧，否则下一块的帧号偏移会出现小数
+    if (8 % channels == 0)
+    {
+        RampLanes ramp(channels, 8);
+        const __m256 dtVec = _mm256_set1_ps(dt);
+        for (; i + 8 <= samples; i += 8)
+        {
+            float blockT = t0 + static_cast<float>(i / channels) * dt;
+            __m256 t = _mm256_fmadd_ps(ramp.laneFrame, dtVec, _mm256_set1_ps(blockT));
+            __m256 fadeOut, fadeIn;
+            gainPair(t, fadeOut, fadeIn);
+
+            __m256 out = _mm256_mul_ps(_mm256_loadu_ps(dst + i), fadeOut);
+            if (src)
+                out = _mm256_fmadd_ps(_mm256_loadu_ps(src + i), fadeIn, out);
+            _mm256_storeu_ps(dst + i, out);
+        }
+    }
+    crossfadeScalar(i, samples, channels, t0, dt, src != nullptr, [&](bool isDst, size_t k)
+                    { return isDst ? dst[k] : src[k]; }, [&](size_t k, float v)
+                    { dst[k] = v; });
+}
+
+void crossfadeS16(int16_t *dst, const int16_t *src, size_t samples, int channels, float t0, float dt)
+{
+    size_t i = 0;
+    if (8 % channels == 0)
+    {
+        RampLanes ramp(channels, 8);
+        const __m256 dtVec = _mm256_set1_ps(dt);
+        for (; i + 8 <= samples; i += 8)
+        {
+            float blockT = t0 + static_cast<float>(i / channels) * dt;
+            __m256 t = _mm256_fmadd_ps(ramp.laneFrame, dtVec, _mm256_set1_ps(blockT));
+            __m256 fadeOut, fadeIn;
+            gainPair(t, fadeOut, fadeIn);
+
+            __m256 d = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i))));
+            __m256 out = _mm256_mul_ps(d, fadeOut);
+            if (src)
+            {
+                __m256 s = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))));
+                out = _mm256_fmadd_ps(s, fadeIn, out);
+            }
+            // 四舍五入后饱和打包回 16 位
+            __m256i rounded = _mm256_cvtps_epi32(out);
+            __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(rounded), _mm256_extracti128_si256(rounded, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), packed);
+        }
+    }
+    crossfadeScalar(i, samples, channels, t0, dt, src != nullptr, [&](bool isDst, size_t k)
+                    { return static_cast<float>(isDst ? dst[k] : src[k]); }, [&](size_t k, float v)
+                    { dst[k] = static_cast<int16_t>(std::clamp(std::lrintf(v), -32768L, 32767L)); });
+}
+
+void crossfadeS32(int32_t *dst, const int32_t *src, size_t samples, int channels, float t0, float dt)
+{
+    // 32 位整数超出 float 的 24 位尾数，混音在 double 中进行 (每次 4 个采样)
+    size_t i = 0;
+    if (4 % channels == 0)
+    {
+        RampLanes ramp(channels, 4);
+        const __m128 dtVec = _mm_set1_ps(dt);
+        const __m256d maxVal = _mm256_set1_pd(2147483647.0);
+        const __m256d minVal = _mm256_set1_pd(-2147483648.0);
+        for (; i + 4 <= samples; i += 4)
+        {
+            float blockT = t0 + static_cast<float>(i / channels) * dt;
+            __m128 t = _mm_fmadd_ps(_mm256_castps256_ps128(ramp.laneFrame), dtVec, _mm_set1_ps(blockT));
+            __m256 fadeOut8, fadeIn8;
+            gainPair(_mm256_castps128_ps256(t), fadeOut8, fadeIn8);
+            __m256d fadeOut = _mm256_cvtps_pd(_mm256_castps256_ps128(fadeOut8));
+            __m256d fadeIn = _mm256_cvtps_pd(_mm256_castps256_ps128(fadeIn8));
+
+            __m256d out = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i))), fadeOut);
+            if (src)
+                out = _mm256_fmadd_pd(_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))), fadeIn, out);
+            out = _mm256_min_pd(_mm256_max_pd(out, minVal), maxVal);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm256_cvtpd_epi32(out));
+        }
+    }
+    for (; i < samples; ++i)
+    {
+        float fadeOut = 0.0f;
+        float fadeIn = 0.0f;
+        gainPair(t0 + static_cast<float>(i / channels) * dt, fadeOut, fadeIn);
+        double mixed = static_cast<double>(dst[i]) * fadeOut;
+        if (src)
+            mixed += static_cast<double>(src[i]) * fadeIn;
+        dst[i] = static_cast<int32_t>(std::clamp(std::llrint(mixed), -2147483648LL, 2147483647LL));
+    }
+}
+
+void crossfadeDbl(double *dst, const double *src, size_t samples, int channels, float t0, float dt)
+{
+    size_t i = 0;
+    if (4 % channels == 0)
+    {
+        RampLanes ramp(channels, 4);
+        const __m128 dtVec = _mm_set1_ps(dt);
+        for (; i + 4 <= samples; i += 4)
+        {
+            float blockT = t0 + static_cast<float>(i / channels) * dt;
+            __m128 t = _mm_fmadd_ps(_mm256_castps256_ps128(ramp.laneFrame), dtVec, _mm_set1_ps(blockT));
+            __m256 fadeOut8, fadeIn8;
+            gainPair(_mm256_castps128_ps256(t), fadeOut8, fadeIn8);
+
+            __m256d out = _mm256_mul_pd(_mm256_loadu_pd(dst + i), _mm256_cvtps_pd(_mm256_castps256_ps128(fadeOut8)));
+            if (src)
+                out = _mm256_fmadd_pd(_mm256_loadu_pd(src + i), _mm256_cvtps_pd(_mm256_castps256_ps128(fadeIn8)), out);
+            _mm256_storeu_pd(dst + i, out);
+        }
+    }
+    for (; i < samples; ++i)
+    {
+        float fadeOut = 0.0f;
+        float fadeIn = 0.0f;
+        gainPair(t0 + static_cast<float>(i / channels) * dt, fadeOut, fadeIn);
+        double mixed = dst[i] * fadeOut;
+        if (src)
+            mixed += src[i] * fadeIn;
+        dst[i] = mixed;
+    }
+}
+
+inline int32_t loadS24(const uint8_t *p)
+{
+    // 先放到高 24 位再算术右移，完成符号扩展
+    return static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+}
+
+inline void storeS24(uint8_t *p, int32_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+}
+
+void crossfadeS24(uint8_t *dst, const uint8_t *src, size_t samples, int channels, float t0, float dt)
+{
+    // 3 字节打包格式无法直接装入向量，标量处理 (仅用于曲目末尾的短淡出)
+    crossfadeScalar(0, samples, channels, t0, dt, src != nullptr, [&](bool isDst, size_t k)
+                    { return static_cast<float>(loadS24((isDst ? dst : src) + k * 3)); }, [&](size_t k, float v)
+                    { storeS24(dst + k * 3, static_cast<int32_t>(std::clamp(std::lrintf(v), -8388608L, 8388607L))); });
+}
+
+void crossfadeU8(uint8_t *dst, const uint8_t *src, size_t samples, int channels, float t0, float dt)
+{
+    size_t i = 0;
+    if (8 % channels == 0)
+    {
+        RampLanes ramp(channels, 8);
+        const __m256 dtVec = _mm256_set1_ps(dt);
+        const __m256i bias = _mm256_set1_epi32(128);
+        for (; i + 8 <= samples; i += 8)
+        {
+            float blockT = t0 + static_cast<float>(i / channels) * dt;
+            __m256 t = _mm256_fmadd_ps(ramp.laneFrame, dtVec, _mm256_set1_ps(blockT));
+            __m256 fadeOut, fadeIn;
+            gainPair(t, fadeOut, fadeIn);
+
+            // 无符号 8 位以 128 为零点
+            __m256i d = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(dst + i))), bias);
+            __m256 out = _mm256_mul_ps(_mm256_cvtepi32_ps(d), fadeOut);
+            if (src)
+            {
+                __m256i s = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i))), bias);
+                out = _mm256_fmadd_ps(_mm256_cvtepi32_ps(s), fadeIn, out);
+            }
+            __m256i rounded = _mm256_add_epi32(_mm256_cvtps_epi32(out), bias);
+            __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(rounded), _mm256_extracti128_si256(rounded, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(words, words));
+        }
+    }
+    crossfadeScalar(i, samples, channels, t0, dt, src != nullptr, [&](bool isDst, size_t k)
+                    { return static_cast<float>(isDst ? dst[k] : src[k]) - 128.0f; }, [&](size_t k, float v)
+                    { dst[k] = static_cast<uint8_t>(std::clamp(std::lrintf(v) + 128L, 0L, 255L)); });
+}
+// ---------------- float32 -> 设备格式 ----------------
+
+// 8 路并行 xorshift32
+inline __m256i nextRandom(__m256i &state)
+{
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+    state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+    return state;
+}
+
+inline uint32_t nextRandom(uint32_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// 随机位 -> [-0.5, 0.5) 均匀分布 (取高 23 位作为 [1, 2) 浮点数的尾数)
+inline __m256 uniformNoise(__m256i bits)
+{
+    __m256i mantissa = _mm256_or_si256(_mm256_srli_epi32(bits, 9), _mm256_set1_epi32(0x3F800000));
+    return _mm256_sub_ps(_mm256_castsi256_ps(mantissa), _mm256_set1_ps(1.5f));
+}
+
+inline float uniformNoise(uint32_t bits)
+{
+    uint32_t mantissa = (bits >> 9) | 0x3F800000u;
+    float value;
+    std::memcpy(&value, &mantissa, sizeof(value));
+    return value - 1.5f;
+}
+
+// 整数输出的量化参数：满幅缩放系数与饱和范围 (以 LSB 为单位)
+struct IntTarget
+{
+    float scale;
+    float minVal;
+    float maxVal;
+    bool dither;
+};
+
+IntTarget intTarget(PcmFormat format)
+{
+    switch (format)
+    {
+    case PcmFormat::U8: return {128.0f, -128.0f, 127.0f, true};
+    case PcmFormat::S16: return {32768.0f, -32768.0f, 32767.0f, true};
+    case PcmFormat::S24: return {8388608.0f, -8388608.0f, 8388607.0f, true};
+    // 2^31 - 1 无法用 float 精确表示，取不超过它的最大 float
+    case PcmFormat::S32: return {2147483648.0f, -2147483648.0f, 2147483520.0f, false};
+    default: return {1.0f, -1.0f, 1.0f, false};
+    }
+}
+
+void storeInt(uint8_t *dst, size_t index, int32_t value, PcmFormat format)
+{
+    switch (format)
+    {
+    case PcmFormat::U8: dst[index] = static_cast<uint8_t>(value + 128); break;
+    case PcmFormat::S16: reinterpret_cast<int16_t *>(dst)[index] = static_cast<int16_t>(value); break;
+    case PcmFormat::S24: storeS24(dst + index * 3, value); break;
+    case PcmFormat::S32: reinterpret_cast<int32_t *>(dst)[index] = value; break;
+    default: break;
+    }
+}
+
+// 标量量化：处理噪声整形 (误差反馈 H(z) = 1 - z^-1) 以及 SIMD 的尾部
+void quantizeScalar(uint8_t *dst, const float *src, size_t begin, size_t end, int channels, PcmFormat format, DitherState &dither)
+{
+    const IntTarget target = intTarget(format);
+    const bool useDither = target.dither && dither.mode != DitherMode::None;
+    const bool shaped = useDither && dither.mode == DitherMode::TpdfShaped && channels <= MAX_DITHER_CHANNELS;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        float value = src[i] * target.scale;
+        int ch = static_cast<int>(i % channels);
+        if (shaped)
+        {
+            value -= dither.shapingError[ch];
+        }
+        float noise = 0.0f;
+        if (useDither)
+        {
+            uint32_t &state = dither.rng[i & 7];
+            noise = uniformNoise(nextRandom(state)) + uniformNoise(nextRandom(state));
+        }
+        float quantized = std::clamp(std::nearbyint(value + noise), target.minVal, target.maxVal);
+        if (shaped)
+        {
+            // 限制误差幅度，削波时不让反馈失控
+            dither.shapingError[ch] = std::clamp(quantized - value, -2.0f, 2.0f);
+        }
+        storeInt(dst, i, static_cast<int32_t>(quantized), format);
+    }
+}
+
+void quantizeAVX2(uint8_t *dst, const float *src, size_t samples, PcmFormat format, DitherState &dither, size_t &done)
+{
+    const IntTarget target = intTarget(format);
+    const bool useDither = target.dither && dither.mode != DitherMode::None;
+    const __m256 scale = _mm256_set1_ps(target.scale);
+    const __m256 minVal = _mm256_set1_ps(target.minVal);
+    const __m256 maxVal = _mm256_set1_ps(target.maxVal);
+    __m256i state = _mm256_load_si256(reinterpret_cast<const __m256i *>(dither.rng));
+
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8)
+    {
+        __m256 value = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+        if (useDither)
+        {
+            __m256 tpdf = _mm256_add_ps(uniformNoise(nextRandom(state)), uniformNoise(nextRandom(state)));
+            value = _mm256_add_ps(value, tpdf);
+        }
+        value = _mm256_min_ps(_mm256_max_ps(value, minVal), maxVal);
+        __m256i rounded = _mm256_cvtps_epi32(value);
+
+        switch (format)
+        {
+        case PcmFormat::S16:
+        {
+            __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(rounded), _mm256_extracti128_si256(rounded, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst) + i / 8, packed);
+            break;
+        }
+        case PcmFormat::S32:
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), rounded);
+            break;
+        case PcmFormat::U8:
+        {
+            rounded = _mm256_add_epi32(rounded, _mm256_set1_epi32(128));
+            __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(rounded), _mm256_extracti128_si256(rounded, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(words, words));
+            break;
+        }
+        case PcmFormat::S24:
+        {
+            // 先在寄存器中完成计算，再逐个写出 3 字节
+            alignas(32) int32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), rounded);
+            for (int k = 0; k < 8; ++k)
+            {
+                storeS24(dst + (i + k) * 3, lanes[k]);
+            }
+            break;
+        }
+        default: break;
+        }
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i *>(dither.rng), state);
+    done = i;
+}
+} // namespace
+
+namespace AudioKernels
+{
+PcmFormat toPcmFormat(AVSampleFormat format, bool packed24)
+{
+    switch (format)
+    {
+    case AV_SAMPLE_FMT_U8: return PcmFormat::U8;
+    case AV_SAMPLE_FMT_S16: return PcmFormat::S16;
+    case AV_SAMPLE_FMT_S32: return packed24 ? PcmFormat::S24 : PcmFormat::S32;
+    case AV_SAMPLE_FMT_FLT: return PcmFormat::F32;
+    case AV_SAMPLE_FMT_DBL: return PcmFormat::F64;
+    default: return PcmFormat::Unknown;
+    }
+}
+
+size_t bytesPerSample(PcmFormat format)
+{
+    switch (format)
+    {
+    case PcmFormat::U8: return 1;
+    case PcmFormat::S16: return 2;
+    case PcmFormat::S24: return 3;
+    case PcmFormat::S32: return 4;
+    case PcmFormat::F32: return 4;
+    case PcmFormat::F64: return 8;
+    default: return 0;
+    }
+}
+
+void convertFromFloat(uint8_t *dst, const float *src, size_t frames, int channels, PcmFormat format, DitherState &dither)
+{
+    if (!dst || !src || frames == 0 || channels <= 0)
+        return;
+
+    const size_t samples = frames * static_cast<size_t>(channels);
+    switch (format)
+    {
+    case PcmFormat::F32:
+        std::memcpy(dst, src, samples * sizeof(float));
+        return;
+    case PcmFormat::F64:
+    {
+        double *out = reinterpret_cast<double *>(dst);
+        size_t i = 0;
+        for (; i + 4 <= samples; i += 4)
+        {
+            _mm256_storeu_pd(out + i, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+        }
+        for (; i < samples; ++i)
+        {
+            out[i] = src[i];
+        }
+        return;
+    }
+    case PcmFormat::U8:
+    case PcmFormat::S16:
+    case PcmFormat::S24:
+    case PcmFormat::S32:
+    {
+        size_t done = 0;
+        // 噪声整形的误差反馈依赖同一通道的上一个采样，无法按交错顺序并行
+        if (!(dither.mode == DitherMode::TpdfShaped && intTarget(format).dither))
+        {
+            quantizeAVX2(dst, src, samples, format, dither, done);
+        }
+        quantizeScalar(dst, src, done, samples, channels, format, dither);
+        return;
+    }
+    default:
+        return;
+    }
+}
+
+void equalPowerCrossfade(uint8_t *dst, const uint8_t *src, size_t frames, int channels, PcmFormat format, float t0, float dt)
+{
+    if (!dst || frames == 0 || channels <= 0)
+        return;
+
+    const size_t samples = frames * static_cast<size_t>(channels);
+    switch (format)
+    {
+    case PcmFormat::F32:
+        crossfadeFlt(reinterpret_cast<float *>(dst), reinterpret_cast<const float *>(src), samples, channels, t0, dt);
+        break;
+    case PcmFormat::S16:
+        crossfadeS16(reinterpret_cast<int16_t *>(dst), reinterpret_cast<const int16_t *>(src), samples, channels, t0, dt);
+        break;
+    case PcmFormat::S24:
+        crossfadeS24(dst, src, samples, channels, t0, dt);
+        break;
+    case PcmFormat::S32:
+        crossfadeS32(reinterpret_cast<int32_t *>(dst), reinterpret_cast<const int32_t *>(src), samples, channels, t0, dt);
+        break;
+    case PcmFormat::F64:
+        crossfadeDbl(reinterpret_cast<double *>(dst), reinterpret_cast<const double *>(src), samples, channels, t0, dt);
+        break;
+    case PcmFormat::U8:
+        crossfadeU8(dst, src, samples, channels, t0, dt);
+        break;
+    default:
+        break;
+    }
+}
+
+void interleave(uint8_t *dst, const uint8_t *const *planes, size_t offset, size_t frames, int channels, size_t sampleBytes)
+{
+    size_t i = 0;
+    if (channels == 2 && sampleBytes == 4)
+    {
+        const int32_t *left = reinterpret_cast<const int32_t *>(planes[0]) + offset;
+        const int32_t *right = reinterpret_cast<const int32_t *>(planes[1]) + offset;
+        __m256i *out = reinterpret_cast<__m256i *>(dst);
+        for (; i + 8 <= frames; i += 8)
+        {
+            __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(left + i));
+            __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + i));
+            // 128 位通道内交织，再跨通道重排为 L0 R0 L1 R1 ...
+            __m256i lo = _mm256_unpacklo_epi32(l, r);
+            __m256i hi = _mm256_unpackhi_epi32(l, r);
+            _mm256_storeu_si256(out++, _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(out++, _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+    }
+    else if (channels == 2 && sampleBytes == 2)
+    {
+        const int16_t *left = reinterpret_cast<const int16_t *>(planes[0]) + offset;
+        const int16_t *right = reinterpret_cast<const int16_t *>(planes[1]) + offset;
+        __m256i *out = reinterpret_cast<__m256i *>(dst);
+        for (; i + 16 <= frames; i += 16)
+        {
+            __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(left + i));
+            __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + i));
+            __m256i lo = _mm256_unpacklo_epi16(l, r);
+            __m256i hi = _mm256_unpackhi_epi16(l, r);
+            _mm256_storeu_si256(out++, _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(out++, _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+    }
+
+    // 尾部与其他通道数 / 位宽
+    uint8_t *p = dst + i * channels * sampleBytes;
+    for (; i < frames; ++i)
+    {
+        for (int c = 0; c < channels; ++c)
+        {
+            std::memcpy(p, planes[c] + (offset + i) * sampleBytes, sampleBytes);
+            p += sampleBytes;
+        }
+    }
+}
+
+void applyGain(float *data, size_t samples, float gain)
+{
+    size_t i = 0;
+    const __m256 g = _mm256_set1_ps(gain);
+    for (; i + 8 <= samples; i += 8)
+    {
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g));
+    }
+    for (; i < samples; ++i)
+    {
+        data[i] *= gain;
+    }
+}
+
+SquareSum sumOfSquares(const float *data, int count, int step, int decimation)
+{
+    float sum = 0.0f;
+    int processed = 0;
+    int i = 0;
+    if (step == 1)
+    {
+        const int jump = 8 * decimation;
+        __m256 sumVec = _mm256_setzero_ps();
+        for (; i <= count - 8; i += jump)
+        {
+            __m256 v = _mm256_loadu_ps(data + i);
+            sumVec = _mm256_fmadd_ps(v, v, sumVec);
+            processed += 8;
+        }
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, sumVec);
+        for (float lane : lanes)
+        {
+            sum += lane;
+        }
+    }
+    const int scalarStride = step * decimation;
+    for (; i < count; i += scalarStride)
+    {
+        sum += data[i] * data[i];
+        processed++;
+    }
+    return {sum, processed};
+}
+
+float peakAbsolute(const float *data, size_t samples)
+{
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 peakVec = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8)
+    {
+        peakVec = _mm256_max_ps(peakVec, _mm256_andnot_ps(signMask, _mm256_loadu_ps(data + i)));
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, peakVec);
+    float peak = 0.0f;
+    for (float lane : lanes)
+    {
+        peak = std::max(peak, lane);
+    }
+    for (; i < samples; ++i)
+    {
+        peak = std::max(peak, std::fabs(data[i]));
+    }
+    return peak;
+}
+
+float interpolatedPeak(const float *data, size_t samples, const float *taps, int phases, int tapsPerPhase)
+{
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 peakVec = _mm256_setzero_ps();
+    float peak = 0.0f;
+
+    // 一次计算某个相位上 8 个相邻输出：系数广播，输入按偏移连续读取
+    size_t n = 0;
+    for (; n + 8 <= samples; n += 8)
+    {
+        for (int p = 0; p < phases; ++p)
+        {
+            const float *h = taps + static_cast<size_t>(p) * tapsPerPhase;
+            __m256 acc = _mm256_setzero_ps();
+            for (int k = 0; k < tapsPerPhase; ++k)
+            {
+                acc = _mm256_fmadd_ps(_mm256_set1_ps(h[k]), _mm256_loadu_ps(data + n - k), acc);
+            }
+            peakVec = _mm256_max_ps(peakVec, _mm256_andnot_ps(signMask, acc));
+        }
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, peakVec);
+    for (float lane : lanes)
+    {
+        peak = std::max(peak, lane);
+    }
+
+    for (; n < samples; ++n)
+    {
+        for (int p = 0; p < phases; ++p)
+        {
+            const float *h = taps + static_cast<size_t>(p) * tapsPerPhase;
+            float acc = 0.0f;
+            for (int k = 0; k < tapsPerPhase; ++k)
+            {
+                acc += h[k] * data[static_cast<ptrdiff_t>(n) - k];
+            }
+            peak = std::max(peak, std::fabs(acc));
+        }
+    }
+    return peak;
+}
+} // namespace AudioKernels
@@ -1,6 +1,14 @@
 #include "AudioPlayer.hpp"
+#include "AudioKernels.hpp"
+#include "ChunkDecoder.hpp"
+#include "SeekIndex.hpp"
 #include "SimpleThreadPool.hpp"
 
+extern "C"
+{
+#include <libavutil/crc.h>
+}
+
 // --- Helper Functions ---
 
 static std::string my_av_strerror(int errnum)
@@ -13,8 +21,44 @@ static std::string my_av_strerror(int errnum)
 namespace
 {
 constexpr double PRELOAD_TRIGGER_SECONDS_BEFORE_END = 10.0;
-constexpr double AUDIO_BUFFER_DURATION_SECONDS = 0.4; // 400ms
-constexpr int MIN_AUDIO_QUEUE_SIZE = 4;
+// 交叉淡化开始前额外预留的预加载时间，保证淡化起点之前下一首已经就绪
+constexpr double CROSSFADE_PRELOAD_MARGIN_SECONDS = 2.0;
+constexpr int MAX_CROSSFADE_MILLISECONDS = 12000;
+// 借助 seek 索引定位时额外提前的时长，让解码器 (例如 MP3 的比特池) 在被丢弃的部分完成预热
+constexpr int64_t SEEK_INDEX_PREROLL_US = 200000;
+// 波形生成时每块之前额外解码的时长 (不计入波形)，让解码器越过重新开始解码时的过渡帧
+constexpr int64_t WAVEFORM_PREROLL_US = 100000;
+// 解码会话缓存容量 (当前曲目之外：最近播放的若干首 + 预加载的下一首)
+constexpr size_t SESSION_CACHE_CAPACITY = 6;
+// 环形缓冲区在目标水位之外额外预留的空间，容纳单个解码帧的突发写入
+constexpr double RING_HEADROOM_SECONDS = 0.25;
+constexpr int MAX_DEVICE_PERIOD_MILLISECONDS = 200;
+// 提前解码的缓存上限 (秒)
+constexpr double MAX_DECODE_AHEAD_SECONDS = 30.0;
+// 离线渲染：每个数据包解码后立即取空环形缓冲区，容量只需容纳单个数据包的输出 (APE 等单帧可达数秒)
+constexpr double RENDER_BUFFER_SECONDS = 8.0;
+constexpr size_t RENDER_CHUNK_FRAMES = 16384;
+
+// 各缓冲策略的参数
+struct LatencyProfileConfig
+{
+    double bufferSeconds;   // 目标水位
+    double lowWaterSeconds; // 低于此水位才开始补充 (等于目标水位时为持续补充)
+    int minPollMs;          // 回调不唤醒解码线程，解码线程至少间隔这么久检查一次水位
+    int periodMs;           // 设备周期，0 表示由后端决定
+    ma_performance_profile performance;
+};
+
+constexpr LatencyProfileConfig latencyProfileConfig(LatencyProfile profile)
+{
+    switch (profile)
+    {
+    case LatencyProfile::LowLatency: return {0.06, 0.06, 10, 5, ma_performance_profile_low_latency};
+    case LatencyProfile::LowPower: return {4.0, 1.0, 50, 50, ma_performance_profile_conservative};
+    case LatencyProfile::Balanced:
+    default: return {0.4, 0.4, 100, 0, ma_performance_profile_low_latency};
+    }
+}
 } // namespace
 
 // 将 FFmpeg 格式转换为 Miniaudio 格式
@@ -41,6 +85,7 @@ static AVSampleFormat toAVSampleFormat(ma_format maFormat)
     {
     case ma_format_u8: return AV_SAMPLE_FMT_U8;
     case ma_format_s16: return AV_SAMPLE_FMT_S16;
+    case ma_format_s24: return AV_SAMPLE_FMT_S32; // 24 位打包格式由 AudioParams::packed24 标记
     case ma_format_s32: return AV_SAMPLE_FMT_S32;
     case ma_format_f32: return AV_SAMPLE_FMT_FLT;
     default: return AV_SAMPLE_FMT_NONE;
@@ -54,10 +99,72 @@ static AVChannelLayout toAVChannelLayout(const uint8_t &channels)
     return layout;
 }
 
+// 能否按 seek 索引记录的包偏移直接字节定位
+// 只限于数据包可以独立同步的格式；APE 等格式的解复用器按内部帧号读取，字节定位会破坏其状态
+static bool supportsIndexedByteSeek(const AVFormatContext *fmtCtx)
+{
+    if (!fmtCtx || !fmtCtx->iformat || (fmtCtx->iformat->flags & AVFMT_NO_BYTE_SEEK))
+        return false;
+
+    static const std::array<std::string_view, 8> formats = {"mp3", "wav", "w64", "aiff", "flac", "aac", "ac3", "eac3"};
+    const std::string_view name = fmtCtx->iformat->name;
+    return std::find(formats.begin(), formats.end(), name) != formats.end();
+}
+
+// 单帧解码开销大的格式：即时解码时容易在机器繁忙时拖慢缓冲区补充
+static bool isHeavyCodec(const AVCodecContext *codecCtx)
+{
+    switch (codecCtx->codec_id)
+    {
+    case AV_CODEC_ID_APE:
+    case AV_CODEC_ID_TAK:
+    case AV_CODEC_ID_DSD_LSBF:
+    case AV_CODEC_ID_DSD_MSBF:
+    case AV_CODEC_ID_DSD_LSBF_PLANAR:
+    case AV_CODEC_ID_DSD_MSBF_PLANAR: return true;
+    case AV_CODEC_ID_FLAC:
+    case AV_CODEC_ID_ALAC:
+    case AV_CODEC_ID_WAVPACK:
+    case AV_CODEC_ID_TTA: return codecCtx->sample_rate > 96000;
+    default: return false;
+    }
+}
+
+// 打开解码器：threaded 时由 FFmpeg 按核心数选择线程数 (不支持多线程的解码器保持单线程)
+static AVCodecContext *openCodecContext(const AVCodec *codec, const AVCodecParameters *par, bool threaded)
+{
+    AVCodecContext *ctx = avcodec_alloc_context3(codec);
+    if (!ctx || avcodec_parameters_to_context(ctx, par) < 0)
+    {
+        avcodec_free_context(&ctx);
+        return nullptr;
+    }
+
+    if (threaded && (codec->capabilities & (AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS | AV_CODEC_CAP_OTHER_THREADS)))
+    {
+        ctx->thread_count = 0;
+        ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+    else
+    {
+        ctx->thread_count = 1;
+    }
+
+    if (avcodec_open2(ctx, codec, nullptr) < 0)
+    {
+        avcodec_free_context(&ctx);
+        return nullptr;
+    }
+    return ctx;
+}
+
 // --- AudioStreamSource ---
 
 void AudioPlayer::AudioStreamSource::free()
 {
+    // 工作线程必须先于上下文释放退出
+    stopDecodeAhead();
+    tempo.close();
     if (swrCtx)
     {
         swr_free(&swrCtx);
@@ -141,21 +248,97 @@ bool AudioPlayer::AudioStreamSource::initDecoder(const std::string &inputPath, c
         return false;
     }
 
-    pCodecCtx = avcodec_alloc_context3(pCodec);
-    if (avcodec_parameters_to_context(pCodecCtx, pCodecParameters) < 0)
+    // 缓存 / 预加载中的会话单线程打开，成为当前会话时再按设置决定是否开启多线程
+    pCodecCtx = openCodecContext(pCodec, pCodecParameters, false);
+    if (!pCodecCtx)
     {
         free();
         return false;
     }
+    codecThreaded = false;
+    decoderFed = false;
+    return true;
+}
 
-    if (avcodec_open2(pCodecCtx, pCodec, nullptr) < 0)
+void AudioPlayer::AudioStreamSource::setCodecThreading(bool threaded)
+{
+    if (!pFormatCtx || !pCodecCtx || audioStreamIndex < 0 || codecThreaded == threaded || decoderFed)
+        return;
+
+    stopDecodeAhead();
+    AVCodecContext *ctx = openCodecContext(pCodecCtx->codec, pFormatCtx->streams[audioStreamIndex]->codecpar, threaded);
+    if (!ctx)
     {
-        free();
-        return false;
+        spdlog::warn("Cannot reopen decoder with threading {}: {}", threaded ? "on" : "off", path);
+        return;
     }
+
+    avcodec_free_context(&pCodecCtx);
+    pCodecCtx = ctx;
+    codecThreaded = threaded;
+}
+
+bool AudioPlayer::AudioStreamSource::rewind()
+{
+    stopDecodeAhead();
+    if (!pFormatCtx || !pCodecCtx || audioStreamIndex < 0)
+        return false;
+
+    AVStream *stream = pFormatCtx->streams[audioStreamIndex];
+    int64_t startTs = (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+    if (av_seek_frame(pFormatCtx, audioStreamIndex, startTs, AVSEEK_FLAG_BACKWARD) < 0)
+        return false;
+
+    avcodec_flush_buffers(pCodecCtx);
+    decoderFed = false;
+    tempo.close();
+    trimUntilUs = -1;
+    startPositionUs = 0;
+    landingUs = 0;
+    timestampsUnreliable = false;
     return true;
 }
 
+bool AudioPlayer::AudioStreamSource::seekTo(int64_t targetUs)
+{
+    stopDecodeAhead();
+    if (!pFormatCtx || !pCodecCtx || audioStreamIndex < 0)
+        return false;
+
+    int ret = -1;
+    landingUs = targetUs;
+    timestampsUnreliable = false;
+
+    // 优先使用持久化的 seek 索引：直接跳到目标之前最近的数据包，落点时间已知
+    // (VBR MP3 无 TOC、WAV 等格式的默认定位是估算的，落点与目标可能相差很远)
+    SeekPoint point;
+    if (supportsIndexedByteSeek(pFormatCtx) && SeekIndexCache::instance().lookup(path, std::max<int64_t>(targetUs - SEEK_INDEX_PREROLL_US, 0), point))
+    {
+        ret = av_seek_frame(pFormatCtx, audioStreamIndex, point.bytePos, AVSEEK_FLAG_BYTE);
+        if (ret >= 0)
+        {
+            landingUs = point.ptsUs;
+            timestampsUnreliable = true;
+        }
+    }
+
+    if (ret < 0)
+    {
+        AVRational tb = pFormatCtx->streams[audioStreamIndex]->time_base;
+        int64_t streamTs = av_rescale_q(targetUs, AV_TIME_BASE_Q, tb);
+        ret = av_seek_frame(pFormatCtx, audioStreamIndex, streamTs, AVSEEK_FLAG_BACKWARD);
+    }
+    avcodec_flush_buffers(pCodecCtx);
+    decoderFed = false;
+    // 变速滤镜图中缓存的是旧位置的样本；速度为 1 时之后不再经过滤镜图
+    tempo.close();
+
+    // 落点在目标之前的关键帧，解码后丢弃目标之前的样本，做到采样级精确
+    trimUntilUs = targetUs;
+    startPositionUs = targetUs;
+    return ret >= 0;
+}
+
 bool AudioPlayer::AudioStreamSource::openSwrContext(const AudioParams &deviceParams, double volume, char *errorBuffer)
 {
     if (!pCodecCtx)
@@ -167,33 +350,42 @@ bool AudioPlayer::AudioStreamSource::openSwrContext(const AudioParams &devicePar
         swrCtx = nullptr;
     }
 
-    swrCtx = swr_alloc();
+    swrCtx = Resampler::create(pCodecCtx->ch_layout, pCodecCtx->sample_rate, pCodecCtx->sample_fmt,
+                               deviceParams.ch_layout, deviceParams.sampleRate, deviceParams.sampleFormat,
+                               deviceParams.resampler);
     if (!swrCtx)
-        return false;
-
-    av_opt_set_chlayout(swrCtx, "in_chlayout", &(pCodecCtx->ch_layout), 0);
-    av_opt_set_int(swrCtx, "in_sample_rate", pCodecCtx->sample_rate, 0);
-    av_opt_set_sample_fmt(swrCtx, "in_sample_fmt", pCodecCtx->sample_fmt, 0);
-
-    av_opt_set_chlayout(swrCtx, "out_chlayout", &(deviceParams.ch_layout), 0);
-    av_opt_set_int(swrCtx, "out_sample_rate", deviceParams.sampleRate, 0);
-    av_opt_set_sample_fmt(swrCtx, "out_sample_fmt", deviceParams.sampleFormat, 0);
-
-    int ret = swr_init(swrCtx);
-    if (ret < 0)
     {
-        spdlog::error("swr_init failed: {}", my_av_strerror(ret));
-        swr_free(&swrCtx);
+        spdlog::error("swr_init failed: {}", path);
         return false;
     }
+    spdlog::debug("Resampler: {} ({} -> {} Hz)", Resampler::describe(deviceParams.resampler, pCodecCtx->sample_rate == deviceParams.sampleRate),
+                  pCodecCtx->sample_rate, deviceParams.sampleRate);
     return true;
 }
 
+void AudioPlayer::AudioStreamSource::startDecodeAhead(double seconds, LatencyHistogram *decodeLatency)
+{
+    stopDecodeAhead();
+    if (!pFormatCtx || !pCodecCtx || audioStreamIndex < 0)
+        return;
+    decodeAhead = std::make_unique<DecodeAhead>(pFormatCtx, pCodecCtx, audioStreamIndex, seconds, decodeLatency);
+    decoderFed = true;
+}
+
+void AudioPlayer::AudioStreamSource::stopDecodeAhead()
+{
+    // 析构时等待工作线程退出，之后上下文重新归调用方使用
+    decodeAhead.reset();
+}
+
 // --- AudioPlayer ---
 
 AudioPlayer::AudioPlayer()
 {
     av_channel_layout_default(&mixingParams.ch_layout, 2);
+    // 内置均衡器始终位于处理链开头，关闭时旁路 (不产生任何处理开销)
+    m_equalizerStageId = m_dspChain.addStage(m_equalizer, 0);
+    m_dspChain.setBypassed(m_equalizerStageId, true);
     decodeThread = std::thread(&AudioPlayer::mainDecodeThread, this);
 }
 
@@ -203,13 +395,14 @@ AudioPlayer::~AudioPlayer()
 
     // 1. 设置退出标志
     quitFlag.store(true);
+    SeekIndexCache::instance().cancelPending();
     pathCondVar.notify_one();
     stateCondVar.notify_one();
 
     // 2. 停止设备 (确保不再有回调访问)
     if (m_deviceInited)
     {
-        ma_device_stop(&m_device);
+        stopDevice();
         // ma_device_uninit 会等待回调线程结束，确保不在持有 queueMutex 时调用它
         ma_device_uninit(&m_device);
         m_deviceInited = false;
@@ -222,43 +415,76 @@ AudioPlayer::~AudioPlayer()
         m_contextInited = false;
     }
 
-    // 4. 等待解码线程
+    // 4. 等待解码线程与后台预打开任务
     if (decodeThread.joinable())
     {
         decodeThread.join();
     }
+    if (m_prefetchTask.valid())
+    {
+        m_prefetchTask.wait();
+    }
 
     // 5. 释放其他资源
     freeResources();
+    av_packet_free(&m_crossfadePacket);
+    av_frame_free(&m_crossfadeFrame);
+    av_frame_free(&m_aheadFrame);
     spdlog::info("AudioPlayer: Destruction complete.");
 }
 
 void AudioPlayer::freeResources()
 {
-    if (outputMode.load() != OUTPUT_MIXING)
+    // 设备与 Context 保持打开，下一首格式一致时直接复用 (openAudioDevice 负责按需重建)
+    releaseSession(std::move(m_currentSource));
+
+    // Direct 模式下格式不一致导致的切歌：保留已预加载的源，由下一次会话直接接管
+    bool keepPreload = false;
+    if (m_preloadSource)
     {
-        closeAudioDevice();
+        std::lock_guard<std::mutex> lock(pathMutex);
+        keepPreload = (m_preloadSource->path == currentPath);
+    }
+    if (!keepPreload)
+    {
+        cancelCrossfade();
     }
-    m_currentSource.reset();
-    m_preloadSource.reset();
     flushQueue();
+}
+
+void AudioPlayer::drainRingBuffer()
+{
+    // 等待设备播放完缓冲区中的剩余数据 (最多等待一个缓冲时长加余量)
+    m_ringBuffer.publish();
+    const double bufferSeconds = latencyProfileConfig(m_latencyProfile.load()).bufferSeconds;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(bufferSeconds + RING_HEADROOM_SECONDS);
+    while (m_ringBuffer.bufferedBytes() > 0 && !quitFlag.load() && std::chrono::steady_clock::now() < deadline)
+    {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (playingState != PlayerState::PLAYING)
+                break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+bool AudioPlayer::matchesDeviceFormat(const AudioStreamSource &source) const
+{
+    // 离线渲染时没有设备，deviceParams 即输出格式
+    if ((!m_deviceInited && !m_renderOutputReady) || !source.pCodecCtx)
+        return false;
 
-    totalDecodedBytes = 0;
-    totalDecodedFrames = 0;
-    hasCalculatedQueueSize = false;
-    hasPreloaded = false;
+    const ma_format outputFormat = deviceParams.packed24 ? ma_format_s24 : toMaFormat(deviceParams.sampleFormat);
+    return outputFormat == toMaFormat(source.pCodecCtx->sample_fmt) &&
+           deviceParams.channels == source.pCodecCtx->ch_layout.nb_channels &&
+           deviceParams.sampleRate == source.pCodecCtx->sample_rate;
 }
 
 void AudioPlayer::flushQueue()
 {
-    std::lock_guard<std::mutex> lock(audioFrameQueueMutex);
-    // 清空队列
-    std::queue<std::shared_ptr<AudioFrame>> empty;
-    std::swap(audioFrameQueue, empty);
-
-    // 重置当前帧
-    m_currentFrame.reset();
-    m_currentFramePos = 0;
+    // 只移动生产者侧的水位，回调线程会自行跳过被丢弃的数据
+    m_ringBuffer.discard();
 }
 
 bool AudioPlayer::isValidAudio(const std::string &path)
@@ -272,20 +498,161 @@ bool AudioPlayer::isValidAudio(const std::string &path)
     return found;
 }
 
-bool AudioPlayer::setPath(const std::string &path)
+// --- 解码会话缓存 (LRU) ---
+
+bool AudioPlayer::ensureSession(const std::string &path)
+{
+    if (path.empty())
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_sessionCacheMutex);
+        auto it = std::find_if(m_sessionCache.begin(), m_sessionCache.end(),
+                               [&path](const std::unique_ptr<AudioStreamSource> &src)
+                               { return src->path == path; });
+        if (it != m_sessionCache.end())
+        {
+            // 命中：移到队首 (最近使用)
+            std::rotate(m_sessionCache.begin(), it, it + 1);
+            return true;
+        }
+    }
+
+    // 未命中：在锁外打开文件 (耗时操作)，成功即说明是有效音频
+    auto source = std::make_unique<AudioStreamSource>();
+    char localErrorBuffer[AV_ERROR_MAX_STRING_SIZE] = {0};
+    if (!source->initDecoder(path, localErrorBuffer))
+        return false;
+
+    releaseSession(std::move(source));
+    return true;
+}
+
+std::unique_ptr<AudioPlayer::AudioStreamSource> AudioPlayer::acquireSession(const std::string &path)
+{
+    std::unique_ptr<AudioStreamSource> source;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionCacheMutex);
+        auto it = std::find_if(m_sessionCache.begin(), m_sessionCache.end(),
+                               [&path](const std::unique_ptr<AudioStreamSource> &src)
+                               { return src->path == path; });
+        if (it != m_sessionCache.end())
+        {
+            source = std::move(*it);
+            m_sessionCache.erase(it);
+        }
+    }
+
+    // 曾经被播放过的会话需要回到开头，失败则重新打开
+    if (source && source->consumed && !source->rewind())
+    {
+        source.reset();
+    }
+
+    if (!source)
+    {
+        source = std::make_unique<AudioStreamSource>();
+        if (!source->initDecoder(path, errorBuffer))
+            return nullptr;
+    }
+
+    source->consumed = true;
+    return source;
+}
+
+void AudioPlayer::releaseSession(std::unique_ptr<AudioStreamSource> source)
+{
+    if (!source || !source->pFormatCtx)
+        return;
+
+    // 缓存中的会话不再提前解码 (取出后 rewind / seekTo 也会让解码器回到新位置)
+    source->stopDecodeAhead();
+    // 也不保留解码线程：下次取出时会回到开头，丢弃解码器状态无妨
+    source->decoderFed = false;
+    source->setCodecThreading(false);
+
+    // 重采样器与设备参数绑定，下次取出时重新创建
+    if (source->swrCtx)
+    {
+        swr_free(&source->swrCtx);
+    }
+
+    std::unique_ptr<AudioStreamSource> evicted;
+    std::unique_ptr<AudioStreamSource> duplicate;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionCacheMutex);
+        auto it = std::find_if(m_sessionCache.begin(), m_sessionCache.end(),
+                               [&source](const std::unique_ptr<AudioStreamSource> &src)
+                               { return src->path == source->path; });
+        if (it != m_sessionCache.end())
+        {
+            duplicate = std::move(*it);
+            m_sessionCache.erase(it);
+        }
+
+        m_sessionCache.push_front(std::move(source));
+        if (m_sessionCache.size() > SESSION_CACHE_CAPACITY)
+        {
+            evicted = std::move(m_sessionCache.back());
+            m_sessionCache.pop_back();
+        }
+    }
+    // evicted / duplicate 在锁外析构 (关闭文件句柄)
+}
+
+void AudioPlayer::prefetchSessions(const std::vector<std::string> &paths)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+        m_prefetchPaths = paths;
+        if (m_prefetchRunning)
+            return; // 正在运行的任务会取走新的列表
+        m_prefetchRunning = true;
+    }
+
+    // 同一时间只有一个后台任务，析构时只需等待这一个 future
+    m_prefetchTask = SimpleThreadPool::instance().enqueue(
+        [this]
+        {
+            for (;;)
+            {
+                std::vector<std::string> pending;
+                {
+                    std::lock_guard<std::mutex> lock(m_prefetchMutex);
+                    if (m_prefetchPaths.empty() || quitFlag.load())
+                    {
+                        m_prefetchRunning = false;
+                        return;
+                    }
+                    pending.swap(m_prefetchPaths);
+                }
+                for (const auto &path : pending)
+                {
+                    if (quitFlag.load())
+                        break;
+                    ensureSession(path);
+                }
+            }
+        });
+}
+
+bool AudioPlayer::setPath(const std::string &path, int64_t startMicroseconds)
 {
-    if (!isValidAudio(path))
+    // 打开会话放入缓存，同时完成有效性校验，解码线程稍后直接取用
+    if (!ensureSession(path))
     {
         spdlog::warn("Invalid audio: {}", path);
         return false;
     }
 
     {
+        // 预加载源可能正被解码线程用于交叉淡化，先取得 decodeMutex (与解码线程的加锁顺序一致)
+        std::lock_guard<std::mutex> decodeLock(decodeMutex);
         std::lock_guard<std::mutex> lock(pathMutex);
         currentPath = path;
+        currentStartPosition = std::max<int64_t>(startMicroseconds, 0);
         preloadPath.clear();
-        hasPreloaded = false;
-        m_preloadSource.reset();
+        cancelCrossfade();
         m_decoderCursor.store(0);
     }
 
@@ -311,25 +678,100 @@ bool AudioPlayer::setPath(const std::string &path)
     return true;
 }
 
-void AudioPlayer::setPreloadPath(const std::string &path)
+void AudioPlayer::setPreloadPath(const std::string &path, int64_t startMicroseconds)
 {
-    if (!isValidAudio(path))
+    if (path.empty())
+    {
+        std::lock_guard<std::mutex> decodeLock(decodeMutex);
+        std::lock_guard<std::mutex> lock(pathMutex);
+        if (!preloadPath.empty())
+        {
+            preloadPath.clear();
+            cancelCrossfade();
+        }
+        return;
+    }
+
+    if (!ensureSession(path))
     {
         return;
     }
 
+    startMicroseconds = std::max<int64_t>(startMicroseconds, 0);
+    std::lock_guard<std::mutex> decodeLock(decodeMutex);
     std::lock_guard<std::mutex> lock(pathMutex);
-    if (path != preloadPath)
+    if (path != preloadPath || startMicroseconds != preloadStartPosition)
     {
         preloadPath = path;
-        // 只有在 Mixing 模式下我们才会在当前歌曲播放时去预加载资源
-        // Direct 模式下只是存储路径，等当前歌曲播完后再处理
-        if (outputMode.load() == OUTPUT_MIXING)
+        preloadStartPosition = startMicroseconds;
+        // 两种模式都会在当前歌曲即将结束时预先打开下一首
+        cancelCrossfade();
+    }
+}
+
+void AudioPlayer::setTrackBoundaries(const std::string &path, std::vector<int64_t> boundariesUs)
+{
+    std::sort(boundariesUs.begin(), boundariesUs.end());
+    boundariesUs.erase(std::unique(boundariesUs.begin(), boundariesUs.end()), boundariesUs.end());
+
+    {
+        std::lock_guard<std::mutex> lock(pathMutex);
+        // 只保留当前曲目与预加载曲目所在文件的边界，防止无限增长
+        for (auto it = m_trackBoundaries.begin(); it != m_trackBoundaries.end();)
+        {
+            if (it->first != path && it->first != currentPath && it->first != preloadPath)
+                it = m_trackBoundaries.erase(it);
+            else
+                ++it;
+        }
+        m_trackBoundaries[path] = std::move(boundariesUs);
+    }
+    m_boundariesChanged.store(true);
+}
+
+bool AudioPlayer::waitForEvent(PlaybackEvent &event, std::chrono::milliseconds timeout)
+{
+    if (!m_eventSignal.try_acquire_for(timeout))
+        return false;
+
+    // 队列为空说明是被 interruptEventWait 唤醒
+    return m_events.pop(event);
+}
+
+void AudioPlayer::interruptEventWait()
+{
+    m_eventSignal.release();
+}
+
+void AudioPlayer::pushEvent(const PlaybackEvent &event)
+{
+    // 可能来自回调线程、解码线程或设备通知线程 (多生产者)
+    // 事件很少发生 (每首歌最多几次)，这里的 release 不会影响回调的实时性
+    if (m_events.push(event))
+    {
+        m_eventSignal.release();
+    }
+}
+
+void AudioPlayer::loadTrackBoundaries(int64_t fromUs)
+{
+    m_boundariesChanged.store(false);
+    m_activeBoundaries.clear();
+    m_nextBoundaryIndex = 0;
+    if (!m_currentSource)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(pathMutex);
+        auto it = m_trackBoundaries.find(m_currentSource->path);
+        if (it != m_trackBoundaries.end())
         {
-            hasPreloaded = false;
-            m_preloadSource.reset();
+            m_activeBoundaries = it->second;
         }
     }
+
+    // 起点本身 (例如从分轨开头播放) 不算越过边界
+    m_nextBoundaryIndex = std::upper_bound(m_activeBoundaries.begin(), m_activeBoundaries.end(), fromUs) - m_activeBoundaries.begin();
 }
 
 void AudioPlayer::play()
@@ -339,10 +781,7 @@ void AudioPlayer::play()
     {
         isFirstPlay = false;
         playingState = PlayerState::PLAYING;
-        if (m_deviceInited)
-        {
-            ma_device_start(&m_device);
-        }
+        startDevice();
         stateCondVar.notify_one();
     }
 }
@@ -353,10 +792,7 @@ void AudioPlayer::pause()
     if (playingState != PlayerState::PAUSED)
     {
         playingState = PlayerState::PAUSED;
-        if (m_deviceInited)
-        {
-            ma_device_stop(&m_device);
-        }
+        stopDevice();
         stateCondVar.notify_one();
     }
 }
@@ -373,10 +809,7 @@ void AudioPlayer::seek(int64_t timeMicroseconds)
     playingState = PlayerState::SEEKING;
 
     // 暂停设备防止爆音
-    if (m_deviceInited)
-    {
-        ma_device_stop(&m_device);
-    }
+    stopDevice();
     stateCondVar.notify_one();
 }
 
@@ -389,6 +822,16 @@ void AudioPlayer::setVolume(double vol)
     }
 }
 
+void AudioPlayer::setCrossfadeDuration(int milliseconds)
+{
+    m_crossfadeMs.store(std::clamp(milliseconds, 0, MAX_CROSSFADE_MILLISECONDS));
+}
+
+int AudioPlayer::getCrossfadeDuration() const
+{
+    return m_crossfadeMs.load();
+}
+
 // --- 功能补全：参数设置与模式切换 ---
 
 void AudioPlayer::setMixingParameters(const AudioParams &params)
@@ -406,36 +849,37 @@ void AudioPlayer::setMixingParameters(const AudioParams &params)
     bool wasPlaying = (playingState == PlayerState::PLAYING);
 
     // 1. 停止设备
-    if (m_deviceInited)
-    {
-        ma_device_stop(&m_device);
-    }
+    stopDevice();
 
     // 2. 清空队列 (旧格式的数据已失效)
     flushQueue();
 
     // 3. 重新配置
     mixingParams = params;
+    const AudioParams oldTarget = resampleTarget();
 
     // 关闭旧设备并重新打开 (openAudioDevice 会使用新的 mixingParams)
     closeAudioDevice();
     if (openAudioDevice())
     {
-        // 4. 重新初始化重采样器
-        if (m_currentSource)
+        // 4. 重采样器只输出内部 float32：采样率与通道数不变时 (仅改变设备格式) 无需重建
+        const AudioParams newTarget = resampleTarget();
+        if (newTarget.sampleRate != oldTarget.sampleRate || newTarget.channels != oldTarget.channels)
         {
-            // 使用更新后的 deviceParams
-            m_currentSource->openSwrContext(deviceParams, 1.0, errorBuffer);
-        }
+            if (m_currentSource)
+            {
+                // 使用更新后的 deviceParams
+                m_currentSource->openSwrContext(newTarget, 1.0, errorBuffer);
+            }
 
-        // 注意：m_preloadSource 的 swr 也是旧的，直接重置预加载状态让其稍后重新加载
-        m_preloadSource.reset();
-        hasPreloaded.store(false);
+            // 注意：m_preloadSource 的 swr 也是旧的，直接重置预加载状态让其稍后重新加载
+            cancelCrossfade();
+        }
 
         // 5. 恢复播放
-        if (wasPlaying && m_deviceInited)
+        if (wasPlaying)
         {
-            ma_device_start(&m_device);
+            startDevice();
         }
     }
 }
@@ -451,10 +895,7 @@ void AudioPlayer::setOutputMode(outputMod mode)
     bool wasPlaying = (playingState == PlayerState::PLAYING);
 
     // 1. 停止设备
-    if (m_deviceInited)
-    {
-        ma_device_stop(&m_device);
-    }
+    stopDevice();
 
     // 2. 清空队列
     flushQueue();
@@ -474,51 +915,387 @@ void AudioPlayer::setOutputMode(outputMod mode)
         // 5. 重新初始化重采样器
         if (m_currentSource)
         {
-            m_currentSource->openSwrContext(deviceParams, 1.0, errorBuffer);
+            m_currentSource->openSwrContext(resampleTarget(), 1.0, errorBuffer);
         }
 
         // 清理预加载资源 (模式切换导致预加载的资源格式可能不匹配)
-        m_preloadSource.reset();
-        hasPreloaded.store(false);
+        cancelCrossfade();
 
         // 6. 恢复播放
-        if (wasPlaying && m_deviceInited)
+        if (wasPlaying)
         {
-            ma_device_start(&m_device);
+            startDevice();
         }
     }
 }
 
-AudioParams AudioPlayer::getMixingParameters() const
+AudioParams AudioPlayer::resampleTarget() const
 {
-    return mixingParams;
+    // Mixing 模式下所有处理级都工作在 float32 上，由最终输出级转换为设备格式
+    AudioParams target = deviceParams;
+    target.resampler = m_resamplerQuality[outputMode.load()].load();
+    if (outputMode.load() == OUTPUT_MIXING)
+    {
+        target.sampleFormat = AV_SAMPLE_FMT_FLT;
+        target.packed24 = false;
+    }
+    return target;
 }
 
-AudioParams AudioPlayer::getDeviceParameters() const
+void AudioPlayer::setResamplerQuality(outputMod mode, ResamplerQuality quality)
 {
-    return deviceParams;
-}
-
-// --- Audio Device Management (Miniaudio) ---
+    if (m_resamplerQuality[mode].exchange(quality) == quality || outputMode.load() != mode)
+        return;
 
-void AudioPlayer::closeAudioDevice()
-{
-    if (m_deviceInited)
+    // 只重建当前曲目的重采样器 (丢弃其内部缓存的几毫秒样本)，预加载的曲目在下次打开时使用新设置
+    std::lock_guard<std::mutex> decodeLock(decodeMutex);
+    if (m_currentSource && m_currentSource->swrCtx)
     {
-        ma_device_uninit(&m_device);
-        m_deviceInited = false;
+        m_currentSource->openSwrContext(resampleTarget(), 1.0, errorBuffer);
     }
+}
 
-    // Device 依赖 Context，所以 Device 关了之后可以关 Context，或者在析构时关。
-    // 为了支持动态改名，建议在 openAudioDevice 里按需重建，
-    // 这里可以不做操作，或者也清理掉。
-    // 如果为了性能（Context 初始化涉及加载 DLL），可以保留 Context 直到析构。
-    // 但为了改名，我们在 openAudioDevice 里已经做了清理逻辑。
+ResamplerQuality AudioPlayer::getResamplerQuality(outputMod mode) const
+{
+    return m_resamplerQuality[mode].load();
 }
 
-bool AudioPlayer::openAudioDevice()
+void AudioPlayer::setDitherMode(AudioKernels::DitherMode mode)
 {
-    // 1. 计算期望的目标参数
+    m_ditherMode.store(mode);
+}
+
+AudioKernels::DitherMode AudioPlayer::getDitherMode() const
+{
+    return m_ditherMode.load();
+}
+
+void AudioPlayer::setRealtimeMode(bool enabled, int cpuCore)
+{
+    m_realtimeRequested.store(enabled);
+    m_realtimeCore.store(cpuCore);
+    // 唤醒空闲 / 暂停中的解码线程让设置尽快生效 (在锁内置位 / 通知，避免错过唤醒)
+    {
+        std::lock_guard<std::mutex> lock(pathMutex);
+        m_realtimeDirty.store(true);
+    }
+    pathCondVar.notify_one();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stateCondVar.notify_one();
+    }
+}
+
+RealtimeStatus AudioPlayer::getRealtimeStatus() const
+{
+    std::lock_guard<std::mutex> lock(m_realtimeMutex);
+    RealtimeStatus status = m_realtimeStatus;
+    // 环形缓冲区在设备重建时会重新分配并重新锁定，以当前状态为准
+    status.memoryLocked = m_ringBuffer.isLocked();
+    return status;
+}
+
+void AudioPlayer::applyRealtimeSettings()
+{
+    RealtimeStatus status;
+    status.requested = m_realtimeRequested.load();
+    const int core = m_realtimeCore.load();
+
+    if (status.requested)
+    {
+        status.realtimeGranted = ThreadPriority::promoteToRealtime(status.method);
+        status.pinned = (core >= 0) && ThreadPriority::pinToCore(core);
+        if (core < 0)
+            ThreadPriority::pinToCore(-1);
+    }
+    else
+    {
+        ThreadPriority::resetToNormal();
+        ThreadPriority::pinToCore(-1);
+    }
+
+    {
+        std::lock_guard<std::mutex> decodeLock(decodeMutex);
+        status.memoryLocked = m_ringBuffer.setLocked(status.requested);
+    }
+
+    if (status.requested)
+    {
+        spdlog::info("[AudioPlayer] Realtime mode: scheduling={} ({}), pinned={}, memoryLocked={}",
+                     status.realtimeGranted ? "granted" : "denied", status.method, status.pinned, status.memoryLocked);
+    }
+    else
+    {
+        spdlog::info("[AudioPlayer] Realtime mode disabled");
+    }
+
+    std::lock_guard<std::mutex> lock(m_realtimeMutex);
+    m_realtimeStatus = status;
+}
+
+void AudioPlayer::setNormalizationMode(NormalizationMode mode)
+{
+    m_normalizationMode.store(mode);
+}
+
+NormalizationMode AudioPlayer::getNormalizationMode() const
+{
+    return m_normalizationMode.load();
+}
+
+void AudioPlayer::setEqualizerEnabled(bool enabled)
+{
+    m_equalizerEnabled.store(enabled);
+    m_dspChain.setBypassed(m_equalizerStageId, !enabled);
+}
+
+bool AudioPlayer::getEqualizerEnabled() const
+{
+    return m_equalizerEnabled.load();
+}
+
+void AudioPlayer::setEqualizerSettings(const EqSettings &settings)
+{
+    m_equalizer->setSettings(settings);
+}
+
+EqSettings AudioPlayer::getEqualizerSettings() const
+{
+    return m_equalizer->settings();
+}
+
+bool AudioPlayer::setConvolverImpulse(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(m_convolverMutex);
+    if (path.empty())
+    {
+        if (m_convolverStageId >= 0)
+        {
+            m_dspChain.removeStage(m_convolverStageId);
+        }
+        m_convolverStageId = -1;
+        m_convolverPath.clear();
+        return true;
+    }
+
+    ImpulseResponse impulse;
+    if (!ConvolverStage::loadImpulseResponse(path, impulse))
+        return false;
+
+    // 放在处理链末尾 (均衡之后)；已有卷积级时原子替换，不会出现一块未卷积或卷积两次的音频
+    auto stage = std::make_shared<ConvolverStage>(std::move(impulse));
+    if (m_convolverStageId < 0 || !m_dspChain.replaceStage(m_convolverStageId, stage))
+    {
+        m_convolverStageId = m_dspChain.addStage(stage);
+    }
+    if (m_convolverStageId < 0)
+        return false;
+
+    m_convolverPath = path;
+    return true;
+}
+
+std::string AudioPlayer::getConvolverImpulse() const
+{
+    std::lock_guard<std::mutex> lock(m_convolverMutex);
+    return m_convolverPath;
+}
+
+void AudioPlayer::setPlaybackSpeed(double speed)
+{
+    m_playbackSpeed.store(std::clamp(speed, TempoFilter::MIN_SPEED, TempoFilter::MAX_SPEED));
+}
+
+double AudioPlayer::getPlaybackSpeed() const
+{
+    return m_playbackSpeed.load();
+}
+
+void AudioPlayer::setSpectrumEnabled(bool enabled)
+{
+    m_spectrum.setEnabled(enabled);
+}
+
+bool AudioPlayer::getSpectrumEnabled() const
+{
+    return m_spectrum.isEnabled();
+}
+
+void AudioPlayer::readSpectrum(SpectrumFrame &frame)
+{
+    m_spectrum.read(frame);
+}
+
+void AudioPlayer::setBitPerfectVerification(bool enabled)
+{
+    m_verifyBitPerfect.store(enabled);
+}
+
+bool AudioPlayer::getBitPerfectVerification() const
+{
+    return m_verifyBitPerfect.load();
+}
+
+void AudioPlayer::setDecodeAhead(DecodeAheadMode mode, double seconds)
+{
+    m_decodeAheadSeconds.store(std::clamp(seconds, 0.5, MAX_DECODE_AHEAD_SECONDS));
+    m_decodeAheadMode.store(mode);
+}
+
+DecodeAheadMode AudioPlayer::getDecodeAheadMode() const
+{
+    return m_decodeAheadMode.load();
+}
+
+void AudioPlayer::startDecodeAhead(AudioStreamSource &source)
+{
+    const DecodeAheadMode mode = m_decodeAheadMode.load();
+    const bool enabled = (mode == DecodeAheadMode::Always) || (mode == DecodeAheadMode::HeavyCodecs && source.pCodecCtx && isHeavyCodec(source.pCodecCtx));
+    // 会话成为当前会话 / 定位之后调用：解码器多线程与提前解码使用同一范围
+    // (已经送入过数据包的会话，如交叉淡化后接管的预加载源，保持原设置)
+    source.setCodecThreading(enabled);
+    if (enabled)
+    {
+        source.startDecodeAhead(m_decodeAheadSeconds.load(), &m_decodeLatency);
+    }
+    else
+    {
+        source.stopDecodeAhead();
+    }
+}
+
+void AudioPlayer::setLatencyProfile(LatencyProfile profile)
+{
+    if (m_latencyProfile.exchange(profile) != profile)
+    {
+        applyLatencyConfiguration();
+    }
+}
+
+LatencyProfile AudioPlayer::getLatencyProfile() const
+{
+    return m_latencyProfile.load();
+}
+
+void AudioPlayer::setDevicePeriod(int milliseconds)
+{
+    milliseconds = std::clamp(milliseconds, 0, MAX_DEVICE_PERIOD_MILLISECONDS);
+    if (m_devicePeriodMs.exchange(milliseconds) != milliseconds)
+    {
+        applyLatencyConfiguration();
+    }
+}
+
+int AudioPlayer::getDevicePeriod() const
+{
+    return m_devicePeriodMs.load();
+}
+
+void AudioPlayer::applyLatencyConfiguration()
+{
+    // 缓冲区大小与设备周期都在打开设备时确定，设备尚未打开时下次打开即生效
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!m_deviceInited)
+            return;
+    }
+
+    // 重建设备会丢弃缓冲区 (含设备内部缓冲) 中尚未播放的数据，从正在输出的位置重新定位以免跳过这部分音频
+    const int64_t position = m_clock.positionUs();
+    if (reopenDevice() && !getCurrentPath().empty())
+    {
+        seek(position);
+    }
+}
+
+AudioParams AudioPlayer::getMixingParameters() const
+{
+    return mixingParams;
+}
+
+AudioParams AudioPlayer::getDeviceParameters() const
+{
+    return deviceParams;
+}
+
+// --- Audio Device Management (Miniaudio) ---
+
+bool AudioPlayer::startDevice()
+{
+    if (!m_deviceInited)
+        return false;
+    m_deviceStopExpected.store(false);
+    return ma_device_start(&m_device) == MA_SUCCESS;
+}
+
+void AudioPlayer::stopDevice()
+{
+    if (!m_deviceInited)
+        return;
+    // 主动停止：通知回调据此区分 "预期内停止" 与 "设备丢失"
+    m_deviceStopExpected.store(true);
+    ma_device_stop(&m_device);
+    // 回调已停止：时钟停在正在输出的位置
+    m_clock.freeze();
+}
+
+bool AudioPlayer::reopenDevice()
+{
+    std::lock_guard<std::mutex> stateLock(stateMutex);
+    std::lock_guard<std::mutex> decodeLock(decodeMutex);
+
+    bool wasPlaying = (playingState == PlayerState::PLAYING);
+    bool canOpen = (outputMode.load() == OUTPUT_MIXING) || (m_currentSource != nullptr);
+
+    flushQueue();
+    closeAudioDevice();
+    if (!canOpen || !openAudioDevice())
+        return false;
+
+    if (m_currentSource)
+    {
+        m_currentSource->openSwrContext(resampleTarget(), 1.0, errorBuffer);
+    }
+    cancelCrossfade();
+
+    if (wasPlaying)
+    {
+        startDevice();
+    }
+    return true;
+}
+
+void AudioPlayer::ma_notification_callback(const ma_device_notification *pNotification)
+{
+    AudioPlayer *player = static_cast<AudioPlayer *>(pNotification->pDevice->pUserData);
+    if (!player)
+        return;
+
+    if (pNotification->type == ma_device_notification_type_stopped && !player->m_deviceStopExpected.load())
+    {
+        player->pushEvent({PlaybackEventType::DeviceLost, player->nowPlayingTime.load(), 0});
+    }
+}
+
+void AudioPlayer::closeAudioDevice()
+{
+    if (m_deviceInited)
+    {
+        m_deviceStopExpected.store(true);
+        ma_device_uninit(&m_device);
+        m_deviceInited = false;
+    }
+
+    // Device 依赖 Context，所以 Device 关了之后可以关 Context，或者在析构时关。
+    // 为了支持动态改名，建议在 openAudioDevice 里按需重建，
+    // 这里可以不做操作，或者也清理掉。
+    // 如果为了性能（Context 初始化涉及加载 DLL），可以保留 Context 直到析构。
+    // 但为了改名，我们在 openAudioDevice 里已经做了清理逻辑。
+}
+
+bool AudioPlayer::openAudioDevice()
+{
+    // 1. 计算期望的目标参数
     ma_format targetFormat;
     ma_uint32 targetChannels;
     ma_uint32 targetSampleRate;
@@ -526,7 +1303,7 @@ bool AudioPlayer::openAudioDevice()
 
     if (outputMode.load() == OUTPUT_MIXING)
     {
-        targetFormat = toMaFormat(mixingParams.sampleFormat);
+        targetFormat = (mixingParams.packed24 && mixingParams.sampleFormat == AV_SAMPLE_FMT_S32) ? ma_format_s24 : toMaFormat(mixingParams.sampleFormat);
         targetChannels = mixingParams.channels;
         targetSampleRate = mixingParams.sampleRate;
         targetAppName = "AppMusicPlayer";
@@ -543,10 +1320,24 @@ bool AudioPlayer::openAudioDevice()
         targetAppName = getCurrentStreamTitle();
     }
 
+    // 离线渲染：不打开声卡，输出格式即请求的格式 (本次渲染中已确定时保持不变)
+    if (m_rendering.load())
+    {
+        const bool same = deviceParams.sampleFormat == toAVSampleFormat(targetFormat) && deviceParams.packed24 == (targetFormat == ma_format_s24) &&
+                          deviceParams.channels == static_cast<int>(targetChannels) && deviceParams.sampleRate == static_cast<int>(targetSampleRate);
+        if (!m_renderOutputReady || !same)
+        {
+            configureOutput(targetFormat, targetChannels, targetSampleRate, RENDER_BUFFER_SECONDS, RENDER_BUFFER_SECONDS);
+            m_renderOutputReady = true;
+        }
+        return true;
+    }
+
     // --- 优化检查逻辑 ---
+    // 格式一致时复用已打开的设备与 Context (Direct 模式下跨曲目也不重建)
     if (m_deviceInited)
     {
-        if (outputMode.load() == OUTPUT_MIXING && m_device.playback.format == targetFormat && m_device.playback.channels == targetChannels && m_device.sampleRate == targetSampleRate)
+        if (m_device.playback.format == targetFormat && m_device.playback.channels == targetChannels && m_device.sampleRate == targetSampleRate)
         {
             return true;
         }
@@ -561,6 +1352,8 @@ bool AudioPlayer::openAudioDevice()
     }
 
     ma_context_config ctxConfig = ma_context_config_init();
+    // 实时模式下请求实时优先级的设备线程 (系统不允许时 miniaudio 会自动退回普通优先级)
+    ctxConfig.threadPriority = m_realtimeRequested.load() ? ma_thread_priority_realtime : ma_thread_priority_highest;
 
     // [修复 1] 针对不同后端设置应用名称
     // miniaudio 的 config 结构体中，应用名称通常是在特定后端的子结构里
@@ -582,6 +1375,7 @@ bool AudioPlayer::openAudioDevice()
     // 3. 配置新设备
     ma_device_config config = ma_device_config_init(ma_device_type_playback);
     config.dataCallback = ma_data_callback;
+    config.notificationCallback = ma_notification_callback;
     config.pUserData = this;
 
     // 应用参数
@@ -589,6 +1383,15 @@ bool AudioPlayer::openAudioDevice()
     config.playback.channels = targetChannels;
     config.sampleRate = targetSampleRate;
 
+    // 设备周期：显式设置优先，否则使用缓冲策略的默认值
+    const LatencyProfileConfig profile = latencyProfileConfig(m_latencyProfile.load());
+    const int periodMs = m_devicePeriodMs.load() > 0 ? m_devicePeriodMs.load() : profile.periodMs;
+    if (periodMs > 0)
+    {
+        config.periodSizeInMilliseconds = static_cast<ma_uint32>(periodMs);
+    }
+    config.performanceProfile = profile.performance;
+
     // 4. 初始化设备
     if (ma_device_init(&m_context, &config, &m_device) != MA_SUCCESS)
     {
@@ -598,17 +1401,64 @@ bool AudioPlayer::openAudioDevice()
 
     m_deviceInited = true;
 
-    // 回填实际参数
-    deviceParams.sampleRate = m_device.sampleRate;
-    deviceParams.sampleFormat = toAVSampleFormat(m_device.playback.format);
-    deviceParams.ch_layout = toAVChannelLayout(m_device.playback.channels);
-    deviceParams.channels = m_device.playback.channels;
+    // 后端实际使用的格式与请求一致时，miniaudio 不会再做格式 / 声道 / 采样率转换
+    const bool native = m_device.playback.internalFormat == m_device.playback.format &&
+                        m_device.playback.internalChannels == m_device.playback.channels &&
+                        m_device.playback.internalSampleRate == m_device.sampleRate;
+    m_deviceNative.store(native);
+    if (!native)
+    {
+        spdlog::info("[AudioPlayer] Device converts internally: {} Hz {} ch -> {} Hz {} ch",
+                     m_device.sampleRate, m_device.playback.channels,
+                     m_device.playback.internalSampleRate, m_device.playback.internalChannels);
+    }
+
+    // 输出延迟估计：后端缓冲区 (全部周期) + miniaudio 内部格式转换 (重采样滤波器) 的延迟
+    const ma_uint32 internalRate = m_device.playback.internalSampleRate;
+    if (internalRate > 0)
+    {
+        const uint64_t bufferFrames = static_cast<uint64_t>(m_device.playback.internalPeriodSizeInFrames) * m_device.playback.internalPeriods;
+        const uint64_t converterFrames = ma_data_converter_get_output_latency(&m_device.playback.converter);
+        m_outputLatencyUs.store(static_cast<int64_t>((bufferFrames + converterFrames) * 1000000 / internalRate));
+    }
+    spdlog::info("[AudioPlayer] Estimated output latency {:.1f} ms", m_outputLatencyUs.load() / 1000.0);
 
     ma_device_set_master_volume(&m_device, (float)volume.load());
 
+    // 回填实际参数
+    configureOutput(m_device.playback.format, m_device.playback.channels, m_device.sampleRate, profile.bufferSeconds, profile.lowWaterSeconds);
     return true;
 }
 
+void AudioPlayer::configureOutput(ma_format format, ma_uint32 channels, ma_uint32 sampleRate, double bufferSeconds, double lowWaterSeconds)
+{
+    deviceParams.sampleRate = sampleRate;
+    deviceParams.sampleFormat = toAVSampleFormat(format);
+    deviceParams.packed24 = (format == ma_format_s24);
+    deviceParams.ch_layout = toAVChannelLayout(channels);
+    deviceParams.channels = channels;
+    // DSP 处理级按输出的采样率 / 声道数准备 (同样不会与解码线程的处理并发)
+    m_dspChain.prepare(static_cast<int>(sampleRate), static_cast<int>(channels));
+
+    // 按时长重新分配环形缓冲区 (设备尚未 start 或处于离线渲染，不会有并发读取)
+    m_outputFormat = AudioKernels::toPcmFormat(deviceParams.sampleFormat, deviceParams.packed24);
+    m_spectrum.configure(m_outputFormat, static_cast<int>(channels), static_cast<int>(sampleRate));
+    const size_t frameBytes = static_cast<size_t>(deviceParams.channels) * AudioKernels::bytesPerSample(m_outputFormat);
+    const int64_t bytesPerSecond = static_cast<int64_t>(frameBytes) * deviceParams.sampleRate;
+    m_outputBytesPerSecond.store(bytesPerSecond);
+    m_bufferTargetBytes.store(static_cast<size_t>(bytesPerSecond * bufferSeconds) / frameBytes * frameBytes);
+    m_lowWaterBytes.store(static_cast<size_t>(bytesPerSecond * lowWaterSeconds) / frameBytes * frameBytes);
+    m_ringBuffer.reset(static_cast<size_t>(bytesPerSecond * (bufferSeconds + RING_HEADROOM_SECONDS)), frameBytes);
+    m_timeMarkers.clear();
+    m_streamMarkers.clear();
+    m_activeMarker = TimeMarker{};
+    m_lastReadEnd = 0;
+    m_underrunArmed = false;
+    m_inUnderrun = false;
+    m_sessionStartPos = 0;
+    m_lastFramePos = 0;
+}
+
 // --- Critical: Miniaudio Callback ---
 void AudioPlayer::ma_data_callback(ma_device *pDevice, void *pOutput, const void *pInput, ma_uint32 frameCount)
 {
@@ -616,84 +1466,126 @@ void AudioPlayer::ma_data_callback(ma_device *pDevice, void *pOutput, const void
     if (!player)
         return;
 
-    // 计算需要的总字节数
-    int bytesPerSample = av_get_bytes_per_sample(player->deviceParams.sampleFormat);
-    int channels = player->deviceParams.channels;
-    int totalBytesNeeded = frameCount * channels * bytesPerSample;
+    // 本次回调的截止时间为一个周期 (frameCount 帧) 的时长
+    const int64_t deadlineUs = pDevice->sampleRate ? static_cast<int64_t>(frameCount) * 1000000 / pDevice->sampleRate : 0;
+    const auto callbackStart = std::chrono::steady_clock::now();
 
+    // 回调线程只做内存拷贝：不加锁、不分配、不通知解码线程
+    AudioRingBuffer &ring = player->m_ringBuffer;
+    const size_t totalBytesNeeded = static_cast<size_t>(frameCount) * ring.frameBytes();
     uint8_t *outPtr = static_cast<uint8_t *>(pOutput);
-    int bytesWritten = 0;
 
-    // 必须全程持有锁
-    std::lock_guard<std::mutex> lock(player->audioFrameQueueMutex);
+    uint64_t startPos = 0;
+    const size_t bytesRead = player->readOutput(outPtr, totalBytesNeeded, startPos, nullptr);
 
-    while (bytesWritten < totalBytesNeeded)
+    // 播放时钟：这批数据的起点在设备缓冲区中的数据播完后才会被听到
+    const int64_t bytesPerSecond = player->m_outputBytesPerSecond.load(std::memory_order_relaxed);
+    if (bytesRead > 0 && bytesPerSecond > 0)
     {
-        // 1. 获取数据帧
-        if (!player->m_currentFrame)
-        {
-            if (player->audioFrameQueue.empty())
-            {
-                // 队列为空，通知解码线程
-                player->stateCondVar.notify_one();
-                break; // 退出循环，填充静音
-            }
-
-            player->m_currentFrame = player->audioFrameQueue.front();
-            player->audioFrameQueue.pop();
-            player->m_currentFramePos = 0;
+        const int64_t hostNs = std::chrono::duration_cast<std::chrono::nanoseconds>(callbackStart.time_since_epoch()).count();
+        player->m_clock.update(player->nowPlayingTime.load(), static_cast<int64_t>(bytesRead) * 1000000 / bytesPerSecond,
+                               player->m_outputLatencyUs.load(std::memory_order_relaxed), hostNs, player->m_activeMarker.speed);
+    }
 
-            if (player->m_currentFrame)
-            {
-                player->nowPlayingTime.store(player->m_currentFrame->pts);
-            }
-            player->stateCondVar.notify_one();
-        }
+    // 断流检测：只在 "正常 -> 缺数据" 的跳变时上报一次
+    if (bytesRead == totalBytesNeeded)
+    {
+        player->m_underrunArmed = true;
+        player->m_inUnderrun = false;
+    }
+    else if (player->m_underrunArmed && !player->m_inUnderrun && !player->m_streamEnded)
+    {
+        player->m_inUnderrun = true;
+        const int64_t missingFrames = static_cast<int64_t>((totalBytesNeeded - bytesRead) / ring.frameBytes());
+        player->m_underrunCount.fetch_add(1, std::memory_order_relaxed);
+        player->pushEvent({PlaybackEventType::Underrun, player->nowPlayingTime.load(), missingFrames});
+    }
 
-        if (!player->m_currentFrame)
+    // 如果数据不足，填充静音 (Miniaudio 要求填满 buffer)
+    if (bytesRead < totalBytesNeeded)
+    {
+        memset(outPtr + bytesRead, 0, totalBytesNeeded - bytesRead);
+        // 断流期间 (含跳变之后的后续回调) 补上的静音都计入断流时长
+        if (player->m_inUnderrun && pDevice->sampleRate)
         {
-            break;
+            const uint64_t missingFrames = (totalBytesNeeded - bytesRead) / ring.frameBytes();
+            player->m_underrunSilenceUs.fetch_add(missingFrames * 1000000 / pDevice->sampleRate, std::memory_order_relaxed);
         }
+    }
 
-        // 实时更新 nowPlayingTime (平滑插值)
-        // 基础时间 (帧开始时间) + 偏移时间 (已播放字节对应的时间)
-        // 计算公式：偏移字节 / (通道数 * 采样深度) / 采样率 * 1000000
-        if (player->deviceParams.sampleRate > 0)
-        {
-            int64_t bytesAlreadyPlayedInFrame = player->m_currentFramePos;
-            int64_t offsetMicroseconds = (bytesAlreadyPlayedInFrame * 1000000) / (channels * bytesPerSample * player->deviceParams.sampleRate);
+    // 频谱 / 电平表采集实际送往设备的数据 (含补上的静音)，关闭时只有一次原子读取
+    player->m_spectrum.write(outPtr, totalBytesNeeded);
 
-            player->nowPlayingTime.store(player->m_currentFrame->pts + offsetMicroseconds);
-        }
+    const int64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - callbackStart).count();
+    player->m_callbackLatency.record(static_cast<uint64_t>(elapsedUs));
+    player->m_callbackDeadlineUs.store(deadlineUs, std::memory_order_relaxed);
+    if (deadlineUs > 0 && elapsedUs > deadlineUs)
+    {
+        player->m_deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
-        // 2. 拷贝数据
-        size_t frameSize = player->m_currentFrame->data.size();
-        int frameRemaining = static_cast<int>(frameSize - player->m_currentFramePos);
-        int bytesNeeded = totalBytesNeeded - bytesWritten;
-        int copySize = std::min(frameRemaining, bytesNeeded);
+size_t AudioPlayer::readOutput(uint8_t *out, size_t bytes, uint64_t &startPos, std::vector<StreamMarker> *collected)
+{
+    // 设备回调或离线渲染线程 (二者不会同时存在) 调用，读取并推进时间 / 流标记
+    const size_t bytesRead = m_ringBuffer.read(out, bytes, &startPos);
 
-        if (copySize > 0)
+    if (bytesRead > 0)
+    {
+        // 推进时间标记到当前读取位置
+        while (const TimeMarker *marker = m_timeMarkers.front())
         {
-            memcpy(outPtr + bytesWritten,
-                   player->m_currentFrame->data.data() + player->m_currentFramePos,
-                   copySize);
-
-            bytesWritten += copySize;
-            player->m_currentFramePos += copySize;
+            if (marker->position > startPos)
+                break;
+            m_activeMarker = *marker;
+            m_timeMarkers.pop();
         }
 
-        // 3. 帧用尽
-        if (player->m_currentFramePos >= frameSize)
+        // 实时更新 nowPlayingTime (平滑插值)
+        // 基础时间 (标记时间) + 偏移时间 (标记之后已播放字节对应的时间)
+        const int64_t bytesPerSecond = m_outputBytesPerSecond.load(std::memory_order_relaxed);
+        if (bytesPerSecond > 0)
         {
-            player->m_currentFrame.reset();
+            int64_t offsetBytes = static_cast<int64_t>(startPos - m_activeMarker.position);
+            nowPlayingTime.store(m_activeMarker.ptsUs + static_cast<int64_t>(static_cast<double>(offsetBytes * 1000000 / bytesPerSecond) * m_activeMarker.speed));
         }
     }
 
-    // 4. 如果数据不足，填充静音 (Miniaudio 要求填满 buffer)
-    if (bytesWritten < totalBytesNeeded)
+    // 跳过了被丢弃的数据 (Seek / 切歌)：需要先完整读到一次数据才重新开始断流检测
+    const uint64_t endPos = startPos + bytesRead;
+    if (startPos != m_lastReadEnd)
+    {
+        m_underrunArmed = false;
+    }
+    m_lastReadEnd = endPos;
+
+    // 流事件 (曲目开始 / 无缝切换 / 分轨边界 / 播放结束)：在真正播放到该采样点的这次读取中发出
+    // 位于被丢弃区域中的标记直接跳过；离线渲染时交给调用方而不是控制器
+    while (const StreamMarker *marker = m_streamMarkers.front())
     {
-        memset(outPtr + bytesWritten, 0, totalBytesNeeded - bytesWritten);
+        if (marker->position >= endPos)
+            break;
+        if (marker->position >= startPos)
+        {
+            switch (marker->event.type)
+            {
+            case PlaybackEventType::TrackStarted:
+            case PlaybackEventType::SeamlessSwitch: m_streamEnded = false; break;
+            case PlaybackEventType::TrackFinished: m_streamEnded = true; break;
+            default: break;
+            }
+            if (collected)
+            {
+                collected->push_back(*marker);
+            }
+            else
+            {
+                pushEvent(marker->event);
+            }
+        }
+        m_streamMarkers.pop();
     }
+    return bytesRead;
 }
 
 // --- Decoder Thread & Logic ---
@@ -704,17 +1596,26 @@ void AudioPlayer::mainDecodeThread()
 
     while (!quitFlag.load())
     {
+        if (m_realtimeDirty.exchange(false))
+        {
+            applyRealtimeSettings();
+        }
+
         std::string path;
+        int64_t startPosition = 0;
         {
             std::unique_lock<std::mutex> lock(pathMutex);
             pathCondVar.wait(lock, [this]
-                             { return !currentPath.empty() || quitFlag.load(); });
+                             { return (!currentPath.empty() && !m_rendering.load()) || quitFlag.load() || m_realtimeDirty.load(); });
             if (quitFlag.load())
                 break;
+            if (currentPath.empty())
+                continue; // 只是实时模式有变化
             path = currentPath;
+            startPosition = currentStartPosition;
         }
 
-        if (setupDecodingSession(path))
+        if (setupDecodingSession(path, startPosition))
         {
             // 初始状态恢复
             {
@@ -724,16 +1625,13 @@ void AudioPlayer::mainDecodeThread()
                     playingState = isFirstPlay ? PlayerState::PAUSED : oldPlayingState;
                 }
 
-                if (m_deviceInited)
+                if (playingState == PlayerState::PLAYING)
                 {
-                    if (playingState == PlayerState::PLAYING)
-                    {
-                        ma_device_start(&m_device);
-                    }
-                    else
-                    {
-                        ma_device_stop(&m_device);
-                    }
+                    startDevice();
+                }
+                else
+                {
+                    stopDevice();
                 }
             }
 
@@ -748,6 +1646,12 @@ void AudioPlayer::mainDecodeThread()
                     continue;
                 }
 
+                if (m_realtimeDirty.exchange(false))
+                {
+                    applyRealtimeSettings();
+                    continue;
+                }
+
                 if (playingState == PlayerState::SEEKING)
                 {
                     handleSeekRequest();
@@ -761,149 +1665,469 @@ void AudioPlayer::mainDecodeThread()
                 }
             }
 
-            freeResources();
+            // Direct 模式格式变化切歌：设备即将重建，先让当前缓冲的尾音播放完
+            if (!playbackFinishedNaturally && hasPreloaded.load())
+            {
+                drainRingBuffer();
+            }
+
+            {
+                std::lock_guard<std::mutex> decodeLock(decodeMutex);
+                if (playbackFinishedNaturally)
+                {
+                    // 自然结束时保留缓冲区中的尾音，让设备播放完毕
+                    m_ringBuffer.publish();
+                    releaseSession(std::move(m_currentSource));
+                    cancelCrossfade();
+                }
+                else
+                {
+                    freeResources();
+                }
+            }
             if (playbackFinishedNaturally)
             {
-                std::lock_guard<std::mutex> lock(pathMutex);
-                currentPath.clear();
-                preloadPath.clear();
+                std::lock_guard<std::mutex> lock(pathMutex);
+                currentPath.clear();
+                preloadPath.clear();
+            }
+        }
+        else
+        {
+            {
+                std::lock_guard<std::mutex> decodeLock(decodeMutex);
+                freeResources();
+            }
+            std::lock_guard<std::mutex> lock(pathMutex);
+            currentPath.clear();
+        }
+    }
+    av_packet_free(&packet);
+}
+
+RenderResult AudioPlayer::renderOffline(const std::vector<std::string> &playlist, const RenderOptions &options)
+{
+    RenderResult result;
+    if (playlist.empty())
+    {
+        result.error = "empty playlist";
+        return result;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pathMutex);
+        if (!currentPath.empty() || m_rendering.load())
+        {
+            result.error = "player is busy";
+            return result;
+        }
+        // 渲染期间解码线程不接管 currentPath；预加载与格式变化切歌沿用播放时的路径交接
+        m_rendering.store(true);
+        currentPath = playlist[0];
+        currentStartPosition = std::max<int64_t>(options.startPositionUs, 0);
+        preloadPath = (playlist.size() > 1) ? playlist[1] : std::string();
+        preloadStartPosition = 0;
+    }
+
+    std::unique_lock<std::mutex> decodeLock(decodeMutex);
+    // 输出不经过设备：环形缓冲区只由本线程读写
+    closeAudioDevice();
+    m_renderOutputReady = false;
+
+    RenderWriter writer;
+    AVPacket *packet = av_packet_alloc();
+    std::vector<uint8_t> chunk;
+    std::vector<StreamMarker> markers;
+    size_t nextIndex = 2;
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    // 取空环形缓冲区写入输出。平时最后一帧保留在暂存区 (曲目结束时可能被原地淡出)，会话结束时一并发布
+    auto drain = [&](bool finalize) -> bool
+    {
+        if (finalize)
+        {
+            m_ringBuffer.publish();
+        }
+        const size_t frameBytes = m_ringBuffer.frameBytes();
+        uint64_t startPos = 0;
+        size_t bytes = 0;
+        while ((bytes = readOutput(chunk.data(), chunk.size(), startPos, &markers)) > 0)
+        {
+            for (const StreamMarker &marker : markers)
+            {
+                if (marker.event.type == PlaybackEventType::TrackStarted || marker.event.type == PlaybackEventType::SeamlessSwitch)
+                {
+                    result.trackStartFrames.push_back(result.frames + (marker.position - startPos) / frameBytes);
+                }
+            }
+            markers.clear();
+            if (result.frames == 0)
+            {
+                result.firstSampleSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+            }
+            if (!writer.write(chunk.data(), bytes))
+            {
+                result.error = "write failed";
+                return false;
+            }
+            result.frames += bytes / frameBytes;
+        }
+        return true;
+    };
+
+    bool ok = (packet != nullptr);
+    bool limitReached = false;
+    while (ok && !limitReached)
+    {
+        std::string path;
+        int64_t startPosition = 0;
+        {
+            std::lock_guard<std::mutex> lock(pathMutex);
+            path = currentPath;
+            startPosition = currentStartPosition;
+        }
+        if (path.empty())
+            break;
+
+        if (!setupDecodingSession(path, startPosition))
+        {
+            result.error = std::format("cannot open {}", path);
+            ok = false;
+            break;
+        }
+
+        // 输出格式由第一个会话确定；Direct 模式下之后的曲目格式不同时无法写入同一个文件
+        if (!writer.isOpen())
+        {
+            result.format = deviceParams;
+            const uint64_t mask = (deviceParams.ch_layout.order == AV_CHANNEL_ORDER_NATIVE) ? deviceParams.ch_layout.u.mask : 0;
+            if (!writer.open(options.sink, options.outputPath, m_outputFormat, deviceParams.channels, deviceParams.sampleRate, mask))
+            {
+                result.error = std::format("cannot create {}", options.outputPath);
+                ok = false;
+                break;
+            }
+            chunk.resize(RENDER_CHUNK_FRAMES * m_ringBuffer.frameBytes());
+        }
+        else if (deviceParams.sampleFormat != result.format.sampleFormat || deviceParams.channels != result.format.channels ||
+                 deviceParams.sampleRate != result.format.sampleRate)
+        {
+            result.error = std::format("output format changes at {} (render in mixing mode instead)", path);
+            ok = false;
+            break;
+        }
+
+        bool isSongLoopActive = true;
+        bool playbackFinishedNaturally = false;
+        const uint64_t frameLimit = (options.maxSeconds > 0) ? static_cast<uint64_t>(options.maxSeconds * deviceParams.sampleRate) : 0;
+        while (isSongLoopActive && ok)
+        {
+            decodeAndProcessPacket(packet, isSongLoopActive, playbackFinishedNaturally);
+            ok = drain(false);
+            if (frameLimit > 0 && result.frames >= frameLimit)
+            {
+                limitReached = true;
+                break;
+            }
+
+            // 播放时由控制器在切歌后设置下一首，这里按播放列表顺序补上
+            std::lock_guard<std::mutex> lock(pathMutex);
+            if (preloadPath.empty() && !hasPreloaded.load() && nextIndex < playlist.size())
+            {
+                preloadPath = playlist[nextIndex++];
+                preloadStartPosition = 0;
+            }
+        }
+        if (!ok || !drain(true))
+        {
+            ok = false;
+            break;
+        }
+
+        if (limitReached)
+        {
+            // 会话放回缓存 (之后再次渲染同一文件时无需重新打开)
+            freeResources();
+        }
+        else if (playbackFinishedNaturally)
+        {
+            releaseSession(std::move(m_currentSource));
+            cancelCrossfade();
+            std::lock_guard<std::mutex> lock(pathMutex);
+            currentPath.clear();
+        }
+        else
+        {
+            // Direct 模式格式变化时 currentPath 已换成下一首；仍是当前文件说明读取 / 解码出错
+            std::string next;
+            {
+                std::lock_guard<std::mutex> lock(pathMutex);
+                next = currentPath;
+            }
+            if (next == path)
+            {
+                result.error = std::format("decoding failed in {}", path);
+                ok = false;
+                break;
+            }
+            freeResources();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pathMutex);
+        currentPath.clear();
+        preloadPath.clear();
+    }
+    freeResources();
+    cancelCrossfade();
+    av_packet_free(&packet);
+    if (!writer.close() && ok)
+    {
+        result.error = "write failed";
+        ok = false;
+    }
+    m_renderOutputReady = false;
+    m_rendering.store(false);
+    decodeLock.unlock();
+
+    result.ok = ok;
+    result.tracks = result.trackStartFrames.size();
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    result.audioSeconds = result.format.sampleRate > 0 ? static_cast<double>(result.frames) / result.format.sampleRate : 0.0;
+    if (ok)
+    {
+        spdlog::info("[AudioPlayer] Rendered {} tracks, {:.1f} s of audio in {:.2f} s ({:.1f}x realtime)",
+                     result.tracks, result.audioSeconds, result.wallSeconds, result.realtimeFactor());
+    }
+    else
+    {
+        spdlog::error("[AudioPlayer] Offline render failed: {}", result.error);
+    }
+    return result;
+}
+
+bool AudioPlayer::waitForDecodeState()
+{
+    std::unique_lock<std::mutex> lock(stateMutex);
+    while (!(quitFlag.load() || playingState == PlayerState::STOPPED || playingState == PlayerState::SEEKING || m_realtimeDirty.load()))
+    {
+        if (playingState == PlayerState::PLAYING)
+        {
+            // 跌破低水位时开始补充，之后一直解码到目标水位 (低功耗策略下为一次连续解码数秒)
+            const size_t buffered = m_ringBuffer.bufferedBytes();
+            if (buffered < m_lowWaterBytes.load())
+            {
+                m_refilling = true;
             }
+            if (m_refilling && buffered < m_bufferTargetBytes.load() && m_ringBuffer.writableBytes() > 0)
+                break;
+            m_refilling = false;
+            // 回调不会通知，休眠到预计降至低水位的时刻再检查
+            stateCondVar.wait_for(lock, refillWaitTime(buffered));
         }
         else
         {
-            freeResources();
-            std::lock_guard<std::mutex> lock(pathMutex);
-            currentPath.clear();
+            stateCondVar.wait(lock); // Paused -> wait
         }
     }
-    av_packet_free(&packet);
+
+    return !(quitFlag.load() || playingState == PlayerState::STOPPED);
 }
 
-bool AudioPlayer::waitForDecodeState()
+std::chrono::milliseconds AudioPlayer::refillWaitTime(size_t bufferedBytes) const
 {
-    std::unique_lock<std::mutex> lock(stateMutex);
-    stateCondVar.wait(lock, [this]
-                      {
-                          if (quitFlag.load() || playingState == PlayerState::STOPPED || playingState == PlayerState::SEEKING)
-                              return true;
-                          if (playingState == PlayerState::PLAYING)
-                          {
-                              std::lock_guard<std::mutex> qLock(audioFrameQueueMutex);
-                              return audioFrameQueue.size() < audioFrameQueueMaxSize.load();
-                          }
-                          return false; // Paused -> wait
-                      });
-
-    return !(quitFlag.load() || playingState == PlayerState::STOPPED);
+    const LatencyProfileConfig profile = latencyProfileConfig(m_latencyProfile.load());
+    const int64_t bytesPerSecond = m_outputBytesPerSecond.load();
+    const size_t lowWater = m_lowWaterBytes.load();
+    int64_t waitMs = 0;
+    if (bytesPerSecond > 0 && bufferedBytes > lowWater)
+    {
+        waitMs = static_cast<int64_t>(bufferedBytes - lowWater) * 1000 / bytesPerSecond;
+    }
+    return std::chrono::milliseconds(std::max<int64_t>(waitMs, profile.minPollMs));
 }
 
 void AudioPlayer::handleSeekRequest()
 {
-    flushQueue();
-
-    // seek 时也要保护，虽然 seekTarget 由 stateMutex 保护，但操作 ffmpeg 上下文最好也互斥
-    std::lock_guard<std::mutex> decodeLock(decodeMutex);
-
-    if (!m_currentSource)
+    int64_t target = seekTarget.load();
     {
-        return;
-    }
+        // seek 时也要保护，虽然 seekTarget 由 stateMutex 保护，但操作 ffmpeg 上下文最好也互斥
+        // 注意：先释放 decodeMutex 再获取 stateMutex，与 setMixingParameters 的加锁顺序保持一致
+        std::lock_guard<std::mutex> decodeLock(decodeMutex);
 
-    int streamIdx = m_currentSource->audioStreamIndex;
-    if (streamIdx < 0)
-        return;
+        flushQueue();
 
-    AVRational tb = m_currentSource->pFormatCtx->streams[streamIdx]->time_base;
-    int64_t target = seekTarget.load();
-    int64_t stream_ts = av_rescale_q(target, AV_TIME_BASE_Q, tb);
+        if (!m_currentSource || m_currentSource->audioStreamIndex < 0)
+        {
+            return;
+        }
 
-    av_seek_frame(m_currentSource->pFormatCtx, streamIdx, stream_ts, AVSEEK_FLAG_BACKWARD);
-    avcodec_flush_buffers(m_currentSource->pCodecCtx);
+        m_currentSource->seekTo(target);
+        startDecodeAhead(*m_currentSource);
+        resetDirectCopyStats();
+        // 已提前解码的预加载源与新位置不再衔接，交给 triggerPreload 重新打开
+        if (m_crossfadeActive)
+        {
+            cancelCrossfade();
+        }
+        // 清空 swr 内部残留的旧位置样本
+        m_currentSource->openSwrContext(resampleTarget(), 1.0, errorBuffer);
+        loadTrackBoundaries(target);
+        // 游标从解码实际开始的位置推算，裁剪逻辑据此丢弃目标之前的样本
+        m_decoderCursor.store(m_currentSource->landingUs);
+        nowPlayingTime.store(target);
+        m_clock.reset(target);
+        m_dspChain.reset();
+    }
 
     {
         std::lock_guard<std::mutex> stateLock(stateMutex);
         playingState = oldPlayingState;
-        if (playingState == PlayerState::PLAYING && m_deviceInited)
+        if (playingState == PlayerState::PLAYING)
         {
-            ma_device_start(&m_device);
+            startDevice();
         }
     }
-    m_decoderCursor.store(target);
-    nowPlayingTime.store(target);
+    pushEvent({PlaybackEventType::SeekCompleted, target, 0});
 }
 
 void AudioPlayer::decodeAndProcessPacket(AVPacket *packet, bool &isSongLoopActive, bool &playbackFinishedNaturally)
 {
+    if (m_currentSource->decodeAhead)
+    {
+        processDecodeAheadFrame(isSongLoopActive, playbackFinishedNaturally);
+        return;
+    }
+
     int ret = av_read_frame(m_currentSource->pFormatCtx, packet);
     if (ret < 0)
     {
-        if (ret == AVERROR_EOF)
+        // 多线程 / 有内部延迟的解码器在文件末尾仍持有若干帧，先全部取出 (与提前解码的结尾一致)
+        m_currentSource->decoderFed = true;
+        if (ret == AVERROR_EOF && avcodec_send_packet(m_currentSource->pCodecCtx, nullptr) >= 0)
         {
-            // Bug Fix 3: Logic for switching songs
-
-            // 情况 A: Mixing 模式且有预加载源 -> 无缝切换
-            if (outputMode.load() == OUTPUT_MIXING)
+            AVFrame *frame = av_frame_alloc();
+            while (frame && avcodec_receive_frame(m_currentSource->pCodecCtx, frame) >= 0)
             {
-                if (performSeamlessSwitch())
-                    return;
+                if (!processFrame(frame))
+                    break;
             }
-            else if (outputMode.load() == OUTPUT_DIRECT)
-            {
-                // 情况 B: Direct 模式，检查是否有 preloadPath
-                // Direct 模式下不能做无缝DSP混音，必须重新打开设备。
-                // 这里的策略是：将 preloadPath 移至 currentPath，然后跳出当前 loop，
-                // 但设置 playbackFinishedNaturally = false，这样外层循环不会清空 currentPath，
-                // 而是再次调用 setupDecodingSession，从而根据新文件重新初始化设备。
-
-                std::string nextPath;
-                {
-                    std::lock_guard<std::mutex> lock(pathMutex);
-                    nextPath = preloadPath;
-                }
+            av_frame_free(&frame);
+        }
+        handleEndOfInput(ret, isSongLoopActive, playbackFinishedNaturally);
+        return;
+    }
 
-                if (!nextPath.empty())
+    if (packet->stream_index == m_currentSource->audioStreamIndex)
+    {
+        // 解码耗时只统计 send / receive 本身，不含后续的重采样与处理级
+        auto decodeStart = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration decodeTime{};
+        m_currentSource->decoderFed = true;
+        if (avcodec_send_packet(m_currentSource->pCodecCtx, packet) >= 0)
+        {
+            AVFrame *frame = av_frame_alloc();
+            while (avcodec_receive_frame(m_currentSource->pCodecCtx, frame) >= 0)
+            {
+                decodeTime += std::chrono::steady_clock::now() - decodeStart;
+                bool ok = processFrame(frame);
+                decodeStart = std::chrono::steady_clock::now();
+                if (!ok)
                 {
-                    {
-                        std::lock_guard<std::mutex> lock(pathMutex);
-                        currentPath = nextPath;
-                        preloadPath.clear();
-                    }
-                    // 关键：不设为 naturally finished，也不清空 currentPath
-                    playbackFinishedNaturally = false;
-                    isSongLoopActive = false; // 退出内层循环
-                    return;
+                    isSongLoopActive = false;
+                    break; // Error during processing
                 }
             }
+            av_frame_free(&frame);
+        }
+        decodeTime += std::chrono::steady_clock::now() - decodeStart;
+        m_decodeLatency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(decodeTime).count()));
+    }
+    av_packet_unref(packet);
+}
 
-            // 没有下一首，正常结束
-            playbackFinishedNaturally = true;
+void AudioPlayer::processDecodeAheadFrame(bool &isSongLoopActive, bool &playbackFinishedNaturally)
+{
+    if (!m_aheadFrame)
+    {
+        m_aheadFrame = av_frame_alloc();
+        if (!m_aheadFrame)
+        {
             isSongLoopActive = false;
+            return;
         }
-        else
+    }
+
+    int error = 0;
+    DecodeAhead::Status status = m_currentSource->decodeAhead->pop(m_aheadFrame, error);
+    if (status == DecodeAhead::Status::Frame)
+    {
+        if (!processFrame(m_aheadFrame))
         {
-            spdlog::error("Read error: {}", my_av_strerror(ret));
             isSongLoopActive = false;
         }
+        av_frame_unref(m_aheadFrame);
         return;
     }
 
-    if (packet->stream_index == m_currentSource->audioStreamIndex)
+    // 工作线程已读完 (解码器中的剩余帧也已取出) 或出错：收回上下文，按同步路径处理结尾
+    m_currentSource->stopDecodeAhead();
+    handleEndOfInput(status == DecodeAhead::Status::EndOfStream ? AVERROR_EOF : error, isSongLoopActive, playbackFinishedNaturally);
+}
+
+void AudioPlayer::handleEndOfInput(int ret, bool &isSongLoopActive, bool &playbackFinishedNaturally)
+{
+    if (ret == AVERROR_EOF)
     {
-        if (avcodec_send_packet(m_currentSource->pCodecCtx, packet) >= 0)
+        drainTempoFilter();
+
+        // Bug Fix 3: Logic for switching songs
+
+        // 情况 A: 有预加载源且可以沿用当前设备 -> 无缝切换
+        // (Mixing 模式总是可以；Direct 模式要求下一首的原生格式与设备一致)
+        if (performSeamlessSwitch())
+            return;
+
+        if (outputMode.load() == OUTPUT_DIRECT)
         {
-            AVFrame *frame = av_frame_alloc();
-            while (avcodec_receive_frame(m_currentSource->pCodecCtx, frame) >= 0)
+            // 情况 B: Direct 模式且格式不一致，必须重新打开设备。
+            // 这里的策略是：将 preloadPath 移至 currentPath，然后跳出当前 loop，
+            // 但设置 playbackFinishedNaturally = false，这样外层循环不会清空 currentPath，
+            // 而是再次调用 setupDecodingSession，从而根据新文件重新初始化设备。
+            // 已预加载的源会被保留，新会话直接接管，无需再次打开文件。
+
+            std::string nextPath;
+            {
+                std::lock_guard<std::mutex> lock(pathMutex);
+                nextPath = preloadPath;
+            }
+
+            if (!nextPath.empty())
             {
-                if (!processFrame(frame))
                 {
-                    isSongLoopActive = false;
-                    break; // Error during processing
+                    std::lock_guard<std::mutex> lock(pathMutex);
+                    currentPath = nextPath;
+                    currentStartPosition = preloadStartPosition;
+                    preloadPath.clear();
                 }
+                // 关键：不设为 naturally finished，也不清空 currentPath
+                playbackFinishedNaturally = false;
+                isSongLoopActive = false; // 退出内层循环
+                return;
             }
-            av_frame_free(&frame);
         }
+
+        // 没有下一首，正常结束 (最后一个采样点播放时通知控制器)
+        markTrackFinished();
+        playbackFinishedNaturally = true;
+        isSongLoopActive = false;
+    }
+    else
+    {
+        spdlog::error("Read error: {}", my_av_strerror(ret));
+        isSongLoopActive = false;
     }
-    av_packet_unref(packet);
 }
 
 bool AudioPlayer::processFrame(AVFrame *frame)
@@ -911,75 +2135,438 @@ bool AudioPlayer::processFrame(AVFrame *frame)
     if (!frame || !m_currentSource)
         return false;
 
+    const uint8_t **input = nullptr;
+    int inputSamples = 0;
+    int64_t ptsMicro = 0;
+    int64_t cursor = m_decoderCursor.load();
+    bool hasSamples = prepareFrame(*m_currentSource, frame, cursor, input, inputSamples, ptsMicro);
+    m_decoderCursor.store(cursor);
+    if (!hasSamples)
+        return true; // 整帧都在目标之前
+
+    triggerPreload(static_cast<double>(ptsMicro) / 1000000.0);
+
+    // 变速：速度为 1 且滤镜图未建立时直接输出 (Direct 模式保持逐位一致)
+    // 滤镜图在第一次需要时按解码器的输出格式建立，之后改变速度只发送命令
+    TempoFilter &tempo = m_currentSource->tempo;
+    const double speed = m_playbackSpeed.load(std::memory_order_relaxed);
+    if (!tempo.isOpen() && (speed == 1.0 || !tempo.open(frame, speed)))
+    {
+        m_tempoActive.store(false, std::memory_order_relaxed);
+        return writeToRingBuffer(input, inputSamples, ptsMicro, 1.0);
+    }
+
+    m_tempoActive.store(true, std::memory_order_relaxed);
+    tempo.setSpeed(speed);
+    if (!tempo.send(frame, input, inputSamples, ptsMicro))
+    {
+        spdlog::warn("[AudioPlayer] Tempo filter rejected a frame, continuing at normal speed");
+        tempo.close();
+        return writeToRingBuffer(input, inputSamples, ptsMicro, 1.0);
+    }
+    return writeTempoOutput();
+}
+
+bool AudioPlayer::writeTempoOutput()
+{
+    TempoFilter &tempo = m_currentSource->tempo;
+    int64_t ptsUs = 0;
+    while (AVFrame *out = tempo.receive(ptsUs))
+    {
+        if (!writeToRingBuffer(const_cast<const uint8_t **>(out->extended_data), out->nb_samples, ptsUs, tempo.speed()))
+            return false;
+    }
+    return true;
+}
+
+void AudioPlayer::drainTempoFilter()
+{
+    // 文件结束：取出 atempo 内部缓存的最后一段样本 (之后滤镜图不能再送入，定位 / 重新开始时会重建)
+    TempoFilter &tempo = m_currentSource->tempo;
+    if (!tempo.isOpen())
+        return;
+    if (tempo.send(nullptr, nullptr, 0, 0))
+    {
+        writeTempoOutput();
+    }
+    tempo.close();
+}
+
+bool AudioPlayer::prepareFrame(AudioStreamSource &source, AVFrame *frame, int64_t &cursorUs, const uint8_t **&input, int &inputSamples, int64_t &ptsMicro)
+{
     // 计算当前帧的时长 (秒)
     double frameDurationSec = (double)frame->nb_samples / frame->sample_rate;
     int64_t frameDurationMicro = static_cast<int64_t>(frameDurationSec * 1000000);
 
-    // 确定 PTS
-    int64_t ptsMicro = 0;
-
-    // 尝试从 FFmpeg 获取
-    if (frame->best_effort_timestamp != AV_NOPTS_VALUE)
+    // 尝试从 FFmpeg 获取 (按字节定位之后的时间戳不可信，只用游标)
+    if (frame->best_effort_timestamp != AV_NOPTS_VALUE && !source.timestampsUnreliable)
     {
-        double ptsSec = frame->best_effort_timestamp * av_q2d(m_currentSource->pFormatCtx->streams[m_currentSource->audioStreamIndex]->time_base);
+        double ptsSec = frame->best_effort_timestamp * av_q2d(source.pFormatCtx->streams[source.audioStreamIndex]->time_base);
         ptsMicro = static_cast<int64_t>(ptsSec * 1000000);
 
         // 既然拿到了准确时间，同步更新我们的游标，供下一帧（如果丢失PTS）使用
-        m_decoderCursor.store(ptsMicro + frameDurationMicro);
+        cursorUs = ptsMicro + frameDurationMicro;
     }
     else
     {
         // FFmpeg 没给时间 (APE/WAV 常见情况)，使用我们要维护的游标
         // 绝对不要使用 nowPlayingTime.load() !
-        ptsMicro = m_decoderCursor.load();
+        ptsMicro = cursorUs;
 
         // 累加游标
-        m_decoderCursor.fetch_add(frameDurationMicro);
+        cursorUs += frameDurationMicro;
     }
 
-    triggerPreload(static_cast<double>(ptsMicro) / 1000000.0);
+    input = const_cast<const uint8_t **>(frame->extended_data);
+    inputSamples = frame->nb_samples;
+
+    // Seek / 分轨起点之后：丢弃目标时间之前的样本 (落点在之前的关键帧)
+    int64_t trimUntil = source.trimUntilUs;
+    if (trimUntil >= 0)
+    {
+        if (ptsMicro + frameDurationMicro <= trimUntil)
+            return false; // 整帧都在目标之前
+
+        if (ptsMicro < trimUntil)
+        {
+            int skip = static_cast<int>(std::min<int64_t>(av_rescale(trimUntil - ptsMicro, frame->sample_rate, 1000000), inputSamples));
+            AVSampleFormat fmt = static_cast<AVSampleFormat>(frame->format);
+            int channels = frame->ch_layout.nb_channels;
+            bool planar = av_sample_fmt_is_planar(fmt);
+            size_t skipBytes = static_cast<size_t>(skip) * av_get_bytes_per_sample(fmt) * (planar ? 1 : channels);
+
+            source.trimmedPlanes.resize(planar ? channels : 1);
+            for (size_t p = 0; p < source.trimmedPlanes.size(); ++p)
+            {
+                source.trimmedPlanes[p] = frame->extended_data[p] + skipBytes;
+            }
+            input = source.trimmedPlanes.data();
+            inputSamples -= skip;
+            ptsMicro = trimUntil;
+        }
+        source.trimUntilUs = -1;
+    }
+    return true;
+}
 
-    // 重采样
-    int64_t delay = swr_get_delay(m_currentSource->swrCtx, frame->sample_rate);
-    int64_t out_samples = av_rescale_rnd(delay + frame->nb_samples, deviceParams.sampleRate, frame->sample_rate, AV_ROUND_UP);
+bool AudioPlayer::writeToRingBuffer(const uint8_t **input, int inputSamples, int64_t ptsMicro, double speed)
+{
+    SwrContext *swr = m_currentSource->swrCtx;
+    if (!swr)
+        return false;
 
-    // 准备输出 buffer
-    auto audioFrame = std::make_shared<AudioFrame>();
-    audioFrame->pts = ptsMicro;
+    // 上一帧此刻才对回调可见：始终保留最后一帧在暂存区，曲目结束时可以原地淡出
+    m_ringBuffer.publish();
 
-    int out_bytes_per_sample = av_get_bytes_per_sample(deviceParams.sampleFormat);
-    int out_channels = deviceParams.channels;
-    int buffer_size = static_cast<int>(out_samples * out_channels * out_bytes_per_sample);
+    // swr 内部缓存的样本属于更早的输入，输出起点的时间需要减去这部分延迟 (变速时每个样本对应 speed 倍的媒体时长)
+    const int inputRate = m_currentSource->pCodecCtx->sample_rate;
+    if (inputRate > 0)
+    {
+        ptsMicro -= static_cast<int64_t>(static_cast<double>(av_rescale(swr_get_delay(swr, inputRate), 1000000, inputRate)) * speed);
+    }
 
-    audioFrame->data.resize(buffer_size);
+    if (m_boundariesChanged.load())
+    {
+        loadTrackBoundaries(ptsMicro);
+    }
 
-    uint8_t *out_ptr = audioFrame->data.data();
-    int64_t converted = swr_convert(m_currentSource->swrCtx, &out_ptr, static_cast<int>(out_samples),
-                                    (const uint8_t **)frame->data, frame->nb_samples);
+    const size_t frameBytes = m_ringBuffer.frameBytes();
+    const uint64_t framePos = m_ringBuffer.stagedPosition();
 
+    int64_t converted = 0;
+    if (outputMode.load() == OUTPUT_MIXING)
+    {
+        m_directCopyActive.store(false, std::memory_order_relaxed);
+        converted = convertMixing(swr, input, inputSamples, ptsMicro);
+    }
+    else
+    {
+        const bool copied = copyDirect(input, inputSamples, converted);
+        m_directCopyActive.store(copied, std::memory_order_relaxed);
+        if (!copied)
+        {
+            converted = convertDirect(swr, input, inputSamples);
+        }
+    }
     if (converted < 0)
         return false;
 
-    // 调整实际大小
-    int real_size = static_cast<int>(converted * out_channels * out_bytes_per_sample);
-    audioFrame->data.resize(real_size);
+    if (converted > 0)
+    {
+        m_ringBuffer.stage(static_cast<size_t>(converted) * frameBytes);
+        m_lastFramePos = framePos;
+        m_timeMarkers.push({framePos, ptsMicro, speed});
+
+        // 本段输出中包含的分轨边界 (媒体时间)：按速度换算为精确的采样位置
+        const int64_t outRate = deviceParams.sampleRate;
+        const int64_t chunkEndUs = ptsMicro + static_cast<int64_t>(static_cast<double>(av_rescale(converted, 1000000, outRate)) * speed);
+        while (m_nextBoundaryIndex < m_activeBoundaries.size() && m_activeBoundaries[m_nextBoundaryIndex] < chunkEndUs)
+        {
+            int64_t boundaryUs = m_activeBoundaries[m_nextBoundaryIndex++];
+            int64_t sampleOffset = (boundaryUs > ptsMicro) ? static_cast<int64_t>(static_cast<double>(av_rescale(boundaryUs - ptsMicro, outRate, 1000000)) / speed) : 0;
+            m_streamMarkers.push({framePos + static_cast<uint64_t>(sampleOffset) * frameBytes, {PlaybackEventType::TrackBoundary, boundaryUs, 0}});
+        }
+    }
+    return true;
+}
+
+bool AudioPlayer::copyDirect(const uint8_t **input, int inputSamples, int64_t &copied)
+{
+    // 设备接受了解码器的原生格式时跳过 swr：打包格式整段复制，平面格式只做一次交错
+    // swr 中还有积压的样本 (之前缓冲区满) 时必须先经 swr 按顺序输出，这一帧交给 convertDirect
+    const AVCodecContext *codecCtx = m_currentSource->pCodecCtx;
+    const AVSampleFormat fmt = codecCtx->sample_fmt;
+    const int channels = codecCtx->ch_layout.nb_channels;
+    const size_t sampleBytes = static_cast<size_t>(av_get_bytes_per_sample(fmt));
+    const size_t frameBytes = m_ringBuffer.frameBytes();
+    if (!matchesDeviceFormat(*m_currentSource) || sampleBytes * channels != frameBytes ||
+        swr_get_out_samples(m_currentSource->swrCtx, 0) > 0)
+        return false;
+
+    AudioRingBuffer::Region regions[2];
+    if (m_ringBuffer.prepareWrite(regions) < static_cast<size_t>(inputSamples) * frameBytes)
+        return false;
 
-    totalDecodedBytes += real_size;
-    totalDecodedFrames++;
-    calculateQueueSize(out_bytes_per_sample);
+    // 与 swr 路径计入同一直方图，便于对比两条路径的开销
+    ScopedLatency copyTiming(m_swrLatency);
+    const bool planar = av_sample_fmt_is_planar(fmt);
+    size_t offset = 0;
+    for (const AudioRingBuffer::Region &region : regions)
+    {
+        const size_t frames = std::min(region.bytes / frameBytes, static_cast<size_t>(inputSamples) - offset);
+        if (frames == 0)
+            break;
+        if (planar)
+        {
+            AudioKernels::interleave(region.data, input, offset, frames, channels, sampleBytes);
+        }
+        else
+        {
+            std::memcpy(region.data, input[0] + offset * frameBytes, frames * frameBytes);
+        }
+        offset += frames;
+    }
 
+    if (m_verifyBitPerfect.load(std::memory_order_relaxed))
     {
-        std::lock_guard<std::mutex> lock(audioFrameQueueMutex);
-        audioFrameQueue.push(audioFrame);
+        verifyDirectCopy(input, inputSamples, regions);
     }
+    m_directCopyFrames.fetch_add(static_cast<uint64_t>(inputSamples), std::memory_order_relaxed);
+    copied = inputSamples;
     return true;
 }
 
-bool AudioPlayer::setupDecodingSession(const std::string &path)
+void AudioPlayer::verifyDirectCopy(const uint8_t **input, int inputSamples, const AudioRingBuffer::Region *regions)
 {
-    m_currentSource = std::make_unique<AudioStreamSource>();
-    if (!m_currentSource->initDecoder(path, errorBuffer))
-        return false;
+    const AVSampleFormat fmt = m_currentSource->pCodecCtx->sample_fmt;
+    const int channels = m_currentSource->pCodecCtx->ch_layout.nb_channels;
+    const size_t sampleBytes = static_cast<size_t>(av_get_bytes_per_sample(fmt));
+    const size_t totalBytes = static_cast<size_t>(inputSamples) * channels * sampleBytes;
+
+    // 参照数据：打包格式即解码输出本身，平面格式用逐样本交错 (不经过 SIMD 路径)
+    const uint8_t *reference = input[0];
+    if (av_sample_fmt_is_planar(fmt))
+    {
+        if (m_verifyScratch.size() < totalBytes)
+        {
+            m_verifyScratch.resize(totalBytes);
+        }
+        uint8_t *dst = m_verifyScratch.data();
+        for (int i = 0; i < inputSamples; ++i)
+        {
+            for (int c = 0; c < channels; ++c)
+            {
+                std::memcpy(dst, input[c] + static_cast<size_t>(i) * sampleBytes, sampleBytes);
+                dst += sampleBytes;
+            }
+        }
+        reference = m_verifyScratch.data();
+    }
+
+    // CRC32 (IEEE，初值与结果取反)，与 ffmpeg -f hash -hash CRC32 的结果一致
+    const AVCRC *table = av_crc_get_table(AV_CRC_32_IEEE_LE);
+    const uint32_t expected = av_crc(table, UINT32_MAX, reference, totalBytes);
+    uint32_t actual = UINT32_MAX;
+    size_t remaining = totalBytes;
+    for (int r = 0; r < 2 && remaining > 0; ++r)
+    {
+        const size_t bytes = std::min(regions[r].bytes, remaining);
+        actual = av_crc(table, actual, regions[r].data, bytes);
+        m_crcState = av_crc(table, m_crcState, regions[r].data, bytes);
+        remaining -= bytes;
+    }
+
+    m_outputCrc.store(m_crcState ^ UINT32_MAX, std::memory_order_relaxed);
+    m_verifiedFrames.fetch_add(static_cast<uint64_t>(inputSamples), std::memory_order_relaxed);
+    if (actual != expected && m_checksumMismatches.fetch_add(1, std::memory_order_relaxed) == 0)
+    {
+        spdlog::warn("[AudioPlayer] Bit-perfect check failed: decoded {:08x}, output {:08x}", expected ^ UINT32_MAX, actual ^ UINT32_MAX);
+    }
+}
+
+void AudioPlayer::resetDirectCopyStats()
+{
+    const uint64_t verified = m_verifiedFrames.exchange(0);
+    if (verified > 0)
+    {
+        spdlog::info("[AudioPlayer] Bit-perfect session: {} frames verified, crc32 {:08x}, mismatches {}",
+                     verified, m_crcState ^ UINT32_MAX, m_checksumMismatches.load());
+    }
+    m_crcState = UINT32_MAX;
+    m_outputCrc.store(0);
+    m_checksumMismatches.store(0);
+    m_directCopyFrames.store(0);
+}
+
+int64_t AudioPlayer::convertDirect(SwrContext *swr, const uint8_t **input, int inputSamples)
+{
+    // 无法直接复制时 (格式不同或缓冲区放不下整帧) 由 swr 完成转换
+    ScopedLatency swrTiming(m_swrLatency);
+    const size_t frameBytes = m_ringBuffer.frameBytes();
+    AudioRingBuffer::Region regions[2];
+    m_ringBuffer.prepareWrite(regions);
+
+    // swr_convert 直接写入环形缓冲区，跨越末尾时分两次转换
+    int64_t converted = 0;
+    bool inputQueued = false;
+    for (const AudioRingBuffer::Region &region : regions)
+    {
+        int capacitySamples = static_cast<int>(region.bytes / frameBytes);
+        if (capacitySamples <= 0)
+            break;
+
+        uint8_t *out = region.data;
+        int ret = swr_convert(swr, &out, capacitySamples, input, inputSamples);
+        if (ret < 0)
+            return -1;
+
+        converted += ret;
+        // 输入已交给 swr，剩余样本缓存在其内部，后续调用只取缓存
+        // (输入数组保持非空：传入 nullptr 会让 swr 进入 flush 状态，破坏后续重采样的连续性)
+        inputQueued = true;
+        inputSamples = 0;
+        if (ret < capacitySamples)
+            break;
+    }
+
+    // 缓冲区已满：仍需把输入交给 swr 缓存，避免丢失样本
+    if (!inputQueued && swr_convert(swr, nullptr, 0, input, inputSamples) < 0)
+        return -1;
+
+    return converted;
+}
+
+int64_t AudioPlayer::convertMixing(SwrContext *swr, const uint8_t **input, int inputSamples, int64_t ptsMicro)
+{
+    const int channels = deviceParams.channels;
+    const size_t frameBytes = m_ringBuffer.frameBytes();
+    AudioRingBuffer::Region regions[2];
+    const int writableFrames = static_cast<int>(m_ringBuffer.prepareWrite(regions) / frameBytes);
+
+    // 缓冲区已满：仍需把输入交给 swr 缓存，避免丢失样本
+    if (writableFrames <= 0)
+        return swr_convert(swr, nullptr, 0, input, inputSamples) < 0 ? -1 : 0;
+
+    // 1. 重采样到内部 float32 交错格式 (复用的连续缓冲区，便于后续逐级处理)
+    const int capacity = std::min(writableFrames, swr_get_out_samples(swr, inputSamples));
+    if (capacity <= 0)
+        return swr_convert(swr, nullptr, 0, input, inputSamples) < 0 ? -1 : 0;
+
+    const size_t needSamples = static_cast<size_t>(capacity) * channels;
+    if (m_mixBuffer.size() < needSamples)
+    {
+        m_mixBuffer.resize(needSamples);
+    }
+    uint8_t *out = reinterpret_cast<uint8_t *>(m_mixBuffer.data());
+    int frames = 0;
+    {
+        ScopedLatency swrTiming(m_swrLatency);
+        frames = swr_convert(swr, &out, capacity, input, inputSamples);
+    }
+    if (frames <= 0)
+        return frames;
+
+    // 2. float 处理级：响度归一化 -> 交叉淡化 -> DSP 处理链
+    const float gain = normalizationGain(*m_currentSource);
+    if (gain != 1.0f)
+    {
+        AudioKernels::applyGain(m_mixBuffer.data(), static_cast<size_t>(frames) * channels, gain);
+    }
+    mixCrossfade(m_mixBuffer.data(), frames, ptsMicro);
+    m_dspChain.process(m_mixBuffer.data(), static_cast<size_t>(frames), channels);
+
+    // 3. 最终输出级：转换为设备格式写入环形缓冲区 (跨越末尾时分两段，抖动状态连续)
+    m_dither.mode = m_ditherMode.load(std::memory_order_relaxed);
+    const float *src = m_mixBuffer.data();
+    size_t remaining = static_cast<size_t>(frames);
+    for (const AudioRingBuffer::Region &region : regions)
+    {
+        size_t regionFrames = std::min(region.bytes / frameBytes, remaining);
+        if (regionFrames == 0)
+            break;
+        AudioKernels::convertFromFloat(region.data, src, regionFrames, channels, m_outputFormat, m_dither);
+        src += regionFrames * channels;
+        remaining -= regionFrames;
+    }
+    return frames;
+}
+
+PlaybackStats AudioPlayer::getStats() const
+{
+    PlaybackStats stats;
+    stats.underrunCount = m_underrunCount.load(std::memory_order_relaxed);
+    stats.underrunMs = static_cast<double>(m_underrunSilenceUs.load(std::memory_order_relaxed)) / 1000.0;
+
+    stats.callbackUs = m_callbackLatency.snapshot();
+    stats.callbackCount = stats.callbackUs.count;
+    stats.deadlineMisses = m_deadlineMisses.load(std::memory_order_relaxed);
+    stats.callbackDeadlineUs = static_cast<double>(m_callbackDeadlineUs.load(std::memory_order_relaxed));
+
+    // 回调可见的水位 (读取时只是近似值)
+    const int64_t bytesPerSecond = m_outputBytesPerSecond.load(std::memory_order_relaxed);
+    if (bytesPerSecond > 0)
+    {
+        stats.bufferedMs = static_cast<double>(m_ringBuffer.publishedBytes()) * 1000.0 / static_cast<double>(bytesPerSecond);
+        stats.bufferTargetMs = static_cast<double>(m_bufferTargetBytes.load(std::memory_order_relaxed)) * 1000.0 / static_cast<double>(bytesPerSecond);
+    }
+
+    stats.outputLatencyMs = static_cast<double>(m_outputLatencyUs.load(std::memory_order_relaxed)) / 1000.0;
+
+    stats.decodeUs = m_decodeLatency.snapshot();
+    stats.swrUs = m_swrLatency.snapshot();
+
+    stats.deviceNative = m_deviceNative.load(std::memory_order_relaxed);
+    stats.directCopy = (outputMode.load() == OUTPUT_DIRECT) && m_directCopyActive.load(std::memory_order_relaxed);
+    stats.bitPerfect = stats.directCopy && stats.deviceNative && volume.load() == 1.0 && !m_tempoActive.load(std::memory_order_relaxed);
+    stats.directCopyFrames = m_directCopyFrames.load(std::memory_order_relaxed);
+    stats.verifiedFrames = m_verifiedFrames.load(std::memory_order_relaxed);
+    stats.checksumMismatches = m_checksumMismatches.load(std::memory_order_relaxed);
+    stats.outputCrc = m_outputCrc.load(std::memory_order_relaxed);
+    stats.dspStages = m_dspChain.stats();
+    return stats;
+}
+
+float AudioPlayer::normalizationGain(const AudioStreamSource &source) const
+{
+    return LoudnessAnalyzer::gainFor(source.loudness, m_normalizationMode.load(std::memory_order_relaxed));
+}
+
+bool AudioPlayer::setupDecodingSession(const std::string &path, int64_t startPosition)
+{
+    if (m_preloadSource && m_preloadSource->path == path)
+    {
+        // 接管预加载阶段已经打开的解码器
+        m_currentSource = std::move(m_preloadSource);
+        hasPreloaded = false;
+        m_crossfadeActive = false;
+    }
+    else
+    {
+        cancelCrossfade();
+        m_currentSource = acquireSession(path);
+        if (!m_currentSource)
+            return false;
+    }
 
     // Direct 模式下这里会根据文件格式打开设备；Mixing 模式下会根据 mixingParams 打开
     if (!openAudioDevice())
@@ -988,35 +2575,78 @@ bool AudioPlayer::setupDecodingSession(const std::string &path)
     }
 
     // 音量设为 1.0 (由 miniaudio master volume 控制)
-    if (!m_currentSource->openSwrContext(deviceParams, 1.0, errorBuffer))
+    if (!m_currentSource->openSwrContext(resampleTarget(), 1.0, errorBuffer))
         return false;
 
+    // 后台建立 seek 索引 (已缓存时立即返回)
+    SeekIndexCache::instance().requestBuild(path);
+    // 尚未分析的文件 loudness.valid = false，归一化增益为 1
+    m_currentSource->loudness = LoudnessInfo{};
+    LoudnessAnalyzer::instance().lookup(path, m_currentSource->loudness);
+
+    // 直接从分轨起点开始解码 (精确到采样点)，无需调用方再 seek
+    if (startPosition > 0)
+    {
+        m_currentSource->seekTo(startPosition);
+    }
+    else
+    {
+        startPosition = m_currentSource->startPositionUs;
+    }
+    m_decoderCursor.store(m_currentSource->landingUs);
+    nowPlayingTime.store(startPosition);
+    m_clock.reset(startPosition);
+    m_dspChain.reset();
+    loadTrackBoundaries(startPosition);
+    startDecodeAhead(*m_currentSource);
+    resetDirectCopyStats();
+
+    // 新会话的第一个采样点播放时通知控制器
+    m_sessionStartPos = m_ringBuffer.stagedPosition();
+    m_streamMarkers.push({m_sessionStartPos, {PlaybackEventType::TrackStarted, startPosition, 0}});
+
     audioDuration.store(m_currentSource->pFormatCtx->duration);
     return true;
 }
 
 void AudioPlayer::triggerPreload(double currentPts)
 {
-    // Direct 模式不支持无缝混音预加载，只支持路径预设，在EOF处处理
-    if (outputMode.load() != OUTPUT_MIXING || hasPreloaded.load() || currentPts < 0)
+    // 两种模式都提前打开下一首；Direct 模式在 EOF 处根据格式决定无缝切换或重建设备
+    if (hasPreloaded.load() || currentPts < 0)
         return;
 
     std::string pPath;
+    int64_t pStart = 0;
     {
         std::lock_guard<std::mutex> lock(pathMutex);
         pPath = preloadPath;
+        pStart = preloadStartPosition;
     }
     if (pPath.empty())
         return;
 
     double dur = audioDuration.load() / (double)AV_TIME_BASE;
-    if (dur > 0 && (dur - currentPts) < PRELOAD_TRIGGER_SECONDS_BEFORE_END)
+    double lead = PRELOAD_TRIGGER_SECONDS_BEFORE_END;
+    if (outputMode.load() == OUTPUT_MIXING)
     {
-        auto src = std::make_unique<AudioStreamSource>();
+        lead = std::max(lead, m_crossfadeMs.load() / 1000.0 + CROSSFADE_PRELOAD_MARGIN_SECONDS);
+    }
+    if (dur > 0 && (dur - currentPts) < lead)
+    {
+        // 优先从会话缓存取出 (setPreloadPath 时已打开)
+        auto src = acquireSession(pPath);
         // 预加载必须使用当前设备的参数进行重采样初始化
-        if (src->initDecoder(pPath, errorBuffer) && src->openSwrContext(deviceParams, 1.0, errorBuffer))
+        if (src && src->openSwrContext(resampleTarget(), 1.0, errorBuffer))
         {
+            if (pStart > 0)
+            {
+                src->seekTo(pStart);
+            }
             m_preloadSource = std::move(src);
+            m_preloadCursorUs = m_preloadSource->landingUs;
+            SeekIndexCache::instance().requestBuild(pPath);
+            m_preloadSource->loudness = LoudnessInfo{};
+            LoudnessAnalyzer::instance().lookup(pPath, m_preloadSource->loudness);
             hasPreloaded.store(true);
             spdlog::debug("Preloading: {}", pPath);
         }
@@ -1028,34 +2658,52 @@ void AudioPlayer::triggerPreload(double currentPts)
     }
 }
 
-void AudioPlayer::calculateQueueSize(int out_bytes_per_sample)
+void AudioPlayer::markTrackFinished()
 {
-    if (hasCalculatedQueueSize.load())
-        return;
-    if (totalDecodedFrames.load() < 10)
-        return;
-
-    int64_t bytes = totalDecodedBytes.load();
-    int64_t frames = totalDecodedFrames.load();
-    int avgBytes = static_cast<int>(bytes / frames);
-    if (avgBytes == 0)
-        return;
-
-    int bytesPerSec = deviceParams.sampleRate * deviceParams.channels * out_bytes_per_sample;
-    int targetBytes = static_cast<int>(bytesPerSec * AUDIO_BUFFER_DURATION_SECONDS);
-    size_t maxF = std::max(MIN_AUDIO_QUEUE_SIZE, targetBytes / avgBytes);
-
-    audioFrameQueueMaxSize.store(maxF);
-    hasCalculatedQueueSize.store(true);
+    PlaybackEvent event{PlaybackEventType::TrackFinished, m_decoderCursor.load(), 0};
+    const uint64_t endPos = m_ringBuffer.stagedPosition();
+    const size_t frameBytes = m_ringBuffer.frameBytes();
+    if (endPos >= m_sessionStartPos + frameBytes)
+    {
+        // 标记在最后一个采样帧上
+        m_streamMarkers.push({endPos - frameBytes, event});
+    }
+    else
+    {
+        // 本会话没有产生任何可播放的数据，立即通知
+        pushEvent(event);
+    }
 }
 
 bool AudioPlayer::performSeamlessSwitch()
 {
-    if (outputMode.load() != OUTPUT_MIXING || !hasPreloaded.load() || !m_preloadSource)
+    if (!hasPreloaded.load() || !m_preloadSource)
         return false;
 
-    applyFadeOutToLastFrame();
+    const bool crossfaded = m_crossfadeActive;
+    if (outputMode.load() == OUTPUT_MIXING)
+    {
+        if (crossfaded && m_crossfadeFrame)
+        {
+            // 交叉淡化已解码出的帧仍在解码器中，交给 swr 缓存，主循环接着读取下一个包
+            while (avcodec_receive_frame(m_preloadSource->pCodecCtx, m_crossfadeFrame) >= 0)
+            {
+                feedPreloadFrame();
+            }
+        }
+        else
+        {
+            applyFadeOutToLastFrame();
+        }
+    }
+    else if (!matchesDeviceFormat(*m_preloadSource))
+    {
+        // Direct 模式下格式不同，只能重建设备
+        return false;
+    }
 
+    // 旧会话放回缓存，"上一首" 时无需重新打开
+    releaseSession(std::move(m_currentSource));
     m_currentSource = std::move(m_preloadSource);
     {
         std::lock_guard<std::mutex> lock(pathMutex);
@@ -1065,36 +2713,173 @@ bool AudioPlayer::performSeamlessSwitch()
 
     audioDuration.store(m_currentSource->pFormatCtx->duration);
     hasPreloaded.store(false);
-    nowPlayingTime.store(0);
-    m_decoderCursor.store(0);
-
-    totalDecodedBytes = 0;
-    totalDecodedFrames = 0;
-    hasCalculatedQueueSize = false;
+    m_crossfadeActive = false;
+    nowPlayingTime.store(m_currentSource->startPositionUs);
+    // 交叉淡化期间下一首已经解码了一段，游标从已解码的位置继续
+    m_decoderCursor.store(crossfaded ? m_preloadCursorUs : m_currentSource->startPositionUs);
+    loadTrackBoundaries(m_currentSource->startPositionUs);
+    // 交叉淡化期间解码器中已取出的帧都已交给 swr，工作线程从下一个包接着解码
+    startDecodeAhead(*m_currentSource);
+    resetDirectCopyStats();
+
+    // 下一首的第一个采样点 (即将写入的位置) 播放时通知控制器
+    m_sessionStartPos = m_ringBuffer.stagedPosition();
+    m_streamMarkers.push({m_sessionStartPos, {PlaybackEventType::SeamlessSwitch, m_currentSource->startPositionUs, 0}});
 
     return true;
 }
 
 void AudioPlayer::applyFadeOutToLastFrame()
 {
-    std::lock_guard<std::mutex> lock(audioFrameQueueMutex);
-    if (audioFrameQueue.empty())
+    // 最后一帧仍在暂存区 (尚未发布)，可以直接原地修改
+    if (m_lastFramePos < m_ringBuffer.publishedPosition())
+        return;
+
+    AudioRingBuffer::Region regions[2];
+    m_ringBuffer.stagedRegions(m_lastFramePos, regions);
+
+    const size_t frameBytes = m_ringBuffer.frameBytes();
+    const size_t totalFrames = (regions[0].bytes + regions[1].bytes) / frameBytes;
+    if (totalFrames == 0)
+        return;
+
+    // 等功率曲线从 1 降到 0，两段区域的进度连续
+    const float dt = 1.0f / static_cast<float>(totalFrames);
+    float t = 0.0f;
+    for (const AudioRingBuffer::Region &region : regions)
+    {
+        size_t frames = region.bytes / frameBytes;
+        AudioKernels::equalPowerCrossfade(region.data, nullptr, frames, deviceParams.channels, m_outputFormat, t, dt);
+        t += frames * dt;
+    }
+}
+
+void AudioPlayer::mixCrossfade(float *buffer, int64_t chunkFrames, int64_t chunkPtsUs)
+{
+    // 变速播放时下一首不经过当前曲目的滤镜图，不做交叉淡化 (仍无缝衔接)
+    if (!hasPreloaded.load() || !m_preloadSource || !m_preloadSource->swrCtx || m_currentSource->tempo.isOpen())
+        return;
+
+    const int64_t durationUs = audioDuration.load();
+    // 曲目过短时淡化不超过其一半长度
+    const int64_t fadeUs = std::min<int64_t>(static_cast<int64_t>(m_crossfadeMs.load()) * 1000, durationUs / 2);
+    if (fadeUs <= 0)
+        return;
+
+    const int64_t outRate = deviceParams.sampleRate;
+    const int64_t fadeStartUs = durationUs - fadeUs;
+    const int64_t chunkEndUs = chunkPtsUs + av_rescale(chunkFrames, 1000000, outRate);
+    if (chunkEndUs <= fadeStartUs)
         return;
 
-    auto frame = audioFrameQueue.back();
-    if (!frame || frame->data.empty())
+    // 本段中淡化起点之前的帧保持原样
+    int64_t skipFrames = (chunkPtsUs < fadeStartUs) ? std::min(av_rescale(fadeStartUs - chunkPtsUs, outRate, 1000000), chunkFrames) : 0;
+    int64_t mixFrames = chunkFrames - skipFrames;
+    if (mixFrames <= 0)
         return;
 
-    if (deviceParams.sampleFormat == AV_SAMPLE_FMT_FLT)
+    const int channels = deviceParams.channels;
+    m_crossfadeActive = true;
+
+    // 下一首的对应片段重采样到复用的暂存区，再与当前曲目原地混合
+    size_t needSamples = static_cast<size_t>(mixFrames) * channels;
+    if (m_crossfadeScratch.size() < needSamples)
+    {
+        m_crossfadeScratch.resize(needSamples);
+    }
+    int incoming = pullPreloadSamples(m_crossfadeScratch.data(), static_cast<int>(mixFrames));
+    const float incomingGain = normalizationGain(*m_preloadSource);
+    if (incomingGain != 1.0f)
+    {
+        AudioKernels::applyGain(m_crossfadeScratch.data(), static_cast<size_t>(incoming) * channels, incomingGain);
+    }
+
+    const double mixStartUs = static_cast<double>(chunkPtsUs) + skipFrames * 1000000.0 / outRate;
+    const float t = static_cast<float>((mixStartUs - fadeStartUs) / fadeUs);
+    const float dt = static_cast<float>(1000000.0 / (static_cast<double>(outRate) * fadeUs));
+
+    float *dst = buffer + static_cast<size_t>(skipFrames) * channels;
+    AudioKernels::equalPowerCrossfade(reinterpret_cast<uint8_t *>(dst), reinterpret_cast<const uint8_t *>(m_crossfadeScratch.data()),
+                                      static_cast<size_t>(incoming), channels, AudioKernels::PcmFormat::F32, t, dt);
+    // 下一首提前结束 (极短曲目) 时，剩余部分只做淡出
+    if (incoming < mixFrames)
+    {
+        AudioKernels::equalPowerCrossfade(reinterpret_cast<uint8_t *>(dst + static_cast<size_t>(incoming) * channels), nullptr,
+                                          static_cast<size_t>(mixFrames - incoming), channels, AudioKernels::PcmFormat::F32, t + incoming * dt, dt);
+    }
+}
+
+int AudioPlayer::pullPreloadSamples(float *dst, int frames)
+{
+    SwrContext *swr = m_preloadSource->swrCtx;
+    const int channels = deviceParams.channels;
+    // 只取 swr 内部缓存时输入数组也不能为空 (nullptr 表示 flush)
+    const uint8_t *noInput[AV_NUM_DATA_POINTERS] = {};
+
+    int got = 0;
+    while (got < frames)
+    {
+        uint8_t *out = reinterpret_cast<uint8_t *>(dst + static_cast<size_t>(got) * channels);
+        int ret = swr_convert(swr, &out, frames - got, noInput, 0);
+        if (ret < 0)
+            break;
+        got += ret;
+        if (got >= frames || !decodePreloadFrame())
+            break;
+    }
+    return got;
+}
+
+bool AudioPlayer::decodePreloadFrame()
+{
+    AudioStreamSource &source = *m_preloadSource;
+    if (!m_crossfadePacket)
+        m_crossfadePacket = av_packet_alloc();
+    if (!m_crossfadeFrame)
+        m_crossfadeFrame = av_frame_alloc();
+
+    for (;;)
     {
-        float *samples = reinterpret_cast<float *>(frame->data.data());
-        size_t count = frame->data.size() / sizeof(float);
-        for (size_t i = 0; i < count; ++i)
+        int ret = avcodec_receive_frame(source.pCodecCtx, m_crossfadeFrame);
+        if (ret >= 0)
+        {
+            feedPreloadFrame();
+            return true;
+        }
+        if (ret != AVERROR(EAGAIN))
+            return false;
+
+        ret = av_read_frame(source.pFormatCtx, m_crossfadePacket);
+        if (ret < 0)
+            return false;
+        if (m_crossfadePacket->stream_index == source.audioStreamIndex)
         {
-            float gain = 1.0f - (static_cast<float>(i) / count);
-            samples[i] *= gain;
+            source.decoderFed = true;
+            avcodec_send_packet(source.pCodecCtx, m_crossfadePacket);
         }
+        av_packet_unref(m_crossfadePacket);
+    }
+}
+
+void AudioPlayer::feedPreloadFrame()
+{
+    // 与当前曲目相同的 PTS / 裁剪处理，输出先缓存在预加载源的 swr 中
+    const uint8_t **input = nullptr;
+    int inputSamples = 0;
+    int64_t ptsMicro = 0;
+    if (prepareFrame(*m_preloadSource, m_crossfadeFrame, m_preloadCursorUs, input, inputSamples, ptsMicro) && inputSamples > 0)
+    {
+        swr_convert(m_preloadSource->swrCtx, nullptr, 0, input, inputSamples);
     }
+    av_frame_unref(m_crossfadeFrame);
+}
+
+void AudioPlayer::cancelCrossfade()
+{
+    // 预加载源可能已被提前解码了一部分，放回缓存后下次取出时会回到开头
+    releaseSession(std::move(m_preloadSource));
+    hasPreloaded.store(false);
+    m_crossfadeActive = false;
 }
 
 // --- Getters ---
@@ -1117,7 +2902,7 @@ int64_t AudioPlayer::getNowPlayingTime() const
 }
 int64_t AudioPlayer::getCurrentPositionMicroseconds() const
 {
-    return nowPlayingTime.load();
+    return m_clock.positionUs();
 }
 int64_t AudioPlayer::getAudioDuration() const
 {
@@ -1132,47 +2917,27 @@ int64_t AudioPlayer::getDurationMicroseconds() const
     return audioDuration.load();
 }
 
-// --- Static: Waveform ---
-// =========================================================
-//  SIMD 计算内核
-// =========================================================
-struct ChunkResult
+ClockAnchor AudioPlayer::getPlaybackClock() const
 {
-    float sumSquares;
-    int actualCount;
-};
+    return m_clock.read();
+}
 
-// Float SIMD
-static ChunkResult computeSumSquaresAVX2_Float(const float *data, int range_count, int step, int decimation)
+DspChain &AudioPlayer::getDspChain()
 {
-    float sum = 0.0f;
-    int processed = 0;
-    int i = 0;
-    if (step == 1)
-    {
-        int jump = 8 * decimation;
-        __m256 sum_vec = _mm256_setzero_ps();
-        for (; i <= range_count - 8; i += jump)
-        {
-            __m256 vals = _mm256_loadu_ps(data + i);
-            sum_vec = _mm256_fmadd_ps(vals, vals, sum_vec);
-            processed += 8;
-        }
-        float temp[8];
-        _mm256_storeu_ps(temp, sum_vec);
-        for (int k = 0; k < 8; ++k)
-            sum += temp[k];
-    }
-    int scalar_stride = step * decimation;
-    for (; i < range_count; i += scalar_stride)
-    {
-        float val = data[i];
-        sum += val * val;
-        processed++;
-    }
-    return {sum, processed};
+    return m_dspChain;
+}
+
+int64_t AudioPlayer::getOutputLatencyMicroseconds() const
+{
+    return m_outputLatencyUs.load(std::memory_order_relaxed);
 }
 
+// --- Static: Waveform ---
+// =========================================================
+//  SIMD 计算内核
+// =========================================================
+using ChunkResult = AudioKernels::SquareSum;
+
 // S16 SIMD
 static ChunkResult computeSumSquaresAVX2_S16(const int16_t *data, int range_count, int step, int decimation)
 {
@@ -1269,316 +3034,93 @@ struct BarData
     int actualCount = 0;
 };
 
-struct SafePacket
-{
-    AVPacket *pkt;
-    SafePacket()
-    {
-        pkt = av_packet_alloc();
-    }
-    ~SafePacket()
-    {
-        av_packet_free(&pkt);
-    }
-    SafePacket(const SafePacket &) = delete;
-    SafePacket &operator=(const SafePacket &) = delete;
-    SafePacket(SafePacket &&other) noexcept :
-        pkt(other.pkt)
-    {
-        other.pkt = nullptr;
-    }
-    void refFrom(const AVPacket *src)
-    {
-        av_packet_ref(pkt, src);
-    }
-};
-
 // =========================================================
-//  Part 2: 策略A - 并行 Seek (FLAC/MP3)
+//  Part 2: 分块解码的接收者 (直接在解码器输出格式上计算，不做转换)
 // =========================================================
-static std::vector<BarData> processAudioChunk_StrategyA(
-    std::string filepath,
-    int streamIdx,
-    int64_t absoluteStartSample,
-    int64_t absoluteEndSample,
-    int64_t globalStartSample,
-    double samplesPerBar,
-    int totalBars)
-{
-    std::vector<BarData> localBars(totalBars);
-    AVFormatContext *fmt = nullptr;
-    if (avformat_open_input(&fmt, filepath.c_str(), nullptr, nullptr) < 0)
-        return {};
-    if (streamIdx >= (int)fmt->nb_streams)
+class WaveformSink : public ChunkDecoder::FrameSink
+{
+public:
+    WaveformSink(int64_t globalStartSample, double samplesPerBar, int totalBars) :
+        bars(totalBars), m_globalStartSample(globalStartSample), m_samplesPerBar(samplesPerBar)
     {
-        avformat_close_input(&fmt);
-        return {};
     }
 
-    AVCodecParameters *param = fmt->streams[streamIdx]->codecpar;
-    const AVCodec *codec = avcodec_find_decoder(param->codec_id);
-    AVCodecContext *ctx = avcodec_alloc_context3(codec);
-    avcodec_parameters_to_context(ctx, param);
-    ctx->thread_count = 1;
-
-    if (avcodec_open2(ctx, codec, nullptr) < 0)
+    bool open(const AVCodecContext *ctx) override
     {
-        avcodec_free_context(&ctx);
-        avformat_close_input(&fmt);
-        return {};
+        m_format = ctx->sample_fmt;
+        const int channels = ctx->ch_layout.nb_channels;
+        if (!av_sample_fmt_is_planar(m_format) && channels > 1)
+            m_step = channels;
+        if (ctx->sample_rate > 48000)
+            m_decimation = std::max(ctx->sample_rate / 32000, 1);
+        return true;
     }
 
-    int decimation = 1;
-    if (ctx->sample_rate > 48000)
+    void push(const AVFrame *frame, int64_t firstSample, int begin, int end) override
     {
-        decimation = ctx->sample_rate / 32000;
-        if (decimation < 1)
-            decimation = 1;
-    }
-
-    int64_t seekTimestamp = av_rescale_q(absoluteStartSample, (AVRational){1, ctx->sample_rate}, fmt->streams[streamIdx]->time_base);
-    av_seek_frame(fmt, streamIdx, seekTimestamp, AVSEEK_FLAG_BACKWARD);
-    avcodec_flush_buffers(ctx);
+        const int totalBars = static_cast<int>(bars.size());
+        const void *rawData = frame->data[0];
+        const int64_t frameBaseSample = firstSample + begin;
+        const int processSamples = end - begin;
 
-    AVPacket *pkt = av_packet_alloc();
-    AVFrame *frame = av_frame_alloc();
-    int64_t currentGlobalSample = -1;
+        int curBarIdx = static_cast<int>((frameBaseSample - m_globalStartSample) / m_samplesPerBar);
+        if (curBarIdx < 0)
+            curBarIdx = 0;
+        double nextBarBoundaryRel = (curBarIdx + 1) * m_samplesPerBar;
 
-    while (av_read_frame(fmt, pkt) >= 0)
-    {
-        if (pkt->stream_index == streamIdx)
+        int processedInFrame = 0;
+        while (processedInFrame < processSamples && curBarIdx < totalBars)
         {
-            if (avcodec_send_packet(ctx, pkt) >= 0)
-            {
-                while (avcodec_receive_frame(ctx, frame) >= 0)
-                {
-                    if (frame->pts != AV_NOPTS_VALUE)
-                    {
-                        int64_t ptsSample = av_rescale_q(frame->pts, fmt->streams[streamIdx]->time_base, (AVRational){1, ctx->sample_rate});
-                        if (currentGlobalSample == -1 || std::abs(ptsSample - currentGlobalSample) > 2000)
-                        {
-                            currentGlobalSample = ptsSample;
-                        }
-                    }
-                    else if (currentGlobalSample == -1)
-                        currentGlobalSample = 0;
-
-                    if (currentGlobalSample >= absoluteEndSample)
-                        goto cleanup;
-
-                    int samples = frame->nb_samples;
-                    int offset = 0;
-
-                    if (currentGlobalSample < absoluteStartSample)
-                    {
-                        offset = static_cast<int>(absoluteStartSample - currentGlobalSample);
-                        if (offset >= samples)
-                        {
-                            currentGlobalSample += samples;
-                            continue;
-                        }
-                    }
-
-                    int processSamples = samples - offset;
-                    if (currentGlobalSample + samples > absoluteEndSample)
-                    {
-                        processSamples = static_cast<int>(absoluteEndSample - (currentGlobalSample + offset));
-                    }
-                    if (processSamples <= 0)
-                        continue;
-
-                    int channels = ctx->ch_layout.nb_channels;
-                    int step = 1;
-                    bool isPlanar = av_sample_fmt_is_planar(ctx->sample_fmt);
-                    void *rawData = frame->data[0];
-                    if (!isPlanar && channels > 1)
-                        step = channels;
-
-                    int processedInFrame = 0;
-                    int64_t frameBaseSample = currentGlobalSample + offset;
-
-                    int64_t relativeSample = frameBaseSample - globalStartSample;
-                    int curBarIdx = static_cast<int>(relativeSample / samplesPerBar);
-                    if (curBarIdx < 0)
-                        curBarIdx = 0;
+            int64_t currentRelative = (frameBaseSample + processedInFrame) - m_globalStartSample;
+            int64_t needed = static_cast<int64_t>(nextBarBoundaryRel) - currentRelative;
+            if (needed <= 0)
+                needed = 1;
+            int count = std::min((int64_t)(processSamples - processedInFrame), needed);
 
-                    double nextBarBoundaryRel = (curBarIdx + 1) * samplesPerBar;
+            ChunkResult res = {0.0f, 0};
+            int dataOffset = (begin + processedInFrame) * m_step;
 
-                    while (processedInFrame < processSamples && curBarIdx < totalBars)
-                    {
-                        int64_t currentRelative = (frameBaseSample + processedInFrame) - globalStartSample;
-                        int64_t needed = static_cast<int64_t>(nextBarBoundaryRel) - currentRelative;
-
-                        if (needed <= 0)
-                            needed = 1;
-                        int count = std::min((int64_t)(processSamples - processedInFrame), needed);
-
-                        ChunkResult res = {0.0f, 0};
-                        int dataOffset = (offset + processedInFrame) * step;
-
-                        switch (ctx->sample_fmt)
-                        {
-                        case AV_SAMPLE_FMT_FLTP:
-                        case AV_SAMPLE_FMT_FLT:
-                            res = computeSumSquaresAVX2_Float((const float *)rawData + dataOffset, count, step, decimation);
-                            break;
-                        case AV_SAMPLE_FMT_S16P:
-                        case AV_SAMPLE_FMT_S16:
-                            res = computeSumSquaresAVX2_S16((const int16_t *)rawData + dataOffset, count, step, decimation);
-                            break;
-                        case AV_SAMPLE_FMT_S32P:
-                        case AV_SAMPLE_FMT_S32:
-                            res = computeSumSquaresAVX2_S32((const int32_t *)rawData + dataOffset, count, step, decimation);
-                            break;
-                        case AV_SAMPLE_FMT_U8P:
-                        case AV_SAMPLE_FMT_U8:
-                            res = computeSumSquares_U8((const uint8_t *)rawData + dataOffset, count, step, decimation);
-                            break;
-                        default: break;
-                        }
-                        localBars[curBarIdx].sumSquares += res.sumSquares;
-                        localBars[curBarIdx].actualCount += res.actualCount;
-                        processedInFrame += count;
-
-                        if (((frameBaseSample + processedInFrame) - globalStartSample) >= nextBarBoundaryRel)
-                        {
-                            curBarIdx++;
-                            nextBarBoundaryRel += samplesPerBar;
-                        }
-                    }
-                    currentGlobalSample += samples;
-                }
+            switch (m_format)
+            {
+            case AV_SAMPLE_FMT_FLTP:
+            case AV_SAMPLE_FMT_FLT:
+                res = AudioKernels::sumOfSquares((const float *)rawData + dataOffset, count, m_step, m_decimation);
+                break;
+            case AV_SAMPLE_FMT_S16P:
+            case AV_SAMPLE_FMT_S16:
+                res = computeSumSquaresAVX2_S16((const int16_t *)rawData + dataOffset, count, m_step, m_decimation);
+                break;
+            case AV_SAMPLE_FMT_S32P:
+            case AV_SAMPLE_FMT_S32:
+                res = computeSumSquaresAVX2_S32((const int32_t *)rawData + dataOffset, count, m_step, m_decimation);
+                break;
+            case AV_SAMPLE_FMT_U8P:
+            case AV_SAMPLE_FMT_U8:
+                res = computeSumSquares_U8((const uint8_t *)rawData + dataOffset, count, m_step, m_decimation);
+                break;
+            default: break;
             }
-        }
-        av_packet_unref(pkt);
-    }
-cleanup:
-    av_packet_free(&pkt);
-    av_frame_free(&frame);
-    avcodec_free_context(&ctx);
-    avformat_close_input(&fmt);
-    return localBars;
-}
+            bars[curBarIdx].sumSquares += res.sumSquares;
+            bars[curBarIdx].actualCount += res.actualCount;
+            processedInFrame += count;
 
-// =========================================================
-//  Part 3: 策略B - 流水线内存解码 (M4A/MP4)
-// =========================================================
-static std::vector<BarData> processPacketBatch_StrategyB(
-    std::vector<AVPacket *> packets,
-    AVCodecParameters *codecPar,
-    AVRational timeBase,
-    int64_t globalStartSample,
-    double samplesPerBar,
-    int totalBars)
-{
-    std::vector<BarData> localBars(totalBars);
-    if (packets.empty())
-        return localBars;
-
-    const AVCodec *codec = avcodec_find_decoder(codecPar->codec_id);
-    AVCodecContext *ctx = avcodec_alloc_context3(codec);
-    avcodec_parameters_to_context(ctx, codecPar);
-    ctx->thread_count = 1;
-
-    if (avcodec_open2(ctx, codec, nullptr) < 0)
-    {
-        avcodec_free_context(&ctx);
-        return localBars;
-    }
-
-    int decimation = 1;
-    if (ctx->sample_rate > 48000)
-    {
-        decimation = ctx->sample_rate / 32000;
-        if (decimation < 1)
-            decimation = 1;
-    }
-    AVFrame *frame = av_frame_alloc();
-
-    for (auto *pkt : packets)
-    {
-        if (avcodec_send_packet(ctx, pkt) >= 0)
-        {
-            while (avcodec_receive_frame(ctx, frame) >= 0)
+            if (((frameBaseSample + processedInFrame) - m_globalStartSample) >= nextBarBoundaryRel)
             {
-                if (frame->pts == AV_NOPTS_VALUE)
-                    continue;
-
-                int64_t ptsSample = av_rescale_q(frame->pts, timeBase, (AVRational){1, ctx->sample_rate});
-                int samples = frame->nb_samples;
-                int channels = ctx->ch_layout.nb_channels;
-                int step = 1;
-                bool isPlanar = av_sample_fmt_is_planar(ctx->sample_fmt);
-                void *rawData = frame->data[0];
-                if (!isPlanar && channels > 1)
-                    step = channels;
-
-                int processedInFrame = 0;
-                int64_t frameBaseSample = ptsSample;
-                int64_t relativeSample = frameBaseSample - globalStartSample;
-                int curBarIdx = static_cast<int>(relativeSample / samplesPerBar);
-
-                if (curBarIdx < 0 && (relativeSample + samples) < 0)
-                    continue;
-                if (curBarIdx < 0)
-                    curBarIdx = 0;
-
-                double nextBarBoundaryRel = (curBarIdx + 1) * samplesPerBar;
-
-                while (processedInFrame < samples && curBarIdx < totalBars)
-                {
-                    int64_t currentRel = (frameBaseSample + processedInFrame) - globalStartSample;
-                    if (currentRel < 0)
-                    {
-                        processedInFrame++;
-                        continue;
-                    }
-
-                    int64_t needed = static_cast<int64_t>(nextBarBoundaryRel) - currentRel;
-                    if (needed <= 0)
-                        needed = 1;
-                    int count = std::min((int64_t)(samples - processedInFrame), needed);
-
-                    ChunkResult res = {0.0f, 0};
-                    int dataOffset = processedInFrame * step;
-
-                    switch (ctx->sample_fmt)
-                    {
-                    case AV_SAMPLE_FMT_FLTP:
-                    case AV_SAMPLE_FMT_FLT:
-                        res = computeSumSquaresAVX2_Float((const float *)rawData + dataOffset, count, step, decimation);
-                        break;
-                    case AV_SAMPLE_FMT_S16P:
-                    case AV_SAMPLE_FMT_S16:
-                        res = computeSumSquaresAVX2_S16((const int16_t *)rawData + dataOffset, count, step, decimation);
-                        break;
-                    case AV_SAMPLE_FMT_S32P:
-                    case AV_SAMPLE_FMT_S32:
-                        res = computeSumSquaresAVX2_S32((const int32_t *)rawData + dataOffset, count, step, decimation);
-                        break;
-                    case AV_SAMPLE_FMT_U8P:
-                    case AV_SAMPLE_FMT_U8:
-                        res = computeSumSquares_U8((const uint8_t *)rawData + dataOffset, count, step, decimation);
-                        break;
-                    default: break;
-                    }
-                    localBars[curBarIdx].sumSquares += res.sumSquares;
-                    localBars[curBarIdx].actualCount += res.actualCount;
-                    processedInFrame += count;
-
-                    if (((frameBaseSample + processedInFrame) - globalStartSample) >= nextBarBoundaryRel)
-                    {
-                        curBarIdx++;
-                        nextBarBoundaryRel += samplesPerBar;
-                    }
-                }
+                curBarIdx++;
+                nextBarBoundaryRel += m_samplesPerBar;
             }
         }
     }
-    av_frame_free(&frame);
-    avcodec_free_context(&ctx);
-    return localBars;
-}
+
+    std::vector<BarData> bars;
+
+private:
+    int64_t m_globalStartSample;
+    double m_samplesPerBar;
+    AVSampleFormat m_format = AV_SAMPLE_FMT_NONE;
+    int m_step = 1;
+    int m_decimation = 1;
+};
 
 // =========================================================
 //  Part 4: 主函数
@@ -1599,25 +3141,13 @@ std::vector<int> AudioPlayer::buildAudioWaveform(
     if (barWidth < 1)
         barWidth = 1;
 
-    // 1. 打开文件
-    AVFormatContext *fmt = nullptr;
-    if (avformat_open_input(&fmt, filepath.c_str(), nullptr, nullptr) < 0)
-        return barHeights;
-    if (avformat_find_stream_info(fmt, nullptr) < 0)
-    {
-        avformat_close_input(&fmt);
-        return barHeights;
-    }
-
-    int streamIdx = av_find_best_stream(fmt, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
-    if (streamIdx < 0)
-    {
-        avformat_close_input(&fmt);
+    // 1. 打开文件 (策略选择：FLAC/MP3 等并行 Seek，M4A/MKA 等流水线读包，见 ChunkDecoder)
+    ChunkDecoder decoder;
+    if (!decoder.open(filepath))
         return barHeights;
-    }
 
     // 2. 计算实际时间范围
-    int64_t fileDurationUS = fmt->duration * 1000000 / AV_TIME_BASE;
+    int64_t fileDurationUS = decoder.durationUs();
     if (endTimeUS <= 0 || endTimeUS > fileDurationUS)
     {
         endTimeUS = fileDurationUS;
@@ -1625,13 +3155,10 @@ std::vector<int> AudioPlayer::buildAudioWaveform(
     if (startTimeUS < 0)
         startTimeUS = 0;
     if (startTimeUS >= endTimeUS)
-    {
-        avformat_close_input(&fmt);
         return barHeights;
-    }
 
     int64_t segmentDurationUS = endTimeUS - startTimeUS;
-    int sampleRate = fmt->streams[streamIdx]->codecpar->sample_rate;
+    int sampleRate = decoder.sampleRate();
 
     int64_t globalStartSample = av_rescale(startTimeUS, sampleRate, 1000000);
     int64_t globalEndSample = av_rescale(endTimeUS, sampleRate, 1000000);
@@ -1641,132 +3168,25 @@ std::vector<int> AudioPlayer::buildAudioWaveform(
     if (samplesPerBar < 1)
         samplesPerBar = 1;
 
-    // 策略判断
-    const char *formatName = fmt->iformat->name;
-    bool useStrategyB = false;
-    const char *complexContainers[] = {"mov", "mp4", "m4a", "3gp", "3g2", "mj2", "matroska", "webm"};
-    for (const char *name : complexContainers)
-    {
-        if (strstr(formatName, name) != nullptr)
-        {
-            useStrategyB = true;
-            break;
-        }
-    }
-
     int threadCount = std::thread::hardware_concurrency();
     if (threadCount < 2)
         threadCount = 2;
     if (segmentDurationUS < 1000000)
         threadCount = 1;
 
-    std::vector<std::future<std::vector<BarData>>> futures;
+    // 3. 分块并行解码，汇总各块结果
+    auto sinks = decoder.decode(SimpleThreadPool::instance(), globalStartSample, globalEndSample, threadCount, av_rescale(WAVEFORM_PREROLL_US, sampleRate, 1000000),
+                                [&] { return std::make_unique<WaveformSink>(globalStartSample, samplesPerBar, barCount); });
 
-    // 用于最终数据汇总
     std::vector<BarData> finalBarsData(barCount);
-
-    // === Strategy A: 并行 Seek (FLAC) ===
-    if (!useStrategyB)
-    {
-        avformat_close_input(&fmt);
-
-        int64_t samplesPerThread = totalSegmentSamples / threadCount;
-
-        for (int i = 0; i < threadCount; ++i)
-        {
-            int64_t tStart = globalStartSample + i * samplesPerThread;
-            int64_t tEnd = (i == threadCount - 1) ? globalEndSample : (tStart + samplesPerThread);
-
-            futures.push_back(
-                SimpleThreadPool::instance().enqueue(
-                    processAudioChunk_StrategyA,
-                    filepath, streamIdx, tStart, tEnd, globalStartSample, samplesPerBar, barCount));
-        }
-
-        // 汇总结果 A
-        for (auto &fut : futures)
-        {
-            std::vector<BarData> chunkResult = fut.get();
-            for (int i = 0; i < barCount; ++i)
-            {
-                if (chunkResult[i].actualCount > 0)
-                {
-                    finalBarsData[i] = chunkResult[i];
-                }
-            }
-        }
-    }
-    // === Strategy B: 流水线读取 (M4A) ===
-    else
+    for (auto &sink : sinks)
     {
-        AVCodecParameters *codecPar = avcodec_parameters_alloc();
-        avcodec_parameters_copy(codecPar, fmt->streams[streamIdx]->codecpar);
-        AVRational timeBase = fmt->streams[streamIdx]->time_base;
-
-        auto packetStorage = std::make_shared<std::deque<SafePacket>>();
-        std::vector<AVPacket *> currentBatch;
-        const int BATCH_SIZE = 250;
-        currentBatch.reserve(BATCH_SIZE);
-
-        AVPacket *tempPkt = av_packet_alloc();
-
-        int64_t seekTarget = av_rescale_q(startTimeUS, (AVRational){1, 1000000}, timeBase);
-        av_seek_frame(fmt, streamIdx, seekTarget, AVSEEK_FLAG_BACKWARD);
-
-        int64_t endPTS = av_rescale_q(endTimeUS, (AVRational){1, 1000000}, timeBase);
-
-        while (av_read_frame(fmt, tempPkt) >= 0)
-        {
-            if (tempPkt->stream_index == streamIdx)
-            {
-                if (tempPkt->pts != AV_NOPTS_VALUE && tempPkt->pts > endPTS)
-                {
-                    av_packet_unref(tempPkt);
-                    break;
-                }
-
-                packetStorage->emplace_back();
-                packetStorage->back().refFrom(tempPkt);
-                currentBatch.push_back(packetStorage->back().pkt);
-
-                if (currentBatch.size() >= BATCH_SIZE)
-                {
-                    futures.push_back(
-                        SimpleThreadPool::instance().enqueue(
-                            processPacketBatch_StrategyB,
-                            currentBatch, codecPar, timeBase, globalStartSample, samplesPerBar, barCount));
-                    currentBatch.clear();
-                    currentBatch.reserve(BATCH_SIZE);
-                }
-            }
-            av_packet_unref(tempPkt);
-        }
-
-        if (!currentBatch.empty())
+        const std::vector<BarData> &chunkResult = static_cast<WaveformSink &>(*sink).bars;
+        for (int i = 0; i < barCount; ++i)
         {
-            futures.push_back(
-                SimpleThreadPool::instance().enqueue(
-                    processPacketBatch_StrategyB,
-                    currentBatch, codecPar, timeBase, globalStartSample, samplesPerBar, barCount));
-        }
-
-        av_packet_free(&tempPkt);
-        avformat_close_input(&fmt);
-
-        // 汇总结果 B
-        for (auto &fut : futures)
-        {
-            std::vector<BarData> chunkResult = fut.get();
-            for (int i = 0; i < barCount; ++i)
-            {
-                if (chunkResult[i].actualCount > 0)
-                {
-                    finalBarsData[i].sumSquares += chunkResult[i].sumSquares;
-                    finalBarsData[i].actualCount += chunkResult[i].actualCount;
-                }
-            }
+            finalBarsData[i].sumSquares += chunkResult[i].sumSquares;
+            finalBarsData[i].actualCount += chunkResult[i].actualCount;
         }
-        avcodec_parameters_free(&codecPar);
     }
 
     // =========================================================
@@ -0,0 +1,329 @@
+#include "ChunkDecoder.hpp"
+
+namespace
+{
+using FrameSink = ChunkDecoder::FrameSink;
+using SinkFactory = ChunkDecoder::SinkFactory;
+
+// 复杂容器：seek 需要解析索引 / 簇，代价高，改为顺序读包 (策略 B)
+constexpr const char *PIPELINED_CONTAINERS[] = {"mov", "mp4", "m4a", "3gp", "3g2", "mj2", "matroska", "webm"};
+// 策略 B 每批的数据包数 (不含预卷)
+constexpr size_t PACKET_BATCH_SIZE = 250;
+// 策略 A 中帧 PTS 与累计位置相差超过这个采样数才重新对齐 (容忍时间基换算的取整误差)
+constexpr int64_t PTS_RESYNC_SAMPLES = 2000;
+
+bool isCancelled(const std::atomic<bool> *cancelled)
+{
+    return cancelled && cancelled->load(std::memory_order_relaxed);
+}
+
+AVCodecContext *openDecoder(const AVCodecParameters *codecPar)
+{
+    const AVCodec *codec = avcodec_find_decoder(codecPar->codec_id);
+    if (!codec)
+        return nullptr;
+    AVCodecContext *ctx = avcodec_alloc_context3(codec);
+    avcodec_parameters_to_context(ctx, codecPar);
+    ctx->thread_count = 1;
+    if (avcodec_open2(ctx, codec, nullptr) < 0)
+    {
+        avcodec_free_context(&ctx);
+        return nullptr;
+    }
+    return ctx;
+}
+
+// 数据包的位置 (采样)，没有时间戳时为 AV_NOPTS_VALUE
+int64_t packetSample(const AVPacket *pkt, AVRational timeBase, int sampleRate)
+{
+    const int64_t ts = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+    return (ts == AV_NOPTS_VALUE) ? AV_NOPTS_VALUE : av_rescale_q(ts, timeBase, AVRational{1, sampleRate});
+}
+
+// 把帧交给接收者，并标出其中属于 [from, until) 的部分
+void pushFrame(FrameSink &sink, const AVFrame *frame, int64_t firstSample, int64_t from, int64_t until)
+{
+    const int begin = static_cast<int>(std::clamp<int64_t>(from - firstSample, 0, frame->nb_samples));
+    const int end = static_cast<int>(std::clamp<int64_t>(until - firstSample, begin, frame->nb_samples));
+    sink.push(frame, firstSample, begin, end);
+}
+
+// =========================================================
+//  策略 A - 并行 Seek (FLAC/MP3/WAV ...)
+// =========================================================
+std::unique_ptr<FrameSink> decodeRange(std::string filepath, int streamIdx, int64_t from, int64_t until, int64_t preroll,
+                                       const SinkFactory *makeSink, const std::atomic<bool> *cancelled)
+{
+    AVFormatContext *fmt = nullptr;
+    if (avformat_open_input(&fmt, filepath.c_str(), nullptr, nullptr) < 0)
+        return nullptr;
+    if (streamIdx >= static_cast<int>(fmt->nb_streams))
+    {
+        avformat_close_input(&fmt);
+        return nullptr;
+    }
+
+    AVStream *stream = fmt->streams[streamIdx];
+    AVCodecContext *ctx = openDecoder(stream->codecpar);
+    std::unique_ptr<FrameSink> sink = (*makeSink)();
+    if (!ctx || !sink->open(ctx))
+    {
+        avcodec_free_context(&ctx);
+        avformat_close_input(&fmt);
+        return nullptr;
+    }
+
+    const AVRational sampleTb = {1, ctx->sample_rate};
+    const int64_t seekSample = std::max<int64_t>(from - preroll, 0);
+    if (seekSample > 0)
+    {
+        av_seek_frame(fmt, streamIdx, av_rescale_q(seekSample, sampleTb, stream->time_base), AVSEEK_FLAG_BACKWARD);
+        avcodec_flush_buffers(ctx);
+    }
+
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    int64_t currentSample = -1;
+    bool finished = false;
+
+    while (!finished && !isCancelled(cancelled) && av_read_frame(fmt, pkt) >= 0)
+    {
+        if (pkt->stream_index == streamIdx && avcodec_send_packet(ctx, pkt) >= 0)
+        {
+            while (avcodec_receive_frame(ctx, frame) >= 0)
+            {
+                if (frame->pts != AV_NOPTS_VALUE)
+                {
+                    int64_t ptsSample = av_rescale_q(frame->pts, stream->time_base, sampleTb);
+                    if (currentSample == -1 || std::abs(ptsSample - currentSample) > PTS_RESYNC_SAMPLES)
+                        currentSample = ptsSample;
+                }
+                else if (currentSample == -1)
+                {
+                    currentSample = 0;
+                }
+
+                if (currentSample >= until)
+                {
+                    finished = true;
+                    break;
+                }
+                pushFrame(*sink, frame, currentSample, from, until);
+                currentSample += frame->nb_samples;
+            }
+        }
+        av_packet_unref(pkt);
+    }
+
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+    avformat_close_input(&fmt);
+    return isCancelled(cancelled) ? nullptr : std::move(sink);
+}
+
+// =========================================================
+//  策略 B - 流水线内存解码 (M4A/MP4/MKA ...)
+// =========================================================
+// packets 以预卷数据包开头，解码器与接收者在 from 之前进入稳态
+std::unique_ptr<FrameSink> decodeBatch(std::vector<AVPacket *> packets, const AVCodecParameters *codecPar, AVRational timeBase,
+                                       int64_t from, int64_t until, const SinkFactory *makeSink, const std::atomic<bool> *cancelled)
+{
+    AVCodecContext *ctx = openDecoder(codecPar);
+    std::unique_ptr<FrameSink> sink = (*makeSink)();
+    if (!ctx || !sink->open(ctx))
+    {
+        avcodec_free_context(&ctx);
+        return nullptr;
+    }
+
+    const AVRational sampleTb = {1, ctx->sample_rate};
+    AVFrame *frame = av_frame_alloc();
+    auto receiveFrames = [&]
+    {
+        while (avcodec_receive_frame(ctx, frame) >= 0)
+        {
+            if (frame->pts != AV_NOPTS_VALUE)
+                pushFrame(*sink, frame, av_rescale_q(frame->pts, timeBase, sampleTb), from, until);
+        }
+    };
+
+    for (AVPacket *pkt : packets)
+    {
+        if (isCancelled(cancelled))
+            break;
+        if (avcodec_send_packet(ctx, pkt) >= 0)
+            receiveFrames();
+    }
+    // 取出解码器内部延迟的最后几帧 (下一批从自己的第一个数据包开始计数，不会重复)
+    if (avcodec_send_packet(ctx, nullptr) >= 0)
+        receiveFrames();
+
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+    return isCancelled(cancelled) ? nullptr : std::move(sink);
+}
+} // namespace
+
+ChunkDecoder::~ChunkDecoder()
+{
+    avformat_close_input(&m_fmt);
+}
+
+bool ChunkDecoder::open(const std::string &path)
+{
+    avformat_close_input(&m_fmt);
+    m_path = path;
+    if (avformat_open_input(&m_fmt, path.c_str(), nullptr, nullptr) < 0)
+        return false;
+    if (avformat_find_stream_info(m_fmt, nullptr) < 0)
+    {
+        avformat_close_input(&m_fmt);
+        return false;
+    }
+    m_streamIdx = av_find_best_stream(m_fmt, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (m_streamIdx < 0 || m_fmt->streams[m_streamIdx]->codecpar->sample_rate <= 0)
+    {
+        avformat_close_input(&m_fmt);
+        return false;
+    }
+
+    m_sampleRate = m_fmt->streams[m_streamIdx]->codecpar->sample_rate;
+    m_durationUs = (m_fmt->duration > 0) ? av_rescale(m_fmt->duration, 1000000, AV_TIME_BASE) : 0;
+    m_pipelined = false;
+    for (const char *name : PIPELINED_CONTAINERS)
+    {
+        if (strstr(m_fmt->iformat->name, name) != nullptr)
+        {
+            m_pipelined = true;
+            break;
+        }
+    }
+    return true;
+}
+
+std::vector<std::unique_ptr<ChunkDecoder::FrameSink>> ChunkDecoder::decode(SimpleThreadPool &pool, int64_t startSample, int64_t endSample, int chunks,
+                                                                          int64_t preroll, const SinkFactory &makeSink, const std::atomic<bool> *cancelled)
+{
+    if (!m_fmt || startSample >= endSample)
+        return {};
+    if (m_pipelined)
+        return decodePipelined(pool, startSample, endSample, preroll, makeSink, cancelled);
+    return decodeSeekable(pool, startSample, endSample, chunks, preroll, makeSink, cancelled);
+}
+
+std::vector<std::unique_ptr<ChunkDecoder::FrameSink>> ChunkDecoder::decodeSeekable(SimpleThreadPool &pool, int64_t startSample, int64_t endSample, int chunks,
+                                                                                  int64_t preroll, const SinkFactory &makeSink, const std::atomic<bool> *cancelled)
+{
+    // 每块各自打开文件
+    avformat_close_input(&m_fmt);
+
+    // 范围可以一直延伸到文件末尾 (endSample 超过时长)，此时按估算的时长切块，最后一块读到末尾
+    const int64_t durationSamples = av_rescale(m_durationUs, m_sampleRate, 1000000);
+    const int64_t span = std::min(endSample, std::max(durationSamples, startSample + 1)) - startSample;
+    const int64_t count = std::clamp<int64_t>(chunks, 1, span);
+    const int64_t samplesPerChunk = span / count;
+
+    std::vector<std::future<std::unique_ptr<FrameSink>>> futures;
+    for (int64_t i = 0; i < count; ++i)
+    {
+        const int64_t from = startSample + i * samplesPerChunk;
+        const int64_t until = (i == count - 1) ? endSample : from + samplesPerChunk;
+        futures.push_back(pool.enqueue(decodeRange, m_path, m_streamIdx, from, until, preroll, &makeSink, cancelled));
+    }
+
+    std::vector<std::unique_ptr<FrameSink>> sinks;
+    for (auto &fut : futures)
+    {
+        if (std::unique_ptr<FrameSink> sink = fut.get())
+            sinks.push_back(std::move(sink));
+    }
+    return sinks;
+}
+
+std::vector<std::unique_ptr<ChunkDecoder::FrameSink>> ChunkDecoder::decodePipelined(SimpleThreadPool &pool, int64_t startSample, int64_t endSample,
+                                                                                   int64_t preroll, const SinkFactory &makeSink, const std::atomic<bool> *cancelled)
+{
+    AVStream *stream = m_fmt->streams[m_streamIdx];
+    AVCodecParameters *codecPar = avcodec_parameters_alloc();
+    avcodec_parameters_copy(codecPar, stream->codecpar);
+    const AVRational timeBase = stream->time_base;
+
+    const int64_t seekSample = std::max<int64_t>(startSample - preroll, 0);
+    if (seekSample > 0)
+    {
+        av_seek_frame(m_fmt, m_streamIdx, av_rescale_q(seekSample, AVRational{1, m_sampleRate}, timeBase), AVSEEK_FLAG_BACKWARD);
+    }
+
+    std::vector<std::future<std::unique_ptr<FrameSink>>> futures;
+    std::deque<AVPacket *> storage;
+    std::vector<AVPacket *> batch; // 预卷 + 本批的数据包
+    batch.reserve(PACKET_BATCH_SIZE);
+    size_t ownPackets = 0;
+    int64_t batchFrom = startSample;
+    auto dispatch = [&](int64_t until)
+    {
+        futures.push_back(pool.enqueue(decodeBatch, batch, codecPar, timeBase, batchFrom, until, &makeSink, cancelled));
+    };
+
+    AVPacket *pkt = av_packet_alloc();
+    while (!isCancelled(cancelled) && av_read_frame(m_fmt, pkt) >= 0)
+    {
+        if (pkt->stream_index != m_streamIdx)
+        {
+            av_packet_unref(pkt);
+            continue;
+        }
+        const int64_t sample = packetSample(pkt, timeBase, m_sampleRate);
+        if (sample != AV_NOPTS_VALUE && sample >= endSample)
+        {
+            av_packet_unref(pkt);
+            break;
+        }
+
+        // 满一批后在有时间戳的数据包处切分：新的一批从这里开始计数，
+        // 前一批末尾覆盖 preroll 个采样的数据包留下来作为新一批的预卷
+        if (ownPackets >= PACKET_BATCH_SIZE && sample != AV_NOPTS_VALUE)
+        {
+            dispatch(sample);
+            size_t keep = 0;
+            int64_t covered = sample;
+            while (keep < batch.size() && covered > sample - preroll)
+            {
+                const int64_t previous = packetSample(batch[batch.size() - 1 - keep], timeBase, m_sampleRate);
+                if (previous == AV_NOPTS_VALUE)
+                    break;
+                covered = previous;
+                ++keep;
+            }
+            batch.erase(batch.begin(), batch.end() - static_cast<std::ptrdiff_t>(keep));
+            batchFrom = sample;
+            ownPackets = 0;
+        }
+
+        storage.push_back(av_packet_clone(pkt));
+        batch.push_back(storage.back());
+        ++ownPackets;
+        av_packet_unref(pkt);
+    }
+    if (ownPackets > 0)
+    {
+        dispatch(endSample);
+    }
+    av_packet_free(&pkt);
+    avformat_close_input(&m_fmt);
+
+    // 数据包与参数在所有批次完成后才能释放
+    std::vector<std::unique_ptr<FrameSink>> sinks;
+    for (auto &fut : futures)
+    {
+        if (std::unique_ptr<FrameSink> sink = fut.get())
+            sinks.push_back(std::move(sink));
+    }
+    for (AVPacket *p : storage)
+    {
+        av_packet_free(&p);
+    }
+    avcodec_parameters_free(&codecPar);
+    return sinks;
+}
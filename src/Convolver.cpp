@@ -0,0 +1,572 @@
+#include "Convolver.hpp"
+#include "Resampler.hpp"
+
+#include <immintrin.h>
+
+namespace
+{
+// MXCSR：FTZ | DAZ，脉冲响应尾部衰减到非规格化数时避免性能骤降
+constexpr unsigned int MXCSR_FLUSH_DENORMALS = 0x8040;
+
+// acc += x · h (复数，实部 / 虚部分开存放，count 为 8 的倍数)
+void multiplyAccumulate(float *acc, const float *x, const float *h, size_t count)
+{
+    float *accRe = acc;
+    float *accIm = acc + count;
+    const float *xRe = x;
+    const float *xIm = x + count;
+    const float *hRe = h;
+    const float *hIm = h + count;
+#ifdef __AVX2__
+    for (size_t i = 0; i < count; i += 8)
+    {
+        const __m256 xr = _mm256_loadu_ps(xRe + i);
+        const __m256 xi = _mm256_loadu_ps(xIm + i);
+        const __m256 hr = _mm256_loadu_ps(hRe + i);
+        const __m256 hi = _mm256_loadu_ps(hIm + i);
+        __m256 re = _mm256_loadu_ps(accRe + i);
+        __m256 im = _mm256_loadu_ps(accIm + i);
+        re = _mm256_fnmadd_ps(xi, hi, _mm256_fmadd_ps(xr, hr, re));
+        im = _mm256_fmadd_ps(xi, hr, _mm256_fmadd_ps(xr, hi, im));
+        _mm256_storeu_ps(accRe + i, re);
+        _mm256_storeu_ps(accIm + i, im);
+    }
+#else
+    for (size_t i = 0; i < count; ++i)
+    {
+        accRe[i] += xRe[i] * hRe[i] - xIm[i] * hIm[i];
+        accIm[i] += xRe[i] * hIm[i] + xIm[i] * hRe[i];
+    }
+#endif
+}
+} // namespace
+
+bool ConvolverStage::loadImpulseResponse(const std::string &path, ImpulseResponse &out)
+{
+    AVFormatContext *fmt = nullptr;
+    if (avformat_open_input(&fmt, path.c_str(), nullptr, nullptr) < 0)
+    {
+        spdlog::error("[Convolver] Cannot open impulse response: {}", path);
+        return false;
+    }
+
+    AVCodecContext *ctx = nullptr;
+    SwrContext *swr = nullptr;
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    auto cleanup = [&]()
+    {
+        av_frame_free(&frame);
+        av_packet_free(&pkt);
+        swr_free(&swr);
+        avcodec_free_context(&ctx);
+        avformat_close_input(&fmt);
+    };
+
+    const AVCodec *codec = nullptr;
+    const int streamIdx = avformat_find_stream_info(fmt, nullptr) >= 0 ? av_find_best_stream(fmt, AVMEDIA_TYPE_AUDIO, -1, -1, &codec, 0) : -1;
+    if (streamIdx < 0 || !codec)
+    {
+        spdlog::error("[Convolver] No audio stream in impulse response: {}", path);
+        cleanup();
+        return false;
+    }
+
+    ctx = avcodec_alloc_context3(codec);
+    avcodec_parameters_to_context(ctx, fmt->streams[streamIdx]->codecpar);
+    const int channels = ctx->ch_layout.nb_channels;
+    if (avcodec_open2(ctx, codec, nullptr) < 0 || channels < 1 || channels > MAX_CHANNELS || ctx->sample_rate <= 0)
+    {
+        spdlog::error("[Convolver] Unsupported impulse response ({} channels, {} Hz): {}", channels, ctx->sample_rate, path);
+        cleanup();
+        return false;
+    }
+
+    ImpulseResponse impulse;
+    impulse.sampleRate = ctx->sample_rate;
+    impulse.channels.resize(channels);
+    std::vector<uint8_t *> planes(channels);
+    bool truncated = false;
+
+    // 只做格式转换 (平面 float)，采样率在 prepare 时按输出设备转换
+    auto append = [&](AVFrame *decoded) -> bool
+    {
+        if (!swr)
+        {
+            swr = Resampler::create(decoded->ch_layout, decoded->sample_rate, static_cast<AVSampleFormat>(decoded->format),
+                                    decoded->ch_layout, decoded->sample_rate, AV_SAMPLE_FMT_FLTP, ResamplerQuality::Default);
+            if (!swr)
+                return false;
+        }
+        const size_t offset = impulse.taps();
+        const size_t count = std::min<size_t>(decoded->nb_samples, MAX_TAPS - offset);
+        truncated |= count < static_cast<size_t>(decoded->nb_samples);
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            impulse.channels[ch].resize(offset + decoded->nb_samples);
+            planes[ch] = reinterpret_cast<uint8_t *>(impulse.channels[ch].data() + offset);
+        }
+        swr_convert(swr, planes.data(), decoded->nb_samples, const_cast<const uint8_t **>(decoded->extended_data), decoded->nb_samples);
+        for (auto &channel : impulse.channels)
+        {
+            channel.resize(offset + count);
+        }
+        return true;
+    };
+
+    bool ok = true;
+    while (ok && !truncated && av_read_frame(fmt, pkt) >= 0)
+    {
+        if (pkt->stream_index == streamIdx && avcodec_send_packet(ctx, pkt) >= 0)
+        {
+            while (ok && avcodec_receive_frame(ctx, frame) >= 0)
+            {
+                ok = append(frame);
+            }
+        }
+        av_packet_unref(pkt);
+    }
+    if (ok && !truncated && avcodec_send_packet(ctx, nullptr) >= 0)
+    {
+        while (ok && avcodec_receive_frame(ctx, frame) >= 0)
+        {
+            ok = append(frame);
+        }
+    }
+    cleanup();
+
+    if (!ok || impulse.taps() == 0)
+    {
+        spdlog::error("[Convolver] Failed to decode impulse response: {}", path);
+        return false;
+    }
+    if (truncated)
+    {
+        spdlog::warn("[Convolver] Impulse response truncated to {} taps: {}", MAX_TAPS, path);
+    }
+
+    spdlog::info("[Convolver] Loaded impulse response: {} taps, {} channels, {} Hz ({})", impulse.taps(), channels, impulse.sampleRate, path);
+    out = std::move(impulse);
+    return true;
+}
+
+ConvolverStage::ConvolverStage(ImpulseResponse impulse)
+    : m_impulse(std::move(impulse))
+{
+    const float forwardScale = 1.0f;
+    const float inverseScale = 1.0f / FFT_SIZE;
+    if (av_tx_init(&m_forward, &m_forwardFn, AV_TX_FLOAT_RDFT, 0, FFT_SIZE, &forwardScale, AV_TX_UNALIGNED) < 0 ||
+        av_tx_init(&m_inverse, &m_inverseFn, AV_TX_FLOAT_RDFT, 1, FFT_SIZE, &inverseScale, AV_TX_UNALIGNED) < 0)
+    {
+        spdlog::error("[Convolver] av_tx_init failed, convolver disabled");
+        av_tx_uninit(&m_forward);
+        av_tx_uninit(&m_inverse);
+    }
+}
+
+ConvolverStage::~ConvolverStage()
+{
+    stopWorker();
+    av_tx_uninit(&m_forward);
+    av_tx_uninit(&m_inverse);
+}
+
+const char *ConvolverStage::name() const
+{
+    return "convolver";
+}
+
+uint64_t ConvolverStage::workerBusyNs() const
+{
+    return m_workerNs.load(std::memory_order_relaxed);
+}
+
+std::vector<std::vector<float>> ConvolverStage::resampleImpulse(int sampleRate) const
+{
+    const int inRate = m_impulse.sampleRate;
+    if (inRate == sampleRate)
+        return m_impulse.channels;
+
+    const int channels = static_cast<int>(m_impulse.channels.size());
+    const int inSamples = static_cast<int>(m_impulse.taps());
+    const size_t expected = static_cast<size_t>(av_rescale_rnd(inSamples, sampleRate, inRate, AV_ROUND_UP));
+
+    AVChannelLayout layout;
+    av_channel_layout_default(&layout, channels);
+    SwrContext *swr = Resampler::create(layout, inRate, AV_SAMPLE_FMT_FLTP, layout, sampleRate, AV_SAMPLE_FMT_FLTP, ResamplerQuality::High);
+    av_channel_layout_uninit(&layout);
+    if (!swr)
+    {
+        spdlog::error("[Convolver] Cannot resample impulse response {} -> {} Hz", inRate, sampleRate);
+        return {};
+    }
+
+    // 预留重采样滤波器延迟的余量，冲刷后截到预期长度
+    const size_t capacity = expected + static_cast<size_t>(swr_get_out_samples(swr, 0)) + 4096;
+    std::vector<std::vector<float>> result(channels, std::vector<float>(capacity, 0.0f));
+    std::vector<const uint8_t *> in(channels);
+    std::vector<uint8_t *> out(channels);
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        in[ch] = reinterpret_cast<const uint8_t *>(m_impulse.channels[ch].data());
+    }
+
+    size_t produced = 0;
+    const uint8_t **input = in.data();
+    int inputSamples = inSamples;
+    while (produced < capacity)
+    {
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            out[ch] = reinterpret_cast<uint8_t *>(result[ch].data() + produced);
+        }
+        const int got = swr_convert(swr, out.data(), static_cast<int>(capacity - produced), input, inputSamples);
+        if (got <= 0 && !input)
+            break;
+        produced += static_cast<size_t>(std::max(got, 0));
+        input = nullptr;
+        inputSamples = 0;
+    }
+    swr_free(&swr);
+
+    // swr 保持样本值不变，而单位冲激在更高的采样率下对应更多的样本：按采样率之比缩放以保持频率响应
+    const float scale = static_cast<float>(inRate) / static_cast<float>(sampleRate);
+    for (auto &channel : result)
+    {
+        channel.resize(std::min(expected, produced));
+        for (float &sample : channel)
+        {
+            sample *= scale;
+        }
+    }
+    return result;
+}
+
+void ConvolverStage::prepare(int sampleRate, int channels)
+{
+    stopWorker();
+
+    m_channels = static_cast<size_t>(std::max(channels, 0));
+    m_filter.clear();
+    m_partitions = 0;
+    m_taps = 0;
+    if (!m_forward || !m_inverse || m_channels == 0 || sampleRate <= 0)
+        return;
+
+    const std::vector<std::vector<float>> impulse = resampleImpulse(sampleRate);
+    if (impulse.empty() || impulse[0].empty())
+        return;
+
+    m_filterChannels = impulse.size();
+    m_taps = std::min(impulse[0].size(), MAX_TAPS);
+    m_partitions = (m_taps + PARTITION_FRAMES - 1) / PARTITION_FRAMES;
+    m_headPartitions = std::min(m_partitions, HEAD_PARTITIONS);
+
+    m_time.assign(FFT_SIZE, 0.0f);
+    m_bins.assign(PARTITION_FRAMES + 1, AVComplexFloat{});
+    m_filter.assign(m_filterChannels * m_partitions * SPECTRUM, 0.0f);
+    for (size_t ch = 0; ch < m_filterChannels; ++ch)
+    {
+        for (size_t k = 0; k < m_partitions; ++k)
+        {
+            // 每个分区补零到 FFT_SIZE 后变换
+            const size_t begin = k * PARTITION_FRAMES;
+            const size_t count = std::min(PARTITION_FRAMES, m_taps - begin);
+            std::fill(m_time.begin(), m_time.end(), 0.0f);
+            std::copy_n(impulse[ch].begin() + begin, count, m_time.begin());
+            m_forwardFn(m_forward, m_bins.data(), m_time.data(), sizeof(float));
+
+            float *spectrum = &m_filter[(ch * m_partitions + k) * SPECTRUM];
+            for (size_t i = 0; i <= PARTITION_FRAMES; ++i)
+            {
+                spectrum[i] = m_bins[i].re;
+                spectrum[BINS + i] = m_bins[i].im;
+            }
+        }
+    }
+
+    // 块号环比分区数多出 TAIL_SLOTS 个块：工作线程稍有落后时它要读的块还不会被回收
+    m_fdlRing = m_partitions + TAIL_SLOTS;
+    m_fdl.assign((m_fdlRing + 1) * m_channels * SPECTRUM, 0.0f);
+    m_fdlMap = std::make_unique<std::atomic<size_t>[]>(m_fdlRing);
+    m_fdlBlock = std::make_unique<std::atomic<int64_t>[]>(m_fdlRing + 1);
+    for (size_t i = 0; i < m_fdlRing; ++i)
+    {
+        m_fdlMap[i].store(i, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i <= m_fdlRing; ++i)
+    {
+        m_fdlBlock[i].store(-1, std::memory_order_relaxed);
+    }
+    m_fdlSpare = m_fdlRing;
+    m_pinned.store(-1, std::memory_order_relaxed);
+    m_window.assign(m_channels * FFT_SIZE, 0.0f);
+    m_output.assign(m_channels * PARTITION_FRAMES, 0.0f);
+    m_accumulator.assign(m_channels * SPECTRUM, 0.0f);
+    m_tail.assign(TAIL_SLOTS * m_channels * SPECTRUM, 0.0f);
+    m_position = 0;
+    m_block = 0;
+    m_firstBlock.store(0, std::memory_order_relaxed);
+    m_posted.store(-1, std::memory_order_relaxed);
+    m_claimed.store(-1, std::memory_order_relaxed);
+    for (auto &job : m_tailJob)
+    {
+        job.store(-1, std::memory_order_relaxed);
+    }
+    m_pollInterval = std::chrono::nanoseconds(static_cast<int64_t>(PARTITION_FRAMES) * 1000000000 / sampleRate / POLLS_PER_BLOCK);
+    m_workerNs.store(0, std::memory_order_relaxed);
+
+    spdlog::info("[Convolver] Prepared {} taps at {} Hz: {} partitions of {} frames ({} on worker thread)",
+                 m_taps, sampleRate, m_partitions, PARTITION_FRAMES, m_partitions - m_headPartitions);
+
+    if (m_partitions > m_headPartitions)
+    {
+        startWorker();
+    }
+}
+
+void ConvolverStage::reset()
+{
+    if (m_partitions == 0)
+        return;
+
+    // 延迟线不清空 (工作线程可能正在读取)：纪元之前的输入块在之后的计算中直接跳过，等价于零
+    std::fill(m_window.begin(), m_window.end(), 0.0f);
+    std::fill(m_output.begin(), m_output.end(), 0.0f);
+    m_position = 0;
+    m_firstBlock.store(m_block, std::memory_order_release);
+}
+
+void ConvolverStage::process(float *samples, size_t frames, int channels)
+{
+    if (m_partitions == 0 || static_cast<size_t>(channels) != m_channels)
+        return;
+
+    const unsigned int mxcsr = _mm_getcsr();
+    _mm_setcsr(mxcsr | MXCSR_FLUSH_DENORMALS);
+
+    // 输入填入当前块，同时送出上一块的输出 (固定延迟一个分区)
+    size_t offset = 0;
+    while (offset < frames)
+    {
+        const size_t count = std::min(frames - offset, PARTITION_FRAMES - m_position);
+        float *data = samples + offset * m_channels;
+        for (size_t f = 0; f < count; ++f)
+        {
+            float *frame = data + f * m_channels;
+            const float *output = &m_output[(m_position + f) * m_channels];
+            for (size_t ch = 0; ch < m_channels; ++ch)
+            {
+                m_window[ch * FFT_SIZE + PARTITION_FRAMES + m_position + f] = frame[ch];
+                frame[ch] = output[ch];
+            }
+        }
+        m_position += count;
+        offset += count;
+
+        if (m_position == PARTITION_FRAMES)
+        {
+            processBlock();
+            m_position = 0;
+        }
+    }
+
+    _mm_setcsr(mxcsr);
+}
+
+void ConvolverStage::processBlock()
+{
+    const int64_t block = m_block++;
+
+    storeBlock(block);
+    const int64_t firstBlock = m_firstBlock.load(std::memory_order_relaxed);
+
+    // 交给工作线程：输出块 block + HEAD_PARTITIONS 的尾部分区从现在起可以计算 (工作线程轮询，不唤醒)
+    const bool hasTail = m_partitions > m_headPartitions;
+    if (hasTail)
+    {
+        m_posted.store(block, std::memory_order_release);
+    }
+
+    // 头部分区
+    for (size_t ch = 0; ch < m_channels; ++ch)
+    {
+        float *acc = &m_accumulator[ch * SPECTRUM];
+        std::fill_n(acc, SPECTRUM, 0.0f);
+        for (size_t k = 0; k < m_headPartitions && block - static_cast<int64_t>(k) >= firstBlock; ++k)
+        {
+            multiplyAccumulate(acc, fdlSlot(fdlSlotOf(block - static_cast<int64_t>(k)), ch), filter(ch, k), BINS);
+        }
+    }
+
+    // 尾部分区：工作线程在 HEAD_PARTITIONS 个块之前就已开始计算，通常已经完成。
+    // 没有完成时解码线程领取该任务就地计算；工作线程若正在算同一任务，它的结果不再被读取
+    // (它读取的输入块被回收前会放弃该任务)
+    const bool useTail = hasTail && block >= firstBlock + static_cast<int64_t>(m_headPartitions);
+    bool tailReady = false;
+    if (useTail)
+    {
+        std::atomic<int64_t> &slotJob = m_tailJob[static_cast<size_t>(block % static_cast<int64_t>(TAIL_SLOTS))];
+        tailReady = slotJob.load(std::memory_order_acquire) == block;
+        if (!tailReady)
+        {
+            int64_t claimed = m_claimed.load(std::memory_order_relaxed);
+            while (claimed < block && !m_claimed.compare_exchange_weak(claimed, block, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+            }
+            // 领取失败说明工作线程已开始该任务，期间可能刚好完成
+            tailReady = claimed >= block && slotJob.load(std::memory_order_acquire) == block;
+        }
+        if (!tailReady)
+        {
+            accumulateTail(block);
+        }
+    }
+
+    for (size_t ch = 0; ch < m_channels; ++ch)
+    {
+        const float *acc = &m_accumulator[ch * SPECTRUM];
+        const float *tailSpectrum = tailReady ? tail(ch, block) : nullptr;
+        for (size_t i = 0; i <= PARTITION_FRAMES; ++i)
+        {
+            m_bins[i].re = acc[i] + (tailSpectrum ? tailSpectrum[i] : 0.0f);
+            m_bins[i].im = acc[BINS + i] + (tailSpectrum ? tailSpectrum[BINS + i] : 0.0f);
+        }
+        // 逆变换会覆盖输入；后半部分即为本块的线性卷积结果
+        m_inverseFn(m_inverse, m_time.data(), m_bins.data(), sizeof(AVComplexFloat));
+        for (size_t f = 0; f < PARTITION_FRAMES; ++f)
+        {
+            m_output[f * m_channels + ch] = m_time[PARTITION_FRAMES + f];
+        }
+    }
+}
+
+void ConvolverStage::storeBlock(int64_t block)
+{
+    std::atomic<size_t> &mapping = m_fdlMap[static_cast<size_t>(block % static_cast<int64_t>(m_fdlRing))];
+    size_t slot = mapping.load(std::memory_order_relaxed);
+
+    // 先作废槽位再检查登记 (与工作线程的 "先登记再核对标签" 构成 Dekker 式的互斥，两边都用 seq_cst)：
+    // 工作线程要么看到标签已作废而放弃，要么在这里被看到登记，此时改写备用槽位
+    m_fdlBlock[slot].store(-1, std::memory_order_seq_cst);
+    if (m_pinned.load(std::memory_order_seq_cst) == static_cast<int64_t>(slot))
+    {
+        std::swap(slot, m_fdlSpare);
+        mapping.store(slot, std::memory_order_relaxed);
+    }
+
+    // 新输入块变换到频域，窗口前移半个 FFT 长度 (overlap-save)
+    for (size_t ch = 0; ch < m_channels; ++ch)
+    {
+        float *window = &m_window[ch * FFT_SIZE];
+        std::copy_n(window, FFT_SIZE, m_time.begin());
+        m_forwardFn(m_forward, m_bins.data(), m_time.data(), sizeof(float));
+        std::copy_n(window + PARTITION_FRAMES, PARTITION_FRAMES, window);
+
+        float *spectrum = &m_fdl[(slot * m_channels + ch) * SPECTRUM];
+        for (size_t i = 0; i <= PARTITION_FRAMES; ++i)
+        {
+            spectrum[i] = m_bins[i].re;
+            spectrum[BINS + i] = m_bins[i].im;
+        }
+    }
+    m_fdlBlock[slot].store(block, std::memory_order_release);
+}
+
+void ConvolverStage::accumulateTail(int64_t block)
+{
+    const int64_t firstBlock = m_firstBlock.load(std::memory_order_relaxed);
+    for (size_t k = m_headPartitions; k < m_partitions && block - static_cast<int64_t>(k) >= firstBlock; ++k)
+    {
+        const size_t slot = fdlSlotOf(block - static_cast<int64_t>(k));
+        for (size_t ch = 0; ch < m_channels; ++ch)
+        {
+            multiplyAccumulate(&m_accumulator[ch * SPECTRUM], fdlSlot(slot, ch), filter(ch, k), BINS);
+        }
+    }
+}
+
+bool ConvolverStage::computeTail(int64_t job, int64_t firstBlock)
+{
+    for (size_t ch = 0; ch < m_channels; ++ch)
+    {
+        std::fill_n(tail(ch, job), SPECTRUM, 0.0f);
+    }
+
+    // 从最早的输入块开始 (最先被回收)；每个分区读取前登记槽位并核对其中仍是所需的块
+    bool complete = true;
+    for (size_t k = m_partitions; k-- > m_headPartitions;)
+    {
+        const int64_t input = job - static_cast<int64_t>(k);
+        if (input < firstBlock)
+            continue;
+
+        const size_t slot = m_fdlMap[static_cast<size_t>(input % static_cast<int64_t>(m_fdlRing))].load(std::memory_order_acquire);
+        m_pinned.store(static_cast<int64_t>(slot), std::memory_order_seq_cst);
+        if (m_fdlBlock[slot].load(std::memory_order_seq_cst) != input)
+        {
+            complete = false;
+            break;
+        }
+        for (size_t ch = 0; ch < m_channels; ++ch)
+        {
+            multiplyAccumulate(tail(ch, job), fdlSlot(slot, ch), filter(ch, k), BINS);
+        }
+    }
+    m_pinned.store(-1, std::memory_order_release);
+    return complete;
+}
+
+void ConvolverStage::workerLoop()
+{
+    const unsigned int mxcsr = _mm_getcsr();
+    _mm_setcsr(mxcsr | MXCSR_FLUSH_DENORMALS);
+
+    const int64_t head = static_cast<int64_t>(m_headPartitions);
+    while (!m_stop.load(std::memory_order_relaxed))
+    {
+        // 下一个任务：已领取的之后、且不早于当前纪元的第一个可用输出块。
+        // 前后两次读取纪元相同，说明读到的 posted 属于该纪元 (reset 在发布新纪元的块之前更新纪元)
+        const int64_t firstBlock = m_firstBlock.load(std::memory_order_acquire);
+        const int64_t posted = m_posted.load(std::memory_order_acquire);
+        if (m_firstBlock.load(std::memory_order_acquire) != firstBlock)
+            continue;
+        const int64_t earliest = firstBlock + head;
+        int64_t claimed = m_claimed.load(std::memory_order_relaxed);
+        const int64_t job = std::max(claimed + 1, earliest);
+        if (job > posted + head)
+        {
+            std::this_thread::sleep_for(m_pollInterval);
+            continue;
+        }
+        // 解码线程抢先领取了迟到的任务时重新选择
+        if (!m_claimed.compare_exchange_strong(claimed, job, std::memory_order_acq_rel, std::memory_order_relaxed))
+            continue;
+
+        const auto start = std::chrono::steady_clock::now();
+        // 落后太多 (所需的输入块已被回收) 时放弃，解码线程会自己计算
+        if (computeTail(job, firstBlock))
+        {
+            m_tailJob[static_cast<size_t>(job % static_cast<int64_t>(TAIL_SLOTS))].store(job, std::memory_order_release);
+        }
+        m_workerNs.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()),
+                             std::memory_order_relaxed);
+    }
+}
+
+void ConvolverStage::startWorker()
+{
+    m_stop.store(false, std::memory_order_relaxed);
+    m_worker = std::thread(&ConvolverStage::workerLoop, this);
+}
+
+void ConvolverStage::stopWorker()
+{
+    if (!m_worker.joinable())
+        return;
+
+    // 工作线程在下一次轮询时退出
+    m_stop.store(true, std::memory_order_relaxed);
+    m_worker.join();
+}
+
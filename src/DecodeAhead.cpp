@@ -0,0 +1,180 @@
+#include "DecodeAhead.hpp"
+
+DecodeAhead::DecodeAhead(AVFormatContext *formatCtx, AVCodecContext *codecCtx, int streamIndex, double maxSeconds, LatencyHistogram *decodeLatency)
+    : m_formatCtx(formatCtx),
+      m_codecCtx(codecCtx),
+      m_streamIndex(streamIndex),
+      m_maxUs(static_cast<int64_t>(std::max(maxSeconds, 0.0) * 1000000.0)),
+      m_decodeLatency(decodeLatency)
+{
+    m_worker = std::thread(&DecodeAhead::workerLoop, this);
+}
+
+DecodeAhead::~DecodeAhead()
+{
+    m_stop.store(true);
+    m_cond.notify_all();
+    if (m_worker.joinable())
+    {
+        m_worker.join();
+    }
+    for (AVFrame *frame : m_frames)
+    {
+        av_frame_free(&frame);
+    }
+}
+
+DecodeAhead::Status DecodeAhead::pop(AVFrame *frame, int &error)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this]
+                { return !m_frames.empty() || m_finished; });
+
+    if (m_frames.empty())
+    {
+        error = m_error;
+        return (m_error == 0) ? Status::EndOfStream : Status::Error;
+    }
+
+    AVFrame *front = m_frames.front();
+    m_frames.pop_front();
+    if (front->sample_rate > 0)
+    {
+        m_bufferedUs -= av_rescale(front->nb_samples, 1000000, front->sample_rate);
+    }
+    av_frame_move_ref(frame, front);
+    av_frame_free(&front);
+    lock.unlock();
+
+    // 腾出了空间，唤醒等待中的工作线程
+    m_cond.notify_all();
+    return Status::Frame;
+}
+
+double DecodeAhead::bufferedSeconds() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<double>(m_bufferedUs) / 1000000.0;
+}
+
+bool DecodeAhead::pushFrame(AVFrame *frame)
+{
+    const int64_t frameUs = (frame->sample_rate > 0) ? av_rescale(frame->nb_samples, 1000000, frame->sample_rate) : 0;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    // 按已缓存的 PCM 时长限量 (而不是帧数：不同格式单帧的时长相差数十倍)
+    m_cond.wait(lock, [this]
+                { return m_stop.load() || m_bufferedUs < m_maxUs || m_frames.empty(); });
+    if (m_stop.load())
+        return false;
+
+    m_frames.push_back(frame);
+    m_bufferedUs += frameUs;
+    lock.unlock();
+    m_cond.notify_all();
+    return true;
+}
+
+void DecodeAhead::finish(int error)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished = true;
+        m_error = error;
+    }
+    m_cond.notify_all();
+}
+
+void DecodeAhead::workerLoop()
+{
+    AVPacket *packet = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    if (!packet || !frame)
+    {
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        finish(AVERROR(ENOMEM));
+        return;
+    }
+
+    // 把解码器中已就绪的帧全部移入缓存；被要求停止时返回 false
+    auto drainFrames = [&]() -> bool
+    {
+        while (avcodec_receive_frame(m_codecCtx, frame) >= 0)
+        {
+            AVFrame *owned = av_frame_alloc();
+            if (!owned)
+                return false;
+            av_frame_move_ref(owned, frame);
+            if (!pushFrame(owned))
+            {
+                av_frame_free(&owned);
+                return false;
+            }
+        }
+        return true;
+    };
+
+    int error = 0;
+    while (!m_stop.load())
+    {
+        int ret = av_read_frame(m_formatCtx, packet);
+        if (ret < 0)
+        {
+            if (ret == AVERROR_EOF)
+            {
+                // 取出解码器内部延迟的最后几帧
+                if (avcodec_send_packet(m_codecCtx, nullptr) >= 0)
+                {
+                    drainFrames();
+                }
+            }
+            else
+            {
+                error = ret;
+            }
+            break;
+        }
+
+        if (packet->stream_index == m_streamIndex)
+        {
+            // 解码耗时只统计 send / receive 本身 (不含等待缓存空间的时间)
+            auto start = std::chrono::steady_clock::now();
+            bool sent = avcodec_send_packet(m_codecCtx, packet) >= 0;
+            std::chrono::steady_clock::duration decodeTime = std::chrono::steady_clock::now() - start;
+            av_packet_unref(packet);
+
+            while (sent)
+            {
+                start = std::chrono::steady_clock::now();
+                ret = avcodec_receive_frame(m_codecCtx, frame);
+                decodeTime += std::chrono::steady_clock::now() - start;
+                if (ret < 0)
+                    break;
+
+                AVFrame *owned = av_frame_alloc();
+                if (!owned)
+                    break;
+                av_frame_move_ref(owned, frame);
+                if (!pushFrame(owned))
+                {
+                    av_frame_free(&owned);
+                    break;
+                }
+            }
+
+            if (m_decodeLatency)
+            {
+                m_decodeLatency->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(decodeTime).count()));
+            }
+        }
+        else
+        {
+            av_packet_unref(packet);
+        }
+    }
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    finish(error);
+}
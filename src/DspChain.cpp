@@ -0,0 +1,247 @@
+#include "DspChain.hpp"
+
+DspChain::DspChain()
+    : m_activeOwner(std::make_unique<StageList>())
+{
+    m_active.store(m_activeOwner.get(), std::memory_order_release);
+}
+
+// 解码线程已停止，所有列表与处理级随成员一起释放
+DspChain::~DspChain() = default;
+
+int DspChain::addStage(std::shared_ptr<DspStage> stage, int position)
+{
+    if (!stage)
+        return -1;
+
+    std::lock_guard<std::mutex> lock(m_editMutex);
+    collectRetired();
+    if (m_activeOwner->count >= MAX_STAGES)
+        return -1;
+
+    // 在发布之前准备好 (分配内存等)，解码线程看到它时已可直接处理
+    if (m_sampleRate > 0 && m_channels > 0)
+    {
+        stage->prepare(m_sampleRate, m_channels);
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->id = m_nextId++;
+    entry->stage = std::move(stage);
+
+    auto list = std::make_unique<StageList>(*m_activeOwner);
+    const size_t index = (position < 0 || static_cast<size_t>(position) > list->count) ? list->count : static_cast<size_t>(position);
+    for (size_t i = list->count; i > index; --i)
+    {
+        list->entries[i] = list->entries[i - 1];
+    }
+    list->entries[index] = entry.get();
+    list->count++;
+
+    const int id = entry->id;
+    spdlog::info("[DspChain] Added stage {} '{}' at {}", id, entry->stage->name(), index);
+    m_entries.push_back(std::move(entry));
+    publish(std::move(list), {});
+    return id;
+}
+
+bool DspChain::removeStage(int id)
+{
+    std::lock_guard<std::mutex> lock(m_editMutex);
+    auto it = std::find_if(m_entries.begin(), m_entries.end(), [id](const std::unique_ptr<Entry> &entry) { return entry->id == id; });
+    if (it == m_entries.end())
+        return false;
+
+    auto list = std::make_unique<StageList>(*m_activeOwner);
+    const Entry *target = it->get();
+    list->count = 0;
+    for (size_t i = 0; i < m_activeOwner->count; ++i)
+    {
+        if (m_activeOwner->entries[i] != target)
+            list->entries[list->count++] = m_activeOwner->entries[i];
+    }
+    for (size_t i = list->count; i < MAX_STAGES; ++i)
+    {
+        list->entries[i] = nullptr;
+    }
+
+    spdlog::info("[DspChain] Removed stage {} '{}'", id, target->stage->name());
+    std::vector<std::unique_ptr<Entry>> removed;
+    removed.push_back(std::move(*it));
+    m_entries.erase(it);
+    publish(std::move(list), std::move(removed));
+    return true;
+}
+
+bool DspChain::replaceStage(int id, std::shared_ptr<DspStage> stage)
+{
+    if (!stage)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_editMutex);
+    collectRetired();
+    auto it = std::find_if(m_entries.begin(), m_entries.end(), [id](const std::unique_ptr<Entry> &entry) { return entry->id == id; });
+    if (it == m_entries.end())
+        return false;
+
+    if (m_sampleRate > 0 && m_channels > 0)
+    {
+        stage->prepare(m_sampleRate, m_channels);
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->id = id;
+    entry->stage = std::move(stage);
+    entry->bypassed.store((*it)->bypassed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    auto list = std::make_unique<StageList>(*m_activeOwner);
+    for (size_t i = 0; i < list->count; ++i)
+    {
+        if (list->entries[i] == it->get())
+            list->entries[i] = entry.get();
+    }
+
+    spdlog::info("[DspChain] Replaced stage {} '{}' with '{}'", id, (*it)->stage->name(), entry->stage->name());
+    std::vector<std::unique_ptr<Entry>> removed;
+    removed.push_back(std::move(*it));
+    *it = std::move(entry);
+    publish(std::move(list), std::move(removed));
+    return true;
+}
+
+bool DspChain::setBypassed(int id, bool bypassed)
+{
+    std::lock_guard<std::mutex> lock(m_editMutex);
+    for (const auto &entry : m_entries)
+    {
+        if (entry->id == id)
+        {
+            // 旁路只是一个标志，解码线程在下一块生效，无需替换列表
+            entry->bypassed.store(bypassed, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void DspChain::clear()
+{
+    std::lock_guard<std::mutex> lock(m_editMutex);
+    if (m_entries.empty())
+        return;
+    publish(std::make_unique<StageList>(), std::move(m_entries));
+    m_entries.clear();
+}
+
+std::vector<DspStageStats> DspChain::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_editMutex);
+    std::vector<DspStageStats> result;
+    result.reserve(m_activeOwner->count);
+    for (size_t i = 0; i < m_activeOwner->count; ++i)
+    {
+        const Entry *entry = m_activeOwner->entries[i];
+        DspStageStats stats;
+        stats.id = entry->id;
+        stats.name = entry->stage->name();
+        stats.bypassed = entry->bypassed.load(std::memory_order_relaxed);
+        stats.blockUs = entry->blockUs.snapshot();
+        const uint64_t frames = entry->frames.load(std::memory_order_relaxed);
+        if (frames > 0 && m_sampleRate > 0)
+        {
+            const double audioNs = static_cast<double>(frames) * 1e9 / m_sampleRate;
+            stats.load = static_cast<double>(entry->busyNs.load(std::memory_order_relaxed)) / audioNs;
+            stats.workerLoad = static_cast<double>(entry->stage->workerBusyNs()) / audioNs;
+        }
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+void DspChain::prepare(int sampleRate, int channels)
+{
+    std::lock_guard<std::mutex> lock(m_editMutex);
+    // 此时解码线程不在处理链中，待释放的列表全部可以释放
+    m_retired.clear();
+    if (sampleRate == m_sampleRate && channels == m_channels)
+        return;
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+    for (const auto &entry : m_entries)
+    {
+        entry->stage->prepare(sampleRate, channels);
+        // 耗时占比按新的采样率重新统计
+        entry->busyNs.store(0, std::memory_order_relaxed);
+        entry->frames.store(0, std::memory_order_relaxed);
+    }
+}
+
+void DspChain::reset()
+{
+    m_processing.store(true, std::memory_order_seq_cst);
+    const StageList *list = m_active.load(std::memory_order_seq_cst);
+    for (size_t i = 0; i < list->count; ++i)
+    {
+        list->entries[i]->stage->reset();
+    }
+    m_idleVersion.store(list->version, std::memory_order_release);
+    m_processing.store(false, std::memory_order_release);
+}
+
+void DspChain::process(float *samples, size_t frames, int channels)
+{
+    // 先声明进入处理链再读取列表 (与 collectRetired 的 "先替换列表再检查" 配对，两边都用 seq_cst)
+    m_processing.store(true, std::memory_order_seq_cst);
+    const StageList *list = m_active.load(std::memory_order_seq_cst);
+    if (list->count > 0)
+    {
+        // 按块依次经过所有处理级 (块留在缓存中)
+        for (size_t offset = 0; offset < frames; offset += BLOCK_FRAMES)
+        {
+            const size_t block = std::min(BLOCK_FRAMES, frames - offset);
+            float *data = samples + offset * channels;
+            for (size_t i = 0; i < list->count; ++i)
+            {
+                Entry *entry = list->entries[i];
+                if (entry->bypassed.load(std::memory_order_relaxed))
+                    continue;
+
+                const auto start = std::chrono::steady_clock::now();
+                entry->stage->process(data, block, channels);
+                const uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+                entry->blockUs.record(ns / 1000);
+                entry->busyNs.fetch_add(ns, std::memory_order_relaxed);
+                entry->frames.fetch_add(block, std::memory_order_relaxed);
+            }
+        }
+    }
+    // 本次处理结束后解码线程不再持有任何列表，早于该版本被替换的列表可以释放
+    m_idleVersion.store(list->version, std::memory_order_release);
+    m_processing.store(false, std::memory_order_release);
+}
+
+void DspChain::publish(std::unique_ptr<StageList> list, std::vector<std::unique_ptr<Entry>> removed)
+{
+    list->version = m_nextVersion++;
+    m_active.store(list.get(), std::memory_order_seq_cst);
+
+    Retired retired;
+    retired.version = list->version;
+    retired.list = std::move(m_activeOwner);
+    retired.entries = std::move(removed);
+    m_retired.push_back(std::move(retired));
+    m_activeOwner = std::move(list);
+    collectRetired();
+}
+
+void DspChain::collectRetired()
+{
+    // 解码线程不在处理链中 (停止 / Direct 模式 / 没有音频流动)：之后的处理只会读到当前列表，全部释放
+    if (!m_processing.load(std::memory_order_seq_cst))
+    {
+        m_retired.clear();
+        return;
+    }
+    const uint64_t idle = m_idleVersion.load(std::memory_order_acquire);
+    std::erase_if(m_retired, [idle](const Retired &retired) { return retired.version <= idle; });
+}
@@ -0,0 +1,254 @@
+#include "Equalizer.hpp"
+
+#include <immintrin.h>
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+constexpr size_t LANES = 8;
+// 低于该增益的频段视为直通，不参与处理
+constexpr float FLAT_GAIN_DB = 0.01f;
+// 中心频率上限 (相对采样率)，更高的频率在双线性变换下已无意义
+constexpr double MAX_RELATIVE_FREQUENCY = 0.45;
+// MXCSR：FTZ | DAZ，避免滤波器状态衰减为非规格化数时的性能骤降
+constexpr unsigned int MXCSR_FLUSH_DENORMALS = 0x8040;
+
+size_t stateIndex(size_t group, size_t band, size_t which)
+{
+    return ((group * EQ_BANDS + band) * 2 + which) * LANES;
+}
+} // namespace
+
+const std::vector<EqPreset> &EqualizerStage::presets()
+{
+    //                                  31    62   125   250   500    1k    2k    4k    8k   16k
+    static const std::vector<EqPreset> list = {
+        {"Flat", {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+        {"Bass Boost", {6, 5, 4, 2, 0, 0, 0, 0, 0, 0}},
+        {"Treble Boost", {0, 0, 0, 0, 0, 0, 1, 3, 5, 6}},
+        {"Loudness", {5, 4, 2, 0, -1, -1, 0, 1, 3, 4}},
+        {"Vocal", {-2, -2, -1, 0, 2, 4, 4, 2, 0, -1}},
+        {"Rock", {4, 3, 2, 0, -1, -1, 1, 2, 3, 4}},
+        {"Pop", {-1, 0, 2, 3, 4, 3, 1, 0, -1, -1}},
+        {"Jazz", {3, 2, 1, 2, -1, -1, 0, 1, 2, 3}},
+        {"Classical", {3, 2, 1, 0, 0, 0, -1, -1, 1, 2}},
+        {"Electronic", {5, 4, 1, 0, -2, 1, 0, 1, 4, 5}},
+    };
+    return list;
+}
+
+EqSettings EqualizerStage::graphic(const std::array<float, EQ_BANDS> &gainsDb)
+{
+    EqSettings settings;
+    float maxBoost = 0.0f;
+    for (size_t i = 0; i < EQ_BANDS; ++i)
+    {
+        EqBand &band = settings.bands[i];
+        band.type = EqFilterType::Peaking;
+        band.frequency = GRAPHIC_FREQUENCIES[i];
+        band.gainDb = std::clamp(gainsDb[i], -MAX_GAIN_DB, MAX_GAIN_DB);
+        maxBoost = std::max(maxBoost, band.gainDb);
+    }
+    settings.preampDb = -maxBoost;
+    return settings;
+}
+
+EqualizerStage::EqualizerStage()
+    : m_settings(graphic({}))
+{
+}
+
+void EqualizerStage::setSettings(const EqSettings &settings)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_settings = settings;
+    if (m_sampleRate > 0)
+    {
+        m_coefficients.set(compute(m_settings, m_sampleRate));
+    }
+}
+
+EqSettings EqualizerStage::settings() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_settings;
+}
+
+const char *EqualizerStage::name() const
+{
+    return "equalizer";
+}
+
+void EqualizerStage::prepare(int sampleRate, int channels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+    const size_t groups = (static_cast<size_t>(std::max(channels, 0)) + LANES - 1) / LANES;
+    m_state.assign(groups * EQ_BANDS * 2 * LANES, 0.0f);
+    m_coefficients.set(compute(m_settings, sampleRate));
+}
+
+void EqualizerStage::reset()
+{
+    std::fill(m_state.begin(), m_state.end(), 0.0f);
+}
+
+EqualizerStage::Coefficients EqualizerStage::compute(const EqSettings &settings, int sampleRate)
+{
+    Coefficients result;
+    result.preamp = static_cast<float>(std::pow(10.0, settings.preampDb / 20.0));
+
+    for (size_t i = 0; i < EQ_BANDS; ++i)
+    {
+        const EqBand &band = settings.bands[i];
+        if (std::abs(band.gainDb) < FLAT_GAIN_DB)
+            continue;
+
+        // RBJ Audio EQ Cookbook
+        const double a = std::pow(10.0, band.gainDb / 40.0);
+        const double frequency = std::clamp<double>(band.frequency, 1.0, MAX_RELATIVE_FREQUENCY * sampleRate);
+        const double w0 = 2.0 * PI * frequency / sampleRate;
+        const double cosw = std::cos(w0);
+        const double alpha = std::sin(w0) / (2.0 * std::max(band.q, 0.1f));
+        const double shelf = 2.0 * std::sqrt(a) * alpha;
+
+        double b0 = 0, b1 = 0, b2 = 0, a0 = 0, a1 = 0, a2 = 0;
+        switch (band.type)
+        {
+        case EqFilterType::LowShelf:
+            b0 = a * ((a + 1) - (a - 1) * cosw + shelf);
+            b1 = 2 * a * ((a - 1) - (a + 1) * cosw);
+            b2 = a * ((a + 1) - (a - 1) * cosw - shelf);
+            a0 = (a + 1) + (a - 1) * cosw + shelf;
+            a1 = -2 * ((a - 1) + (a + 1) * cosw);
+            a2 = (a + 1) + (a - 1) * cosw - shelf;
+            break;
+        case EqFilterType::HighShelf:
+            b0 = a * ((a + 1) + (a - 1) * cosw + shelf);
+            b1 = -2 * a * ((a - 1) + (a + 1) * cosw);
+            b2 = a * ((a + 1) + (a - 1) * cosw - shelf);
+            a0 = (a + 1) - (a - 1) * cosw + shelf;
+            a1 = 2 * ((a - 1) - (a + 1) * cosw);
+            a2 = (a + 1) - (a - 1) * cosw - shelf;
+            break;
+        case EqFilterType::Peaking:
+        default:
+            b0 = 1 + alpha * a;
+            b1 = -2 * cosw;
+            b2 = 1 - alpha * a;
+            a0 = 1 + alpha / a;
+            a1 = -2 * cosw;
+            a2 = 1 - alpha / a;
+            break;
+        }
+
+        result.bands[result.count] = {static_cast<float>(b0 / a0), static_cast<float>(b1 / a0), static_cast<float>(b2 / a0),
+                                      static_cast<float>(a1 / a0), static_cast<float>(a2 / a0)};
+        result.index[result.count] = static_cast<uint8_t>(i);
+        result.count++;
+    }
+    return result;
+}
+
+void EqualizerStage::process(float *samples, size_t frames, int channels)
+{
+    if (m_coefficients.fetch())
+    {
+        // 不再处理的频段清零状态，之后重新启用时从静止开始
+        const Coefficients &c = m_coefficients.current();
+        std::array<bool, EQ_BANDS> active{};
+        for (size_t i = 0; i < c.count; ++i)
+        {
+            active[c.index[i]] = true;
+        }
+        for (size_t group = 0; group * LANES < static_cast<size_t>(m_channels); ++group)
+        {
+            for (size_t band = 0; band < EQ_BANDS; ++band)
+            {
+                if (!active[band])
+                    std::fill_n(m_state.begin() + stateIndex(group, band, 0), 2 * LANES, 0.0f);
+            }
+        }
+    }
+
+    const Coefficients &c = m_coefficients.current();
+    // 尚未按当前格式准备好，或完全直通
+    if (channels != m_channels || (c.count == 0 && c.preamp == 1.0f))
+        return;
+
+    const unsigned int mxcsr = _mm_getcsr();
+    _mm_setcsr(mxcsr | MXCSR_FLUSH_DENORMALS);
+
+#ifdef __AVX2__
+    // 每组最多 8 个通道占用一个寄存器的各个通道，每一帧依次经过所有频段 (直接 II 型转置)
+    __m256 b0[EQ_BANDS], b1[EQ_BANDS], b2[EQ_BANDS], a1[EQ_BANDS], a2[EQ_BANDS];
+    for (size_t i = 0; i < c.count; ++i)
+    {
+        b0[i] = _mm256_set1_ps(c.bands[i][0]);
+        b1[i] = _mm256_set1_ps(c.bands[i][1]);
+        b2[i] = _mm256_set1_ps(c.bands[i][2]);
+        a1[i] = _mm256_set1_ps(c.bands[i][3]);
+        a2[i] = _mm256_set1_ps(c.bands[i][4]);
+    }
+    const __m256 preamp = _mm256_set1_ps(c.preamp);
+
+    for (size_t group = 0; group * LANES < static_cast<size_t>(channels); ++group)
+    {
+        const int lanes = std::min<int>(LANES, channels - static_cast<int>(group * LANES));
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(lanes), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+        __m256 s1[EQ_BANDS], s2[EQ_BANDS];
+        for (size_t i = 0; i < c.count; ++i)
+        {
+            s1[i] = _mm256_loadu_ps(&m_state[stateIndex(group, c.index[i], 0)]);
+            s2[i] = _mm256_loadu_ps(&m_state[stateIndex(group, c.index[i], 1)]);
+        }
+
+        float *p = samples + group * LANES;
+        for (size_t f = 0; f < frames; ++f, p += channels)
+        {
+            __m256 x = _mm256_mul_ps(_mm256_maskload_ps(p, mask), preamp);
+            for (size_t i = 0; i < c.count; ++i)
+            {
+                const __m256 y = _mm256_fmadd_ps(b0[i], x, s1[i]);
+                s1[i] = _mm256_fmadd_ps(b1[i], x, _mm256_fnmadd_ps(a1[i], y, s2[i]));
+                s2[i] = _mm256_fnmadd_ps(a2[i], y, _mm256_mul_ps(b2[i], x));
+                x = y;
+            }
+            _mm256_maskstore_ps(p, mask, x);
+        }
+
+        for (size_t i = 0; i < c.count; ++i)
+        {
+            _mm256_storeu_ps(&m_state[stateIndex(group, c.index[i], 0)], s1[i]);
+            _mm256_storeu_ps(&m_state[stateIndex(group, c.index[i], 1)], s2[i]);
+        }
+    }
+#else
+    // 标量实现：与 AVX2 版本的状态布局相同
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const size_t group = static_cast<size_t>(ch) / LANES;
+        const size_t lane = static_cast<size_t>(ch) % LANES;
+        float *p = samples + ch;
+        for (size_t f = 0; f < frames; ++f, p += channels)
+        {
+            float x = *p * c.preamp;
+            for (size_t i = 0; i < c.count; ++i)
+            {
+                const std::array<float, 5> &k = c.bands[i];
+                float &s1 = m_state[stateIndex(group, c.index[i], 0) + lane];
+                float &s2 = m_state[stateIndex(group, c.index[i], 1) + lane];
+                const float y = k[0] * x + s1;
+                s1 = k[1] * x - k[3] * y + s2;
+                s2 = k[2] * x - k[4] * y;
+                x = y;
+            }
+            *p = x;
+        }
+    }
+#endif
+
+    _mm_setcsr(mxcsr);
+}
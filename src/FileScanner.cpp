@@ -1,5 +1,6 @@
 #include "FileScanner.hpp"
 #include "CoverCache.hpp"
+#include "LoudnessAnalyzer.hpp"
 #include "MetaData.hpp"
 #include "PCH.h"
 #include "SimpleThreadPool.hpp"
@@ -500,6 +501,32 @@ static std::string extractLyrics(TagLib::Tag *tag, const TagLib::FileRef &fileRe
     return EncodingUtils::sanitizeUTF8(lyrics);
 }
 
+// 同步歌词 (ID3v2 SYLT，只支持毫秒时间戳) 转为 LRC 文本，与其他来源统一解析
+static std::string extractSyncedLyrics(TagLib::ID3v2::Tag *tag)
+{
+    if (!tag)
+        return "";
+    for (auto *frame : tag->frameList("SYLT"))
+    {
+        auto *sylt = dynamic_cast<TagLib::ID3v2::SynchronizedLyricsFrame *>(frame);
+        if (!sylt || sylt->timestampFormat() != TagLib::ID3v2::SynchronizedLyricsFrame::AbsoluteMilliseconds)
+            continue;
+
+        std::string lrc;
+        for (const auto &entry : sylt->synchedText())
+        {
+            char stamp[32];
+            std::snprintf(stamp, sizeof(stamp), "[%02u:%02u.%03u]", entry.time / 60000, entry.time / 1000 % 60, entry.time % 1000);
+            lrc += stamp;
+            lrc += entry.text.to8Bit(true);
+            lrc += '\n';
+        }
+        if (!lrc.empty())
+            return EncodingUtils::sanitizeUTF8(lrc);
+    }
+    return "";
+}
+
 // 标签解析逻辑
 static std::string resolveSafeTag(TagLib::Tag *tag, const std::string &type)
 {
@@ -599,12 +626,22 @@ static void processTrackCover(const std::string &musicPath, const std::string &a
 namespace AudioInfoUtils
 {
 
+// 容器内的章节 (M4B / MKA / FLAC CUESHEET 块等)，时间单位为微秒
+struct ChapterInfo
+{
+    std::string title;
+    int64_t startTime = 0;
+    int64_t duration = 0; // 0 表示未知 (到下一章或文件末尾)
+};
+
 struct AudioTechInfo
 {
     int64_t duration = 0;
     uint32_t sampleRate = 0;
     uint16_t bitDepth = 0;
     std::string formatType;
+    std::vector<ChapterInfo> chapters;
+    std::string cueSheet; // 内嵌的 CUE 文本 (Vorbis / APE 标签 CUESHEET)
 };
 
 static AudioTechInfo getAudioTechInfo(const std::string &filePath)
@@ -646,6 +683,21 @@ static AudioTechInfo getAudioTechInfo(const std::string &filePath)
             }
         }
     }
+
+    // 探测时已经读出的章节与内嵌 CUE 顺便带回，避免为分轨再打开一次文件
+    for (unsigned int i = 0; i < ctx->nb_chapters; ++i)
+    {
+        const AVChapter *ch = ctx->chapters[i];
+        ChapterInfo chapter;
+        chapter.startTime = av_rescale_q(ch->start, ch->time_base, AV_TIME_BASE_Q);
+        if (ch->end != AV_NOPTS_VALUE && ch->end > ch->start)
+            chapter.duration = av_rescale_q(ch->end, ch->time_base, AV_TIME_BASE_Q) - chapter.startTime;
+        if (const AVDictionaryEntry *title = av_dict_get(ch->metadata, "title", nullptr, 0))
+            chapter.title = EncodingUtils::sanitizeUTF8(title->value);
+        info.chapters.push_back(std::move(chapter));
+    }
+    if (const AVDictionaryEntry *cue = av_dict_get(ctx->metadata, "cuesheet", nullptr, 0))
+        info.cueSheet = EncodingUtils::sanitizeUTF8(cue->value);
     return info;
 }
 
@@ -687,23 +739,10 @@ static std::string cleanString(const std::string &str)
     return str.substr(first, (last - first + 1));
 }
 
-static std::vector<CueTrackInfo> parseCueFile(const fs::path &cuePath)
+// 解析已转为 UTF-8 的 CUE 文本 (独立 .cue 文件或内嵌的 CUESHEET 标签)
+static std::vector<CueTrackInfo> parseCueText(const std::string &utf8Content)
 {
     std::vector<CueTrackInfo> tracks;
-    std::ifstream file(cuePath, std::ios::binary | std::ios::ate);
-    if (!file.is_open())
-        return tracks;
-
-    auto fileSize = file.tellg();
-    if (fileSize <= 0)
-        return tracks;
-    std::string rawBuffer(fileSize, '\0');
-    file.seekg(0, std::ios::beg);
-    if (!file.read(&rawBuffer[0], fileSize))
-        return tracks;
-
-    std::string utf8Content = EncodingUtils::detectAndConvert(rawBuffer);
-
     size_t bomOffset = 0;
     if (utf8Content.size() >= 3 && (uint8_t)utf8Content[0] == 0xEF && (uint8_t)utf8Content[1] == 0xBB && (uint8_t)utf8Content[2] == 0xBF)
         bomOffset = 3;
@@ -792,6 +831,23 @@ static std::vector<CueTrackInfo> parseCueFile(const fs::path &cuePath)
     return tracks;
 }
 
+static std::vector<CueTrackInfo> parseCueFile(const fs::path &cuePath)
+{
+    std::ifstream file(cuePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return {};
+
+    auto fileSize = file.tellg();
+    if (fileSize <= 0)
+        return {};
+    std::string rawBuffer(fileSize, '\0');
+    file.seekg(0, std::ios::beg);
+    if (!file.read(&rawBuffer[0], fileSize))
+        return {};
+
+    return parseCueText(EncodingUtils::detectAndConvert(rawBuffer));
+}
+
 static std::string findRealAudioFile(const fs::path &dirPath, const std::string &cueFileName)
 {
     fs::path target = dirPath / cueFileName;
@@ -819,27 +875,132 @@ static std::string findRealAudioFile(const fs::path &dirPath, const std::string
 
 static std::shared_ptr<PlaylistNode> buildNodeFromDir(const fs::path &dirPath, std::stop_token stoken);
 
-static std::shared_ptr<PlaylistNode> processSingleFile(const std::string &filePath)
+// techOut 不为空时带回完整的技术参数 (章节 / 内嵌 CUE)
+static MetaData readMetaData(const std::string &musicPath, AudioInfoUtils::AudioTechInfo *techOut)
 {
+    fs::path p(musicPath);
+    MetaData musicData;
+    if (!fs::exists(p))
+        return musicData;
+
+    TagLib::FileRef f(p.c_str());
+    if (!f.isNull() && f.tag())
+    {
+        auto tag = f.tag();
+        musicData.setTitle(TagLibHelpers::resolveSafeTag(tag, "Title"));
+        musicData.setArtist(TagLibHelpers::resolveSafeTag(tag, "Artist"));
+        musicData.setAlbum(TagLibHelpers::resolveSafeTag(tag, "Album"));
+        if (tag->year() > 0)
+            musicData.setYear(std::to_string(tag->year()));
+
+        // 歌词不在扫描时读取 (曲目很多时会成倍增加 I/O 与内存)，切换到该曲目时由 extractLyrics 按需加载
+    }
+    if (musicData.getTitle().empty())
+    {
+        std::string filename = p.stem().string();
+        musicData.setTitle(EncodingUtils::detectAndConvert(filename));
+    }
+
+    musicData.setFilePath(p.string());
+    musicData.setParentDir(p.parent_path().string());
+
+    auto tech = AudioInfoUtils::getAudioTechInfo(p.string());
+    musicData.setDuration(tech.duration);
+    musicData.setSampleRate(tech.sampleRate);
+    musicData.setBitDepth(tech.bitDepth);
+    musicData.setFormatType(tech.formatType);
+
+    std::error_code ec;
+    auto lwt = fs::last_write_time(p, ec);
+    if (!ec)
+        musicData.setLastWriteTime(lwt);
+
+    // 之前已分析过的响度结果 (文件未修改时有效)
+    LoudnessInfo loudness;
+    if (LoudnessAnalyzer::instance().lookup(p.string(), loudness))
+        musicData.setLoudness(loudness);
+
+    if (techOut)
+        *techOut = std::move(tech);
+    return musicData;
+}
+
+// 单个音频文件 -> 节点
+// 内嵌 CUE 或容器章节 (有声书 / DJ 混音等单个大文件) 展开为与 CUE 分轨相同的虚拟分轨：
+// 共享同一路径，以 offset / duration 区分，播放时在同一解码会话内定位切换
+static std::vector<std::shared_ptr<PlaylistNode>> processFileAndGetNodes(const std::string &filePath)
+{
+    std::vector<std::shared_ptr<PlaylistNode>> resultNodes;
     try
     {
-        auto fileNode = std::make_shared<PlaylistNode>(filePath, false);
-        MetaData md = FileScanner::getMetaData(filePath);
+        AudioInfoUtils::AudioTechInfo tech;
+        MetaData md = readMetaData(filePath, &tech);
 
         std::string albumName = md.getAlbum();
         std::string titleName = md.getTitle();
         std::string albumKey = albumName.empty() ? titleName : albumName;
 
-        fileNode->setCoverKey(albumKey);
-        fileNode->setMetaData(md);
+        // 内嵌 CUE 带曲名与艺术家，优先于章节 (FLAC 的 CUESHEET 块转成的章节没有标题)
+        std::vector<CueUtils::CueTrackInfo> tracks;
+        if (!tech.cueSheet.empty())
+            tracks = CueUtils::parseCueText(tech.cueSheet);
+        if (tracks.size() < 2)
+        {
+            tracks.clear();
+            for (size_t i = 0; i < tech.chapters.size(); ++i)
+            {
+                CueUtils::CueTrackInfo track;
+                track.trackNum = static_cast<int>(i) + 1;
+                track.title = tech.chapters[i].title;
+                track.startTime = tech.chapters[i].startTime;
+                track.duration = tech.chapters[i].duration;
+                tracks.push_back(std::move(track));
+            }
+        }
+        std::ranges::stable_sort(tracks, {}, &CueUtils::CueTrackInfo::startTime);
+
+        if (tracks.size() >= 2)
+        {
+            const int64_t fileDuration = md.getDuration();
+            for (size_t i = 0; i < tracks.size(); ++i)
+            {
+                const auto &track = tracks[i];
+                // 分轨必须首尾相接，否则边界切换会跳过或重复一段
+                int64_t end = i + 1 < tracks.size() ? tracks[i + 1].startTime : fileDuration;
+                if (end <= track.startTime && track.duration > 0)
+                    end = track.startTime + track.duration;
+                if (end <= track.startTime)
+                    continue;
+
+                MetaData trackMd = md;
+                trackMd.setTitle(track.title.empty() ? std::format("{} ({:02})", titleName, track.trackNum) : track.title);
+                if (!track.performer.empty())
+                    trackMd.setArtist(track.performer);
+                if (trackMd.getAlbum().empty())
+                    trackMd.setAlbum(titleName);
+                trackMd.setOffset(track.startTime);
+                trackMd.setDuration(end - track.startTime);
+
+                auto trackNode = std::make_shared<PlaylistNode>(filePath, false);
+                trackNode->setCoverKey(albumKey);
+                trackNode->setMetaData(trackMd);
+                resultNodes.push_back(trackNode);
+            }
+        }
+        if (resultNodes.empty())
+        {
+            auto fileNode = std::make_shared<PlaylistNode>(filePath, false);
+            fileNode->setCoverKey(albumKey);
+            fileNode->setMetaData(md);
+            resultNodes.push_back(fileNode);
+        }
 
         ImageHelpers::processTrackCover(filePath, albumKey);
-        return fileNode;
     }
     catch (...)
     {
-        return nullptr;
     }
+    return resultNodes;
 }
 
 static std::vector<std::shared_ptr<PlaylistNode>> processCueAndGetNodes(const fs::path &cuePath)
@@ -849,6 +1010,8 @@ static std::vector<std::shared_ptr<PlaylistNode>> processCueAndGetNodes(const fs
     {
         fs::path dirPath = cuePath.parent_path();
         auto tracks = CueUtils::parseCueFile(cuePath);
+        // 同一文件的各分轨只读取一次标签与技术参数
+        std::unordered_map<std::string, MetaData> fileMetaData;
 
         for (auto &track : tracks)
         {
@@ -856,7 +1019,10 @@ static std::vector<std::shared_ptr<PlaylistNode>> processCueAndGetNodes(const fs
             if (!realAudioPath.empty() && isffmpeg(realAudioPath))
             {
                 auto trackNode = std::make_shared<PlaylistNode>(realAudioPath, false);
-                MetaData md = FileScanner::getMetaData(realAudioPath);
+                auto cached = fileMetaData.find(realAudioPath);
+                if (cached == fileMetaData.end())
+                    cached = fileMetaData.emplace(realAudioPath, readMetaData(realAudioPath, nullptr)).first;
+                MetaData md = cached->second;
 
                 if (!track.title.empty())
                     md.setTitle(track.title);
@@ -1018,7 +1184,7 @@ static std::shared_ptr<PlaylistNode> buildNodeFromDir(const fs::path &dirPath, s
     auto node = std::make_shared<PlaylistNode>(preferred.string(), true);
     node->setCoverKey(folderName);
 
-    std::vector<std::future<std::shared_ptr<PlaylistNode>>> fileFutures;
+    std::vector<std::pair<std::string, std::future<std::vector<std::shared_ptr<PlaylistNode>>>>> fileFutures;
     std::vector<fs::path> subDirs;
     std::set<std::string> processedFiles;
 
@@ -1045,7 +1211,7 @@ static std::shared_ptr<PlaylistNode> buildNodeFromDir(const fs::path &dirPath, s
                 {
                     if (!processedFiles.contains(pathStr))
                     {
-                        fileFutures.push_back(SimpleThreadPool::instance().enqueue(processSingleFile, pathStr));
+                        fileFutures.emplace_back(pathStr, SimpleThreadPool::instance().enqueue(processFileAndGetNodes, pathStr));
                     }
                 }
             }
@@ -1064,9 +1230,13 @@ static std::shared_ptr<PlaylistNode> buildNodeFromDir(const fs::path &dirPath, s
         if (auto child = buildNodeFromDir(sd, stoken))
             node->addChild(child);
     }
-    for (auto &fut : fileFutures)
+    for (auto &[pathStr, fut] : fileFutures)
     {
-        if (auto child = fut.get())
+        auto children = fut.get();
+        // 目录遍历顺序不定，音频文件可能先于引用它的 .cue 被提交；独立 .cue 优先
+        if (processedFiles.contains(pathStr))
+            continue;
+        for (auto &child : children)
             node->addChild(child);
     }
 
@@ -1185,12 +1355,27 @@ void FileScanner::scanDir(std::stop_token stoken)
 
     if (fs::is_regular_file(rootPath))
     {
-        rootNode = processSingleFile(rootPath.string());
-        if (rootNode)
+        auto nodes = processFileAndGetNodes(rootPath.string());
+        if (nodes.size() == 1)
         {
+            rootNode = nodes.front();
             rootNode->setTotalSongs(1);
             rootNode->setTotalDuration(rootNode->getMetaData().getDuration() / 1000000);
         }
+        else if (!nodes.empty())
+        {
+            // 带章节的单个文件：以文件为根，章节作为其下的虚拟分轨
+            rootNode = std::make_shared<PlaylistNode>(rootPath.string(), true);
+            rootNode->setCoverKey(nodes.front()->getThisDirCover());
+            uint64_t tDuration = 0;
+            for (auto &n : nodes)
+            {
+                tDuration += n->getMetaData().getDuration() / 1000000;
+                rootNode->addChild(n);
+            }
+            rootNode->setTotalSongs(nodes.size());
+            rootNode->setTotalDuration(tDuration);
+        }
     }
     else
     {
@@ -1206,44 +1391,49 @@ void FileScanner::scanDir(std::stop_token stoken)
 
 MetaData FileScanner::getMetaData(const std::string &musicPath)
 {
-    fs::path p(musicPath);
-    MetaData musicData;
-    if (!fs::exists(p))
-        return musicData;
-
-    TagLib::FileRef f(p.c_str());
-    if (!f.isNull() && f.tag())
-    {
-        auto tag = f.tag();
-        musicData.setTitle(TagLibHelpers::resolveSafeTag(tag, "Title"));
-        musicData.setArtist(TagLibHelpers::resolveSafeTag(tag, "Artist"));
-        musicData.setAlbum(TagLibHelpers::resolveSafeTag(tag, "Album"));
-        if (tag->year() > 0)
-            musicData.setYear(std::to_string(tag->year()));
+    return readMetaData(musicPath, nullptr);
+}
 
-        // musicData.setLyrics(TagLibHelpers::extractLyrics(tag, f));
-    }
-    if (musicData.getTitle().empty())
-    {
-        std::string filename = p.stem().string();
-        musicData.setTitle(EncodingUtils::detectAndConvert(filename));
-    }
+std::string FileScanner::extractLyrics(const std::string &musicPath)
+{
+    fs::path p(musicPath);
+    TagLib::FileRef f(p.c_str(), false);
+    if (f.isNull() || !f.tag())
+        return "";
 
-    musicData.setFilePath(p.string());
-    musicData.setParentDir(p.parent_path().string());
+    // 通过 FileRef 拿到的是合并后的标签，SYLT / USLT 需要直接访问 ID3v2 标签
+    TagLib::ID3v2::Tag *id3v2 = nullptr;
+    if (auto *mpeg = dynamic_cast<TagLib::MPEG::File *>(f.file()))
+        id3v2 = mpeg->ID3v2Tag();
+    else if (auto *wav = dynamic_cast<TagLib::RIFF::WAV::File *>(f.file()))
+        id3v2 = wav->ID3v2Tag();
+    else if (auto *aiff = dynamic_cast<TagLib::RIFF::AIFF::File *>(f.file()))
+        id3v2 = aiff->tag();
+
+    std::string synced = TagLibHelpers::extractSyncedLyrics(id3v2);
+    if (!synced.empty())
+        return synced;
+    return TagLibHelpers::extractLyrics(id3v2 ? id3v2 : f.tag(), f);
+}
 
-    auto tech = AudioInfoUtils::getAudioTechInfo(p.string());
-    musicData.setDuration(tech.duration);
-    musicData.setSampleRate(tech.sampleRate);
-    musicData.setBitDepth(tech.bitDepth);
-    musicData.setFormatType(tech.formatType);
+std::string FileScanner::readLyricsFile(const std::string &lrcPath)
+{
+    constexpr std::streamoff MAX_LYRICS_BYTES = 1 << 20;
+    std::ifstream file(fs::path(lrcPath), std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return "";
+    const std::streamoff size = file.tellg();
+    if (size <= 0 || size > MAX_LYRICS_BYTES)
+        return "";
 
-    std::error_code ec;
-    auto lwt = fs::last_write_time(p, ec);
-    if (!ec)
-        musicData.setLastWriteTime(lwt);
+    std::string raw(static_cast<size_t>(size), '\0');
+    file.seekg(0);
+    file.read(raw.data(), size);
 
-    return musicData;
+    // 带 BOM 的 UTF-8 不再探测编码
+    if (raw.starts_with("\xEF\xBB\xBF"))
+        return EncodingUtils::sanitizeUTF8(raw.substr(3));
+    return EncodingUtils::detectAndConvert(raw);
 }
 
 std::string FileScanner::extractCoverToTempFile(MetaData &metadata)
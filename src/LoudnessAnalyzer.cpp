@@ -0,0 +1,663 @@
+#include "LoudnessAnalyzer.hpp"
+#include "AudioKernels.hpp"
+#include "ChunkDecoder.hpp"
+#include "ThreadPriority.hpp"
+
+namespace
+{
+// BS.1770 / EBU Tech 3341, 3342 的测量参数
+constexpr int HOPS_PER_SECOND = 10; // 100 ms 一个分段
+constexpr int MOMENTARY_HOPS = 4;   // 400 ms 块，75% 重叠
+constexpr int SHORT_TERM_HOPS = 30; // 3 s 窗口
+constexpr double ABSOLUTE_GATE_LUFS = -70.0;
+constexpr double RELATIVE_GATE_LU = -10.0;
+constexpr double LRA_RELATIVE_GATE_LU = -20.0;
+constexpr double LRA_LOW_PERCENTILE = 0.10;
+constexpr double LRA_HIGH_PERCENTILE = 0.95;
+
+// 真峰值：4 倍过采样，48 阶 FIR (每相位 12 阶)
+constexpr int TRUE_PEAK_PHASES = 4;
+constexpr int TRUE_PEAK_TAPS = 12;
+
+// 每个并行块 (流水线模式下的每批数据包) 前多解码一段让解码器与 K 加权滤波器进入稳态 (这段不计入结果)
+constexpr double CHUNK_PREROLL_SECONDS = 0.5;
+// 单个并行块的最短时长，避免短文件被切得过碎 (每块都要重新打开文件并 seek)
+constexpr int64_t MIN_CHUNK_SECONDS = 30;
+
+constexpr uint32_t STORE_MAGIC = 0x3142444C; // "LDB1"
+constexpr double PI = 3.14159265358979323846;
+
+// 双二阶滤波器 (转置直接 II 型，双精度状态)
+struct Biquad
+{
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    double z1 = 0.0, z2 = 0.0;
+
+    double process(double x)
+    {
+        double y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+};
+
+// K 加权：高搁架 (头部声学效应) + 高通 (RLB)，按任意采样率由模拟原型双线性变换得到
+struct KWeighting
+{
+    Biquad shelf;
+    Biquad highpass;
+
+    explicit KWeighting(double sampleRate)
+    {
+        {
+            const double f0 = 1681.974450955533;
+            const double gainDb = 3.999843853973347;
+            const double q = 0.7071752369554196;
+            const double k = std::tan(PI * f0 / sampleRate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+            shelf.b0 = (vh + vb * k / q + k * k) / a0;
+            shelf.b1 = 2.0 * (k * k - vh) / a0;
+            shelf.b2 = (vh - vb * k / q + k * k) / a0;
+            shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+            shelf.a2 = (1.0 - k / q + k * k) / a0;
+        }
+        {
+            const double f0 = 38.13547087602444;
+            const double q = 0.5003270373238773;
+            const double k = std::tan(PI * f0 / sampleRate);
+            const double a0 = 1.0 + k / q + k * k;
+            highpass.b0 = 1.0;
+            highpass.b1 = -2.0;
+            highpass.b2 = 1.0;
+            highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+            highpass.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    void process(const float *in, float *out, int samples)
+    {
+        for (int i = 0; i < samples; ++i)
+        {
+            out[i] = static_cast<float>(highpass.process(shelf.process(in[i])));
+        }
+    }
+};
+
+// 真峰值插值滤波器：Blackman 窗 sinc，按相位重排，每个相位归一化为单位直流增益
+const float *truePeakTaps()
+{
+    static const auto taps = []
+    {
+        std::array<float, TRUE_PEAK_PHASES * TRUE_PEAK_TAPS> result{};
+        const int length = TRUE_PEAK_PHASES * TRUE_PEAK_TAPS;
+        const int center = length / 2;
+        for (int p = 0; p < TRUE_PEAK_PHASES; ++p)
+        {
+            double sum = 0.0;
+            std::array<double, TRUE_PEAK_TAPS> phase{};
+            for (int k = 0; k < TRUE_PEAK_TAPS; ++k)
+            {
+                // 多相分解：y[nL + p] = Σ h[p + kL] · x[n - k] (固定延迟 center / L 个样本不影响峰值)
+                const int n = p + k * TRUE_PEAK_PHASES;
+                const double t = static_cast<double>(center - n) / TRUE_PEAK_PHASES;
+                const double sinc = (t == 0.0) ? 1.0 : std::sin(PI * t) / (PI * t);
+                const double w = static_cast<double>(n) / (length - 1);
+                const double window = 0.42 - 0.5 * std::cos(2.0 * PI * w) + 0.08 * std::cos(4.0 * PI * w);
+                phase[k] = sinc * window;
+                sum += phase[k];
+            }
+            for (int k = 0; k < TRUE_PEAK_TAPS; ++k)
+            {
+                result[p * TRUE_PEAK_TAPS + k] = static_cast<float>(phase[k] / sum);
+            }
+        }
+        return result;
+    }();
+    return taps.data();
+}
+
+// BS.1770 通道权重：LFE 不计入，环绕声道 +1.5 dB
+double channelWeight(const AVChannelLayout &layout, int index)
+{
+    switch (av_channel_layout_channel_from_index(&layout, index))
+    {
+    case AV_CHAN_LOW_FREQUENCY:
+    case AV_CHAN_LOW_FREQUENCY_2:
+        return 0.0;
+    case AV_CHAN_SIDE_LEFT:
+    case AV_CHAN_SIDE_RIGHT:
+    case AV_CHAN_BACK_LEFT:
+    case AV_CHAN_BACK_RIGHT:
+        return 1.41;
+    default:
+        return 1.0;
+    }
+}
+
+double energyToLufs(double meanSquare)
+{
+    return meanSquare > 0.0 ? -0.691 + 10.0 * std::log10(meanSquare) : -HUGE_VAL;
+}
+
+double lufsToEnergy(double lufs)
+{
+    return std::pow(10.0, (lufs + 0.691) / 10.0);
+}
+
+// 两级门限的综合响度 (绝对 -70 LUFS，相对 -10 LU)
+double gatedLoudness(const std::vector<double> &blocks)
+{
+    const double absoluteGate = lufsToEnergy(ABSOLUTE_GATE_LUFS);
+    double sum = 0.0;
+    size_t count = 0;
+    for (double z : blocks)
+    {
+        if (z > absoluteGate)
+        {
+            sum += z;
+            ++count;
+        }
+    }
+    if (count == 0)
+        return -HUGE_VAL;
+
+    const double relativeGate = std::max(absoluteGate, sum / count * std::pow(10.0, RELATIVE_GATE_LU / 10.0));
+    sum = 0.0;
+    count = 0;
+    for (double z : blocks)
+    {
+        if (z > relativeGate)
+        {
+            sum += z;
+            ++count;
+        }
+    }
+    return count > 0 ? energyToLufs(sum / count) : -HUGE_VAL;
+}
+
+// 响度范围：门限后短时响度分布的 10% ~ 95% 分位差
+double loudnessRange(const std::vector<double> &shortTerm)
+{
+    const double absoluteGate = lufsToEnergy(ABSOLUTE_GATE_LUFS);
+    double sum = 0.0;
+    size_t count = 0;
+    for (double z : shortTerm)
+    {
+        if (z > absoluteGate)
+        {
+            sum += z;
+            ++count;
+        }
+    }
+    if (count == 0)
+        return 0.0;
+
+    const double relativeGate = std::max(absoluteGate, sum / count * std::pow(10.0, LRA_RELATIVE_GATE_LU / 10.0));
+    std::vector<double> levels;
+    levels.reserve(count);
+    for (double z : shortTerm)
+    {
+        if (z > relativeGate)
+            levels.push_back(energyToLufs(z));
+    }
+    if (levels.empty())
+        return 0.0;
+
+    std::sort(levels.begin(), levels.end());
+    const size_t last = levels.size() - 1;
+    const double low = levels[static_cast<size_t>(std::lround(last * LRA_LOW_PERCENTILE))];
+    const double high = levels[static_cast<size_t>(std::lround(last * LRA_HIGH_PERCENTILE))];
+    return high - low;
+}
+
+// 单个并行块的测量结果：各 100 ms 分段的能量 (K 加权平方和 × 通道权重，未归一化) 与真峰值
+struct ChunkMeasurement
+{
+    int64_t firstHop = -1;
+    std::vector<double> hops;
+    float truePeak = 0.0f;
+};
+
+// 逐帧累计 K 加权能量与真峰值，滤波器状态跨帧连续
+class ChunkMeter
+{
+public:
+    ChunkMeter(const AVChannelLayout &layout, int sampleRate) :
+        m_sampleRate(sampleRate)
+    {
+        const int channels = layout.nb_channels;
+        for (int c = 0; c < channels; ++c)
+        {
+            m_weights.push_back(channelWeight(layout, c));
+            m_filters.emplace_back(sampleRate);
+            m_history.emplace_back(TRUE_PEAK_TAPS - 1, 0.0f);
+        }
+    }
+
+    // planes: 平面 float 样本；只有 [accumulateFrom, accumulateUntil) 内的样本计入结果，其余只用于推进滤波器状态
+    void push(const float *const *planes, int samples, int64_t firstSample, int64_t accumulateFrom, int64_t accumulateUntil)
+    {
+        const int from = static_cast<int>(std::clamp<int64_t>(accumulateFrom - firstSample, 0, samples));
+        const int to = static_cast<int>(std::clamp<int64_t>(accumulateUntil - firstSample, 0, samples));
+        if (m_filtered.size() < static_cast<size_t>(samples))
+        {
+            m_filtered.resize(samples);
+        }
+
+        for (size_t c = 0; c < m_filters.size(); ++c)
+        {
+            m_filters[c].process(planes[c], m_filtered.data(), samples);
+
+            // 真峰值需要前 TRUE_PEAK_TAPS - 1 个样本作为历史
+            std::vector<float> &history = m_history[c];
+            history.resize(TRUE_PEAK_TAPS - 1 + samples);
+            std::memcpy(history.data() + TRUE_PEAK_TAPS - 1, planes[c], sizeof(float) * samples);
+            if (to > from)
+            {
+                const float peak = AudioKernels::interpolatedPeak(history.data() + TRUE_PEAK_TAPS - 1 + from, to - from,
+                                                                  truePeakTaps(), TRUE_PEAK_PHASES, TRUE_PEAK_TAPS);
+                m_result.truePeak = std::max(m_result.truePeak, peak);
+            }
+            std::memmove(history.data(), history.data() + samples, sizeof(float) * (TRUE_PEAK_TAPS - 1));
+            history.resize(TRUE_PEAK_TAPS - 1);
+
+            if (m_weights[c] > 0.0)
+            {
+                accumulate(m_filtered.data(), from, to, firstSample, m_weights[c]);
+            }
+        }
+    }
+
+    ChunkMeasurement take()
+    {
+        return std::move(m_result);
+    }
+
+private:
+    void accumulate(const float *filtered, int from, int to, int64_t firstSample, double weight)
+    {
+        int i = from;
+        while (i < to)
+        {
+            const int64_t sample = firstSample + i;
+            const int64_t hop = sample * HOPS_PER_SECOND / m_sampleRate;
+            const int64_t hopEnd = ((hop + 1) * m_sampleRate + HOPS_PER_SECOND - 1) / HOPS_PER_SECOND;
+            const int count = static_cast<int>(std::min<int64_t>(to, hopEnd - firstSample) - i);
+
+            if (m_result.firstHop < 0)
+            {
+                m_result.firstHop = hop;
+            }
+            if (hop >= m_result.firstHop)
+            {
+                const size_t index = static_cast<size_t>(hop - m_result.firstHop);
+                if (index >= m_result.hops.size())
+                {
+                    m_result.hops.resize(index + 1, 0.0);
+                }
+                m_result.hops[index] += weight * AudioKernels::sumOfSquares(filtered + i, count).sumSquares;
+            }
+            i += count;
+        }
+    }
+
+    int64_t m_sampleRate;
+    std::vector<double> m_weights;
+    std::vector<KWeighting> m_filters;
+    std::vector<std::vector<float>> m_history;
+    std::vector<float> m_filtered;
+    ChunkMeasurement m_result;
+};
+
+// 解码帧转换为平面 float (采样率与布局不变，swr 不引入延迟)
+class PlanarConverter
+{
+public:
+    ~PlanarConverter()
+    {
+        swr_free(&m_swr);
+    }
+
+    bool init(const AVCodecContext *ctx)
+    {
+        return swr_alloc_set_opts2(&m_swr, &ctx->ch_layout, AV_SAMPLE_FMT_FLTP, ctx->sample_rate,
+                                   &ctx->ch_layout, ctx->sample_fmt, ctx->sample_rate, 0, nullptr) >= 0 &&
+               swr_init(m_swr) >= 0;
+    }
+
+    // 返回转换后的样本数，平面指针写入 planes
+    int convert(const AVFrame *frame, int channels, std::vector<const float *> &planes)
+    {
+        m_buffer.resize(static_cast<size_t>(frame->nb_samples) * channels);
+        m_out.resize(channels);
+        planes.resize(channels);
+        for (int c = 0; c < channels; ++c)
+        {
+            float *plane = m_buffer.data() + static_cast<size_t>(c) * frame->nb_samples;
+            m_out[c] = reinterpret_cast<uint8_t *>(plane);
+            planes[c] = plane;
+        }
+        return swr_convert(m_swr, m_out.data(), frame->nb_samples, const_cast<const uint8_t **>(frame->extended_data), frame->nb_samples);
+    }
+
+private:
+    SwrContext *m_swr = nullptr;
+    std::vector<float> m_buffer;
+    std::vector<uint8_t *> m_out;
+};
+
+// 分块解码的接收者：解码帧转为平面 float 后逐帧测量
+class LoudnessSink : public ChunkDecoder::FrameSink
+{
+public:
+    bool open(const AVCodecContext *ctx) override
+    {
+        // 分析在专用线程池中进行，工作线程保持空闲优先级
+        ThreadPriority::lowerToIdle();
+        if (!m_converter.init(ctx))
+            return false;
+        m_channels = ctx->ch_layout.nb_channels;
+        m_meter = std::make_unique<ChunkMeter>(ctx->ch_layout, ctx->sample_rate);
+        return true;
+    }
+
+    void push(const AVFrame *frame, int64_t firstSample, int begin, int end) override
+    {
+        int samples = m_converter.convert(frame, m_channels, m_planes);
+        if (samples > 0)
+        {
+            m_meter->push(m_planes.data(), samples, firstSample, firstSample + begin, firstSample + end);
+        }
+    }
+
+    ChunkMeasurement take()
+    {
+        return m_meter->take();
+    }
+
+private:
+    PlanarConverter m_converter;
+    std::unique_ptr<ChunkMeter> m_meter;
+    std::vector<const float *> m_planes;
+    int m_channels = 0;
+};
+} // namespace
+
+LoudnessAnalyzer::LoudnessAnalyzer() :
+    m_pool(std::max<size_t>(std::thread::hardware_concurrency() / 2, 1))
+{
+    m_storePath = fs::path(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation).toStdString()) / "loudness.db";
+    loadStore();
+}
+
+LoudnessAnalyzer::~LoudnessAnalyzer()
+{
+    stop();
+}
+
+void LoudnessAnalyzer::analyzeLibrary(std::vector<std::vector<std::string>> albums)
+{
+    stop();
+    m_cancelled.store(false);
+    m_worker = std::thread(&LoudnessAnalyzer::workerLoop, this, std::move(albums));
+}
+
+void LoudnessAnalyzer::stop()
+{
+    m_cancelled.store(true);
+    if (m_worker.joinable())
+    {
+        m_worker.join();
+    }
+}
+
+bool LoudnessAnalyzer::lookup(const std::string &path, LoudnessInfo &info)
+{
+    const int64_t mtime = fileMtime(path);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_results.find(path);
+    if (it == m_results.end() || it->second.mtime != mtime || !it->second.info.valid)
+        return false;
+    info = it->second.info;
+    return true;
+}
+
+float LoudnessAnalyzer::gainFor(const LoudnessInfo &info, NormalizationMode mode)
+{
+    if (!info.valid || mode == NormalizationMode::Off)
+        return 1.0f;
+
+    const bool album = (mode == NormalizationMode::Album);
+    const float lufs = album ? info.albumIntegratedLufs : info.integratedLufs;
+    const float peak = album ? info.albumTruePeak : info.truePeak;
+    float gain = std::pow(10.0f, (REFERENCE_LUFS - lufs) / 20.0f);
+    // 提升增益时不让真峰值超过 0 dBTP
+    if (peak > 0.0f)
+    {
+        gain = std::min(gain, 1.0f / peak);
+    }
+    return gain;
+}
+
+void LoudnessAnalyzer::workerLoop(std::vector<std::vector<std::string>> albums)
+{
+    ThreadPriority::lowerToIdle();
+
+    size_t analyzed = 0;
+    for (const auto &album : albums)
+    {
+        if (m_cancelled.load())
+            break;
+        if (album.empty() || isUpToDate(album))
+            continue;
+
+        std::vector<std::pair<std::string, Entry>> entries;
+        std::vector<Measurement> measurements;
+        for (const auto &path : album)
+        {
+            if (m_cancelled.load())
+                break;
+            Measurement m;
+            Entry entry;
+            entry.mtime = fileMtime(path);
+            if (analyzeFile(path, m))
+            {
+                const double integrated = gatedLoudness(m.momentary);
+                entry.info.valid = std::isfinite(integrated);
+                entry.info.integratedLufs = static_cast<float>(integrated);
+                entry.info.loudnessRange = static_cast<float>(loudnessRange(m.shortTerm));
+                entry.info.truePeak = m.truePeak;
+                measurements.push_back(std::move(m));
+            }
+            // 分析失败也登记 (valid = false)，避免每次启动都重试
+            entries.emplace_back(path, entry);
+        }
+        // 中断的文件夹整个作废，下次启动时重新分析
+        if (m_cancelled.load())
+            break;
+
+        // 专辑结果：所有曲目的分块合并后重新做门限
+        Measurement albumTotal;
+        for (const auto &m : measurements)
+        {
+            albumTotal.momentary.insert(albumTotal.momentary.end(), m.momentary.begin(), m.momentary.end());
+            albumTotal.shortTerm.insert(albumTotal.shortTerm.end(), m.shortTerm.begin(), m.shortTerm.end());
+            albumTotal.truePeak = std::max(albumTotal.truePeak, m.truePeak);
+        }
+        const double albumIntegrated = gatedLoudness(albumTotal.momentary);
+        const float albumRange = static_cast<float>(loudnessRange(albumTotal.shortTerm));
+        for (auto &[path, entry] : entries)
+        {
+            if (!entry.info.valid)
+                continue;
+            const bool albumValid = std::isfinite(albumIntegrated);
+            entry.info.albumIntegratedLufs = albumValid ? static_cast<float>(albumIntegrated) : entry.info.integratedLufs;
+            entry.info.albumLoudnessRange = albumValid ? albumRange : entry.info.loudnessRange;
+            entry.info.albumTruePeak = albumValid ? albumTotal.truePeak : entry.info.truePeak;
+        }
+
+        appendStore(entries);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto &[path, entry] : entries)
+            {
+                m_results[path] = entry;
+            }
+        }
+        analyzed += entries.size();
+        spdlog::debug("[Loudness] Album {} done: {:.1f} LUFS", fs::path(album.front()).parent_path().string(), albumIntegrated);
+    }
+
+    spdlog::info("[Loudness] Library pass {} ({} files analyzed)", m_cancelled.load() ? "interrupted" : "finished", analyzed);
+}
+
+bool LoudnessAnalyzer::isUpToDate(const std::vector<std::string> &album)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto &path : album)
+    {
+        auto it = m_results.find(path);
+        if (it == m_results.end() || it->second.mtime != fileMtime(path))
+            return false;
+    }
+    return true;
+}
+
+bool LoudnessAnalyzer::analyzeFile(const std::string &path, Measurement &out)
+{
+    ChunkDecoder decoder;
+    if (!decoder.open(path) || decoder.durationUs() <= 0)
+        return false;
+
+    const int sampleRate = decoder.sampleRate();
+    const int64_t totalSamples = av_rescale(decoder.durationUs(), sampleRate, 1000000);
+    const int64_t maxChunks = std::max<int64_t>(totalSamples / (MIN_CHUNK_SECONDS * sampleRate), 1);
+    const int chunkCount = static_cast<int>(std::min<int64_t>(std::max<unsigned>(std::thread::hardware_concurrency() / 2, 1), maxChunks));
+    const int64_t preroll = static_cast<int64_t>(CHUNK_PREROLL_SECONDS * sampleRate);
+
+    // 读到文件末尾 (时长可能是估算值)
+    auto sinks = decoder.decode(m_pool, 0, std::numeric_limits<int64_t>::max(), chunkCount, preroll,
+                                [] { return std::make_unique<LoudnessSink>(); }, &m_cancelled);
+
+    // 合并各块的分段能量 (块边界落在同一分段内时直接相加)
+    std::vector<double> hops;
+    float truePeak = 0.0f;
+    for (auto &sink : sinks)
+    {
+        ChunkMeasurement chunk = static_cast<LoudnessSink &>(*sink).take();
+        if (chunk.firstHop < 0)
+            continue;
+        const size_t end = static_cast<size_t>(chunk.firstHop) + chunk.hops.size();
+        if (hops.size() < end)
+        {
+            hops.resize(end, 0.0);
+        }
+        for (size_t i = 0; i < chunk.hops.size(); ++i)
+        {
+            hops[chunk.firstHop + i] += chunk.hops[i];
+        }
+        truePeak = std::max(truePeak, chunk.truePeak);
+    }
+    if (m_cancelled.load() || hops.size() < 2)
+        return false;
+    // 最后一个分段通常不完整，舍弃
+    hops.pop_back();
+
+    // 100 ms 分段滑动求和得到 400 ms 块与 3 s 窗口的均方
+    const double hopSamples = static_cast<double>(sampleRate) / HOPS_PER_SECOND;
+    auto slidingMeans = [&](int window, std::vector<double> &result)
+    {
+        if (hops.size() < static_cast<size_t>(window))
+            return;
+        result.reserve(hops.size() - window + 1);
+        double sum = 0.0;
+        for (int i = 0; i < window; ++i)
+        {
+            sum += hops[i];
+        }
+        result.push_back(sum / (window * hopSamples));
+        for (size_t i = window; i < hops.size(); ++i)
+        {
+            sum += hops[i] - hops[i - window];
+            result.push_back(std::max(sum, 0.0) / (window * hopSamples));
+        }
+    };
+    slidingMeans(MOMENTARY_HOPS, out.momentary);
+    slidingMeans(SHORT_TERM_HOPS, out.shortTerm);
+    out.truePeak = truePeak;
+    return true;
+}
+
+int64_t LoudnessAnalyzer::fileMtime(const std::string &path)
+{
+    std::error_code ec;
+    auto time = fs::last_write_time(fs::path(path), ec);
+    if (ec)
+        return -1;
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+void LoudnessAnalyzer::loadStore()
+{
+    std::ifstream in(m_storePath, std::ios::binary);
+    if (!in)
+        return;
+
+    uint32_t magic = 0;
+    in.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    if (!in || magic != STORE_MAGIC)
+    {
+        in.close();
+        std::error_code ec;
+        fs::remove(m_storePath, ec);
+        return;
+    }
+
+    // 只追加的记录：路径长度 + 路径, mtime, LoudnessInfo；同一路径以最后一条为准
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        uint32_t pathLength = 0;
+        Entry entry;
+        in.read(reinterpret_cast<char *>(&pathLength), sizeof(pathLength));
+        if (!in || pathLength == 0 || pathLength > 4096)
+            break;
+        std::string path(pathLength, '\0');
+        in.read(path.data(), pathLength);
+        in.read(reinterpret_cast<char *>(&entry.mtime), sizeof(entry.mtime));
+        in.read(reinterpret_cast<char *>(&entry.info), sizeof(entry.info));
+        if (!in)
+            break; // 末尾不完整的记录 (写入时被中断) 直接忽略
+        m_results[path] = entry;
+    }
+    spdlog::info("[Loudness] Loaded {} stored results", m_results.size());
+}
+
+void LoudnessAnalyzer::appendStore(const std::vector<std::pair<std::string, Entry>> &entries)
+{
+    std::error_code ec;
+    fs::create_directories(m_storePath.parent_path(), ec);
+    const bool fresh = !fs::exists(m_storePath, ec) || fs::file_size(m_storePath, ec) == 0;
+
+    std::ofstream out(m_storePath, std::ios::binary | std::ios::app);
+    if (!out)
+    {
+        spdlog::warn("[Loudness] Cannot write {}", m_storePath.string());
+        return;
+    }
+    if (fresh)
+    {
+        out.write(reinterpret_cast<const char *>(&STORE_MAGIC), sizeof(STORE_MAGIC));
+    }
+    for (const auto &[path, entry] : entries)
+    {
+        uint32_t pathLength = static_cast<uint32_t>(path.size());
+        out.write(reinterpret_cast<const char *>(&pathLength), sizeof(pathLength));
+        out.write(path.data(), pathLength);
+        out.write(reinterpret_cast<const char *>(&entry.mtime), sizeof(entry.mtime));
+        out.write(reinterpret_cast<const char *>(&entry.info), sizeof(entry.info));
+    }
+}
@@ -0,0 +1,238 @@
+#include "Lyrics.hpp"
+#include "FileScanner.hpp"
+
+#include <charconv>
+
+namespace
+{
+std::string_view trim(std::string_view text)
+{
+    const size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos)
+        return {};
+    const size_t last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+}
+
+// "mm:ss"、"mm:ss.xx"、"mm:ss:xx" (小数部分位数不限) -> 毫秒；不是时间时返回 false
+bool parseTimestamp(std::string_view tag, int64_t &ms)
+{
+    const size_t colon = tag.find(':');
+    if (colon == 0 || colon == std::string_view::npos)
+        return false;
+
+    int64_t minutes = 0;
+    for (size_t i = 0; i < colon; ++i)
+    {
+        if (!std::isdigit(static_cast<unsigned char>(tag[i])))
+            return false;
+        minutes = minutes * 10 + (tag[i] - '0');
+    }
+
+    size_t i = colon + 1;
+    int64_t seconds = 0;
+    size_t digits = 0;
+    for (; i < tag.size() && std::isdigit(static_cast<unsigned char>(tag[i])); ++i, ++digits)
+    {
+        seconds = seconds * 10 + (tag[i] - '0');
+    }
+    if (digits == 0 || digits > 2)
+        return false;
+
+    int64_t fraction = 0;
+    int64_t scale = 1000;
+    if (i < tag.size())
+    {
+        if (tag[i] != '.' && tag[i] != ':')
+            return false;
+        for (++i; i < tag.size(); ++i)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(tag[i])))
+                return false;
+            if (scale > 1)
+            {
+                scale /= 10;
+                fraction += (tag[i] - '0') * scale;
+            }
+        }
+    }
+
+    ms = (minutes * 60 + seconds) * 1000 + fraction;
+    return true;
+}
+
+// 去掉增强 LRC 的逐字时间标签 <mm:ss.xx>
+std::string stripWordTimestamps(std::string_view text)
+{
+    std::string result;
+    result.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size())
+    {
+        if (text[i] == '<')
+        {
+            const size_t close = text.find('>', i);
+            int64_t ms = 0;
+            if (close != std::string_view::npos && parseTimestamp(text.substr(i + 1, close - i - 1), ms))
+            {
+                i = close + 1;
+                continue;
+            }
+        }
+        result.push_back(text[i++]);
+    }
+    return std::string(trim(result));
+}
+} // namespace
+
+Lyrics Lyrics::parse(std::string_view text)
+{
+    Lyrics lyrics;
+    std::vector<std::string> plain;
+    int64_t offsetMs = 0;
+
+    size_t begin = 0;
+    while (begin < text.size())
+    {
+        size_t end = text.find('\n', begin);
+        if (end == std::string_view::npos)
+            end = text.size();
+        std::string_view line = trim(text.substr(begin, end - begin));
+        begin = end + 1;
+
+        // 行首连续的 [...] 标签：时间标签记下，[offset:] 记下，其余 (ar / ti / al / by ...) 忽略
+        std::vector<int64_t> stamps;
+        bool tagged = false;
+        while (!line.empty() && line.front() == '[')
+        {
+            const size_t close = line.find(']');
+            if (close == std::string_view::npos)
+                break;
+            const std::string_view tag = trim(line.substr(1, close - 1));
+            int64_t ms = 0;
+            if (parseTimestamp(tag, ms))
+            {
+                stamps.push_back(ms);
+            }
+            else if (tag.starts_with("offset:"))
+            {
+                const std::string_view value = trim(tag.substr(7));
+                std::from_chars(value.data() + (value.starts_with('+') ? 1 : 0), value.data() + value.size(), offsetMs);
+            }
+            tagged = true;
+            line = trim(line.substr(close + 1));
+        }
+
+        if (!stamps.empty())
+        {
+            // 空白的时间行也保留：歌词里用它表示间奏，当前行应随之清空
+            const std::string content = stripWordTimestamps(line);
+            for (int64_t ms : stamps)
+            {
+                lyrics.m_lines.push_back({ms * 1000, content});
+            }
+        }
+        else if (!tagged && !line.empty())
+        {
+            plain.emplace_back(line);
+        }
+    }
+
+    if (!lyrics.m_lines.empty())
+    {
+        // offset 为正时歌词提前出现
+        for (LyricLine &line : lyrics.m_lines)
+        {
+            line.timeUs = std::max<int64_t>(0, line.timeUs - offsetMs * 1000);
+        }
+        std::ranges::stable_sort(lyrics.m_lines, {}, &LyricLine::timeUs);
+        lyrics.m_synced = true;
+    }
+    else
+    {
+        for (std::string &line : plain)
+        {
+            lyrics.m_lines.push_back({0, std::move(line)});
+        }
+    }
+    return lyrics;
+}
+
+Lyrics Lyrics::load(const MetaData &track)
+{
+    const fs::path audioPath(track.getFilePath());
+    const int64_t startUs = track.getOffset();
+    const int64_t endUs = track.getDuration() > 0 ? startUs + track.getDuration() : 0;
+
+    Lyrics fallback;
+    // 同步歌词直接返回，纯文本只作为最后的备选
+    auto consider = [&](std::string_view text, bool wholeFile) -> bool
+    {
+        if (text.empty())
+            return false;
+        Lyrics lyrics = parse(text);
+        if (wholeFile && lyrics.m_synced)
+            lyrics.clip(startUs, endUs);
+        if (lyrics.empty())
+            return false;
+        if (lyrics.m_synced)
+        {
+            fallback = std::move(lyrics);
+            return true;
+        }
+        if (fallback.empty())
+            fallback = std::move(lyrics);
+        return false;
+    };
+
+    if (consider(FileScanner::extractLyrics(track.getFilePath()), true))
+        return fallback;
+
+    auto sidecar = [&](const std::string &stem, bool wholeFile) -> bool
+    {
+        std::error_code ec;
+        const fs::path lrcPath = audioPath.parent_path() / (stem + ".lrc");
+        if (stem.empty() || !fs::is_regular_file(lrcPath, ec))
+            return false;
+        return consider(FileScanner::readLyricsFile(lrcPath.string()), wholeFile);
+    };
+
+    if (sidecar(audioPath.stem().string(), true))
+        return fallback;
+    if (!track.getTitle().empty())
+    {
+        if (sidecar(track.getTitle(), false))
+            return fallback;
+        if (!track.getArtist().empty() && sidecar(track.getArtist() + " - " + track.getTitle(), false))
+            return fallback;
+    }
+    return fallback;
+}
+
+int Lyrics::lineAt(int64_t positionUs) const
+{
+    if (!m_synced)
+        return -1;
+    auto it = std::ranges::upper_bound(m_lines, positionUs, {}, &LyricLine::timeUs);
+    return static_cast<int>(it - m_lines.begin()) - 1;
+}
+
+int64_t Lyrics::nextLineTime(int line) const
+{
+    if (!m_synced)
+        return -1;
+    // 同一时间标签可能对应多行 (多个时间标签 / 翻译行)，跳到时间更晚的一行
+    const int64_t current = line >= 0 ? m_lines[line].timeUs : -1;
+    auto it = std::ranges::upper_bound(m_lines, current, {}, &LyricLine::timeUs);
+    return it == m_lines.end() ? -1 : it->timeUs;
+}
+
+void Lyrics::clip(int64_t startUs, int64_t endUs)
+{
+    std::erase_if(m_lines, [&](const LyricLine &line)
+                  { return line.timeUs < startUs || (endUs > startUs && line.timeUs >= endUs); });
+    for (LyricLine &line : m_lines)
+    {
+        line.timeUs -= startUs;
+    }
+}
@@ -59,8 +59,8 @@ MediaController::MediaController()
     player = std::make_shared<AudioPlayer>();
     scanner = std::make_unique<FileScanner>();
 
-    monitorRunning = true;
-    monitorThread = std::thread(&MediaController::monitorLoop, this);
+    eventRunning = true;
+    eventThread = std::thread(&MediaController::eventLoop, this);
 
 #ifndef __WIN32__
     mediaService = std::make_shared<SysMediaService>(*this);
@@ -72,15 +72,20 @@ void MediaController::cleanup()
 {
     spdlog::info("[MediaController] Cleanup started.");
 
-    // 1. 停止监控线程
-    monitorRunning = false;
-    if (monitorThread.joinable())
+    // 1. 停止事件线程
+    eventRunning = false;
+    if (player)
+    {
+        player->interruptEventWait();
+    }
+    if (eventThread.joinable())
     {
-        monitorThread.join();
+        eventThread.join();
     }
-    spdlog::info("[MediaController] Monitor thread stopped.");
+    spdlog::info("[MediaController] Event thread stopped.");
 
-    // 2. 停止扫描器
+    // 2. 停止扫描器与后台响度分析
+    LoudnessAnalyzer::instance().stop();
     if (scanner)
     {
         scanner->stopScan();
@@ -108,150 +113,209 @@ void MediaController::cleanup()
 MediaController::~MediaController()
 {
     // 如果直接 delete 而没调 cleanup，这里做个保底
-    if (monitorThread.joinable())
+    if (eventThread.joinable())
     {
-        monitorRunning = false;
-        monitorThread.join();
+        eventRunning = false;
+        if (player)
+            player->interruptEventWait();
+        eventThread.join();
     }
 }
 
-void MediaController::monitorLoop()
+void MediaController::syncWithPlayerPath()
 {
-    while (monitorRunning)
-    {
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
-
-        // 判空保护
-        if (!player)
-            break;
-
-        std::string realCurrentPath = player->getCurrentPath();
-        int64_t currentAbsMicroseconds = player->getCurrentPositionMicroseconds();
+    std::lock_guard<std::recursive_mutex> lock(controllerMutex);
+    if (!player)
+        return;
 
-        bool justSwitched = false;
+    // 物理文件切换 (无缝切换 / Direct 模式重建设备后的下一首)
+    std::string realCurrentPath = player->getCurrentPath();
+    if (realCurrentPath.empty() || realCurrentPath == lastDetectedPath)
+        return;
 
-        // 情况 A: 物理文件切换
-        if (!realCurrentPath.empty() && realCurrentPath != lastDetectedPath)
+    PlaylistNode *newNode = nullptr;
+    PlaylistNode *potentialNext = calculateNextNode(currentPlayingSongs);
+    if (potentialNext && potentialNext->getPath() == realCurrentPath)
+    {
+        newNode = potentialNext;
+    }
+    else if (currentPlayingSongs && currentPlayingSongs->getParent())
+    {
+        for (auto &child : currentPlayingSongs->getParent()->getChildren())
         {
-            std::lock_guard<std::recursive_mutex> lock(controllerMutex);
-
-            PlaylistNode *newNode = nullptr;
-            PlaylistNode *potentialNext = calculateNextNode(currentPlayingSongs);
-            if (potentialNext && potentialNext->getPath() == realCurrentPath)
-            {
-                newNode = potentialNext;
-            }
-            else if (currentPlayingSongs && currentPlayingSongs->getParent())
+            if (child->getPath() == realCurrentPath)
             {
-                for (auto &child : currentPlayingSongs->getParent()->getChildren())
-                {
-                    if (child->getPath() == realCurrentPath)
-                    {
-                        newNode = child.get();
-                        break;
-                    }
-                }
+                newNode = child.get();
+                break;
             }
+        }
+    }
 
-            if (newNode)
-            {
-                playHistory.push_back(currentPlayingSongs);
-                if (playHistory.size() > MAX_HISTORY_SIZE)
-                    playHistory.pop_front();
+    if (newNode)
+    {
+        playHistory.push_back(currentPlayingSongs);
+        if (playHistory.size() > MAX_HISTORY_SIZE)
+            playHistory.pop_front();
 
-                currentPlayingSongs = newNode;
-                updateMetaData(currentPlayingSongs);
+        currentPlayingSongs = newNode;
+        updateMetaData(currentPlayingSongs);
 
-                if (mediaService)
-                    mediaService->triggerSeeked(std::chrono::microseconds(0));
+        if (mediaService)
+            mediaService->triggerSeeked(std::chrono::microseconds(0));
 
-                justSwitched = true;
-                preloadNextSong();
-            }
+        preloadNextSong();
+    }
 
-            lastDetectedPath = realCurrentPath;
-        }
-        // 情况 B: CUE 分轨切换
-        else if (isPlaying.load() && !realCurrentPath.empty() && realCurrentPath == lastDetectedPath)
-        {
-            std::lock_guard<std::recursive_mutex> lock(controllerMutex);
+    lastDetectedPath = realCurrentPath;
+}
 
-            if (currentPlayingSongs)
-            {
-                int64_t startOffset = currentPlayingSongs->getMetaData().getOffset();
-                int64_t duration = currentPlayingSongs->getMetaData().getDuration();
-
-                if (duration > 0)
-                {
-                    int64_t expectedEndTime = startOffset + duration;
-                    if (currentAbsMicroseconds >= expectedEndTime)
-                    {
-                        PlaylistNode *nextNode = calculateNextNode(currentPlayingSongs);
-                        if (nextNode && nextNode->getPath() == currentPlayingSongs->getPath())
-                        {
-                            playHistory.push_back(currentPlayingSongs);
-                            if (playHistory.size() > MAX_HISTORY_SIZE)
-                                playHistory.pop_front();
-
-                            currentPlayingSongs = nextNode;
-                            updateMetaData(currentPlayingSongs);
-
-                            if (mediaService)
-                                mediaService->triggerSeeked(std::chrono::microseconds(0));
-
-                            preloadNextSong();
-                            justSwitched = true;
-                        }
-                    }
-                }
-            }
-        }
-        // 情况 C: 播放结束
-        else if (isPlaying.load() && realCurrentPath.empty() && !lastDetectedPath.empty())
-        {
-            // 如果 logic 是 Playing，且刚才还有路径，现在突然没了，说明底层 AudioPlayer 跑完了
-            std::lock_guard<std::recursive_mutex> lock(controllerMutex);
+void MediaController::handleTrackFinished()
+{
+    // 最后一个采样点已经播放，且底层没有可接续的预加载曲目
+    std::lock_guard<std::recursive_mutex> lock(controllerMutex);
 
-            PlaylistNode *nextNode = calculateNextNode(currentPlayingSongs);
+    PlaylistNode *nextNode = calculateNextNode(currentPlayingSongs);
 
-            // 只有当存在下一首时才自动播放，否则视为播放结束
-            if (nextNode)
-            {
-                // 模拟切歌逻辑
-                playNode(nextNode);
+    // 只有当存在下一首时才自动播放，否则视为播放结束
+    if (nextNode)
+    {
+        playNode(nextNode);
+    }
+    else
+    {
+        // 没有下一首了 (例如单次播放且不循环)，停止状态
+        isPlaying = false;
+        lastDetectedPath = ""; // 重置检测路径
+        if (mediaService)
+            mediaService->setPlayBackStatus(mpris::PlaybackStatus::Stopped);
+    }
+}
 
-                // playNode 会更新 lastDetectedPath，所以这里不需要手动更新
-                justSwitched = true;
-            }
-            else
-            {
-                // 没有下一首了 (例如单次播放且不循环)，停止状态
-                isPlaying = false;
-                lastDetectedPath = ""; // 重置检测路径
-                if (mediaService)
-                    mediaService->setPlayBackStatus(mpris::PlaybackStatus::Stopped);
-            }
-        }
+void MediaController::handleDeviceLost()
+{
+    spdlog::error("[MediaController] Audio device lost, trying to reopen.");
+    if (!player)
+        return;
 
-        // 自然停止检测
-        if (player && isPlaying.load() && player->getNowPlayingTime() > 0 && !player->isPlaying())
+    if (!player->reopenDevice())
+    {
+        // 无法恢复：进入暂停状态，等待用户操作
+        player->pause();
+        isPlaying = false;
+        if (mediaService)
+            mediaService->setPlayBackStatus(mpris::PlaybackStatus::Paused);
+    }
+}
+
+void MediaController::eventLoop()
+{
+    while (eventRunning)
+    {
+        if (!player)
+            break;
+
+        // 所有状态变化都由 AudioPlayer 事件驱动；超时只用于播放中低频刷新 MPRIS 位置
+        // (客户端会根据 Rate 自行插值)，暂停 / 停止时几乎不唤醒
+        auto timeout = isPlaying.load() ? MPRIS_POSITION_REFRESH_INTERVAL : std::chrono::milliseconds(30000);
+
+        PlaybackEvent event;
+        if (!player->waitForEvent(event, timeout))
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            // 再次检查 player 是否存在
-            if (player && !player->isPlaying() && !player->getCurrentPath().empty())
-            {
-                isPlaying = false;
-                if (mediaService)
-                    mediaService->setPlayBackStatus(mpris::PlaybackStatus::Stopped);
-            }
+            if (isPlaying.load() && mediaService)
+                mediaService->setPosition(std::chrono::microseconds(getCurrentPosMicroseconds()));
+            continue;
         }
 
-        if (isPlaying.load() && !justSwitched)
+        switch (event.type)
         {
+        case PlaybackEventType::TrackStarted:
+        case PlaybackEventType::SeamlessSwitch:
+            spdlog::debug("[MediaController] Playback stats: {}", getStats().summary());
+            syncWithPlayerPath();
+            break;
+        case PlaybackEventType::TrackBoundary:
+            handleTrackBoundary(event.positionUs);
+            break;
+        case PlaybackEventType::TrackFinished:
+            handleTrackFinished();
+            break;
+        case PlaybackEventType::SeekCompleted:
             if (mediaService)
-                mediaService->setPosition(std::chrono::microseconds(getCurrentPosMicroseconds()));
+                mediaService->triggerSeeked(std::chrono::microseconds(getCurrentPosMicroseconds()));
+            break;
+        case PlaybackEventType::Underrun:
+            spdlog::warn("[MediaController] Audio underrun at {} us ({} frames missing)", event.positionUs, event.value);
+            // 附带统计，便于区分是解码 (I/O / CPU 竞争) 跟不上还是设备回调超时
+            spdlog::warn("[MediaController] Playback stats: {}", getStats().summary());
+            break;
+        case PlaybackEventType::DeviceLost:
+            handleDeviceLost();
+            break;
+        }
+    }
+}
+
+void MediaController::handleTrackBoundary(int64_t boundaryUs)
+{
+    std::lock_guard<std::recursive_mutex> lock(controllerMutex);
+    if (!player || !currentPlayingSongs)
+        return;
+
+    // 当前分轨恰好在此采样点结束
+    PlaylistNode *nextNode = calculateNextNode(currentPlayingSongs);
+    if (nextNode && nextNode != currentPlayingSongs && nextNode->getPath() == currentPlayingSongs->getPath() && nextNode->getMetaData().getOffset() == boundaryUs)
+    {
+        // 下一首就是同一文件中紧接着的分轨：音频本身连续，只切换元数据
+        playHistory.push_back(currentPlayingSongs);
+        if (playHistory.size() > MAX_HISTORY_SIZE)
+            playHistory.pop_front();
+
+        currentPlayingSongs = nextNode;
+        updateMetaData(currentPlayingSongs);
+
+        if (mediaService)
+            mediaService->triggerSeeked(std::chrono::microseconds(0));
+
+        preloadNextSong();
+        return;
+    }
+
+    if (nextNode)
+    {
+        // 随机 / 单曲循环 / 跨文件：当前分轨已播完，跳到目标曲目
+        playHistory.push_back(currentPlayingSongs);
+        if (playHistory.size() > MAX_HISTORY_SIZE)
+            playHistory.pop_front();
+        playNode(nextNode, true);
+    }
+    else
+    {
+        // 列表结束：在分轨终点停止，而不是继续播放文件中的下一段
+        player->pause();
+        isPlaying = false;
+        if (mediaService)
+            mediaService->setPlayBackStatus(mpris::PlaybackStatus::Stopped);
+    }
+}
+
+std::vector<int64_t> MediaController::collectTrackBoundaries(PlaylistNode *node)
+{
+    std::vector<int64_t> boundaries;
+    if (!node || !node->getParent())
+        return boundaries;
+
+    // 同一文件中的所有分轨起点 (CUE 虚拟分轨共享物理文件)
+    const std::string &path = node->getPath();
+    for (const auto &sibling : node->getParent()->getChildren())
+    {
+        if (!sibling->isDir() && sibling->getPath() == path)
+        {
+            int64_t offset = sibling->getMetaData().getOffset();
+            if (offset > 0)
+                boundaries.push_back(offset);
         }
     }
+    return boundaries;
 }
 
 PlaylistNode *MediaController::calculateNextNode(PlaylistNode *current, bool ignoreSingleRepeat)
@@ -315,14 +379,43 @@ void MediaController::preloadNextSong()
     if (!player)
         return;
     PlaylistNode *nextNode = calculateNextNode(currentPlayingSongs);
-    if (nextNode)
+    const bool sameFile = nextNode && currentPlayingSongs && nextNode->getPath() == currentPlayingSongs->getPath();
+    if (sameFile && !collectTrackBoundaries(nextNode).empty())
     {
-        player->setPreloadPath(nextNode->getPath());
+        // 下一首是同一文件中的另一条虚拟分轨 (CUE / 章节)：由分轨边界或定位在当前解码会话内切换，
+        // 预加载只会为同一个 (可能很大的) 文件再打开并探测一个会话
+        player->setPreloadPath("");
+    }
+    else if (nextNode)
+    {
+        if (!sameFile)
+        {
+            player->setTrackBoundaries(nextNode->getPath(), collectTrackBoundaries(nextNode));
+        }
+        player->setPreloadPath(nextNode->getPath(), nextNode->getMetaData().getOffset());
     }
     else
     {
         player->setPreloadPath("");
     }
+
+    // 最近播放过的几首保持解码会话打开，"上一首" 可以立即开始
+    std::vector<std::string> recentPaths;
+    std::string currentPath = currentPlayingSongs ? currentPlayingSongs->getPath() : "";
+    for (auto it = playHistory.rbegin(); it != playHistory.rend() && recentPaths.size() < PREFETCH_HISTORY_SIZE; ++it)
+    {
+        if (!*it)
+            continue;
+        const std::string &path = (*it)->getPath();
+        if (path != currentPath && std::find(recentPaths.begin(), recentPaths.end(), path) == recentPaths.end())
+        {
+            recentPaths.push_back(path);
+        }
+    }
+    if (!recentPaths.empty())
+    {
+        player->prefetchSessions(recentPaths);
+    }
 }
 
 PlaylistNode *MediaController::pickRandomSong(PlaylistNode *scope)
@@ -401,17 +494,9 @@ void MediaController::playNode(PlaylistNode *node, bool isAutoSwitch)
     {
         // === 情况 A: 切换到了不同的音频文件 ===
         // AudioPlayer::setPath 内部会处理解码器的状态保存和恢复
-        player->setPath(newPath);
-
-        // 给一点时间让解码线程启动
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-
-        int64_t offset = node->getMetaData().getOffset();
-        if (offset > 0)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(15));
-            player->seek(offset);
-        }
+        // 分轨边界先于 setPath 登记；起始偏移随 setPath 交给解码线程，打开后直接精确定位
+        player->setTrackBoundaries(newPath, collectTrackBoundaries(node));
+        player->setPath(newPath, node->getMetaData().getOffset());
     }
     else
     {
@@ -482,6 +567,8 @@ void MediaController::play()
 
     player->play();
     isPlaying = true;
+    // 唤醒事件线程，恢复播放中的位置刷新
+    player->interruptEventWait();
 
     if (mediaService)
     {
@@ -570,15 +657,8 @@ void MediaController::prev()
 
         if (oldPath != newPath)
         {
-            player->setPath(newPath);
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-
-            int64_t offset = prevNode->getMetaData().getOffset();
-            if (offset > 0)
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(15));
-                player->seek(offset);
-            }
+            player->setTrackBoundaries(newPath, collectTrackBoundaries(prevNode));
+            player->setPath(newPath, prevNode->getMetaData().getOffset());
         }
         else
         {
@@ -588,7 +668,6 @@ void MediaController::prev()
             }
 
             int64_t offset = prevNode->getMetaData().getOffset();
-            std::this_thread::sleep_for(std::chrono::milliseconds(15));
             player->seek(offset);
         }
 
@@ -783,10 +862,47 @@ bool MediaController::isScanCplt()
     {
         rootNode = scanner->getPlaylistTree();
         currentDir = rootNode.get();
+        startLoudnessAnalysis();
     }
     return cplt;
 }
 
+void MediaController::startLoudnessAnalysis()
+{
+    if (!rootNode)
+        return;
+
+    // 每个文件夹作为一张专辑 (CUE 分轨共用同一个文件，只分析一次)
+    std::vector<std::vector<std::string>> albums;
+    std::stack<PlaylistNode *> pending;
+    pending.push(rootNode.get());
+    while (!pending.empty())
+    {
+        PlaylistNode *dir = pending.top();
+        pending.pop();
+
+        std::vector<std::string> files;
+        for (const auto &child : dir->getChildren())
+        {
+            if (child->isDir())
+            {
+                pending.push(child.get());
+            }
+            else if (std::find(files.begin(), files.end(), child->getPath()) == files.end())
+            {
+                files.push_back(child->getPath());
+            }
+        }
+        if (!files.empty())
+        {
+            albums.push_back(std::move(files));
+        }
+    }
+
+    spdlog::info("[MediaController] Loudness analysis queued for {} folders", albums.size());
+    LoudnessAnalyzer::instance().analyzeLibrary(std::move(albums));
+}
+
 std::shared_ptr<PlaylistNode> MediaController::getRootNode()
 {
     return rootNode;
@@ -821,7 +937,7 @@ RepeatMode MediaController::getRepeatMode()
     return repeatMode.load();
 }
 
-void MediaController::setMixingParameters(int sampleRate, AVSampleFormat smapleFormat)
+void MediaController::setMixingParameters(int sampleRate, AVSampleFormat smapleFormat, bool packed24)
 {
     if (!player)
     {
@@ -830,6 +946,7 @@ void MediaController::setMixingParameters(int sampleRate, AVSampleFormat smapleF
     AudioParams params;
     params.sampleRate = sampleRate;
     params.sampleFormat = smapleFormat;
+    params.packed24 = packed24;
     params.ch_layout = AV_CHANNEL_LAYOUT_STEREO;
     params.channels = 2;
     player->setMixingParameters(params);
@@ -852,6 +969,289 @@ outputMod MediaController::getOUTPUTMode()
     return OUTPUT_MIXING;
 }
 
+void MediaController::setCrossfadeDuration(int milliseconds)
+{
+    if (player)
+    {
+        player->setCrossfadeDuration(milliseconds);
+    }
+}
+
+int MediaController::getCrossfadeDuration()
+{
+    if (player)
+    {
+        return player->getCrossfadeDuration();
+    }
+    return 0;
+}
+
+void MediaController::setDitherMode(AudioKernels::DitherMode mode)
+{
+    if (player)
+    {
+        player->setDitherMode(mode);
+    }
+}
+
+AudioKernels::DitherMode MediaController::getDitherMode()
+{
+    if (player)
+    {
+        return player->getDitherMode();
+    }
+    return AudioKernels::DitherMode::Tpdf;
+}
+
+void MediaController::setNormalizationMode(NormalizationMode mode)
+{
+    if (player)
+    {
+        player->setNormalizationMode(mode);
+    }
+}
+
+NormalizationMode MediaController::getNormalizationMode()
+{
+    if (player)
+    {
+        return player->getNormalizationMode();
+    }
+    return NormalizationMode::Off;
+}
+
+void MediaController::setEqualizerEnabled(bool enabled)
+{
+    if (player)
+    {
+        player->setEqualizerEnabled(enabled);
+    }
+}
+
+bool MediaController::getEqualizerEnabled()
+{
+    if (player)
+    {
+        return player->getEqualizerEnabled();
+    }
+    return false;
+}
+
+void MediaController::setEqualizerSettings(const EqSettings &settings)
+{
+    if (player)
+    {
+        player->setEqualizerSettings(settings);
+    }
+}
+
+EqSettings MediaController::getEqualizerSettings()
+{
+    if (player)
+    {
+        return player->getEqualizerSettings();
+    }
+    return EqualizerStage::graphic({});
+}
+
+bool MediaController::setConvolverImpulse(const std::string &path)
+{
+    if (player)
+    {
+        return player->setConvolverImpulse(path);
+    }
+    return false;
+}
+
+std::string MediaController::getConvolverImpulse()
+{
+    if (player)
+    {
+        return player->getConvolverImpulse();
+    }
+    return {};
+}
+
+void MediaController::setPlaybackSpeed(double speed)
+{
+    if (player)
+    {
+        player->setPlaybackSpeed(speed);
+    }
+}
+
+double MediaController::getPlaybackSpeed()
+{
+    if (player)
+    {
+        return player->getPlaybackSpeed();
+    }
+    return 1.0;
+}
+
+void MediaController::setSpectrumEnabled(bool enabled)
+{
+    if (player)
+    {
+        player->setSpectrumEnabled(enabled);
+    }
+}
+
+bool MediaController::getSpectrumEnabled()
+{
+    if (player)
+    {
+        return player->getSpectrumEnabled();
+    }
+    return false;
+}
+
+void MediaController::readSpectrum(SpectrumFrame &frame)
+{
+    if (player)
+    {
+        player->readSpectrum(frame);
+    }
+}
+
+void MediaController::setRealtimeMode(bool enabled, int cpuCore)
+{
+    if (player)
+    {
+        player->setRealtimeMode(enabled, cpuCore);
+    }
+}
+
+RealtimeStatus MediaController::getRealtimeStatus()
+{
+    if (player)
+    {
+        return player->getRealtimeStatus();
+    }
+    return RealtimeStatus();
+}
+
+void MediaController::setLatencyProfile(LatencyProfile profile)
+{
+    if (player)
+    {
+        player->setLatencyProfile(profile);
+    }
+}
+
+LatencyProfile MediaController::getLatencyProfile()
+{
+    if (player)
+    {
+        return player->getLatencyProfile();
+    }
+    return LatencyProfile::Balanced;
+}
+
+void MediaController::setDevicePeriod(int milliseconds)
+{
+    if (player)
+    {
+        player->setDevicePeriod(milliseconds);
+    }
+}
+
+int MediaController::getDevicePeriod()
+{
+    if (player)
+    {
+        return player->getDevicePeriod();
+    }
+    return 0;
+}
+
+void MediaController::setResamplerQuality(outputMod mode, ResamplerQuality quality)
+{
+    if (player)
+    {
+        player->setResamplerQuality(mode, quality);
+    }
+}
+
+ResamplerQuality MediaController::getResamplerQuality(outputMod mode)
+{
+    if (player)
+    {
+        return player->getResamplerQuality(mode);
+    }
+    return ResamplerQuality::Default;
+}
+
+void MediaController::setDecodeAhead(DecodeAheadMode mode, double seconds)
+{
+    if (player)
+    {
+        player->setDecodeAhead(mode, seconds);
+    }
+}
+
+DecodeAheadMode MediaController::getDecodeAheadMode()
+{
+    if (player)
+    {
+        return player->getDecodeAheadMode();
+    }
+    return DecodeAheadMode::Off;
+}
+
+void MediaController::setBitPerfectVerification(bool enabled)
+{
+    if (player)
+    {
+        player->setBitPerfectVerification(enabled);
+    }
+}
+
+bool MediaController::getBitPerfectVerification()
+{
+    if (player)
+    {
+        return player->getBitPerfectVerification();
+    }
+    return false;
+}
+
+PlaybackStats MediaController::getStats()
+{
+    if (player)
+    {
+        return player->getStats();
+    }
+    return PlaybackStats();
+}
+
+int MediaController::addDspStage(std::shared_ptr<DspStage> stage, int position)
+{
+    if (player)
+    {
+        return player->getDspChain().addStage(std::move(stage), position);
+    }
+    return -1;
+}
+
+bool MediaController::removeDspStage(int id)
+{
+    if (player)
+    {
+        return player->getDspChain().removeStage(id);
+    }
+    return false;
+}
+
+bool MediaController::setDspStageBypassed(int id, bool bypassed)
+{
+    if (player)
+    {
+        return player->getDspChain().setBypassed(id, bypassed);
+    }
+    return false;
+}
+
 AudioParams MediaController::getMixingParameters()
 {
     if (player)
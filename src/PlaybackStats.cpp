@@ -0,0 +1,47 @@
+#include "PlaybackStats.hpp"
+
+uint64_t LatencySnapshot::percentileUs(double p) const
+{
+    if (count == 0)
+        return 0;
+
+    const uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= std::max<uint64_t>(rank, 1))
+        {
+            // 桶上界，但不会超过实际观测到的最大值
+            uint64_t upper = (i == 0) ? 0 : ((uint64_t{1} << i) - 1);
+            return (i == BUCKETS - 1) ? maxUs : std::min(upper, maxUs);
+        }
+    }
+    return maxUs;
+}
+
+std::string PlaybackStats::summary() const
+{
+    std::string line = std::format("underruns {} ({:.1f} ms silence) | buffer {:.0f}/{:.0f} ms, output latency {:.1f} ms | "
+                                   "callback {} calls, mean {:.0f} us, p99 {} us, max {} us, deadline {:.0f} us, misses {} | "
+                                   "decode/packet mean {:.0f} us, p99 {} us, max {} us | swr/frame mean {:.0f} us, p99 {} us, max {} us",
+                                   underrunCount, underrunMs, bufferedMs, bufferTargetMs, outputLatencyMs,
+                                   callbackCount, callbackUs.meanUs(), callbackUs.percentileUs(0.99), callbackUs.maxUs, callbackDeadlineUs, deadlineMisses,
+                                   decodeUs.meanUs(), decodeUs.percentileUs(0.99), decodeUs.maxUs,
+                                   swrUs.meanUs(), swrUs.percentileUs(0.99), swrUs.maxUs);
+    line += std::format(" | direct copy {} ({} frames), device native {}, bit-perfect {}", directCopy, directCopyFrames, deviceNative, bitPerfect);
+    if (verifiedFrames > 0)
+    {
+        line += std::format(" | verified {} frames, crc32 {:08x}, mismatches {}", verifiedFrames, outputCrc, checksumMismatches);
+    }
+    for (const DspStageStats &stage : dspStages)
+    {
+        line += std::format(" | dsp {}{}: block mean {:.0f} us, max {} us, load {:.2f} %",
+                            stage.name, stage.bypassed ? " (bypassed)" : "", stage.blockUs.meanUs(), stage.blockUs.maxUs, stage.load * 100.0);
+        if (stage.workerLoad > 0.0)
+        {
+            line += std::format(" + worker {:.2f} %", stage.workerLoad * 100.0);
+        }
+    }
+    return line;
+}
@@ -0,0 +1,158 @@
+#include "RenderWriter.hpp"
+
+namespace
+{
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+// KSDATAFORMAT_SUBTYPE_PCM / IEEE_FLOAT 的后 14 字节 (前 2 字节为格式标签)
+constexpr uint8_t SUBFORMAT_GUID_TAIL[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+void putU16(std::vector<uint8_t> &out, uint16_t value)
+{
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void putU32(std::vector<uint8_t> &out, uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void putTag(std::vector<uint8_t> &out, const char (&tag)[5])
+{
+    out.insert(out.end(), tag, tag + 4);
+}
+} // namespace
+
+RenderWriter::~RenderWriter()
+{
+    close();
+}
+
+bool RenderWriter::open(RenderSink sink, const std::string &path, AudioKernels::PcmFormat format, int channels, int sampleRate, uint64_t channelMask)
+{
+    close();
+    if (format == AudioKernels::PcmFormat::Unknown || channels <= 0 || sampleRate <= 0)
+        return false;
+
+    m_sink = sink;
+    m_format = format;
+    m_channels = channels;
+    m_sampleRate = sampleRate;
+    m_channelMask = channelMask;
+    m_dataBytes = 0;
+
+    if (sink != RenderSink::Discard)
+    {
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file)
+        {
+            spdlog::error("[RenderWriter] Cannot create {}", path);
+            return false;
+        }
+        if (sink == RenderSink::Wav)
+        {
+            // 先写占位头，长度在 close 时回填
+            const std::vector<uint8_t> header = buildWavHeader(0);
+            m_file.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size()));
+        }
+    }
+    m_open = true;
+    return true;
+}
+
+bool RenderWriter::write(const uint8_t *data, size_t bytes)
+{
+    if (!m_open)
+        return false;
+    m_dataBytes += bytes;
+    if (m_sink == RenderSink::Discard)
+        return true;
+    m_file.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+    return static_cast<bool>(m_file);
+}
+
+bool RenderWriter::close()
+{
+    if (!m_open)
+        return true;
+    m_open = false;
+    if (m_sink == RenderSink::Discard)
+        return true;
+
+    bool ok = static_cast<bool>(m_file);
+    if (ok && m_sink == RenderSink::Wav)
+    {
+        // RIFF 长度字段只有 32 位：超过 4 GiB 时写入上限值 (多数播放器按文件实际长度读取)
+        if (m_dataBytes > UINT32_MAX - 80)
+        {
+            spdlog::warn("[RenderWriter] WAV data exceeds 4 GiB, size fields are clamped");
+        }
+        const std::vector<uint8_t> header = buildWavHeader(m_dataBytes);
+        // RIFF 块按偶数字节对齐
+        if (m_dataBytes % 2 != 0)
+        {
+            m_file.put(0);
+        }
+        m_file.seekp(0);
+        m_file.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size()));
+        ok = static_cast<bool>(m_file);
+    }
+    m_file.close();
+    return ok;
+}
+
+std::vector<uint8_t> RenderWriter::buildWavHeader(uint64_t dataBytes) const
+{
+    const bool isFloat = (m_format == AudioKernels::PcmFormat::F32 || m_format == AudioKernels::PcmFormat::F64);
+    const uint16_t bytesPerSample = static_cast<uint16_t>(AudioKernels::bytesPerSample(m_format));
+    const uint16_t bits = static_cast<uint16_t>(bytesPerSample * 8);
+    const uint16_t blockAlign = static_cast<uint16_t>(bytesPerSample * m_channels);
+    // 多声道或高于 16 位的整数格式按规范需要 EXTENSIBLE 头 (声道掩码 + 有效位数)
+    const bool extensible = (m_channels > 2 || bits > 16);
+
+    uint64_t mask = m_channelMask;
+    if (mask == 0)
+    {
+        AVChannelLayout layout{};
+        av_channel_layout_default(&layout, m_channels);
+        mask = (layout.order == AV_CHANNEL_ORDER_NATIVE) ? layout.u.mask : 0;
+        av_channel_layout_uninit(&layout);
+    }
+
+    const uint32_t fmtBytes = extensible ? 40 : 16;
+    const uint32_t dataField = static_cast<uint32_t>(std::min<uint64_t>(dataBytes, UINT32_MAX - 80));
+    const uint32_t riffBytes = 4 + (8 + fmtBytes) + (8 + dataField + (dataField % 2));
+
+    std::vector<uint8_t> header;
+    header.reserve(12 + 8 + fmtBytes + 8);
+    putTag(header, "RIFF");
+    putU32(header, riffBytes);
+    putTag(header, "WAVE");
+
+    putTag(header, "fmt ");
+    putU32(header, fmtBytes);
+    const uint16_t baseTag = isFloat ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM;
+    putU16(header, extensible ? WAVE_FORMAT_EXTENSIBLE : baseTag);
+    putU16(header, static_cast<uint16_t>(m_channels));
+    putU32(header, static_cast<uint32_t>(m_sampleRate));
+    putU32(header, static_cast<uint32_t>(m_sampleRate) * blockAlign);
+    putU16(header, blockAlign);
+    putU16(header, bits);
+    if (extensible)
+    {
+        putU16(header, 22);   // cbSize
+        putU16(header, bits); // 有效位数 (设备格式没有填充位)
+        putU32(header, static_cast<uint32_t>(mask));
+        putU16(header, baseTag);
+        header.insert(header.end(), std::begin(SUBFORMAT_GUID_TAIL), std::end(SUBFORMAT_GUID_TAIL));
+    }
+
+    putTag(header, "data");
+    putU32(header, dataField);
+    return header;
+}
@@ -0,0 +1,101 @@
+#include "Resampler.hpp"
+
+namespace
+{
+// soxr 精度 (位)，28 对应 soxr 的 "very high quality"
+constexpr double SOXR_PRECISION_BITS = 28.0;
+// swr 高质量参数：更长的滤波器与更密的相位表，截止频率更接近 Nyquist
+constexpr int HQ_FILTER_SIZE = 64;
+constexpr int HQ_PHASE_SHIFT = 14;
+constexpr double HQ_CUTOFF = 0.97;
+constexpr int HQ_KAISER_BETA = 9;
+// Fast：短滤波器，相位表粗糙部分由线性插值补偿
+constexpr int FAST_FILTER_SIZE = 8;
+constexpr int FAST_PHASE_SHIFT = 6;
+
+std::atomic<bool> g_soxrUnavailable{false};
+
+SwrContext *allocate(const AVChannelLayout &inLayout, int inRate, AVSampleFormat inFormat,
+                     const AVChannelLayout &outLayout, int outRate, AVSampleFormat outFormat)
+{
+    SwrContext *swr = nullptr;
+    if (swr_alloc_set_opts2(&swr, &outLayout, outFormat, outRate, &inLayout, inFormat, inRate, 0, nullptr) < 0)
+        return nullptr;
+    return swr;
+}
+
+bool initialize(SwrContext *&swr)
+{
+    if (swr_init(swr) >= 0)
+        return true;
+    swr_free(&swr);
+    return false;
+}
+} // namespace
+
+namespace Resampler
+{
+SwrContext *create(const AVChannelLayout &inLayout, int inRate, AVSampleFormat inFormat,
+                   const AVChannelLayout &outLayout, int outRate, AVSampleFormat outFormat,
+                   ResamplerQuality quality)
+{
+    // 采样率相同时 swr 不会建立重采样滤波器，质量参数无意义
+    const bool passthrough = (inRate == outRate);
+
+    if (!passthrough && quality == ResamplerQuality::High && !g_soxrUnavailable.load(std::memory_order_relaxed))
+    {
+        SwrContext *swr = allocate(inLayout, inRate, inFormat, outLayout, outRate, outFormat);
+        if (swr)
+        {
+            av_opt_set_int(swr, "resampler", SWR_ENGINE_SOXR, 0);
+            av_opt_set_double(swr, "precision", SOXR_PRECISION_BITS, 0);
+            if (initialize(swr))
+                return swr;
+        }
+        // FFmpeg 未启用 libsoxr：以后直接使用 swr
+        g_soxrUnavailable.store(true, std::memory_order_relaxed);
+        spdlog::info("[Resampler] soxr unavailable, using high quality swr filter");
+    }
+
+    SwrContext *swr = allocate(inLayout, inRate, inFormat, outLayout, outRate, outFormat);
+    if (!swr)
+        return nullptr;
+
+    if (!passthrough)
+    {
+        switch (quality)
+        {
+        case ResamplerQuality::Fast:
+            av_opt_set_int(swr, "filter_size", FAST_FILTER_SIZE, 0);
+            av_opt_set_int(swr, "phase_shift", FAST_PHASE_SHIFT, 0);
+            av_opt_set_int(swr, "linear_interp", 1, 0);
+            break;
+        case ResamplerQuality::High:
+            av_opt_set_int(swr, "filter_size", HQ_FILTER_SIZE, 0);
+            av_opt_set_int(swr, "phase_shift", HQ_PHASE_SHIFT, 0);
+            av_opt_set_double(swr, "cutoff", HQ_CUTOFF, 0);
+            av_opt_set_int(swr, "filter_type", SWR_FILTER_TYPE_KAISER, 0);
+            av_opt_set_int(swr, "kaiser_beta", HQ_KAISER_BETA, 0);
+            break;
+        case ResamplerQuality::Default:
+        default: break;
+        }
+    }
+
+    initialize(swr);
+    return swr;
+}
+
+const char *describe(ResamplerQuality quality, bool passthrough)
+{
+    if (passthrough)
+        return "passthrough";
+    switch (quality)
+    {
+    case ResamplerQuality::Fast: return "swr fast (linear interp)";
+    case ResamplerQuality::High: return g_soxrUnavailable.load(std::memory_order_relaxed) ? "swr high quality" : "soxr";
+    case ResamplerQuality::Default:
+    default: return "swr default";
+    }
+}
+} // namespace Resampler
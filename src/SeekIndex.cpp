@@ -0,0 +1,244 @@
+#include "SeekIndex.hpp"
+#include "SimpleThreadPool.hpp"
+
+namespace
+{
+// 相邻索引点的最小间隔：1 小时的文件约 7200 个点 (约 112 KB)
+constexpr int64_t SEEK_INDEX_INTERVAL_US = 500000;
+// 内存中最多保留的文件数
+constexpr size_t SEEK_INDEX_MEMORY_CAPACITY = 64;
+constexpr uint32_t SEEK_INDEX_MAGIC = 0x58494B53; // "SKIX"
+constexpr uint32_t SEEK_INDEX_VERSION = 1;
+} // namespace
+
+int64_t SeekIndexCache::fileMtime(const std::string &path)
+{
+    std::error_code ec;
+    auto time = fs::last_write_time(fs::path(path), ec);
+    if (ec)
+        return -1;
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+fs::path SeekIndexCache::cacheFileFor(const std::string &path)
+{
+    static const fs::path dir = fs::path(QStandardPaths::writableLocation(QStandardPaths::CacheLocation).toStdString()) / "seekindex";
+    return dir / std::format("{:016x}.idx", std::hash<std::string>{}(path));
+}
+
+void SeekIndexCache::requestBuild(const std::string &path)
+{
+    if (path.empty())
+        return;
+
+    const int64_t mtime = fileMtime(path);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_indexes.find(path);
+        if (it != m_indexes.end() && it->second.mtime == mtime)
+            return;
+        if (!m_pending.insert(path).second)
+            return;
+    }
+
+    SimpleThreadPool::instance().enqueue(
+        [this, path, mtime]
+        {
+            auto points = loadFromDisk(path, mtime);
+            if (!points)
+            {
+                points = scanFile(path);
+                if (points && !points->empty())
+                {
+                    saveToDisk(path, mtime, *points);
+                    spdlog::debug("[SeekIndex] Built {} points for {}", points->size(), path);
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending.erase(path);
+            }
+            // 扫描失败 (或被取消) 时不登记，下次播放时再尝试
+            if (points && !points->empty())
+            {
+                insert(path, Entry{mtime, std::move(points)});
+            }
+        });
+}
+
+bool SeekIndexCache::lookup(const std::string &path, int64_t targetUs, SeekPoint &point)
+{
+    std::shared_ptr<const PointList> points;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_indexes.find(path);
+        if (it == m_indexes.end())
+            return false;
+        points = it->second.points;
+    }
+
+    // 第一个 pts > targetUs 的点的前一个
+    auto it = std::upper_bound(points->begin(), points->end(), targetUs,
+                               [](int64_t value, const SeekPoint &p)
+                               { return value < p.ptsUs; });
+    if (it == points->begin())
+        return false;
+    point = *std::prev(it);
+    return true;
+}
+
+void SeekIndexCache::cancelPending()
+{
+    m_cancelled.store(true);
+}
+
+void SeekIndexCache::insert(const std::string &path, Entry entry)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_indexes.find(path) == m_indexes.end())
+    {
+        m_order.push_back(path);
+    }
+    m_indexes[path] = std::move(entry);
+
+    while (m_order.size() > SEEK_INDEX_MEMORY_CAPACITY)
+    {
+        m_indexes.erase(m_order.front());
+        m_order.pop_front();
+    }
+}
+
+std::shared_ptr<const SeekIndexCache::PointList> SeekIndexCache::scanFile(const std::string &path) const
+{
+    AVFormatContext *fmtCtx = nullptr;
+    if (avformat_open_input(&fmtCtx, path.c_str(), nullptr, nullptr) != 0)
+        return nullptr;
+
+    auto points = std::make_shared<PointList>();
+    AVPacket *packet = av_packet_alloc();
+    bool ok = avformat_find_stream_info(fmtCtx, nullptr) >= 0 && packet;
+    int streamIndex = ok ? av_find_best_stream(fmtCtx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0) : -1;
+    ok = ok && streamIndex >= 0;
+
+    if (ok)
+    {
+        const AVRational tb = fmtCtx->streams[streamIndex]->time_base;
+        int64_t cursorTs = AV_NOPTS_VALUE; // 没有 pts 时按包时长累加
+        int64_t lastRecordedUs = std::numeric_limits<int64_t>::min();
+        bool firstPacket = true;
+
+        // 只解复用不解码，读取速度接近磁盘顺序读
+        while (av_read_frame(fmtCtx, packet) >= 0)
+        {
+            if (m_cancelled.load())
+            {
+                ok = false;
+                av_packet_unref(packet);
+                break;
+            }
+            if (packet->stream_index != streamIndex)
+            {
+                av_packet_unref(packet);
+                continue;
+            }
+
+            int64_t ts = (packet->pts != AV_NOPTS_VALUE) ? packet->pts : cursorTs;
+            if (ts == AV_NOPTS_VALUE)
+            {
+                if (firstPacket && packet->duration > 0)
+                {
+                    ts = 0;
+                }
+                else
+                {
+                    // 既没有时间戳也无法推算，此文件无法建立可靠的索引
+                    ok = false;
+                    av_packet_unref(packet);
+                    break;
+                }
+            }
+            cursorTs = (packet->duration > 0) ? ts + packet->duration : AV_NOPTS_VALUE;
+            firstPacket = false;
+
+            int64_t ptsUs = av_rescale_q(ts, tb, AV_TIME_BASE_Q);
+            if (packet->pos >= 0 && (packet->flags & AV_PKT_FLAG_KEY) && ptsUs - lastRecordedUs >= SEEK_INDEX_INTERVAL_US)
+            {
+                points->push_back({ptsUs, packet->pos});
+                lastRecordedUs = ptsUs;
+            }
+            av_packet_unref(packet);
+        }
+    }
+
+    av_packet_free(&packet);
+    avformat_close_input(&fmtCtx);
+    if (!ok)
+        return nullptr;
+    return points;
+}
+
+std::shared_ptr<const SeekIndexCache::PointList> SeekIndexCache::loadFromDisk(const std::string &path, int64_t mtime)
+{
+    std::ifstream in(cacheFileFor(path), std::ios::binary);
+    if (!in)
+        return nullptr;
+
+    // 文件头：magic, version, mtime, 路径长度 + 路径 (防止哈希冲突), 点数
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    int64_t storedMtime = 0;
+    uint32_t pathLength = 0;
+    in.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    in.read(reinterpret_cast<char *>(&storedMtime), sizeof(storedMtime));
+    in.read(reinterpret_cast<char *>(&pathLength), sizeof(pathLength));
+    if (!in || magic != SEEK_INDEX_MAGIC || version != SEEK_INDEX_VERSION || storedMtime != mtime || pathLength != path.size())
+        return nullptr;
+
+    std::string storedPath(pathLength, '\0');
+    uint64_t count = 0;
+    in.read(storedPath.data(), pathLength);
+    in.read(reinterpret_cast<char *>(&count), sizeof(count));
+    if (!in || storedPath != path || count == 0 || count > (1u << 24))
+        return nullptr;
+
+    auto points = std::make_shared<PointList>(static_cast<size_t>(count));
+    in.read(reinterpret_cast<char *>(points->data()), static_cast<std::streamsize>(count * sizeof(SeekPoint)));
+    if (!in)
+        return nullptr;
+    return points;
+}
+
+void SeekIndexCache::saveToDisk(const std::string &path, int64_t mtime, const PointList &points)
+{
+    const fs::path file = cacheFileFor(path);
+    std::error_code ec;
+    fs::create_directories(file.parent_path(), ec);
+    if (ec)
+        return;
+
+    // 先写临时文件再重命名，避免半截文件被当作有效索引
+    const fs::path tmp = fs::path(file).concat(".tmp");
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return;
+        uint32_t pathLength = static_cast<uint32_t>(path.size());
+        uint64_t count = points.size();
+        out.write(reinterpret_cast<const char *>(&SEEK_INDEX_MAGIC), sizeof(SEEK_INDEX_MAGIC));
+        out.write(reinterpret_cast<const char *>(&SEEK_INDEX_VERSION), sizeof(SEEK_INDEX_VERSION));
+        out.write(reinterpret_cast<const char *>(&mtime), sizeof(mtime));
+        out.write(reinterpret_cast<const char *>(&pathLength), sizeof(pathLength));
+        out.write(path.data(), pathLength);
+        out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char *>(points.data()), static_cast<std::streamsize>(count * sizeof(SeekPoint)));
+        if (!out)
+            return;
+    }
+    fs::rename(tmp, file, ec);
+    if (ec)
+    {
+        spdlog::warn("[SeekIndex] Failed to persist index for {}: {}", path, ec.message());
+    }
+}
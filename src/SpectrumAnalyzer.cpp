@@ -0,0 +1,350 @@
+#include "SpectrumAnalyzer.hpp"
+
+#include <immintrin.h>
+
+namespace
+{
+// MXCSR：FTZ | DAZ，静音渐弱时避免非规格化数拖慢 FFT
+constexpr unsigned int MXCSR_FLUSH_DENORMALS = 0x8040;
+constexpr double PI = 3.14159265358979323846;
+// 显示值的回落速度 (上升立即跟随)
+constexpr float FALL_DB_PER_SECOND = 48.0f;
+constexpr auto STALE_AFTER = std::chrono::milliseconds(100);
+constexpr float LOWEST_BAND_HZ = 20.0f;
+constexpr float HIGHEST_BAND_HZ = 20000.0f;
+
+// 交错的设备格式 -> 平面 float (±1.0 满幅)，通道 c 写入 planes + c * stride
+void toPlanar(float *planes, size_t stride, const uint8_t *src, size_t frames, int channels, AudioKernels::PcmFormat format)
+{
+    using AudioKernels::PcmFormat;
+    const size_t samples = frames * static_cast<size_t>(channels);
+    for (size_t i = 0; i < samples; ++i)
+    {
+        float value = 0.0f;
+        switch (format)
+        {
+        case PcmFormat::U8:
+            value = (static_cast<int>(src[i]) - 128) * (1.0f / 128.0f);
+            break;
+        case PcmFormat::S16:
+        {
+            int16_t v;
+            std::memcpy(&v, src + i * 2, sizeof(v));
+            value = v * (1.0f / 32768.0f);
+            break;
+        }
+        case PcmFormat::S24:
+        {
+            const uint8_t *p = src + i * 3;
+            const int32_t v = static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8 | static_cast<uint32_t>(p[1]) << 16 | static_cast<uint32_t>(p[2]) << 24) >> 8;
+            value = v * (1.0f / 8388608.0f);
+            break;
+        }
+        case PcmFormat::S32:
+        {
+            int32_t v;
+            std::memcpy(&v, src + i * 4, sizeof(v));
+            value = static_cast<float>(v * (1.0 / 2147483648.0));
+            break;
+        }
+        case PcmFormat::F32:
+            std::memcpy(&value, src + i * 4, sizeof(value));
+            break;
+        case PcmFormat::F64:
+        {
+            double v;
+            std::memcpy(&v, src + i * 8, sizeof(v));
+            value = static_cast<float>(v);
+            break;
+        }
+        default:
+            break;
+        }
+        planes[(i % channels) * stride + i / channels] = value;
+    }
+}
+
+// dB -> [0, 1] 显示值
+float toLevel(float db)
+{
+    return std::clamp((db - SpectrumFrame::FLOOR_DB) / -SpectrumFrame::FLOOR_DB, 0.0f, 1.0f);
+}
+} // namespace
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+    : m_snapshots(std::make_unique<TripleBuffer<Snapshot>>())
+{
+    const float scale = 1.0f;
+    if (av_tx_init(&m_tx, &m_txFn, AV_TX_FLOAT_RDFT, 0, WINDOW_FRAMES, &scale, AV_TX_UNALIGNED) < 0)
+    {
+        spdlog::error("[SpectrumAnalyzer] av_tx_init failed, spectrum disabled");
+        av_tx_uninit(&m_tx);
+    }
+
+    // 周期 Hann 窗 (相干增益 0.5)
+    m_window.resize(WINDOW_FRAMES);
+    for (size_t i = 0; i < WINDOW_FRAMES; ++i)
+    {
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * static_cast<double>(i) / WINDOW_FRAMES));
+    }
+    m_planar.assign(WINDOW_FRAMES * SpectrumFrame::MAX_CHANNELS, 0.0f);
+    m_time.assign(WINDOW_FRAMES, 0.0f);
+    m_bins.assign(WINDOW_FRAMES / 2 + 1, AVComplexFloat{});
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    setEnabled(false);
+    av_tx_uninit(&m_tx);
+}
+
+void SpectrumAnalyzer::configure(AudioKernels::PcmFormat format, int channels, int sampleRate)
+{
+    const bool supported = format != AudioKernels::PcmFormat::Unknown && channels > 0 && channels <= SpectrumFrame::MAX_CHANNELS && sampleRate > 0;
+    m_format = format;
+    m_channels = supported ? channels : 0;
+    m_sampleRate = sampleRate;
+    m_frameBytes = supported ? AudioKernels::bytesPerSample(format) * static_cast<size_t>(channels) : 0;
+    m_history.assign(WINDOW_FRAMES * m_frameBytes, 0);
+    m_historyPos = 0;
+    m_historyFill = 0;
+}
+
+void SpectrumAnalyzer::write(const uint8_t *data, size_t bytes)
+{
+    if (!m_enabled.load(std::memory_order_relaxed) || m_frameBytes == 0)
+    {
+        // 关闭期间的旧数据作废，重新开启后从空窗口开始
+        m_historyFill = 0;
+        return;
+    }
+
+    const size_t capacity = m_history.size();
+    if (bytes >= capacity)
+    {
+        std::memcpy(m_history.data(), data + bytes - capacity, capacity);
+        m_historyPos = 0;
+        m_historyFill = capacity;
+    }
+    else
+    {
+        const size_t first = std::min(bytes, capacity - m_historyPos);
+        std::memcpy(m_history.data() + m_historyPos, data, first);
+        std::memcpy(m_history.data(), data + first, bytes - first);
+        m_historyPos = (m_historyPos + bytes) % capacity;
+        m_historyFill = std::min(m_historyFill + bytes, capacity);
+    }
+
+    // 只在工作线程需要时整理一次窗口，拷贝量与显示刷新率成正比
+    if (!m_snapshotRequested.load(std::memory_order_acquire))
+        return;
+    m_snapshotRequested.store(false, std::memory_order_relaxed);
+
+    Snapshot &snapshot = m_snapshots->back();
+    const size_t start = (m_historyPos + capacity - m_historyFill) % capacity;
+    const size_t first = std::min(m_historyFill, capacity - start);
+    std::memcpy(snapshot.data.data(), m_history.data() + start, first);
+    std::memcpy(snapshot.data.data() + first, m_history.data(), m_historyFill - first);
+    snapshot.frames = m_historyFill / m_frameBytes;
+    snapshot.format = m_format;
+    snapshot.channels = m_channels;
+    snapshot.sampleRate = m_sampleRate;
+    m_snapshots->publish();
+}
+
+void SpectrumAnalyzer::setEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    if (enabled == m_worker.joinable())
+        return;
+
+    if (enabled)
+    {
+        if (!m_tx)
+            return;
+        m_stop.store(false, std::memory_order_relaxed);
+        m_worker = std::thread(&SpectrumAnalyzer::workerLoop, this);
+        m_enabled.store(true, std::memory_order_relaxed);
+        return;
+    }
+
+    m_enabled.store(false, std::memory_order_relaxed);
+    m_stop.store(true, std::memory_order_relaxed);
+    m_demand.fetch_add(1, std::memory_order_release);
+    m_demand.notify_one();
+    m_worker.join();
+
+    // 工作线程已退出，由这里接手两个三缓冲的读 / 写端：丢弃未取走的快照，显示回到静音
+    m_snapshotRequested.store(false, std::memory_order_relaxed);
+    m_snapshots->update();
+    m_display = SpectrumFrame{};
+    m_frames.write(m_display);
+}
+
+void SpectrumAnalyzer::read(SpectrumFrame &out)
+{
+    m_frames.update();
+    out = m_frames.front();
+    if (m_enabled.load(std::memory_order_relaxed))
+    {
+        m_demand.fetch_add(1, std::memory_order_release);
+        m_demand.notify_one();
+    }
+}
+
+void SpectrumAnalyzer::workerLoop()
+{
+    const unsigned int mxcsr = _mm_getcsr();
+    _mm_setcsr(mxcsr | MXCSR_FLUSH_DENORMALS);
+
+    uint64_t seen = m_demand.load(std::memory_order_acquire);
+    m_lastFrame = std::chrono::steady_clock::now();
+    while (true)
+    {
+        m_demand.wait(seen, std::memory_order_acquire);
+        if (m_stop.load(std::memory_order_relaxed))
+            break;
+        seen = m_demand.load(std::memory_order_acquire);
+
+        const auto now = std::chrono::steady_clock::now();
+        const float elapsed = std::min(std::chrono::duration<float>(now - m_lastFrame).count(), 0.25f);
+        m_lastFrame = now;
+
+        if (m_snapshots->update())
+        {
+            analyze(m_snapshots->front());
+            m_lastSnapshot = now;
+        }
+        m_snapshotRequested.store(true, std::memory_order_release);
+        // 设备周期可能长于刷新间隔，短时间没有新快照时沿用上一次的结果；
+        // 长时间没有 (暂停 / 设备停止) 时目标为静音，显示值按回落速度归零
+        const bool live = now - m_lastSnapshot < STALE_AFTER;
+
+        const float fall = FALL_DB_PER_SECOND * elapsed / -SpectrumFrame::FLOOR_DB;
+        auto settle = [fall](float &shown, float target)
+        {
+            shown = std::max(target, shown - fall);
+        };
+        for (size_t b = 0; b < SpectrumFrame::BANDS; ++b)
+        {
+            settle(m_display.bands[b], live ? toLevel(m_bandsDb[b]) : 0.0f);
+        }
+        for (int ch = 0; ch < SpectrumFrame::MAX_CHANNELS; ++ch)
+        {
+            const bool active = live && ch < m_analyzedChannels;
+            settle(m_display.peak[ch], active ? toLevel(m_peakDb[ch]) : 0.0f);
+            settle(m_display.rms[ch], active ? toLevel(m_rmsDb[ch]) : 0.0f);
+        }
+        m_display.channels = m_analyzedChannels;
+        m_frames.write(m_display);
+    }
+}
+
+void SpectrumAnalyzer::analyze(const Snapshot &snapshot)
+{
+    const size_t frames = std::min(snapshot.frames, WINDOW_FRAMES);
+    const int channels = snapshot.channels;
+    m_analyzedChannels = frames > 0 ? channels : 0;
+    if (m_analyzedChannels == 0)
+    {
+        m_bandsDb.fill(SpectrumFrame::FLOOR_DB);
+        return;
+    }
+    if (snapshot.sampleRate != m_bandRate)
+    {
+        prepareBands(snapshot.sampleRate);
+    }
+
+    // 不足一个窗口 (刚开启) 时数据靠右对齐最新样本，前面补零
+    const size_t offset = WINDOW_FRAMES - frames;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        std::fill_n(&m_planar[ch * WINDOW_FRAMES], offset, 0.0f);
+    }
+    toPlanar(&m_planar[offset], WINDOW_FRAMES, snapshot.data.data(), frames, channels, snapshot.format);
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const float *plane = &m_planar[ch * WINDOW_FRAMES + offset];
+        const float peak = AudioKernels::peakAbsolute(plane, frames);
+        const double meanSquare = static_cast<double>(AudioKernels::sumOfSquares(plane, static_cast<int>(frames)).sumSquares) / static_cast<double>(frames);
+        m_peakDb[ch] = 20.0f * std::log10(std::max(peak, 1e-9f));
+        m_rmsDb[ch] = static_cast<float>(10.0 * std::log10(std::max(meanSquare, 1e-18)));
+    }
+
+    // 单声道混合 + 加窗
+    const float mixScale = 1.0f / static_cast<float>(channels);
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256 scaleVec = _mm256_set1_ps(mixScale);
+    for (; i < WINDOW_FRAMES; i += 8)
+    {
+        __m256 sum = _mm256_loadu_ps(&m_planar[i]);
+        for (int ch = 1; ch < channels; ++ch)
+        {
+            sum = _mm256_add_ps(sum, _mm256_loadu_ps(&m_planar[ch * WINDOW_FRAMES + i]));
+        }
+        _mm256_storeu_ps(&m_time[i], _mm256_mul_ps(_mm256_mul_ps(sum, scaleVec), _mm256_loadu_ps(&m_window[i])));
+    }
+#endif
+    for (; i < WINDOW_FRAMES; ++i)
+    {
+        float sum = 0.0f;
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            sum += m_planar[ch * WINDOW_FRAMES + i];
+        }
+        m_time[i] = sum * mixScale * m_window[i];
+    }
+
+    m_txFn(m_tx, m_bins.data(), m_time.data(), sizeof(float));
+
+    // |X|² 换算为正弦幅度：满幅正弦在 Hann 窗下 |X| = N / 4
+    const float toAmplitude = 4.0f / WINDOW_FRAMES;
+    const size_t lastBin = WINDOW_FRAMES / 2;
+    float *power = m_time.data(); // FFT 输入已用完，复用为功率谱
+    for (size_t k = 0; k <= lastBin; ++k)
+    {
+        power[k] = m_bins[k].re * m_bins[k].re + m_bins[k].im * m_bins[k].im;
+    }
+
+    for (size_t b = 0; b < SpectrumFrame::BANDS; ++b)
+    {
+        const float low = m_bandEdges[b];
+        const float high = m_bandEdges[b + 1];
+        if (low >= static_cast<float>(lastBin))
+        {
+            m_bandsDb[b] = SpectrumFrame::FLOOR_DB;
+            continue;
+        }
+
+        // 频带内有完整频点时取最大值，否则 (低频窄带) 在中心频率处线性插值
+        float value = 0.0f;
+        const size_t first = static_cast<size_t>(std::ceil(low));
+        const size_t last = std::min(static_cast<size_t>(std::floor(high)), lastBin);
+        if (first <= last)
+        {
+            value = *std::max_element(power + first, power + last + 1);
+        }
+        else
+        {
+            const float center = 0.5f * (low + high);
+            const size_t k = std::min(static_cast<size_t>(center), lastBin - 1);
+            const float frac = center - static_cast<float>(k);
+            value = power[k] + (power[k + 1] - power[k]) * frac;
+        }
+        m_bandsDb[b] = 10.0f * std::log10(std::max(value * toAmplitude * toAmplitude, 1e-18f));
+    }
+}
+
+void SpectrumAnalyzer::prepareBands(int sampleRate)
+{
+    m_bandRate = sampleRate;
+    m_bandEdges.resize(SpectrumFrame::BANDS + 1);
+    const float binsPerHz = static_cast<float>(WINDOW_FRAMES) / static_cast<float>(sampleRate);
+    for (size_t b = 0; b <= SpectrumFrame::BANDS; ++b)
+    {
+        const float hz = LOWEST_BAND_HZ * std::pow(HIGHEST_BAND_HZ / LOWEST_BAND_HZ, static_cast<float>(b) / SpectrumFrame::BANDS);
+        m_bandEdges[b] = hz * binsPerHz;
+    }
+}
@@ -0,0 +1,181 @@
+#include "TempoFilter.hpp"
+
+extern "C"
+{
+#include <libavfilter/avfilter.h>
+#include <libavfilter/buffersink.h>
+#include <libavfilter/buffersrc.h>
+}
+
+namespace
+{
+// atempo 实例名 (发送 tempo 命令的目标)
+constexpr const char *TEMPO_FILTER_NAME = "tempo";
+
+std::string tempoArgument(double speed)
+{
+    return std::format("{:.6f}", speed);
+}
+} // namespace
+
+TempoFilter::~TempoFilter()
+{
+    close();
+    av_frame_free(&m_input);
+    av_frame_free(&m_output);
+}
+
+bool TempoFilter::open(const AVFrame *frame, double speed)
+{
+    close();
+    if (!m_input)
+        m_input = av_frame_alloc();
+    if (!m_output)
+        m_output = av_frame_alloc();
+    m_graph = avfilter_graph_alloc();
+    if (!m_graph || !m_input || !m_output)
+    {
+        close();
+        return false;
+    }
+
+    const AVSampleFormat format = static_cast<AVSampleFormat>(frame->format);
+    const char *formatName = av_get_sample_fmt_name(format);
+    char layout[128] = {};
+    if (!formatName || av_channel_layout_describe(&frame->ch_layout, layout, sizeof(layout)) < 0)
+    {
+        close();
+        return false;
+    }
+
+    m_speed = std::clamp(speed, MIN_SPEED, MAX_SPEED);
+    m_pendingSpeed = m_speed;
+    m_sampleRate = frame->sample_rate;
+
+    // 输入时间基为微秒；atempo 不支持的采样格式由 libavfilter 自动插入转换，aformat 再转回原格式
+    const std::string sourceArgs = std::format("time_base=1/1000000:sample_rate={}:sample_fmt={}:channel_layout={}", frame->sample_rate, formatName, layout);
+    const std::string formatArgs = std::format("sample_fmts={}:sample_rates={}:channel_layouts={}", formatName, frame->sample_rate, layout);
+    const std::string tempoArgs = std::format("tempo={}", tempoArgument(m_speed));
+
+    AVFilterContext *tempo = nullptr;
+    AVFilterContext *output = nullptr;
+    if (avfilter_graph_create_filter(&m_source, avfilter_get_by_name("abuffer"), "in", sourceArgs.c_str(), nullptr, m_graph) < 0 ||
+        avfilter_graph_create_filter(&tempo, avfilter_get_by_name("atempo"), TEMPO_FILTER_NAME, tempoArgs.c_str(), nullptr, m_graph) < 0 ||
+        avfilter_graph_create_filter(&output, avfilter_get_by_name("aformat"), "format", formatArgs.c_str(), nullptr, m_graph) < 0 ||
+        avfilter_graph_create_filter(&m_sink, avfilter_get_by_name("abuffersink"), "out", nullptr, nullptr, m_graph) < 0 ||
+        avfilter_link(m_source, 0, tempo, 0) < 0 || avfilter_link(tempo, 0, output, 0) < 0 || avfilter_link(output, 0, m_sink, 0) < 0 ||
+        avfilter_graph_config(m_graph, nullptr) < 0)
+    {
+        spdlog::error("[TempoFilter] Failed to build filter graph ({} Hz, {}, {})", frame->sample_rate, formatName, layout);
+        close();
+        return false;
+    }
+
+    spdlog::debug("[TempoFilter] Filter graph ready: {} Hz, {}, {}, speed {:.2f}", frame->sample_rate, formatName, layout, m_speed);
+    return true;
+}
+
+void TempoFilter::close()
+{
+    avfilter_graph_free(&m_graph);
+    m_source = nullptr;
+    m_sink = nullptr;
+    m_inputs.clear();
+    m_position = 0.0;
+    m_tailUs = std::numeric_limits<double>::quiet_NaN();
+    if (m_input)
+        av_frame_unref(m_input);
+    if (m_output)
+        av_frame_unref(m_output);
+}
+
+bool TempoFilter::setSpeed(double speed)
+{
+    if (!m_graph)
+        return false;
+    // 滤镜图与 abuffersink 之间可能还有按原速度生成、尚未取走的帧，立即发送命令会让它们按新速度换算
+    m_pendingSpeed = std::clamp(speed, MIN_SPEED, MAX_SPEED);
+    return true;
+}
+
+void TempoFilter::applyPendingSpeed()
+{
+    if (m_pendingSpeed == m_speed)
+        return;
+
+    const std::string argument = tempoArgument(m_pendingSpeed);
+    if (avfilter_graph_send_command(m_graph, TEMPO_FILTER_NAME, "tempo", argument.c_str(), nullptr, 0, 0) < 0)
+    {
+        spdlog::warn("[TempoFilter] Failed to change speed to {:.2f}", m_pendingSpeed);
+        m_pendingSpeed = m_speed;
+        return;
+    }
+    m_speed = m_pendingSpeed;
+}
+
+int64_t TempoFilter::mediaTimeAt(double position) const
+{
+    const double base = m_inputs.empty() ? m_tailUs : static_cast<double>(m_inputs.front().ptsUs);
+    return static_cast<int64_t>(std::llround(base + position * 1000000.0 / m_sampleRate));
+}
+
+bool TempoFilter::send(const AVFrame *frame, const uint8_t **input, int samples, int64_t ptsUs)
+{
+    if (!m_graph)
+        return false;
+
+    if (!frame)
+        return av_buffersrc_add_frame_flags(m_source, nullptr, 0) >= 0;
+
+    if (samples > 0)
+        m_inputs.push_back({ptsUs, samples});
+
+    // 引用解码帧的缓冲区，只把数据指针移到裁剪后的起点
+    if (av_frame_ref(m_input, frame) < 0)
+        return false;
+    const int planes = av_sample_fmt_is_planar(static_cast<AVSampleFormat>(frame->format)) ? frame->ch_layout.nb_channels : 1;
+    for (int p = 0; p < planes; ++p)
+    {
+        m_input->extended_data[p] = const_cast<uint8_t *>(input[p]);
+        if (p < AV_NUM_DATA_POINTERS)
+            m_input->data[p] = const_cast<uint8_t *>(input[p]);
+    }
+    m_input->nb_samples = samples;
+    m_input->pts = ptsUs;
+
+    // 滤镜图接管引用 (m_input 随之被清空)
+    const int ret = av_buffersrc_add_frame_flags(m_source, m_input, 0);
+    if (ret < 0)
+    {
+        av_frame_unref(m_input);
+        return false;
+    }
+    return true;
+}
+
+AVFrame *TempoFilter::receive(int64_t &ptsUs)
+{
+    if (!m_graph)
+        return nullptr;
+
+    av_frame_unref(m_output);
+    const int ret = av_buffersink_get_frame(m_sink, m_output);
+    if (ret < 0)
+    {
+        // 已生成的输出全部取走，此时改变速度不会影响任何已生成的帧
+        if (ret == AVERROR(EAGAIN))
+            applyPendingSpeed();
+        return nullptr;
+    }
+    // 输出的每个采样对应 speed 个输入采样；按输入段反推媒体时间，输入 PTS 的跳变不会累积成误差
+    ptsUs = mediaTimeAt(m_position);
+    m_position += static_cast<double>(m_output->nb_samples) * m_speed;
+    while (!m_inputs.empty() && m_position >= static_cast<double>(m_inputs.front().samples))
+    {
+        const InputSpan &span = m_inputs.front();
+        m_position -= static_cast<double>(span.samples);
+        m_tailUs = static_cast<double>(span.ptsUs) + static_cast<double>(span.samples) * 1000000.0 / m_sampleRate;
+        m_inputs.pop_front();
+    }
+    return m_output;
+}
@@ -0,0 +1,181 @@
+#include "ThreadPriority.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <sdbus-c++/sdbus-c++.h>
+#endif
+
+namespace
+{
+// 解码线程的实时优先级：低于音频服务器与设备回调线程 (通常 ≥ 20)，高于所有普通线程
+constexpr int DECODE_REALTIME_PRIORITY = 10;
+// 无法获得实时调度时退回的 nice 值
+constexpr int DECODE_FALLBACK_NICE = -10;
+
+#ifdef __linux__
+pid_t currentTid()
+{
+    return static_cast<pid_t>(syscall(SYS_gettid));
+}
+
+// 通过 rtkit 申请实时调度 (普通用户没有 CAP_SYS_NICE 且 RLIMIT_RTPRIO 为 0 时的标准做法)
+bool requestRealtimeFromRtkit(int priority)
+{
+    try
+    {
+        auto connection = sdbus::createSystemBusConnection();
+        auto proxy = sdbus::createProxy(*connection, sdbus::ServiceName{"org.freedesktop.RealtimeKit1"}, sdbus::ObjectPath{"/org/freedesktop/RealtimeKit1"});
+        const sdbus::InterfaceName interface{"org.freedesktop.RealtimeKit1"};
+
+        const int32_t maxPriority = proxy->getProperty("MaxRealtimePriority").onInterface(interface).get<int32_t>();
+        const int64_t maxRtTimeUs = proxy->getProperty("RTTimeUSecMax").onInterface(interface).get<int64_t>();
+
+        // rtkit 要求进程先设置不超过其上限的 RLIMIT_RTTIME
+        rlimit limit{static_cast<rlim_t>(maxRtTimeUs), static_cast<rlim_t>(maxRtTimeUs)};
+        if (setrlimit(RLIMIT_RTTIME, &limit) != 0)
+            return false;
+
+        proxy->callMethod("MakeThreadRealtime")
+            .onInterface(interface)
+            .withArguments(static_cast<uint64_t>(currentTid()), static_cast<uint32_t>(std::min(priority, maxPriority)));
+        return true;
+    }
+    catch (const sdbus::Error &e)
+    {
+        spdlog::debug("[ThreadPriority] rtkit unavailable: {}", e.getMessage());
+        return false;
+    }
+}
+#endif
+} // namespace
+
+namespace ThreadPriority
+{
+bool promoteToRealtime(std::string &method)
+{
+#ifdef _WIN32
+    if (SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+    {
+        method = "TIME_CRITICAL";
+        return true;
+    }
+    method = "none";
+    return false;
+#elif defined(__linux__)
+    sched_param param{};
+    param.sched_priority = DECODE_REALTIME_PRIORITY;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0)
+    {
+        method = "SCHED_FIFO";
+        return true;
+    }
+    if (requestRealtimeFromRtkit(DECODE_REALTIME_PRIORITY))
+    {
+        method = "rtkit";
+        return true;
+    }
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(currentTid()), DECODE_FALLBACK_NICE) == 0)
+    {
+        method = "nice";
+        return false;
+    }
+    method = "none";
+    return false;
+#else
+    method = "none";
+    return false;
+#endif
+}
+
+void resetToNormal()
+{
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_NORMAL);
+#elif defined(__linux__)
+    sched_param param{};
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    setpriority(PRIO_PROCESS, static_cast<id_t>(currentTid()), 0);
+#endif
+}
+
+void lowerToIdle()
+{
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_IDLE);
+#elif defined(__linux__)
+    sched_param param{};
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+}
+
+bool pinToCore(int core)
+{
+    const int cores = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    if (core >= cores)
+        return false;
+#ifdef _WIN32
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+        return false;
+    DWORD_PTR mask = (core < 0) ? processMask : (DWORD_PTR{1} << core);
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (core < 0)
+    {
+        for (int i = 0; i < cores && i < CPU_SETSIZE; ++i)
+            CPU_SET(i, &set);
+    }
+    else
+    {
+        CPU_SET(core, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+bool lockMemory(void *data, size_t bytes)
+{
+    if (!data || bytes == 0)
+        return false;
+
+    // 逐页读写一次 (内容不变)，让所有页在锁定前就已映射
+    constexpr size_t PAGE_STRIDE = 4096;
+    volatile uint8_t *bytesPtr = static_cast<volatile uint8_t *>(data);
+    for (size_t offset = 0; offset < bytes; offset += PAGE_STRIDE)
+    {
+        bytesPtr[offset] = bytesPtr[offset];
+    }
+    bytesPtr[bytes - 1] = bytesPtr[bytes - 1];
+
+#ifdef _WIN32
+    return VirtualLock(data, bytes) != 0;
+#elif defined(__linux__)
+    return mlock(data, bytes) == 0;
+#else
+    return false;
+#endif
+}
+
+void unlockMemory(void *data, size_t bytes)
+{
+    if (!data || bytes == 0)
+        return;
+#ifdef _WIN32
+    VirtualUnlock(data, bytes);
+#elif defined(__linux__)
+    munlock(data, bytes);
+#endif
+}
+} // namespace ThreadPriority
@@ -32,6 +32,11 @@ UIController::UIController(QObject *parent) :
             this, &UIController::onWaveformCalculationFinished);
     m_currentWaveformGeneration = 0;
 
+    connect(&m_lyricsWatcher, &QFutureWatcher<AsyncLyricsResult>::finished,
+            this, &UIController::onLyricsLoaded);
+    m_lyricsTimer.setSingleShot(true);
+    connect(&m_lyricsTimer, &QTimer::timeout, this, &UIController::checkAndUpdateLyricsLine);
+
     // 初始化 OutputMode
     m_outputMode = static_cast<int>(m_mediaController.getOUTPUTMode());
 
@@ -49,6 +54,10 @@ UIController::~UIController()
         m_waveformWatcher.cancel();
         m_waveformWatcher.waitForFinished();
     }
+    if (m_lyricsWatcher.isRunning())
+    {
+        m_lyricsWatcher.waitForFinished();
+    }
 }
 
 void UIController::startMediaScan(const QString &path)
@@ -301,6 +310,10 @@ qint64 UIController::currentPosMicrosec() const
 {
     return m_currentPosMicrosec;
 }
+qint64 UIController::clockPosMicrosec()
+{
+    return m_mediaController.getCurrentPosMicroseconds();
+}
 QString UIController::gradientColor1() const
 {
     return m_gradientColor1;
@@ -364,6 +377,274 @@ void UIController::setOutputMode(int mode)
     }
 }
 
+// 交叉淡化时长 (仅 Mixing 模式生效)
+int UIController::crossfadeMs() const
+{
+    return m_mediaController.getCrossfadeDuration();
+}
+
+void UIController::setCrossfadeMs(int milliseconds)
+{
+    if (milliseconds == m_mediaController.getCrossfadeDuration())
+        return;
+
+    m_mediaController.setCrossfadeDuration(milliseconds);
+    emit crossfadeMsChanged();
+}
+
+// 最终输出级的抖动方式：0 = Off, 1 = TPDF, 2 = TPDF + 噪声整形
+int UIController::ditherMode() const
+{
+    return static_cast<int>(m_mediaController.getDitherMode());
+}
+
+void UIController::setDitherMode(int mode)
+{
+    if (mode < 0 || mode > static_cast<int>(AudioKernels::DitherMode::TpdfShaped) || mode == ditherMode())
+        return;
+
+    m_mediaController.setDitherMode(static_cast<AudioKernels::DitherMode>(mode));
+    emit ditherModeChanged();
+}
+
+// 响度归一化：0 = Off, 1 = 按曲目, 2 = 按专辑
+int UIController::normalizationMode() const
+{
+    return static_cast<int>(m_mediaController.getNormalizationMode());
+}
+
+void UIController::setNormalizationMode(int mode)
+{
+    if (mode < 0 || mode > static_cast<int>(NormalizationMode::Album) || mode == normalizationMode())
+        return;
+
+    m_mediaController.setNormalizationMode(static_cast<NormalizationMode>(mode));
+    emit normalizationModeChanged();
+}
+
+int UIController::latencyProfile() const
+{
+    return static_cast<int>(m_mediaController.getLatencyProfile());
+}
+
+void UIController::setLatencyProfile(int profile)
+{
+    if (profile < 0 || profile > static_cast<int>(LatencyProfile::LowPower) || profile == latencyProfile())
+        return;
+
+    m_mediaController.setLatencyProfile(static_cast<LatencyProfile>(profile));
+    emit latencyProfileChanged();
+}
+
+int UIController::devicePeriodMs() const
+{
+    return m_mediaController.getDevicePeriod();
+}
+
+void UIController::setDevicePeriodMs(int milliseconds)
+{
+    if (milliseconds == devicePeriodMs())
+        return;
+
+    m_mediaController.setDevicePeriod(milliseconds);
+    emit devicePeriodMsChanged();
+}
+
+// 重采样器质量按输出模式分别保存，界面显示 / 修改的是当前模式的设置
+int UIController::resamplerQuality() const
+{
+    return static_cast<int>(m_mediaController.getResamplerQuality(m_mediaController.getOUTPUTMode()));
+}
+
+void UIController::setResamplerQuality(int quality)
+{
+    if (quality < 0 || quality > static_cast<int>(ResamplerQuality::High) || quality == resamplerQuality())
+        return;
+
+    m_mediaController.setResamplerQuality(m_mediaController.getOUTPUTMode(), static_cast<ResamplerQuality>(quality));
+    emit resamplerQualityChanged();
+}
+
+int UIController::decodeAheadMode() const
+{
+    return static_cast<int>(m_mediaController.getDecodeAheadMode());
+}
+
+void UIController::setDecodeAheadMode(int mode)
+{
+    if (mode < 0 || mode > static_cast<int>(DecodeAheadMode::Always) || mode == decodeAheadMode())
+        return;
+
+    m_mediaController.setDecodeAhead(static_cast<DecodeAheadMode>(mode));
+    emit decodeAheadModeChanged();
+}
+
+bool UIController::realtimeMode() const
+{
+    return m_mediaController.getRealtimeStatus().requested;
+}
+
+QString UIController::realtimeStatus() const
+{
+    return m_realtimeStatus;
+}
+
+void UIController::setRealtimeMode(bool enabled)
+{
+    if (enabled == realtimeMode())
+        return;
+
+    m_mediaController.setRealtimeMode(enabled);
+    emit realtimeModeChanged();
+}
+
+bool UIController::eqEnabled() const
+{
+    return m_mediaController.getEqualizerEnabled();
+}
+
+void UIController::setEqEnabled(bool enabled)
+{
+    if (enabled == eqEnabled())
+        return;
+
+    m_mediaController.setEqualizerEnabled(enabled);
+    emit eqEnabledChanged();
+}
+
+// 图示均衡预设下标，-1 表示手动调整过的自定义曲线
+int UIController::eqPreset() const
+{
+    return m_eqPreset;
+}
+
+void UIController::setEqPreset(int preset)
+{
+    const auto &presets = EqualizerStage::presets();
+    if (preset < 0 || preset >= static_cast<int>(presets.size()) || preset == m_eqPreset)
+        return;
+
+    m_mediaController.setEqualizerSettings(EqualizerStage::graphic(presets[preset].gainsDb));
+    m_eqPreset = preset;
+    emit eqPresetChanged();
+    emit eqGainsChanged();
+}
+
+QStringList UIController::eqPresetNames() const
+{
+    QStringList names;
+    for (const EqPreset &preset : EqualizerStage::presets())
+    {
+        names.append(QString::fromUtf8(preset.name));
+    }
+    return names;
+}
+
+QVariantList UIController::eqFrequencies() const
+{
+    QVariantList frequencies;
+    for (float frequency : EqualizerStage::GRAPHIC_FREQUENCIES)
+    {
+        frequencies.append(frequency);
+    }
+    return frequencies;
+}
+
+QVariantList UIController::eqGains() const
+{
+    QVariantList gains;
+    for (const EqBand &band : m_mediaController.getEqualizerSettings().bands)
+    {
+        gains.append(band.gainDb);
+    }
+    return gains;
+}
+
+void UIController::setEqGain(int band, double gainDb)
+{
+    if (band < 0 || band >= static_cast<int>(EQ_BANDS))
+        return;
+
+    std::array<float, EQ_BANDS> gains{};
+    const EqSettings current = m_mediaController.getEqualizerSettings();
+    for (size_t i = 0; i < EQ_BANDS; ++i)
+    {
+        gains[i] = current.bands[i].gainDb;
+    }
+    if (gains[band] == static_cast<float>(gainDb))
+        return;
+
+    gains[band] = static_cast<float>(gainDb);
+    m_mediaController.setEqualizerSettings(EqualizerStage::graphic(gains));
+    emit eqGainsChanged();
+    if (m_eqPreset != -1)
+    {
+        m_eqPreset = -1;
+        emit eqPresetChanged();
+    }
+}
+
+// 当前使用的脉冲响应文件，未加载时为空
+QString UIController::convolverImpulse() const
+{
+    return QString::fromStdString(m_mediaController.getConvolverImpulse());
+}
+
+bool UIController::setConvolverImpulse(const QString &path)
+{
+    if (!m_mediaController.setConvolverImpulse(path.toStdString()))
+        return false;
+
+    emit convolverImpulseChanged();
+    return true;
+}
+
+// 播放速度 (变速不变调)，拖动即生效
+double UIController::playbackSpeed() const
+{
+    return m_mediaController.getPlaybackSpeed();
+}
+
+void UIController::setPlaybackSpeed(double speed)
+{
+    if (qFuzzyCompare(speed, playbackSpeed()))
+        return;
+
+    m_mediaController.setPlaybackSpeed(speed);
+    emit playbackSpeedChanged();
+}
+
+// 频谱 / 电平表：窗口可见时开启，隐藏时关闭 (不做任何计算)
+bool UIController::spectrumEnabled() const
+{
+    return m_mediaController.getSpectrumEnabled();
+}
+
+void UIController::setSpectrumEnabled(bool enabled)
+{
+    if (enabled == spectrumEnabled())
+        return;
+
+    m_mediaController.setSpectrumEnabled(enabled);
+    emit spectrumEnabledChanged();
+}
+
+QList<float> UIController::spectrumFrame()
+{
+    SpectrumFrame frame;
+    m_mediaController.readSpectrum(frame);
+
+    QList<float> values;
+    values.reserve(4 + static_cast<qsizetype>(SpectrumFrame::BANDS));
+    const int right = frame.channels > 1 ? 1 : 0;
+    values << frame.peak[0] << frame.peak[right] << frame.rms[0] << frame.rms[right];
+    for (float band : frame.bands)
+    {
+        values << band;
+    }
+    return values;
+}
+
 // 辅助函数：Index <-> AVSampleFormat
 AVSampleFormat UIController::indexToAvFormat(int index)
 {
@@ -373,12 +654,16 @@ AVSampleFormat UIController::indexToAvFormat(int index)
     case 1: return AV_SAMPLE_FMT_S32;
     case 2: return AV_SAMPLE_FMT_FLT;
     case 3: return AV_SAMPLE_FMT_DBL;
+    case 4: return AV_SAMPLE_FMT_S32; // S24 (打包)，由 packed24 区分
     default: return AV_SAMPLE_FMT_FLT;
     }
 }
 
-int UIController::avFormatToIndex(AVSampleFormat fmt)
+int UIController::avFormatToIndex(AVSampleFormat fmt, bool packed24)
 {
+    if (packed24)
+        return 4;
+
     // 简化匹配，忽略 planar 区别
     switch (fmt)
     {
@@ -398,7 +683,7 @@ void UIController::applyMixingParams(int sampleRate, int formatIndex)
 {
     // 1. 设置参数
     AVSampleFormat fmt = indexToAvFormat(formatIndex);
-    m_mediaController.setMixingParameters(sampleRate, fmt);
+    m_mediaController.setMixingParameters(sampleRate, fmt, formatIndex == 4);
 
     // 2. [修改] 等待 500ms 后读取 (符合需求)
     QTimer::singleShot(500, this, [=, this]()
@@ -406,7 +691,7 @@ void UIController::applyMixingParams(int sampleRate, int formatIndex)
         AudioParams currentParams = m_mediaController.getDeviceParameters();
         
         int actualRate = currentParams.sampleRate;
-        int actualFmtIndex = avFormatToIndex(currentParams.sampleFormat);
+        int actualFmtIndex = avFormatToIndex(currentParams.sampleFormat, currentParams.packed24);
         
         emit mixingParamsApplied(actualRate, actualFmtIndex); });
 }
@@ -417,7 +702,7 @@ QVariantMap UIController::getCurrentDeviceParams()
 
     QVariantMap result;
     result["sampleRate"] = params.sampleRate;
-    result["formatIndex"] = avFormatToIndex(params.sampleFormat);
+    result["formatIndex"] = avFormatToIndex(params.sampleFormat, params.packed24);
 
     return result;
 }
@@ -429,6 +714,26 @@ void UIController::checkAndUpdateOutputMode()
     {
         m_outputMode = current;
         emit outputModeChanged();
+        emit resamplerQualityChanged();
+    }
+}
+
+// 实时模式由解码线程异步应用，这里轮询系统实际批准的结果
+void UIController::checkAndUpdateRealtimeStatus()
+{
+    RealtimeStatus status = m_mediaController.getRealtimeStatus();
+    QString text;
+    if (status.requested)
+    {
+        text = QString("%1 (%2)%3")
+                   .arg(status.realtimeGranted ? "Realtime granted" : "Realtime denied")
+                   .arg(QString::fromStdString(status.method))
+                   .arg(status.memoryLocked ? ", buffer locked" : ", buffer not locked");
+    }
+    if (m_realtimeStatus != text)
+    {
+        m_realtimeStatus = text;
+        emit realtimeStatusChanged();
     }
 }
 
@@ -517,6 +822,70 @@ void UIController::onWaveformCalculationFinished()
     emit waveformHeightsChanged();
 }
 
+// 歌词只在切换到该曲目时加载 (文件 I/O 与编码探测放到后台线程)
+void UIController::loadLyricsForNode(PlaylistNode *node)
+{
+    m_currentLyricsGeneration++;
+    m_lyricsTimer.stop();
+    m_lyrics = Lyrics{};
+    m_lyricsLines.clear();
+    emit lyricsChanged();
+    if (m_lyricsLine != -1)
+    {
+        m_lyricsLine = -1;
+        emit lyricsLineChanged();
+    }
+
+    if (!node || node->isDir() || node->getMetaData().getFilePath().empty())
+        return;
+
+    const quint64 thisRequestId = m_currentLyricsGeneration;
+    const MetaData track = node->getMetaData();
+    m_lyricsWatcher.setFuture(QtConcurrent::run([=]()
+                                                { return AsyncLyricsResult{thisRequestId, Lyrics::load(track)}; }));
+}
+
+void UIController::onLyricsLoaded()
+{
+    AsyncLyricsResult result = m_lyricsWatcher.result();
+    if (result.generationId != m_currentLyricsGeneration)
+        return;
+
+    m_lyrics = std::move(result.lyrics);
+    m_lyricsLines.clear();
+    m_lyricsLines.reserve(static_cast<qsizetype>(m_lyrics.lines().size()));
+    for (const LyricLine &line : m_lyrics.lines())
+    {
+        m_lyricsLines.append(QString::fromStdString(line.text));
+    }
+    emit lyricsChanged();
+    checkAndUpdateLyricsLine();
+}
+
+// 当前行只在变化时通知；播放中按播放时钟预约下一行的切换时刻，不受状态定时器 100ms 粒度的限制
+void UIController::checkAndUpdateLyricsLine()
+{
+    if (!m_lyrics.synced())
+        return;
+
+    const int64_t position = m_mediaController.getCurrentPosMicroseconds();
+    const int line = m_lyrics.lineAt(position);
+    if (m_lyricsLine != line)
+    {
+        m_lyricsLine = line;
+        emit lyricsLineChanged();
+    }
+
+    const int64_t next = m_lyrics.nextLineTime(line);
+    if (next < 0 || !m_mediaController.getIsPlaying())
+    {
+        m_lyricsTimer.stop();
+        return;
+    }
+    const double speed = std::max(m_mediaController.getPlaybackSpeed(), 0.1);
+    m_lyricsTimer.start(static_cast<int>(std::ceil((next - position) / speed / 1000.0)));
+}
+
 void UIController::checkAndUpdateCoverArt(PlaylistNode *currentNode)
 {
     QString newCoverPath = "";
@@ -667,6 +1036,7 @@ void UIController::updateStateFromController()
 
     // [新增] 检查输出模式
     checkAndUpdateOutputMode();
+    checkAndUpdateRealtimeStatus();
 
     PlaylistNode *currentNode = m_mediaController.getCurrentPlayingNode();
     bool isSongChanged = false;
@@ -688,6 +1058,7 @@ void UIController::updateStateFromController()
 
         checkAndUpdateCoverArt(currentNode);
         generateWaveformForNode(currentNode);
+        loadLyricsForNode(currentNode);
     }
 
     checkAndUpdatePlayState();
@@ -695,6 +1066,7 @@ void UIController::updateStateFromController()
     if (!isSongChanged)
     {
         checkAndUpdateTimeState();
+        checkAndUpdateLyricsLine();
     }
 }
 
@@ -714,6 +1086,7 @@ void UIController::prepareForQuit()
         m_stateTimer.stop();
     if (m_volumeTimer.isActive())
         m_volumeTimer.stop();
+    m_lyricsTimer.stop();
 
     // 2. 取消异步任务
     if (m_waveformWatcher.isRunning())
@@ -721,4 +1094,8 @@ void UIController::prepareForQuit()
         m_waveformWatcher.cancel();
         m_waveformWatcher.waitForFinished();
     }
+    if (m_lyricsWatcher.isRunning())
+    {
+        m_lyricsWatcher.waitForFinished();
+    }
 }
\ No newline at end of file
@@ -192,6 +192,8 @@ void runTerminalMode(QCoreApplication &app, const QString &rootDir)
     std::cout << " [.] Next Song\n";
     std::cout << " [q] or [Ctrl+C] Quit\n";
     std::cout << " [r] Random\n";
+    std::cout << " [i] Playback Stats\n";
+    std::cout << " [v] Bit-perfect Verification\n";
     std::cout << "==========================================\n";
 
     // 开启输入监听线程
@@ -231,6 +233,15 @@ void runTerminalMode(QCoreApplication &app, const QString &rootDir)
                     running = false;
                     app.quit(); // 触发 Qt 事件循环退出
                     break;
+                case 'i':
+                    std::cout << "> Stats: " << mediaController.getStats().summary() << "\n";
+                    break;
+                case 'v': {
+                    const bool enabled = !mediaController.getBitPerfectVerification();
+                    mediaController.setBitPerfectVerification(enabled);
+                    std::cout << "> Bit-perfect verification: " << (enabled ? "on" : "off") << "\n";
+                    break;
+                }
                 case 'r':
                     std::cout << "> Command: random\n";
                     mediaController.setShuffle(!mediaController.getShuffle());
@@ -260,6 +271,61 @@ void runTerminalMode(QCoreApplication &app, const QString &rootDir)
 }
 #endif
 
+// 离线渲染：--render=<输出文件 | null> [--direct] <文件>...
+// 扩展名 .raw / .pcm 输出裸 PCM，null 只测量吞吐，其他输出 WAV；默认按 Mixing 模式的参数渲染
+int runRenderMode(int argc, char *argv[])
+{
+    std::string output;
+    bool direct = false;
+    std::vector<std::string> playlist;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("--render="))
+            output = arg.substr(9);
+        else if (arg == "--direct")
+            direct = true;
+        else if (!arg.starts_with("--"))
+            playlist.emplace_back(arg);
+    }
+    if (playlist.empty())
+    {
+        std::cerr << "usage: --render=<out.wav|out.raw|null> [--direct] <file>...\n";
+        return 1;
+    }
+
+    RenderOptions options;
+    options.sink = RenderSink::Wav;
+    options.outputPath = output;
+    const std::string extension = fs::path(output).extension().string();
+    if (output == "null")
+        options.sink = RenderSink::Discard;
+    else if (extension == ".raw" || extension == ".pcm")
+        options.sink = RenderSink::Raw;
+
+    RenderResult result;
+    {
+        AudioPlayer player;
+        player.setOutputMode(direct ? OUTPUT_DIRECT : OUTPUT_MIXING);
+        result = player.renderOffline(playlist, options);
+    }
+    SimpleThreadPool::instance().shutdown();
+
+    if (!result.ok)
+    {
+        std::cerr << "render failed: " << result.error << "\n";
+        return 1;
+    }
+    std::cout << std::format("{} tracks, {} frames ({:.2f} s) at {} Hz {} ch in {:.2f} s, {:.1f}x realtime\n",
+                             result.tracks, result.frames, result.audioSeconds, result.format.sampleRate, result.format.channels,
+                             result.wallSeconds, result.realtimeFactor());
+    for (size_t i = 0; i < result.trackStartFrames.size(); ++i)
+    {
+        std::cout << std::format("  track {:3} starts at frame {}\n", i + 1, result.trackStartFrames[i]);
+    }
+    return 0;
+}
+
 void initLogger()
 {
     try
@@ -350,6 +416,12 @@ int main(int argc, char *argv[])
 
     // 创建logger
     initLogger();
+    // 离线渲染不需要界面与控制器
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string_view(argv[i]).starts_with("--render="))
+            return runRenderMode(argc, argv);
+    }
     // 2. 分支处理：无 GUI 模式
     if (!useGui)
     {